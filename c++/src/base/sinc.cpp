@@ -7,6 +7,11 @@
 #include <csignal>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cmath>
+#include <algorithm>
 
 /**
  * SincConfig
@@ -66,18 +71,226 @@ void BaseMonitor::show(std::ostream& os) {
         formatMemorySize(ckbMemCost).c_str(), ((double) ckbMemCost) / usage.ru_maxrss * 100.0,
         formatMemorySize(usage.ru_maxrss).c_str()
     );
+    printf(os, "%10s %10s %10s\n", "Budget.P", "#Soft", "Relieved");
+    printf(
+        os, "%10s %10d %10s\n\n",
+        formatMemorySize(budgetPeakMemCost).c_str(), softBudgetExceeded, formatMemorySize(relievedMemCost).c_str()
+    );
 
     os << "--- Statistics ---\n";
     printf(
-        os, "# %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
-        "|P|", "|Σ|", "|B|", "|H|", "||H||", "|N|", "|A|", "|ΔΣ|", "#SCC", "|SCC|", "|FVS|", "Comp(%)", "#SQL", "#SQL/|H|"
+        os, "# %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+        "|P|", "|Σ|", "|B|", "|H|", "||H||", "|N|", "|A|", "|ΔΣ|", "#SCC", "|SCC|", "|FVS|", "Comp(%)", "#SQL", "#SQL/|H|", "#Bnd",
+        "#NoJoin", "#BwChg"
     );
     printf(
-        os, "  %10d %10d %10d %10d %10d %10d %10d %10d %10d %10d %10d %10.2f %10d %10.2f\n\n",
+        os, "  %10d %10d %10d %10d %10d %10d %10d %10d %10d %10d %10d %10.2f %10d %10.2f %10d %10d %10d\n\n",
         kbFunctors, kbConstants, kbSize, hypothesisRuleNumber, hypothesisSize, necessaryFacts, counterexamples, supplementaryConstants,
         sccNumber, sccVertices, fvsVertices, (necessaryFacts + counterexamples + hypothesisSize) * 100.0 / kbSize,
-        evaluatedSqls, evaluatedSqls * 1.0 / hypothesisRuleNumber
+        evaluatedSqls, evaluatedSqls * 1.0 / hypothesisRuleNumber, boundPrunedRules, infeasibleJoins, beamwidthChanges
     );
+    if (0 < resumedRelations) {
+        printf(os, "# Resumed from checkpoint: %d relations\n\n", resumedRelations);
+    }
+    if (0 < sampledEvaluations) {
+        printf(
+            os, "# Sampled evaluations: %d (verified: %d); Ranking disagreements: %d/%d (%.2f%%)\n\n", sampledEvaluations,
+            verifiedEvaluations, rankingDisagreements, sampledRankings,
+            (0 < sampledRankings) ? rankingDisagreements * 100.0 / sampledRankings : 0.0
+        );
+    }
+
+    if (!relationSchedules.empty()) {
+        os << "--- Relation Schedule ---\n";
+        printf(os, "%10s %20s %15s %10s %10s\n", "Start", "Relation", "Est. Cost", "Time(ms)", "Timeout");
+        for (RelationSchedule const& schedule: relationSchedules) {
+            printf(
+                os, "%10d %20s %15.1f %10d %10s\n", schedule.startOrder, schedule.relation.c_str(), schedule.estimatedCost,
+                NANO_TO_MILL(schedule.miningTime), schedule.timedOut ? "yes" : "no"
+            );
+        }
+        printf(os, "# Timed out: %d\n", timedOutRelations);
+        os << '\n';
+    }
+}
+
+/**
+ * TopKRules
+ */
+using sinc::TopKRules;
+
+TopKRules::TopKRules(int const capacity) : entries(new Entry[std::max(capacity, 1)]), allocated(std::max(capacity, 1)),
+    cap(std::max(capacity, 1)), bestEntry{nullptr, -std::numeric_limits<double>::infinity(), 0} {}
+
+TopKRules::~TopKRules() {
+    delete[] entries;
+}
+
+sinc::Rule* TopKRules::add(Rule* const rule, double const score) {
+    Entry const entry{rule, score, nextSeq++};
+    Rule* dropped = nullptr;
+    if (num < cap) {
+        entries[num] = entry;
+        siftUp(num);
+        num++;
+    } else if (lower(entries[0], entry)) {
+        dropped = entries[0].rule;
+        entries[0] = entry;
+        siftDown(0);
+    } else {
+        return rule;
+    }
+    if (nullptr == bestEntry.rule || dropped == bestEntry.rule || lower(bestEntry, entry)) {
+        /* The best entry is dropped only if it is the only one in the container */
+        bestEntry = entry;
+    }
+    return dropped;
+}
+
+double TopKRules::threshold() const {
+    return (num < cap) ? -std::numeric_limits<double>::infinity() : entries[0].score;
+}
+
+sinc::Rule* TopKRules::best() const {
+    return bestEntry.rule;
+}
+
+double TopKRules::bestScore() const {
+    return bestEntry.score;
+}
+
+std::vector<sinc::Rule*> TopKRules::ranked() const {
+    std::vector<Entry> sorted_entries(entries, entries + num);
+    std::sort(sorted_entries.begin(), sorted_entries.end(), [](Entry const& a, Entry const& b) {
+        return lower(b, a);
+    });
+    std::vector<Rule*> rules;
+    rules.reserve(num);
+    for (Entry const& entry: sorted_entries) {
+        rules.push_back(entry.rule);
+    }
+    return rules;
+}
+
+void TopKRules::clear() {
+    num = 0;
+    bestEntry = Entry{nullptr, -std::numeric_limits<double>::infinity(), 0};
+}
+
+void TopKRules::reset(int const capacity) {
+    clear();
+    cap = std::max(capacity, 1);
+    if (cap > allocated) {
+        delete[] entries;
+        entries = new Entry[cap];
+        allocated = cap;
+    }
+}
+
+int TopKRules::size() const {
+    return num;
+}
+
+int TopKRules::capacity() const {
+    return cap;
+}
+
+bool TopKRules::empty() const {
+    return 0 == num;
+}
+
+bool TopKRules::full() const {
+    return num >= cap;
+}
+
+bool TopKRules::lower(Entry const& a, Entry const& b) {
+    return a.score < b.score || (a.score == b.score && a.seq > b.seq);
+}
+
+void TopKRules::siftUp(int idx) {
+    Entry const entry = entries[idx];
+    while (0 < idx) {
+        int const parent = (idx - 1) / 2;
+        if (!lower(entry, entries[parent])) {
+            break;
+        }
+        entries[idx] = entries[parent];
+        idx = parent;
+    }
+    entries[idx] = entry;
+}
+
+void TopKRules::siftDown(int idx) {
+    Entry const entry = entries[idx];
+    while (true) {
+        int child = idx * 2 + 1;
+        if (child >= num) {
+            break;
+        }
+        if (child + 1 < num && lower(entries[child + 1], entries[child])) {
+            child++;
+        }
+        if (!lower(entries[child], entry)) {
+            break;
+        }
+        entries[idx] = entries[child];
+        idx = child;
+    }
+    entries[idx] = entry;
+}
+
+/**
+ * AdaptiveBeamwidth
+ */
+using sinc::AdaptiveBeamwidth;
+
+AdaptiveBeamwidth::AdaptiveBeamwidth(int const _beamwidth) : AdaptiveBeamwidth(_beamwidth, _beamwidth, _beamwidth, 0, 0, 0) {}
+
+AdaptiveBeamwidth::AdaptiveBeamwidth(
+    int const _beamwidth, int const _minBeamwidth, int const _maxBeamwidth, size_t const _cacheLimitKb,
+    size_t const _evalMemLimitKb, uint64_t const _iterationTimeLimitMs
+) : beamwidth(std::max(_beamwidth, 1)), minBeamwidth(std::max(std::min(_minBeamwidth, beamwidth), 1)),
+    maxBeamwidth(std::max(_maxBeamwidth, beamwidth)), cacheLimitKb(_cacheLimitKb), evalMemLimitKb(_evalMemLimitKb),
+    iterationTimeLimitMs(_iterationTimeLimitMs) {}
+
+bool AdaptiveBeamwidth::adaptive() const {
+    return minBeamwidth < maxBeamwidth;
+}
+
+int AdaptiveBeamwidth::width() const {
+    return beamwidth;
+}
+
+bool AdaptiveBeamwidth::adjust(Pressure const& pressure, std::string& reason) {
+    if (!adaptive()) {
+        return false;
+    }
+    char buf[64];
+    reason.clear();
+    bool relaxed = true;
+    auto check = [&](const char* name, uint64_t const value, uint64_t const limit) {
+        if (0 == limit) {
+            return;
+        }
+        if (value > limit) {
+            snprintf(
+                buf, sizeof(buf), "%s%s %lu > %lu", reason.empty() ? "" : ", ", name, (unsigned long) value, (unsigned long) limit
+            );
+            reason += buf;
+        }
+        relaxed = relaxed && value * 2 <= limit;
+    };
+    check("cache(KB)", pressure.cacheKb, cacheLimitKb);
+    check("eval(KB)", pressure.evalMemKb, evalMemLimitKb);
+    check("time(ms)", pressure.iterationTimeMs, iterationTimeLimitMs);
+    int const old_width = beamwidth;
+    if (!reason.empty()) {
+        beamwidth = std::max(beamwidth / 2, minBeamwidth);
+    } else if (relaxed) {
+        beamwidth = std::min(beamwidth + 1, maxBeamwidth);
+        reason = "cheap iteration";
+    }
+    return old_width != beamwidth;
 }
 
 /**
@@ -99,11 +312,18 @@ RelationMiner::RelationMiner(
     std::unordered_set<Record>& _counterexamples, std::ostream& _logger
 ) : kb(_kb), targetRelation(_targetRelation), evalMetric(_evalMetric), beamwidth(_beamwidth), maxMemKByte(_maxMemKByte), stopCompressionRatio(_stopCompressionRatio),
     predicate2NodeMap(_predicate2NodeMap), dependencyGraph(_dependencyGraph), hypothesis(_hypothesis), counterexamples(_counterexamples),
-    logger(_logger), logFormatter(_logger) {}
+    localMemoryAccountant(_maxMemKByte * MemoryAccountant::DEFAULT_SOFT_RATIO, _maxMemKByte), memoryAccountant(&localMemoryAccountant),
+    adaptiveBeam(_beamwidth), logger(_logger), logFormatter(_logger)
+{
+    localMemoryAccountant.calibrate();
+}
 
 RelationMiner::~RelationMiner() {
+    for (int const& id: memorySourceIds) {
+        memoryAccountant->removeSource(id);
+    }
     /* Release resources in tabu map */
-    for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -114,7 +334,7 @@ void RelationMiner::run() {
     int covered_facts = 0;
     int const total_facts = kb.getRelation(targetRelation)->getTotalRows();
     BaseMonitor monitor;    // use its formatter method
-    while (shouldContinue && (covered_facts < total_facts) && (nullptr != (rule = findRule()))) {
+    while (shouldContinue && !deadlineReached() && (covered_facts < total_facts) && (nullptr != (rule = findRule()))) {
         hypothesis.push_back(rule);
         covered_facts += updateKbAndDependencyGraph(*rule);
         rule->releaseMemory();
@@ -129,6 +349,10 @@ void RelationMiner::run() {
         getrusage(RUSAGE_SELF, &usage);
         logger << "Max Mem:" << monitor.formatMemorySize(usage.ru_maxrss) << std::endl;
     }
+    if (deadlineReached()) {
+        timedOut = true;
+        logFormatter.printf("Time budget exhausted (Coverage: %.2f%%, %d/%d)\n", covered_facts * 100.0 / total_facts, covered_facts, total_facts);
+    }
     logger << "Done" << std::endl;
 }
 
@@ -148,15 +372,30 @@ std::vector<Rule*>& RelationMiner::getHypothesis() const {
 
 Rule* RelationMiner::findRule() {
     /* Create the beams */
-    Rule** beams = new Rule*[beamwidth]{};
-    beams[0] = getStartRule();
+    std::vector<Rule*> beams;
+    beams.push_back(getStartRule());
+    TopKRules top_candidates(candidateCapacity());
     Rule* best_local_optimum = nullptr;
+    double best_local_optimum_score = -std::numeric_limits<double>::infinity();
 
     /* Find a local optimum (there is certainly a local optimum in the search routine) */
     while (true) {
         /* Find the candidates in the next round according to current beams */
-        Rule** top_candidates = new Rule*[beamwidth]{};
-        for (int i = 0; i < beamwidth && nullptr != beams[i] && maxMemKByte >= getMaxRss(); i++) {
+        uint64_t const time_iteration_start = currentTimeInNano();
+        top_candidates.reset(candidateCapacity());
+        for (int i = 0; i < beams.size() && nullptr != beams[i]; i++) {
+            MemoryAccountant::Level const memory_level = memoryAccountant->check();
+            if (MemoryAccountant::Hard == memory_level || deadlineReached()) {
+                break;
+            }
+            if (MemoryAccountant::Soft == memory_level && 0 < i) {
+                /* Back-pressure: extend fewer beams in this round */
+                logFormatter.printf(
+                    "Memory pressure (%zu/%zu KB): skip %d beams\n", memoryAccountant->getUsageKb(),
+                    memoryAccountant->getSoftBudgetKb(), (int) beams.size() - i
+                );
+                break;
+            }
             Rule* const r = beams[i];
             selectAsBeam(r);
             logFormatter.printf("Extend: %s\n", r->toString(kb.getRelationNames()).c_str());
@@ -168,29 +407,39 @@ Rule* RelationMiner::findRule() {
             if (0 == specializations_cnt && 0 == generalizations_cnt) {
                 /* If no better specialized and generalized rules, 'r' is a local optimum */
                 /* Keep track of only the best local optimum */
-                if (nullptr == best_local_optimum ||
-                        best_local_optimum->getEval().value(evalMetric) < r->getEval().value(evalMetric)) {
+                double const score = r->getEval().value(evalMetric);
+                if (nullptr == best_local_optimum || best_local_optimum_score < score) {
                     best_local_optimum = r;
+                    best_local_optimum_score = score;
                 }
             }
         }
-        if (!shouldContinue || (maxMemKByte < getMaxRss())) {
+        std::vector<Rule*> candidates = top_candidates.ranked();
+        verifyCandidates(candidates);
+        Rule* const best_candidate = candidates.empty() ? nullptr : candidates[0];
+        double const best_candidate_score = candidates.empty() ?
+            -std::numeric_limits<double>::infinity() : best_candidate->getEval().value(evalMetric);
+        if (!shouldContinue || deadlineReached() || (MemoryAccountant::Hard == memoryAccountant->sample())) {
             /* Stop the finding procedure at the current stage and return the best rule */
-            Rule* best_rule = beams[0];
-            for (int i = 1; i < beamwidth && nullptr != beams[i]; i++) {
-                if (best_rule->getEval().value(evalMetric) < beams[i]->getEval().value(evalMetric)) {
-                    delete best_rule;
-                    best_rule = beams[i];
-                } else {
-                    delete beams[i];
+            Rule* best_rule = nullptr;
+            double best_score = -std::numeric_limits<double>::infinity();
+            for (Rule* const& r: beams) {
+                if (nullptr != r && (nullptr == best_rule || best_score < r->getEval().value(evalMetric))) {
+                    best_rule = r;
+                    best_score = r->getEval().value(evalMetric);
                 }
             }
-            for (int i = 0; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                if (best_rule->getEval().value(evalMetric) < top_candidates[i]->getEval().value(evalMetric)) {
-                    delete best_rule;
-                    best_rule = top_candidates[i];
-                } else {
-                    delete top_candidates[i];
+            if (nullptr != best_candidate && (nullptr == best_rule || best_score < best_candidate_score)) {
+                best_rule = best_candidate;
+            }
+            for (Rule* const& r: beams) {
+                if (best_rule != r) {
+                    delete r;
+                }
+            }
+            for (Rule* const& r: candidates) {
+                if (best_rule != r) {
+                    delete r;
                 }
             }
             if (nullptr != best_rule) {
@@ -202,34 +451,20 @@ Rule* RelationMiner::findRule() {
             return best_rule;
         }
 
-        /* Find the best candidate */
-        Rule* best_candidate = nullptr;
-        if (nullptr != top_candidates[0]) {
-            best_candidate = top_candidates[0];
-            for (int i = 1; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                if (best_candidate->getEval().value(evalMetric) < top_candidates[i]->getEval().value(evalMetric)) {
-                    best_candidate = top_candidates[i];
-                }
-            }
-        }
-
         /* If there is a local optimum and it is the best among all, return the rule */
         if (nullptr != best_local_optimum &&
-                (nullptr == best_candidate ||
-                        best_local_optimum->getEval().value(evalMetric) > best_candidate->getEval().value(evalMetric))
+                (nullptr == best_candidate || best_local_optimum_score > best_candidate_score)
         ) {
             /* If the best is not useful, return NULL */
             Rule* const ret = best_local_optimum->getEval().useful() ? best_local_optimum : nullptr;
-            for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
-                if (ret != beams[i]) {
-                    delete beams[i];
+            for (Rule* const& r: beams) {
+                if (ret != r) {
+                    delete r;
                 }
             }
-            delete[] beams;
-            for (int i = 0; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                delete top_candidates[i];
+            for (Rule* const& r: candidates) {
+                delete r;
             }
-            delete[] top_candidates;
             return ret;
         }
 
@@ -239,69 +474,108 @@ Rule* RelationMiner::findRule() {
         const Eval& best_eval = best_candidate->getEval();
         if (stopCompressionRatio <= best_eval.value(EvalMetric::Value::CompressionRatio) || 0 == best_eval.getNegEtls()) {
             Rule* const ret = best_eval.useful() ? best_candidate : nullptr;
-            for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
-                delete beams[i];
+            for (Rule* const& r: beams) {
+                delete r;
             }
-            delete[] beams;
-            for (int i = 0; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                if (ret != top_candidates[i]) {
-                    delete top_candidates[i];
+            for (Rule* const& r: candidates) {
+                if (ret != r) {
+                    delete r;
                 }
             }
-            delete[] top_candidates;
             return ret;
         }
 
         /* Update the beams */
-        for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
-            delete beams[i];
+        for (Rule* const& r: beams) {
+            delete r;
         }
-        delete[] beams;
         best_local_optimum = nullptr;
-        beams = top_candidates;
+        if (adaptiveBeam.adaptive()) {
+            AdaptiveBeamwidth::Pressure pressure{0, 0, NANO_TO_MILL(currentTimeInNano() - time_iteration_start)};
+            measureBeamPressure(candidates, pressure);
+            int const old_width = adaptiveBeam.width();
+            std::string reason;
+            if (adaptiveBeam.adjust(pressure, reason)) {
+                beamwidthChanges++;
+                logFormatter.printf("Beamwidth: %d -> %d (%s)\n", old_width, adaptiveBeam.width(), reason.c_str());
+
+                /* Drop the lowest candidates beyond the narrowed beam */
+                while (candidates.size() > adaptiveBeam.width()) {
+                    delete candidates.back();
+                    candidates.pop_back();
+                }
+            }
+        }
+        beams = candidates;
     }
 }
 
-int RelationMiner::findSpecializations(Rule& rule, Rule** const candidates) {
-    int added_candidate_cnt = 0;
+int RelationMiner::findSpecializations(Rule& rule, TopKRules& candidates) {
+    std::vector<RuleOperation> operations;
 
-    /* Find all empty arguments */
+    /* Find all empty arguments, the columns of the LVs, and a location of each LV */
     std::vector<ArgLocation> empty_args;
+    std::vector<std::vector<std::pair<int, int>>> var_columns(rule.usedLimitedVars());  // (relation ID, column)
+    std::vector<std::pair<int, int>> var_locations(rule.usedLimitedVars());   // (predicate index, argument index)
     for (int pred_idx = HEAD_PRED_IDX; pred_idx < rule.numPredicates(); pred_idx++) {
         const Predicate& predicate = rule.getPredicate(pred_idx);
         for (int arg_idx = 0; arg_idx < predicate.getArity(); arg_idx++) {
-            if (ARG_IS_EMPTY(predicate.getArg(arg_idx))) {
+            int const argument = predicate.getArg(arg_idx);
+            if (ARG_IS_EMPTY(argument)) {
                 empty_args.emplace_back(pred_idx, arg_idx);
+            } else if (ARG_IS_VARIABLE(argument)) {
+                var_columns[ARG_DECODE(argument)].emplace_back(predicate.getPredSymbol(), arg_idx);
+                var_locations[ARG_DECODE(argument)] = std::pair<int, int>(pred_idx, arg_idx);
             }
         }
     }
 
+    /* A join is skipped if the two columns share no constant, as the specialized rule entails nothing */
+    auto var_feasible = [&](int const varId, int const relId, int const col) {
+        for (std::pair<int, int> const& column: var_columns[varId]) {
+            if (!kb.columnsOverlap(column.first, column.second, relId, col)) {
+                infeasibleJoins++;
+                return false;
+            }
+        }
+        return true;
+    };
+    auto args_feasible = [&](ArgLocation const& arg1, int const relId2, int const col2) {
+        if (!kb.columnsOverlap(rule.getPredicate(arg1.predIdx).getPredSymbol(), arg1.argIdx, relId2, col2)) {
+            infeasibleJoins++;
+            return false;
+        }
+        return true;
+    };
+
     /* Add existing LVs (case 1 and 2) */
     std::vector<SimpleRelation*>* const relations = kb.getRelations();
+    std::vector<std::pair<int, int>> join_columns;
+    std::vector<std::pair<int, int>> screened_columns;
     for (int var_id = 0; var_id < rule.usedLimitedVars(); var_id++) {
         /* Case 1 */
         for (ArgLocation const& vacant: empty_args) {
-            Rule* const new_rule = rule.clone();
-            UpdateStatus const update_status = new_rule->specializeCase1(vacant.predIdx, vacant.argIdx, var_id);
-            added_candidate_cnt += checkThenAddRule(update_status, new_rule, rule, candidates);
-            if (maxMemKByte < getMaxRss()) {
-                return added_candidate_cnt;
+            if (var_feasible(var_id, rule.getPredicate(vacant.predIdx).getPredSymbol(), vacant.argIdx)) {
+                operations.emplace_back(RuleOperation::Case1, vacant.predIdx, vacant.argIdx, var_id);
             }
         }
 
         /* Case 2 */
+        join_columns.clear();
         for (SimpleRelation* const& relation: *relations) {
             for (int arg_idx = 0; arg_idx < relation->getTotalCols(); arg_idx++) {
-                Rule* const new_rule = rule.clone();
-                UpdateStatus const update_status = new_rule->specializeCase2(
-                        relation->id, relation->getTotalCols(), arg_idx, var_id
-                );
-                added_candidate_cnt += checkThenAddRule(update_status, new_rule, rule, candidates);
-                if (maxMemKByte < getMaxRss()) {
-                    return added_candidate_cnt;
+                if (var_feasible(var_id, relation->id, arg_idx)) {
+                    join_columns.emplace_back(relation->id, arg_idx);
                 }
             }
         }
+        std::pair<int, int> const& var_loc = var_locations[var_id];
+        screenJoinColumns(rule, ArgLocation(var_loc.first, var_loc.second), join_columns, candidates, screened_columns);
+        for (std::pair<int, int> const& column: screened_columns) {
+            operations.emplace_back(
+                RuleOperation::Case2, column.first, kb.getRelation(column.first)->getTotalCols(), column.second, var_id
+            );
+        }
     }
 
     /* Case 3, 4, and 5 */
@@ -312,68 +586,336 @@ int RelationMiner::findSpecializations(Rule& rule, Rule** const candidates) {
 
         /* Case 5 */
         std::vector<int>* const_list = kb.getPromisingConstants(predicate1.getPredSymbol())[empty_arg_loc_1.argIdx];
-        for (int const& constant: *const_list) {
-            Rule* const new_rule = rule.clone();
-            UpdateStatus const update_status = new_rule->specializeCase5(
-                    empty_arg_loc_1.predIdx, empty_arg_loc_1.argIdx, constant
-            );
-            added_candidate_cnt += checkThenAddRule(update_status, new_rule, rule, candidates);
-            if (maxMemKByte < getMaxRss()) {
-                return added_candidate_cnt;
-            }
+        std::vector<int> constants;
+        screenCase5Constants(rule, empty_arg_loc_1, *const_list, candidates, constants);
+        for (int const& constant: constants) {
+            operations.emplace_back(RuleOperation::Case5, empty_arg_loc_1.predIdx, empty_arg_loc_1.argIdx, constant);
         }
 
         /* Case 3 */
         for (int j = i + 1; j < empty_args.size(); j++) {
             /* Find another empty argument */
             ArgLocation const& empty_arg_loc_2 = empty_args[j];
-            Rule* const new_rule = rule.clone();
-            UpdateStatus update_status = new_rule->specializeCase3(
-                    empty_arg_loc_1.predIdx, empty_arg_loc_1.argIdx, empty_arg_loc_2.predIdx, empty_arg_loc_2.argIdx
-            );
-            added_candidate_cnt += checkThenAddRule(update_status, new_rule, rule, candidates);
-            if (maxMemKByte < getMaxRss()) {
-                return added_candidate_cnt;
+            if (args_feasible(empty_arg_loc_1, rule.getPredicate(empty_arg_loc_2.predIdx).getPredSymbol(), empty_arg_loc_2.argIdx)) {
+                operations.emplace_back(
+                    RuleOperation::Case3, empty_arg_loc_1.predIdx, empty_arg_loc_1.argIdx, empty_arg_loc_2.predIdx,
+                    empty_arg_loc_2.argIdx
+                );
             }
         }
 
         /* Case 4 */
+        join_columns.clear();
         for (SimpleRelation* const& relation: *relations) {
             for (int arg_idx = 0; arg_idx < relation->getTotalCols(); arg_idx++) {
-                Rule* const new_rule = rule.clone();
-                UpdateStatus const update_status = new_rule->specializeCase4(
-                        relation->id, relation->getTotalCols(), arg_idx, empty_arg_loc_1.predIdx, empty_arg_loc_1.argIdx
-                );
-                added_candidate_cnt += checkThenAddRule(update_status, new_rule, rule, candidates);
-                if (maxMemKByte < getMaxRss()) {
-                    return added_candidate_cnt;
+                if (args_feasible(empty_arg_loc_1, relation->id, arg_idx)) {
+                    join_columns.emplace_back(relation->id, arg_idx);
                 }
             }
         }
+        screenJoinColumns(rule, empty_arg_loc_1, join_columns, candidates, screened_columns);
+        for (std::pair<int, int> const& column: screened_columns) {
+            operations.emplace_back(
+                RuleOperation::Case4, column.first, kb.getRelation(column.first)->getTotalCols(), column.second,
+                empty_arg_loc_1.predIdx, empty_arg_loc_1.argIdx
+            );
+        }
     }
-    return added_candidate_cnt;
+    return evaluateOperations(rule, operations, candidates);
 }
 
-int RelationMiner::findGeneralizations(Rule& rule, Rule** const candidates) {
-    int added_candidate_cnt = 0;
+void RelationMiner::screenCase5Constants(
+    Rule&, ArgLocation const&, std::vector<int> const& constants, TopKRules const&, std::vector<int>& survivors
+) {
+    survivors = constants;
+}
+
+void RelationMiner::screenJoinColumns(
+    Rule&, ArgLocation const&, std::vector<std::pair<int, int>> const& columns, TopKRules const&,
+    std::vector<std::pair<int, int>>& survivors
+) {
+    survivors = columns;
+}
+
+int RelationMiner::findGeneralizations(Rule& rule, TopKRules& candidates) {
+    std::vector<RuleOperation> operations;
     for (int pred_idx = HEAD_PRED_IDX; pred_idx < rule.numPredicates(); pred_idx++) {
         /* Independent fragment may appear in a generalized rule, but this will be found by checking rule validness */
         Predicate const& predicate = rule.getPredicate(pred_idx);
         for (int arg_idx = 0; arg_idx < predicate.getArity(); arg_idx++) {
             if (ARG_IS_NON_EMPTY(predicate.getArg(arg_idx))) {
-                Rule* const new_rule = rule.clone();
-                UpdateStatus const update_status = new_rule->generalize(pred_idx, arg_idx);
-                added_candidate_cnt += checkThenAddRule(update_status, new_rule, rule, candidates);
-                if (maxMemKByte < getMaxRss()) {
-                    return added_candidate_cnt;
+                operations.emplace_back(RuleOperation::Generalization, pred_idx, arg_idx);
+            }
+        }
+    }
+    return evaluateOperations(rule, operations, candidates);
+}
+
+RelationMiner::RuleOperation::RuleOperation(Type const _type, int const arg0, int const arg1, int const arg2, int const arg3, int const arg4) :
+    type(_type), args{arg0, arg1, arg2, arg3, arg4} {}
+
+sinc::UpdateStatus RelationMiner::applyOperation(Rule& rule, RuleOperation const& operation) const {
+    int const* const args = operation.args;
+    switch (operation.type) {
+        case RuleOperation::Case1:
+            return rule.specializeCase1(args[0], args[1], args[2]);
+        case RuleOperation::Case2:
+            return rule.specializeCase2(args[0], args[1], args[2], args[3]);
+        case RuleOperation::Case3:
+            return rule.specializeCase3(args[0], args[1], args[2], args[3]);
+        case RuleOperation::Case4:
+            return rule.specializeCase4(args[0], args[1], args[2], args[3], args[4]);
+        case RuleOperation::Case5:
+            return rule.specializeCase5(args[0], args[1], args[2]);
+        case RuleOperation::Generalization:
+            return rule.generalize(args[0], args[1]);
+        default:
+            std::ostringstream os;
+            os << "Unknown Rule Operation: " << operation.type;
+            throw SincException(os.str());
+    }
+}
+
+/**
+ * Take at most `maxThreads` threads from the spare ones.
+ *
+ * @return The number of borrowed threads
+ */
+static int borrowSpareThreads(std::atomic<int>* const spareThreads, int const maxThreads) {
+    if (nullptr == spareThreads || 0 >= maxThreads) {
+        return 0;
+    }
+    int available = spareThreads->load();
+    int borrowed;
+    do {
+        borrowed = std::min(available, maxThreads);
+        if (0 >= borrowed) {
+            return 0;
+        }
+    } while (!spareThreads->compare_exchange_weak(available, available - borrowed));
+    return borrowed;
+}
+
+int RelationMiner::evaluateOperations(Rule& rule, std::vector<RuleOperation> const& operations, TopKRules& candidates) {
+    int added_candidate_cnt = 0;
+    int const total_operations = operations.size();
+    int const borrowed_threads = borrowSpareThreads(spareThreads, total_operations - evaluationThreads);
+    int const total_threads = evaluationThreads + borrowed_threads;
+
+    /* A specialization is skipped if even its optimistic score cannot beat the lowest candidate. Such a rule would be
+       rejected by `checkThenAddRule()` anyway, and its parent cannot be the returned local optimum, as all candidates are
+       better than the parent */
+    double const optimistic_spec_score = rule.getEval().optimisticSpecializationScore(evalMetric);
+    auto bound_pruned = [&](RuleOperation const& operation) {
+        return RuleOperation::Generalization != operation.type && optimistic_spec_score <= candidates.threshold();
+    };
+    if (1 >= total_threads || 1 >= total_operations) {
+        for (RuleOperation const& operation: operations) {
+            if (bound_pruned(operation)) {
+                boundPrunedRules++;
+                continue;
+            }
+            Rule* const new_rule = rule.clone();
+            new_rule->setEvalCutoff(evalMetric, admissionScore(rule, candidates));
+            new_rule->setEvalSampling(evalSampleRatio, evalSampleConfidence);
+            new_rule->setEvalThreads(total_threads);
+            UpdateStatus const update_status = applyOperation(*new_rule, operation);
+            added_candidate_cnt += checkThenAddRule(update_status, new_rule, rule, candidates);
+            if (miningInterrupted()) {
+                return added_candidate_cnt;
+            }
+        }
+        return added_candidate_cnt;
+    }
+
+    /* Evaluate the updated rules concurrently. The rules are checked in the order of the operations, so the candidate list
+       is the same as the one produced sequentially, unless duplicated rules are produced by different operations (the one
+       that wins the fingerprint cache is kept). The cutoff score passed to an updated rule never exceeds the admission
+       score at the time it is checked, so abandoned evaluations do not change the result either */
+    std::vector<Rule*> updated_rules(total_operations, nullptr);
+    std::vector<UpdateStatus> update_statuses(total_operations, UpdateStatus::Normal);
+    std::vector<bool> finished(total_operations, false);
+    std::atomic<int> next_operation(0);
+    std::atomic<bool> interrupted(false);
+    int next_check = 0;
+    std::vector<std::thread> workers;
+    int const num_workers = std::min(total_threads, total_operations);
+    /* The threads that are not taken by the workers are shared among the evaluations, so nothing fans out beyond the
+       total number of threads */
+    int const threads_per_rule = total_threads / num_workers;
+    workers.reserve(num_workers);
+    for (int t = 0; t < num_workers; t++) {
+        workers.emplace_back([&]() {
+            while (!interrupted) {
+                int const idx = next_operation++;
+                if (idx >= total_operations) {
+                    break;
+                }
+                bool pruned;
+                double cutoff;
+                {
+                    std::lock_guard<std::recursive_mutex> lock(candidateMutex);
+                    pruned = bound_pruned(operations[idx]);
+                    boundPrunedRules += pruned ? 1 : 0;
+                    cutoff = admissionScore(rule, candidates);
+                }
+                Rule* new_rule = nullptr;
+                UpdateStatus update_status = UpdateStatus::Normal;
+                if (!pruned) {
+                    new_rule = rule.clone();
+                    new_rule->setEvalCutoff(evalMetric, cutoff);
+                    new_rule->setEvalSampling(evalSampleRatio, evalSampleConfidence);
+                    new_rule->setEvalThreads(threads_per_rule);
+                    update_status = applyOperation(*new_rule, operations[idx]);
+                }
+                if (miningInterrupted()) {
+                    interrupted = true;
+                }
+
+                /* Check all finished rules in order */
+                std::lock_guard<std::recursive_mutex> lock(candidateMutex);
+                updated_rules[idx] = new_rule;
+                update_statuses[idx] = update_status;
+                finished[idx] = true;
+                while (next_check < total_operations && finished[next_check]) {
+                    if (nullptr != updated_rules[next_check]) {
+                        added_candidate_cnt += checkThenAddRule(
+                            update_statuses[next_check], updated_rules[next_check], rule, candidates
+                        );
+                    }
+                    next_check++;
                 }
             }
+        });
+    }
+    for (std::thread& worker: workers) {
+        worker.join();
+    }
+    if (0 < borrowed_threads) {
+        *spareThreads += borrowed_threads;
+    }
+
+    /* Some operations may be skipped if mining is interrupted. Check the remaining finished rules */
+    for (; next_check < total_operations; next_check++) {
+        if (finished[next_check] && nullptr != updated_rules[next_check]) {
+            added_candidate_cnt += checkThenAddRule(update_statuses[next_check], updated_rules[next_check], rule, candidates);
         }
     }
     return added_candidate_cnt;
 }
 
-int RelationMiner::checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates) {
+void RelationMiner::setEvaluationThreads(int const threads) {
+    evaluationThreads = std::max(threads, 1);
+}
+
+void RelationMiner::setSpareThreads(std::atomic<int>* const _spareThreads) {
+    spareThreads = _spareThreads;
+}
+
+void RelationMiner::setMemoryAccountant(MemoryAccountant* const accountant) {
+    for (int const& id: memorySourceIds) {
+        memoryAccountant->removeSource(id);
+    }
+    memorySourceIds.clear();
+    memoryAccountant = accountant;
+    addMemorySources(*memoryAccountant, memorySourceIds);
+}
+
+void RelationMiner::setAdaptiveBeamwidth(AdaptiveBeamwidth const& controller) {
+    adaptiveBeam = controller;
+}
+
+void RelationMiner::addMemorySources(MemoryAccountant&, std::vector<int>&) {}
+
+void RelationMiner::measureBeamPressure(std::vector<Rule*> const&, AdaptiveBeamwidth::Pressure&) {}
+
+bool RelationMiner::memoryExhausted() {
+    return MemoryAccountant::Hard == memoryAccountant->check();
+}
+
+void RelationMiner::setDeadline(uint64_t const deadlineNano) {
+    deadline = deadlineNano;
+}
+
+const int RelationMiner::SAMPLED_CANDIDATE_FACTOR = 2;
+
+void RelationMiner::setEvalSampling(double const ratio, double const confidence) {
+    evalSampleRatio = ratio;
+    evalSampleConfidence = confidence;
+}
+
+int RelationMiner::candidateCapacity() const {
+    return (1.0 > evalSampleRatio) ? adaptiveBeam.width() * SAMPLED_CANDIDATE_FACTOR : adaptiveBeam.width();
+}
+
+void RelationMiner::verifyCandidates(std::vector<Rule*>& candidates) {
+    int const width = std::min((int) candidates.size(), adaptiveBeam.width());
+    bool sampled = false;
+    for (Rule* const& r: candidates) {
+        sampled = sampled || r->isEvalSampled();
+    }
+    if (sampled) {
+        auto verify = [this](Rule* const r) {
+            if (r->isEvalSampled()) {
+                uint64_t const eval_time = r->getEvalTime();
+                r->verifyEval();
+                evalTime += r->getEvalTime() - eval_time;
+                verifiedEvaluations++;
+            }
+        };
+
+        /* Verify the uncertain candidates beyond the beamwidth */
+        std::vector<Rule*> const sampled_ranking(candidates.begin(), candidates.begin() + width);
+        double min_lower_bound = std::numeric_limits<double>::infinity();
+        for (Rule* const& r: sampled_ranking) {
+            min_lower_bound = std::min(min_lower_bound, r->getEvalLowerBound(evalMetric));
+        }
+        for (int i = width; i < candidates.size(); i++) {
+            if (candidates[i]->getEvalUpperBound(evalMetric) >= min_lower_bound) {
+                verify(candidates[i]);
+            }
+        }
+
+        /* Verify the candidates within the beamwidth until all of them are exact */
+        bool all_exact = false;
+        while (!all_exact) {
+            all_exact = true;
+            for (int i = 0; i < width; i++) {
+                all_exact = all_exact && !candidates[i]->isEvalSampled();
+                verify(candidates[i]);
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [this](Rule* const a, Rule* const b) {
+                return a->getEval().value(evalMetric) > b->getEval().value(evalMetric);
+            });
+        }
+        sampledRankings++;
+        if (!std::equal(sampled_ranking.begin(), sampled_ranking.end(), candidates.begin())) {
+            rankingDisagreements++;
+            logFormatter.printf("Sampled ranking differs from the exact one\n");
+        }
+    }
+    while (candidates.size() > width) {
+        delete candidates.back();
+        candidates.pop_back();
+    }
+}
+
+bool RelationMiner::deadlineReached() const {
+    uint64_t const d = deadline;
+    return 0 != d && currentTimeInNano() >= d;
+}
+
+bool RelationMiner::miningInterrupted() {
+    return !shouldContinue || deadlineReached() || memoryExhausted();
+}
+
+double RelationMiner::admissionScore(Rule const& originalRule, TopKRules const& candidates) const {
+    /* The threshold is -inf if the candidate list is not full */
+    return std::max(candidates.threshold(), originalRule.getEval().value(evalMetric));
+}
+
+int RelationMiner::checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates) {
+    std::lock_guard<std::recursive_mutex> lock(candidateMutex);
     fingerprintCreationTime += updatedRule->getFingerprintCreationTime();
     pruningTime += updatedRule->getPruningTime();
 
@@ -386,28 +928,12 @@ int RelationMiner::checkThenAddRule(UpdateStatus updateStatus, Rule* const updat
             #endif
             evalTime += updatedRule->getEvalTime();
             evaluatedSqls += 2;
+            sampledEvaluations += updatedRule->isEvalSampled() ? 1 : 0;
             if (updatedRule->getEval().value(evalMetric) > originalRule.getEval().value(evalMetric)) {
                 updated_is_better = true;
-                int replace_idx = -1;
-                double replaced_score = updatedRule->getEval().value(evalMetric);
-                for (int i = 0; i < beamwidth; i++) {
-                    if (nullptr == candidates[i]) {
-                        replace_idx = i;
-                        break;
-                    }
-                    double candidate_socre = candidates[i]->getEval().value(evalMetric);
-                    if (replaced_score > candidate_socre) {
-                        replace_idx = i;
-                        replaced_score = candidate_socre;
-                    }
-                }
-                if (0 <= replace_idx) {
-                    if (nullptr != candidates[replace_idx]) {
-                        delete candidates[replace_idx];
-                    }
-                    candidates[replace_idx] = updatedRule;
-                } else {
-                    delete updatedRule;
+                Rule* const dropped = candidates.add(updatedRule, updatedRule->getEval().value(evalMetric));
+                if (nullptr != dropped) {
+                    delete dropped;
                 }
             // } else {
             //     delete updatedRule;
@@ -499,6 +1025,265 @@ int RelationMiner::updateKbAndDependencyGraph(Rule& rule) {
     return num_entailed;
 }
 
+/**
+ * CompressionJournal
+ */
+using sinc::CompressionJournal;
+
+CompressionJournal::CompressionJournal(fs::path const& _filePath, SimpleKb& _kb) : filePath(_filePath), kb(_kb) {}
+
+CompressionJournal::~CompressionJournal() {
+    if (nullptr != writer) {
+        writer->close();
+        delete writer;
+    }
+}
+
+bool CompressionJournal::restore(SimpleCompressedKb& compressedKb, MinerWorkspace& workspace, std::vector<int>& completedRelations) {
+    if (!fs::exists(filePath)) {
+        return false;
+    }
+    size_t const total_ints = fs::file_size(filePath) / sizeof(int);
+    std::vector<int> ints;
+    ints.reserve(total_ints);
+    IntReader reader(filePath.c_str());
+    for (size_t i = 0; i < total_ints; i++) {
+        ints.push_back(reader.next());
+    }
+    reader.close();
+    if (4 > total_ints || MAGIC != ints[0] || VERSION != ints[1] || kb.totalRelations() != ints[2] || kb.totalRecords() != ints[3]) {
+        return false;
+    }
+
+    /* Restore records until a truncated or corrupted one */
+    size_t offset = 4;
+    while (offset + 3 <= total_ints && RECORD_MAGIC == ints[offset]) {
+        int const relation_id = ints[offset + 1];
+        int const payload_length = ints[offset + 2];
+        size_t const payload_begin = offset + 3;
+        if (0 > payload_length || payload_begin + payload_length + 1 > total_ints) {
+            break;
+        }
+        size_t const payload_end = payload_begin + payload_length;
+        if (checksum(ints, payload_begin, payload_end) != ints[payload_end]) {
+            break;
+        }
+        if (0 > relation_id || kb.totalRelations() <= relation_id) {
+            throw SincException("Checkpoint record of an unknown relation: " + std::to_string(relation_id));
+        }
+        restoreRecord(relation_id, ints, payload_begin, payload_end, compressedKb, workspace);
+        completedRelations.push_back(relation_id);
+        records++;
+        offset = payload_end + 1;
+    }
+    if (offset * sizeof(int) != fs::file_size(filePath)) {
+        fs::resize_file(filePath, offset * sizeof(int));
+    }
+    return true;
+}
+
+void CompressionJournal::restoreRecord(
+    int const relationId, std::vector<int> const& ints, size_t const begin, size_t const end, SimpleCompressedKb& compressedKb,
+    MinerWorkspace& workspace
+) {
+    size_t pos = begin;
+    auto next = [&]() {
+        if (pos >= end) {
+            throw SincException("Malformed checkpoint record of relation: " + std::to_string(relationId));
+        }
+        return ints[pos++];
+    };
+    auto next_double = [&]() {
+        uint64_t bits = (uint32_t) next();
+        bits |= ((uint64_t) (uint32_t) next()) << 32;
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    };
+    auto next_node = [&]() {
+        int const functor = next();
+        int const arity = next();
+        if (0 > functor) {
+            return (RelationMiner::nodeType*) &RelationMiner::AxiomNode;
+        }
+        Predicate* predicate = new Predicate(functor, arity);
+        for (int arg_idx = 0; arg_idx < arity; arg_idx++) {
+            predicate->setArg(arg_idx, next());
+        }
+        std::pair<RelationMiner::nodeMapType::iterator, bool> ret = workspace.predicate2NodeMap.emplace(predicate, nullptr);
+        if (ret.second) {
+            ret.first->second = new RelationMiner::nodeType(predicate);
+        } else {
+            delete predicate;
+        }
+        return ret.first->second;
+    };
+
+    /* Rules */
+    int const num_rules = next();
+    for (int i = 0; i < num_rules; i++) {
+        int const num_predicates = next();
+        std::vector<Predicate> structure;
+        structure.reserve(num_predicates);
+        for (int pred_idx = 0; pred_idx < num_predicates; pred_idx++) {
+            int const functor = next();
+            int const arity = next();
+            structure.emplace_back(functor, arity);
+            for (int arg_idx = 0; arg_idx < arity; arg_idx++) {
+                structure.back().setArg(arg_idx, next());
+            }
+        }
+        double const pos_etls = next_double();
+        double const all_etls = next_double();
+        int const rule_length = next();
+        workspace.hypothesis.push_back(new BareRule(structure, Eval(pos_etls, all_etls, rule_length), fingerprintCache, tabuMap));
+    }
+
+    /* Counterexamples */
+    SimpleRelation* const relation = kb.getRelation(relationId);
+    int const arity = relation->getTotalCols();
+    int const num_counterexamples = next();
+    std::unordered_set<Record> counterexamples;
+    for (int i = 0; i < num_counterexamples; i++) {
+        int* const args = new int[arity];
+        for (int arg_idx = 0; arg_idx < arity; arg_idx++) {
+            args[arg_idx] = next();
+        }
+        counterexamples.emplace(args, arity);
+    }
+    compressedKb.addCounterexamples(relationId, counterexamples);
+
+    /* Entailment flags */
+    int const flag_length = next();
+    if (relation->getFlagLength() != flag_length || pos + flag_length > end) {
+        throw SincException("Entailment flags in the checkpoint do not match relation: " + std::string(relation->name));
+    }
+    relation->setEntailmentFlags(ints.data() + pos);
+    pos += flag_length;
+
+    /* Dependency edges */
+    int const num_heads = next();
+    for (int i = 0; i < num_heads; i++) {
+        RelationMiner::nodeType* const head_node = next_node();
+        RelationMiner::depGraphType::iterator itr = workspace.dependencyGraph.find(head_node);
+        std::unordered_set<RelationMiner::nodeType*>* dependencies;
+        if (workspace.dependencyGraph.end() == itr) {
+            dependencies = new std::unordered_set<RelationMiner::nodeType*>();
+            workspace.dependencyGraph.emplace(head_node, dependencies);
+        } else {
+            dependencies = itr->second;
+        }
+        int const num_dependencies = next();
+        for (int j = 0; j < num_dependencies; j++) {
+            dependencies->insert(next_node());
+        }
+    }
+    if (pos != end) {
+        throw SincException("Malformed checkpoint record of relation: " + std::to_string(relationId));
+    }
+}
+
+void CompressionJournal::open(bool const append) {
+    if (nullptr != writer) {
+        writer->close();
+        delete writer;
+    }
+    writer = new IntWriter(filePath.c_str(), append);
+    if (!append) {
+        writer->write(MAGIC);
+        writer->write(VERSION);
+        writer->write(kb.totalRelations());
+        writer->write(kb.totalRecords());
+        records = 0;
+    }
+    if (!writer->flush()) {
+        throw SincException("Failed to open the checkpoint: " + filePath.string());
+    }
+}
+
+void CompressionJournal::append(int const relationId, MinerWorkspace const& workspace, SimpleCompressedKb& compressedKb) {
+    std::vector<int> buffer({RECORD_MAGIC, relationId, 0});
+
+    /* Rules */
+    buffer.push_back(workspace.hypothesis.size());
+    for (Rule* const& rule: workspace.hypothesis) {
+        buffer.push_back(rule->numPredicates());
+        for (int pred_idx = 0; pred_idx < rule->numPredicates(); pred_idx++) {
+            Predicate const& predicate = rule->getPredicate(pred_idx);
+            encodePredicate(buffer, predicate.getPredSymbol(), predicate.getArity(), predicate.getArgs());
+        }
+        Eval const& eval = rule->getEval();
+        encodeDouble(buffer, eval.getPosEtls());
+        encodeDouble(buffer, eval.getAllEtls());
+        buffer.push_back((int) eval.getRuleLength());
+    }
+
+    /* Counterexamples */
+    std::unordered_set<Record> const& counterexamples = compressedKb.getCounterexampleSet(relationId);
+    buffer.push_back(counterexamples.size());
+    for (Record const& record: counterexamples) {
+        buffer.insert(buffer.end(), record.getArgs(), record.getArgs() + record.getArity());
+    }
+
+    /* Entailment flags of the target relation. Miners do not mark records in other relations */
+    SimpleRelation const* const relation = kb.getRelation(relationId);
+    buffer.push_back(relation->getFlagLength());
+    buffer.insert(buffer.end(), relation->getEntailmentFlags(), relation->getEntailmentFlags() + relation->getFlagLength());
+
+    /* Dependency edges */
+    auto encode_node = [&buffer](RelationMiner::nodeType const* node) {
+        if (&RelationMiner::AxiomNode == node) {
+            encodePredicate(buffer, -1, 0, nullptr);
+        } else {
+            encodePredicate(buffer, node->content->getPredSymbol(), node->content->getArity(), node->content->getArgs());
+        }
+    };
+    buffer.push_back(workspace.dependencyGraph.size());
+    for (std::pair<RelationMiner::nodeType* const, std::unordered_set<RelationMiner::nodeType*>*> const& kv: workspace.dependencyGraph) {
+        encode_node(kv.first);
+        buffer.push_back(kv.second->size());
+        for (RelationMiner::nodeType* const& body_node: *(kv.second)) {
+            encode_node(body_node);
+        }
+    }
+    buffer[2] = buffer.size() - 3;
+    buffer.push_back(checksum(buffer, 3, buffer.size()));
+
+    std::lock_guard<std::mutex> lock(appendMutex);
+    if (nullptr == writer) {
+        throw SincException("The checkpoint has not been opened: " + filePath.string());
+    }
+    for (int const& i: buffer) {
+        writer->write(i);
+    }
+    if (!writer->flush()) {
+        throw SincException("Failed to write the checkpoint: " + filePath.string());
+    }
+    records++;
+}
+
+int CompressionJournal::totalRecords() const {
+    return records;
+}
+
+int CompressionJournal::checksum(std::vector<int> const& ints, size_t const begin, size_t const end) {
+    uint64_t const hash = IntTupleSet::hashTuple(ints.data() + begin, (int) (end - begin));
+    return (int) (hash ^ (hash >> 32));
+}
+
+void CompressionJournal::encodePredicate(std::vector<int>& buffer, int const functor, int const arity, int const* const args) {
+    buffer.push_back(functor);
+    buffer.push_back(arity);
+    buffer.insert(buffer.end(), args, args + arity);
+}
+
+void CompressionJournal::encodeDouble(std::vector<int>& buffer, double const value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    buffer.push_back((int) (uint32_t) bits);
+    buffer.push_back((int) (uint32_t) (bits >> 32));
+}
+
 /**
  * SInC
  */
@@ -517,11 +1302,16 @@ fs::path SInC::getStdErrFilePath(fs::path& dumpPath, const char* dumpName) {
     return dumpPath / dumpName / STD_ERROR_FILE_NAME;
 }
 
+fs::path SInC::getCheckpointFilePath(fs::path& dumpPath, const char* dumpName) {
+    return dumpPath / dumpName / CHECKPOINT_FILE_NAME;
+}
+
 SInC::SInC(SincConfig* const _config) : SInC(_config, nullptr) {}
 
-SInC::SInC(SincConfig* const _config, SimpleKb* const _kb) : 
+SInC::SInC(SincConfig* const _config, SimpleKb* const _kb, bool const _sharedKb) : 
     config(_config),
     kb(_kb),
+    sharedKb(_sharedKb),
     compressedKb(nullptr) 
 {
     /* Create writer objects to log and std output files */
@@ -558,7 +1348,10 @@ SInC::~SInC() {
     if (nullptr != compressedKb) {
         delete compressedKb;
     }
-    if (nullptr != kb) {
+    if (nullptr != journal) {
+        delete journal; // Restored rules refer to the journal
+    }
+    if (nullptr != kb && !sharedKb) {
         delete kb;
     }
     delete config;
@@ -605,8 +1398,11 @@ void SInC::run() {
 void SInC::loadKb() {
     if (nullptr == kb) {
         kb = new SimpleKb(config->kbName, config->basePath);
+    } else if (sharedKb) {
+        kb->clearEntailment();
     }
     kb->updatePromisingConstants();
+    kb->updateColumnOverlaps();
 }
 
 void SInC::getTargetRelations(int* & targetRelationIds, int& numTargets) {
@@ -683,7 +1479,18 @@ void SInC::showConfig() const {
     (*logger) << "Dump Path:\t" << config->dumpPath << '\n';
     (*logger) << "Dump Name:\t" << config->dumpName << '\n';
     (*logger) << "Beamwidth:\t" << config->beamwidth << '\n';
+    if (config->maxBeamwidth > config->beamwidth) {
+        (*logger) << "Adaptive Beamwidth:\t[" << config->minBeamwidth << ", " << config->maxBeamwidth << "] (cache: "
+            << config->beamCacheLimitKb << " KB, eval: " << config->beamEvalMemLimitKb << " KB, time: "
+            << config->beamIterationTimeLimitMs << " ms)\n";
+    }
     (*logger) << "Threads:\t" << config->threads << '\n';
+    if (config->checkpoint || config->resume) {
+        (*logger) << "Checkpoint:\t" << (config->checkpoint ? "on" : "off") << (config->resume ? " (resume)" : "") << '\n';
+    }
+    if (0 != config->relationTimeLimitMs || 0 != config->totalTimeLimitMs) {
+        (*logger) << "Time Limit (ms):\t" << config->relationTimeLimitMs << " per relation, " << config->totalTimeLimitMs << " in total\n";
+    }
     (*logger) << "Eval Metric:\t" << config->evalMetric << '\n';
     (*logger) << "Min Fact Coverage:\t" << config->minFactCoverage << '\n';
     (*logger) << "Min Constant Coverage:\t" << config->minConstantCoverage << '\n';
@@ -725,34 +1532,86 @@ void SInC::compress() {
     monitor.kbFunctors = kb->totalRelations();
     monitor.kbConstants = kb->totalConstants();
     compressedKb = new SimpleCompressedKb(config->dumpName, kb);
+
+    /* Restore the relations in the checkpoint */
+    std::unordered_set<int> completed_relations;
+    try {
+        openJournal(completed_relations);
+    } catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        logError("Checkpoint failed. Abort.");
+        finish();
+        return;
+    }
     uint64_t time_kb_loaded = currentTimeInNano();
     monitor.kbLoadTime = time_kb_loaded - time_start;
 
+    /* Set up the time and memory budgets */
+    globalDeadline = (0 == config->totalTimeLimitMs) ? 0 : time_start + config->totalTimeLimitMs * 1000000;
+    size_t const hard_budget = ((size_t) config->maxMemGByte) * 1024 * 1024;
+    memoryAccountant = new MemoryAccountant(hard_budget * MemoryAccountant::DEFAULT_SOFT_RATIO, hard_budget);
+    registerMemorySources(*memoryAccountant);
+    memoryAccountant->calibrate();
+
     /* Run relation miners on each relation */
-    int* target_relations;
-    int num_targets;
-    RelationMiner* relation_miner;
+    int* target_relations = nullptr;
+    int num_targets = 0;
+    MinerWorkspace* workspaces = nullptr;
+    RelationMiner* relation_miner = nullptr;
+    int current_target = 0;
     try {
         getTargetRelations(target_relations, num_targets);
-        for (int i = 0; i < num_targets; i++) {
-            int relation_num = target_relations[i];
-            relation_miner = createRelationMiner(relation_num);
-            relation_miner->run();  // counterexamples and hypothesis should be added to `compressedKb` in this procedure
-            // compressedKb->addCounterexamples(relation_num, relation_miner->getCounterexamples());
-            // compressedKb->addHypothesisRules(relation_miner.getHypothesis());
-            (*logger) << "Relation mining done (" << i+1 << '/' << num_targets << "): " << kb->getRelation(relation_num)->name << '\n';
-            finalizeRelationMiner(relation_miner);
-            delete relation_miner;
-            relation_miner = nullptr;
+        if (!completed_relations.empty()) {
+            /* Skip the relations restored from the checkpoint */
+            int remaining_targets = 0;
+            for (int i = 0; i < num_targets; i++) {
+                if (completed_relations.end() == completed_relations.find(target_relations[i])) {
+                    target_relations[remaining_targets] = target_relations[i];
+                    remaining_targets++;
+                }
+            }
+            num_targets = remaining_targets;
+        }
+        threadsPerMiner = minerThreads(num_targets);
+        workspaces = new MinerWorkspace[num_targets];
+        if (1 < relationWorkers(num_targets)) {
+            mineConcurrently(target_relations, num_targets, workspaces);
+        } else {
+            for (; current_target < num_targets; current_target++) {
+                int relation_num = target_relations[current_target];
+                uint64_t const time_miner_start = currentTimeInNano();
+                workspaces[current_target].logger = logger;
+                relation_miner = createRelationMiner(relation_num, workspaces[current_target]);
+                prepareRelationMiner(relation_miner, num_targets - current_target, 1);
+                relation_miner->run();  // counterexamples should be added to `compressedKb` in this procedure
+                checkpointRelation(relation_num, workspaces[current_target]);
+                (*logger) << "Relation mining done (" << current_target+1 << '/' << num_targets << "): " << kb->getRelation(relation_num)->name << '\n';
+                monitor.relationSchedules.push_back(BaseMonitor::RelationSchedule{
+                    kb->getRelation(relation_num)->name, estimateMiningCost(relation_num), current_target,
+                    currentTimeInNano() - time_miner_start, relation_miner->timedOut
+                });
+                finalizeRelationMiner(relation_miner);
+                mergeWorkspace(workspaces[current_target]);
+                delete relation_miner;
+                relation_miner = nullptr;
+            }
         }
     } catch (std::exception const& e) {
         logError("Relation Miner failed. Interrupt");
         (*logger) << e.what() << std::endl;
         if (nullptr != relation_miner) {
             relation_miner->discontinue();
+            mergeWorkspace(workspaces[current_target]);
         }
     }
     delete[] target_relations;
+    delete[] workspaces;
+    memoryAccountant->sample();
+    monitor.budgetPeakMemCost = memoryAccountant->getPeakUsageKb();
+    monitor.softBudgetExceeded = memoryAccountant->getSoftExceeded();
+    monitor.relievedMemCost = memoryAccountant->getRelievedKb();
+    delete memoryAccountant;
+    memoryAccountant = nullptr;
     uint64_t time_hypothesis_found = currentTimeInNano();
     monitor.hypothesisMiningTime = time_hypothesis_found - time_kb_loaded;
 
@@ -808,13 +1667,88 @@ void SInC::compress() {
     finish();
 }
 
+void SInC::registerMemorySources(MemoryAccountant&) {}
+
+void SInC::openJournal(std::unordered_set<int>& completedRelations) {
+    if (!config->checkpoint && !config->resume) {
+        return;
+    }
+    fs::path const checkpoint_path = getCheckpointFilePath(config->dumpPath, config->dumpName);
+    journal = new CompressionJournal(checkpoint_path, *kb);
+    bool resumed = false;
+    if (config->resume) {
+        bool const existing = fs::exists(checkpoint_path);
+        MinerWorkspace workspace;
+        workspace.logger = logger;
+        std::vector<int> restored_relations;
+        resumed = journal->restore(*compressedKb, workspace, restored_relations);
+        if (resumed) {
+            for (Rule* const& r: workspace.hypothesis) {
+                monitor.hypothesisSize += r->getLength();
+            }
+            monitor.hypothesisRuleNumber += workspace.hypothesis.size();
+            monitor.resumedRelations = restored_relations.size();
+            mergeWorkspace(workspace);
+            completedRelations.insert(restored_relations.begin(), restored_relations.end());
+            (*logger) << "Resumed from checkpoint: " << restored_relations.size() << " relations\n";
+        } else if (existing) {
+            /* The file may not be a checkpoint of this KB, so it is not overwritten */
+            logError(
+                "The checkpoint does not match the KB and is left unchanged: " + checkpoint_path.string() +
+                ". Compress from scratch without checkpointing."
+            );
+            delete journal;
+            journal = nullptr;
+            return;
+        } else {
+            logInfo("No checkpoint of the KB is found. Compress from scratch.");
+        }
+    }
+    journal->open(resumed);
+}
+
+void SInC::checkpointRelation(int const relationId, MinerWorkspace const& workspace) {
+    if (nullptr != journal) {
+        journal->append(relationId, workspace, *compressedKb);
+    }
+}
+
+void SInC::prepareRelationMiner(RelationMiner* miner, int const remainingTargets, int const workers) {
+    miner->setMemoryAccountant(memoryAccountant);
+    miner->setAdaptiveBeamwidth(AdaptiveBeamwidth(
+        config->beamwidth, config->minBeamwidth, config->maxBeamwidth, config->beamCacheLimitKb, config->beamEvalMemLimitKb,
+        config->beamIterationTimeLimitMs
+    ));
+    miner->setDeadline(relationDeadline(remainingTargets, workers));
+    miner->setEvalSampling(config->evalSampleRatio, config->evalSampleConfidence);
+}
+
+uint64_t SInC::relationDeadline(int const remainingTargets, int const workers) const {
+    uint64_t const now = currentTimeInNano();
+    uint64_t deadline = (0 == config->relationTimeLimitMs) ? 0 : now + config->relationTimeLimitMs * 1000000;
+    if (0 != globalDeadline) {
+        uint64_t const remaining_time = (globalDeadline > now) ? globalDeadline - now : 0;
+        int const rounds = std::max((remainingTargets + workers - 1) / std::max(workers, 1), 1);
+        uint64_t const fair_deadline = now + remaining_time / rounds;
+        deadline = (0 == deadline) ? fair_deadline : std::min(deadline, fair_deadline);
+    }
+    return deadline;
+}
+
 void SInC::finalizeRelationMiner(RelationMiner* miner) {
-    monitor.hypothesisSize = 0;
     for (Rule* const& r: miner->getHypothesis()) {
         monitor.hypothesisSize += r->getLength();
     }
-    monitor.hypothesisRuleNumber = miner->getHypothesis().size();
+    monitor.hypothesisRuleNumber += miner->getHypothesis().size();
     monitor.evaluatedSqls += miner->evaluatedSqls;
+    monitor.boundPrunedRules += miner->boundPrunedRules;
+    monitor.infeasibleJoins += miner->infeasibleJoins;
+    monitor.beamwidthChanges += miner->beamwidthChanges;
+    monitor.timedOutRelations += miner->timedOut ? 1 : 0;
+    monitor.sampledEvaluations += miner->sampledEvaluations;
+    monitor.verifiedEvaluations += miner->verifiedEvaluations;
+    monitor.sampledRankings += miner->sampledRankings;
+    monitor.rankingDisagreements += miner->rankingDisagreements;
     monitor.fingerprintCreationTime += miner->fingerprintCreationTime;
     monitor.pruningTime += miner->pruningTime;
     monitor.evalTime += miner->evalTime;
@@ -836,3 +1770,183 @@ void SInC::logError(const char* msg) const {
 void SInC::logError(std::string const& msg) const {
     (*logger) << "[ERROR]" << msg << '\n';
 }
+
+int SInC::relationWorkers(int const numTargets) const {
+    return std::max(1, std::min(config->threads, numTargets));
+}
+
+int SInC::minerThreads(int const numTargets) const {
+    return std::max(1, config->threads / relationWorkers(numTargets));
+}
+
+double SInC::estimateMiningCost(int const relationId) const {
+    SimpleRelation* const relation = kb->getRelation(relationId);
+    double column_factor = 0;
+    for (int col = 0; col < relation->getTotalCols(); col++) {
+        column_factor += std::log2(2.0 + relation->numValuesInColumn(col));
+    }
+    return relation->getTotalRows() * column_factor;
+}
+
+std::vector<int> SInC::scheduleRelations(int const* const targetRelations, int const numTargets) const {
+    std::vector<double> costs(numTargets);
+    std::vector<int> schedule(numTargets);
+    for (int i = 0; i < numTargets; i++) {
+        costs[i] = estimateMiningCost(targetRelations[i]);
+        schedule[i] = i;
+    }
+    std::stable_sort(schedule.begin(), schedule.end(), [&costs](int const& a, int const& b) {
+        return costs[a] > costs[b];
+    });
+    return schedule;
+}
+
+void SInC::mineConcurrently(int const* const targetRelations, int const numTargets, MinerWorkspace* const workspaces) {
+    enum MinerState {
+        Pending, Done, Failed, Skipped
+    };
+    std::vector<int> const schedule = scheduleRelations(targetRelations, numTargets);
+    std::vector<RelationMiner*> miners(numTargets, nullptr);
+    std::vector<MinerState> states(numTargets, Pending);
+    std::vector<int> start_orders(numTargets, -1);
+    std::vector<uint64_t> mining_times(numTargets, 0);
+    std::vector<std::string> errors(numTargets);
+    std::mutex state_mutex;
+    std::condition_variable state_changed;
+    std::atomic<int> next_target(0);
+    std::atomic<bool> failed(false);
+    std::atomic<int> spare_threads(0);
+    for (int i = 0; i < numTargets; i++) {
+        workspaces[i].logger = &workspaces[i].logBuffer;
+    }
+
+    /* Each worker takes the next target relation in the schedule until all relations are taken. Then the threads of the
+       worker are lent to the miners that are still running. The results are left in the workspaces */
+    auto worker = [&]() {
+        for (int order = next_target++; order < numTargets; order = next_target++) {
+            int const i = schedule[order];
+            MinerState state = Skipped;
+            if (!failed) {
+                uint64_t const time_start = currentTimeInNano();
+                try {
+                    RelationMiner* miner = createRelationMiner(targetRelations[i], workspaces[i]);
+                    miner->setSpareThreads(&spare_threads);
+                    prepareRelationMiner(miner, numTargets - order, relationWorkers(numTargets));
+                    {
+                        std::lock_guard<std::mutex> lock(state_mutex);
+                        miners[i] = miner;
+                    }
+                    miner->run();   // counterexamples should be added to `compressedKb` in this procedure
+                    checkpointRelation(targetRelations[i], workspaces[i]);
+                    state = Done;
+                } catch (std::exception const& e) {
+                    errors[i] = e.what();
+                    state = Failed;
+                    failed = true;
+                }
+                start_orders[i] = order;
+                mining_times[i] = currentTimeInNano() - time_start;
+            }
+            std::lock_guard<std::mutex> lock(state_mutex);
+            states[i] = state;
+            if (Failed == state) {
+                for (RelationMiner* const& miner: miners) {
+                    if (nullptr != miner) {
+                        miner->discontinue();
+                    }
+                }
+            }
+            state_changed.notify_all();
+        }
+        spare_threads += threadsPerMiner;
+    };
+    int const num_workers = relationWorkers(numTargets);
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+        threads.emplace_back(worker);
+    }
+
+    /* Finalize the miners in the order of the targets */
+    for (int i = 0; i < numTargets; i++) {
+        RelationMiner* miner;
+        MinerState state;
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            state_changed.wait(lock, [&]() { return Pending != states[i]; });
+            miner = miners[i];
+            miners[i] = nullptr;
+            state = states[i];
+        }
+        (*logger) << workspaces[i].logBuffer.str();
+        workspaces[i].logBuffer.str("");
+        switch (state) {
+            case Done:
+                (*logger) << "Relation mining done (" << i+1 << '/' << numTargets << "): " << kb->getRelation(targetRelations[i])->name << '\n';
+                monitor.relationSchedules.push_back(BaseMonitor::RelationSchedule{
+                    kb->getRelation(targetRelations[i])->name, estimateMiningCost(targetRelations[i]), start_orders[i],
+                    mining_times[i], miner->timedOut
+                });
+                finalizeRelationMiner(miner);
+                break;
+            case Failed:
+                logError("Relation Miner failed. Interrupt");
+                (*logger) << errors[i] << std::endl;
+                break;
+            default:
+                break;
+        }
+        if (nullptr != miner) {
+            mergeWorkspace(workspaces[i]);
+            delete miner;
+        }
+    }
+    for (std::thread& t: threads) {
+        t.join();
+    }
+}
+
+void SInC::mergeWorkspace(MinerWorkspace& workspace) {
+    std::vector<Rule*>& hypothesis = compressedKb->getHypothesis();
+    hypothesis.insert(hypothesis.end(), workspace.hypothesis.begin(), workspace.hypothesis.end());
+    workspace.hypothesis.clear();
+
+    /* Merge nodes. Duplicated ones are released after the edges are redirected to the existing nodes */
+    std::vector<std::pair<Predicate*, RelationMiner::nodeType*>> duplicated_nodes;
+    for (std::pair<Predicate* const, RelationMiner::nodeType*> const& kv: workspace.predicate2NodeMap) {
+        if (!predicate2NodeMap.emplace(kv.first, kv.second).second) {
+            duplicated_nodes.emplace_back(kv.first, kv.second);
+        }
+    }
+    auto global_node = [this](RelationMiner::nodeType* node) {
+        return (&RelationMiner::AxiomNode == node) ? node : predicate2NodeMap.find(const_cast<Predicate*>(node->content))->second;
+    };
+
+    /* Merge edges */
+    for (std::pair<RelationMiner::nodeType* const, std::unordered_set<RelationMiner::nodeType*>*> const& kv: workspace.dependencyGraph) {
+        RelationMiner::nodeType* head_node = global_node(kv.first);
+        RelationMiner::depGraphType::iterator itr = dependencyGraph.find(head_node);
+        std::unordered_set<RelationMiner::nodeType*>* dependencies;
+        if (dependencyGraph.end() == itr) {
+            dependencies = new std::unordered_set<RelationMiner::nodeType*>();
+            dependencyGraph.emplace(head_node, dependencies);
+        } else {
+            dependencies = itr->second;
+        }
+        for (RelationMiner::nodeType* const& body_node: *(kv.second)) {
+            dependencies->insert(global_node(body_node));
+        }
+        delete kv.second;
+    }
+    for (std::pair<Predicate*, RelationMiner::nodeType*> const& kv: duplicated_nodes) {
+        delete kv.first;
+        delete kv.second;
+    }
+    workspace.predicate2NodeMap.clear();
+    workspace.dependencyGraph.clear();
+
+    if (&workspace.logBuffer == workspace.logger) {
+        (*logger) << workspace.logBuffer.str();
+        workspace.logBuffer.str("");
+    }
+}
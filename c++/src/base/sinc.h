@@ -6,6 +6,9 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <sstream>
 #include "../util/common.h"
 #include "../util/graphAlg.h"
 #include "../rule/rule.h"
@@ -14,6 +17,7 @@
 #define LOG_FILE_NAME "log.meta"
 #define STD_OUTPUT_FILE_NAME "stdout.meta"
 #define STD_ERROR_FILE_NAME "stderr.meta"
+#define CHECKPOINT_FILE_NAME "checkpoint.meta"
 #define INTERRUPT_CMD "stop"
 
 /* Followings are macros for parsing command line options and arguments */
@@ -51,7 +55,7 @@ namespace sinc {
         /** The path where the compressed KB should be stored */
 
         /* Runtime Config */
-        /** The number of threads used to run SInC Todo: Implement multi-thread strategy */
+        /** The number of threads used to run SInC. Relation miners run concurrently if more than one thread is available */
         int threads;
         /** Whether the compressed KB is recovered to check the correctness */
         bool validation;
@@ -61,13 +65,53 @@ namespace sinc {
         const char* blockedRelations;
         /** Restrict the maximum memory limit (KByte) during compression */
         int maxMemGByte;
+        /** The wall-clock budget (ms) of mining each target relation. 0 means no limit (@since 2.6) */
+        uint64_t relationTimeLimitMs = 0;
+        /**
+         * The wall-clock budget (ms) of the whole compression. Relation miners share the remaining time fairly and return
+         * the best rules found so far when their deadlines are reached. 0 means no limit (@since 2.6)
+         */
+        uint64_t totalTimeLimitMs = 0;
+        /**
+         * Whether a checkpoint journal is appended after each relation miner is done, so that an interrupted compression can
+         * be resumed. A resumed compression keeps appending to the journal regardless of this option (@since 2.6)
+         */
+        bool checkpoint = false;
+        /** Whether the relations in the checkpoint journal are restored and skipped instead of being mined (@since 2.6) */
+        bool resume = false;
+        /**
+         * The memory budget (KB) of the cached blocks of the KB relations that are kept across relation miners, so that
+         * later miners do not rebuild them. 0 means nothing is kept (@since 2.6)
+         */
+        size_t cbRetentionKb = 1024 * 1024;
 
         /* Algorithm Strategy Config */
         /** The beamwidth */
         int beamwidth;
+        /**
+         * The max beamwidth of the adaptive beam search. The beamwidth starts from `beamwidth` and is adjusted within
+         * [`minBeamwidth`, `maxBeamwidth`] after each iteration. The beamwidth is fixed if this is no larger than
+         * `beamwidth` (@since 2.6)
+         */
+        int maxBeamwidth = 0;
+        /** The min beamwidth of the adaptive beam search (@since 2.6) */
+        int minBeamwidth = 1;
+        /** The adaptive beamwidth is narrowed if the cache of the beams exceeds this size (KB). 0 means no limit (@since 2.6) */
+        size_t beamCacheLimitKb = 0;
+        /** The adaptive beamwidth is narrowed if the evaluation memory exceeds this size (KB). 0 means no limit (@since 2.6) */
+        size_t beamEvalMemLimitKb = 0;
+        /** The adaptive beamwidth is narrowed if an iteration takes longer than this (ms). 0 means no limit (@since 2.6) */
+        uint64_t beamIterationTimeLimitMs = 0;
         // bool searchGeneralizations; Todo: Is it possible to efficiently update the cache for the generalizations? If so, implement the option here
         /** The rule evaluation metric */
         EvalMetric::Value evalMetric;
+        /**
+         * The ratio of the head records that the candidate rules are evaluated on. The rules selected as beams are
+         * re-evaluated exactly. 1 means all evaluations are exact (@since 2.6)
+         */
+        double evalSampleRatio = 1.0;
+        /** The confidence level of the intervals of the sampled evaluations (@since 2.6) */
+        double evalSampleConfidence = 0.95;
         /** The threshold for fact coverage */
         double minFactCoverage;
         /** The threshold for constant coverage */
@@ -133,15 +177,200 @@ namespace sinc {
         int fvsVertices = 0;
         /** This member keeps track of the number of evaluated SQL queries */
         int evaluatedSqls = 0;
+        /** The number of specializations skipped by their optimistic scores (@since 2.6) */
+        int boundPrunedRules = 0;
+        /** The number of specializations skipped as they join columns without common constants (@since 2.6) */
+        int infeasibleJoins = 0;
+        /** The number of changes of the adaptive beamwidth (@since 2.6) */
+        int beamwidthChanges = 0;
+        /** The number of relation miners stopped by their deadlines (@since 2.6) */
+        int timedOutRelations = 0;
+        /** The number of relations restored from the checkpoint instead of being mined (@since 2.6) */
+        int resumedRelations = 0;
+        /** The number of evaluations estimated on samples of the head records (@since 2.6) */
+        int sampledEvaluations = 0;
+        /** The number of sampled evaluations re-evaluated exactly (@since 2.6) */
+        int verifiedEvaluations = 0;
+        /** The number of beam selections involving sampled evaluations (@since 2.6) */
+        int sampledRankings = 0;
+        /** The number of beam selections where the sampled ranking differs from the exact one (@since 2.6) */
+        int rankingDisagreements = 0;
 
         /* Memory cost (KB) */
         size_t kbMemCost = 0;
         size_t dependencyGraphMemCost = 0;
         size_t ckbMemCost = 0;
+        /** The peak memory usage observed by the memory accountant (@since 2.6) */
+        size_t budgetPeakMemCost = 0;
+        /** The number of samples where the soft memory budget was exceeded (@since 2.6) */
+        int softBudgetExceeded = 0;
+        /** The memory released by the back-pressure of the memory accountant (KB) (@since 2.6) */
+        size_t relievedMemCost = 0;
+
+        /**
+         * The schedule of a relation miner.
+         *
+         * @since 2.6
+         */
+        struct RelationSchedule {
+            /** The name of the target relation */
+            std::string relation;
+            /** The estimated mining cost of the relation */
+            double estimatedCost;
+            /** The order in which the miner started */
+            int startOrder;
+            /** The wall-clock time of the miner (measured in nanoseconds) */
+            uint64_t miningTime;
+            /** Whether the miner was stopped by its deadline */
+            bool timedOut;
+        };
+        /** The schedule of the relation miners, in the order they were finalized (@since 2.6) */
+        std::vector<RelationSchedule> relationSchedules;
 
         void show(std::ostream& os) override;
     };
 
+    /**
+     * A bounded container of the top-k rules w.r.t. their scores. The rules are organized in a min-heap, so adding a rule
+     * costs O(log k), and the admission threshold, i.e., the lowest score in a full container, is returned in O(1). The
+     * scores are recorded when the rules are added. Among rules of the same score, the earlier added ones rank higher.
+     *
+     * NOTE: The rules are NOT released by the container.
+     *
+     * @since 2.6
+     */
+    class TopKRules {
+    public:
+        /**
+         * @param capacity The max number of rules in the container, i.e., k
+         */
+        TopKRules(int const capacity);
+        ~TopKRules();
+
+        /**
+         * Add a rule to the container.
+         *
+         * @return The rule that is no longer in the container: the lowest one if it is evicted, or `rule` itself if it is
+         * not admitted. NULL if no rule is dropped.
+         */
+        Rule* add(Rule* const rule, double const score);
+
+        /**
+         * The lowest score of the rules if the container is full. Otherwise, -inf. A rule is admitted only if its score is
+         * higher than the threshold.
+         */
+        double threshold() const;
+
+        /**
+         * The best rule in the container, or NULL if the container is empty.
+         */
+        Rule* best() const;
+        double bestScore() const;
+
+        /**
+         * The rules in the container, from the best to the lowest.
+         */
+        std::vector<Rule*> ranked() const;
+
+        /**
+         * Remove all rules from the container (without releasing them).
+         */
+        void clear();
+
+        /**
+         * Remove all rules from the container (without releasing them) and change the capacity.
+         *
+         * @since 2.6
+         */
+        void reset(int const capacity);
+
+        int size() const;
+        int capacity() const;
+        bool empty() const;
+        bool full() const;
+
+    protected:
+        struct Entry {
+            Rule* rule;
+            double score;
+            /** The order of addition, used to break ties */
+            uint64_t seq;
+        };
+
+        Entry* entries;
+        /** The number of allocated entries, which is no less than `cap` */
+        int allocated;
+        int cap;
+        int num = 0;
+        uint64_t nextSeq = 0;
+        /** A copy of the best entry. The rule is NULL if the container is empty */
+        Entry bestEntry;
+
+        /** Whether entry `a` ranks lower than entry `b` */
+        static bool lower(Entry const& a, Entry const& b);
+        void siftUp(int idx);
+        void siftDown(int idx);
+    };
+
+    /**
+     * The controller of the adaptive beamwidth. After each iteration of the beam search, the beamwidth is halved if any
+     * pressure exceeds its limit, or widened by one if all pressures are below half of their limits. That is, the
+     * beamwidth grows on cheap relations and backs off quickly on the expensive ones.
+     *
+     * @since 2.6
+     */
+    class AdaptiveBeamwidth {
+    public:
+        /**
+         * The pressure observed in an iteration of the beam search.
+         */
+        struct Pressure {
+            /** The cache size of the beams (KB) */
+            size_t cacheKb;
+            /** The max evaluation memory of the candidates (KB) */
+            size_t evalMemKb;
+            /** The time of the iteration (ms) */
+            uint64_t iterationTimeMs;
+        };
+
+        /**
+         * A controller of a fixed beamwidth.
+         */
+        AdaptiveBeamwidth(int const beamwidth);
+
+        /**
+         * @param beamwidth                The initial beamwidth
+         * @param minBeamwidth             The min beamwidth
+         * @param maxBeamwidth             The max beamwidth. The beamwidth is fixed if this is no larger than `beamwidth`
+         * @param cacheLimitKb             The limit of the cache size (KB). 0 means no limit
+         * @param evalMemLimitKb           The limit of the evaluation memory (KB). 0 means no limit
+         * @param iterationTimeLimitMs     The limit of the iteration time (ms). 0 means no limit
+         */
+        AdaptiveBeamwidth(
+            int const beamwidth, int const minBeamwidth, int const maxBeamwidth, size_t const cacheLimitKb,
+            size_t const evalMemLimitKb, uint64_t const iterationTimeLimitMs
+        );
+
+        bool adaptive() const;
+        int width() const;
+
+        /**
+         * Adjust the beamwidth according to the pressure of the last iteration.
+         *
+         * @param reason A description of why the beamwidth is changed
+         * @return Whether the beamwidth is changed
+         */
+        bool adjust(Pressure const& pressure, std::string& reason);
+
+    protected:
+        int beamwidth;
+        int minBeamwidth;
+        int maxBeamwidth;
+        size_t cacheLimitKb;
+        size_t evalMemLimitKb;
+        uint64_t iterationTimeLimitMs;
+    };
+
     /**
      * A relation miner is used to induce logic rules that compress a single relation in a KB.
      *
@@ -171,6 +400,22 @@ namespace sinc {
         uint64_t kbUpdateTime = 0;
         /** This member keeps track of the number of evaluated SQL queries */
         int evaluatedSqls = 0;
+        /** The number of specializations skipped by their optimistic scores or coverage (@since 2.6) */
+        int boundPrunedRules = 0;
+        /** The number of specializations skipped as they join columns without common constants (@since 2.6) */
+        int infeasibleJoins = 0;
+        /** The number of changes of the adaptive beamwidth (@since 2.6) */
+        int beamwidthChanges = 0;
+        /** Whether the mining was stopped by the deadline (@since 2.6) */
+        bool timedOut = false;
+        /** The number of evaluations estimated on samples of the head records (@since 2.6) */
+        int sampledEvaluations = 0;
+        /** The number of sampled evaluations re-evaluated exactly (@since 2.6) */
+        int verifiedEvaluations = 0;
+        /** The number of beam selections involving sampled evaluations (@since 2.6) */
+        int sampledRankings = 0;
+        /** The number of beam selections where the sampled ranking differs from the exact one (@since 2.6) */
+        int rankingDisagreements = 0;
 
         /**
          * Construct by passing parameters from the compressor that loads the data.
@@ -209,6 +454,59 @@ namespace sinc {
         std::unordered_set<Record>& getCounterexamples() const;
         std::vector<Rule*>& getHypothesis() const;
 
+        /**
+         * Set the number of threads used to evaluate the specializations and generalizations of a rule.
+         *
+         * @since 2.6
+         */
+        void setEvaluationThreads(int const threads);
+
+        /**
+         * Set the counter of spare threads shared among concurrent miners. When more updated rules are pending than the
+         * evaluation threads, the miner borrows spare threads for the evaluation and returns them afterwards. That is, idle
+         * relation workers steal the evaluation tasks of busy miners.
+         *
+         * @since 2.6
+         */
+        void setSpareThreads(std::atomic<int>* const spareThreads);
+
+        /**
+         * Set the memory accountant shared among the miners. The memory sources of this miner are moved from the current
+         * accountant to the new one. By default, each miner has a local accountant with the hard budget of `maxMemKByte`.
+         *
+         * NOTE: The accountant SHOULD outlive the miner.
+         *
+         * @since 2.6
+         */
+        void setMemoryAccountant(MemoryAccountant* const accountant);
+
+        /**
+         * Set the controller of the beamwidth. By default, the beamwidth is fixed as `beamwidth`.
+         *
+         * @since 2.6
+         */
+        void setAdaptiveBeamwidth(AdaptiveBeamwidth const& controller);
+
+        /**
+         * Set the wall-clock deadline (as returned by `currentTimeInNano()`) of the mining. When the deadline is reached,
+         * `findRule()` returns the best useful rule found so far and no more rules are searched. 0 means no deadline.
+         *
+         * @since 2.6
+         */
+        void setDeadline(uint64_t const deadlineNano);
+        bool deadlineReached() const;
+
+        /**
+         * Set the ratio of the head records that the candidate rules are evaluated on. If the ratio is less than 1, the
+         * candidate list keeps `SAMPLED_CANDIDATE_FACTOR` times the beamwidth of rules, and the candidates are verified by
+         * `verifyCandidates()` before the beams are selected.
+         *
+         * @param ratio      The sample ratio in (0, 1]. 1 means exact evaluation
+         * @param confidence The confidence level of the intervals of the sampled scores
+         * @since 2.6
+         */
+        void setEvalSampling(double const ratio, double const confidence);
+
     protected:
         /** The input KB */
         SimpleKb& kb;
@@ -232,8 +530,48 @@ namespace sinc {
         std::unordered_set<Record>& counterexamples;
         /** The tabu set */
         Rule::tabuMapType tabuMap;
-        /** Mark whether the mining iteration in `run()` should continue */
-        bool shouldContinue = true;
+        /** Mark whether the mining iteration in `run()` should continue. It may be set by another thread (@since 2.6) */
+        std::atomic<bool> shouldContinue{true};
+        /** The number of threads used to evaluate the updated rules */
+        int evaluationThreads = 1;
+        /** Threads released by idle relation workers, which may be borrowed to evaluate updated rules (@since 2.6) */
+        std::atomic<int>* spareThreads = nullptr;
+        /** This lock guards the candidate list and the statistics updated in `checkThenAddRule()` */
+        std::recursive_mutex candidateMutex;
+        /** The memory accountant used when no shared one is set (@since 2.6) */
+        MemoryAccountant localMemoryAccountant;
+        /** The memory accountant that checks the memory budgets (@since 2.6) */
+        MemoryAccountant* memoryAccountant;
+        /** The IDs of the memory sources registered by this miner (@since 2.6) */
+        std::vector<int> memorySourceIds;
+        /** The controller of the beamwidth (@since 2.6) */
+        AdaptiveBeamwidth adaptiveBeam;
+        /** The deadline of the mining (ns). 0 means no deadline (@since 2.6) */
+        std::atomic<uint64_t> deadline{0};
+        /** The ratio of the head records that the candidates are evaluated on (@since 2.6) */
+        double evalSampleRatio = 1.0;
+        /** The confidence level of the sampled evaluations (@since 2.6) */
+        double evalSampleConfidence = 0.95;
+
+        /** The candidate list keeps this times the beamwidth of rules if the evaluations are sampled (@since 2.6) */
+        static const int SAMPLED_CANDIDATE_FACTOR;
+
+        /**
+         * An update operation on a rule, i.e., a case of specialization or a generalization, with its arguments in the order
+         * of the parameters of the corresponding update method in `Rule`.
+         *
+         * @since 2.6
+         */
+        struct RuleOperation {
+            enum Type {
+                Case1, Case2, Case3, Case4, Case5, Generalization
+            };
+
+            Type type;
+            int args[5];
+
+            RuleOperation(Type const type, int const arg0, int const arg1, int const arg2 = 0, int const arg3 = 0, int const arg4 = 0);
+        };
 
         /** Logger */
         std::ostream& logger;
@@ -244,6 +582,57 @@ namespace sinc {
          */
         virtual Rule* getStartRule() = 0;
 
+        /**
+         * Register the memory sources of this miner (e.g., the fingerprint caches and the tabu map) to the accountant. The
+         * IDs of the sources should be appended to `ids`. The sources may be evaluated by other threads, so they SHOULD be
+         * thread-safe and SHOULD NOT acquire `candidateMutex`. This default implementation registers nothing.
+         *
+         * @since 2.6
+         */
+        virtual void addMemorySources(MemoryAccountant& accountant, std::vector<int>& ids);
+
+        /**
+         * Measure the cache size and the evaluation memory of an iteration for the adaptive beamwidth. The iteration time is
+         * measured by the caller. This default implementation reports no memory pressure.
+         *
+         * @param candidates The candidates selected in the iteration, i.e., the beams of the next iteration
+         * @since 2.6
+         */
+        virtual void measureBeamPressure(std::vector<Rule*> const& candidates, AdaptiveBeamwidth::Pressure& pressure);
+
+        /**
+         * Check the memory usage with the accountant.
+         *
+         * @return True if the hard budget is exceeded and mining should stop
+         * @since 2.6
+         */
+        bool memoryExhausted();
+
+        /**
+         * Whether the mining should stop, i.e., it is discontinued, the deadline is reached, or memory is exhausted.
+         *
+         * @since 2.6
+         */
+        bool miningInterrupted();
+
+        /**
+         * The capacity of the candidate list in an iteration of the beam search.
+         *
+         * @since 2.6
+         */
+        int candidateCapacity() const;
+
+        /**
+         * Re-evaluate the sampled candidates exactly and rank them by the exact scores. The candidates within the beamwidth
+         * are verified, as well as those beyond it whose upper bounds reach the lowest lower bound within the beamwidth, as
+         * their order is uncertain. Candidates beyond the beamwidth are released afterwards, so the beams are always exactly
+         * evaluated.
+         *
+         * @param candidates The candidates ranked by their sampled scores. They are re-ranked in place
+         * @since 2.6
+         */
+        void verifyCandidates(std::vector<Rule*>& candidates);
+
         /**
          * The rule mining procedure that finds a single rule in the target relation.
          *
@@ -260,7 +649,7 @@ namespace sinc {
          * @return The number of added candidates
          * @throws InterruptedSignal Thrown when the workflow should be interrupted
          */
-        int findSpecializations(Rule& rule, Rule** const candidates);
+        int findSpecializations(Rule& rule, TopKRules& candidates);
 
         /**
          * Find the generalizations of a basic rule. Only the specializations that have a better quality score is added to the
@@ -271,7 +660,61 @@ namespace sinc {
          * @return The number of added candidates
          * @throws InterruptedSignal Thrown when the workflow should be interrupted
          */
-        int findGeneralizations(Rule& rule, Rule** const candidates);
+        int findGeneralizations(Rule& rule, TopKRules& candidates);
+
+        /**
+         * Select the constants worth trying in the case 5 specializations of an empty argument in `rule`. This default
+         * implementation keeps all constants.
+         *
+         * @param survivors Output: The constants that may produce acceptable specializations
+         * @since 2.6
+         */
+        virtual void screenCase5Constants(
+            Rule& rule, ArgLocation const& arg, std::vector<int> const& constants, TopKRules const& candidates,
+            std::vector<int>& survivors
+        );
+
+        /**
+         * Select the columns worth joining in the case 2 or case 4 specializations of `rule`. The new predicate is joined to
+         * the argument at `arg`, which is either empty (case 4) or an occurrence of the joined LV (case 2). This default
+         * implementation keeps all columns.
+         *
+         * @param columns   The candidate columns, as pairs of relation IDs and column indices
+         * @param survivors Output: The columns that may produce acceptable specializations
+         * @since 2.6
+         */
+        virtual void screenJoinColumns(
+            Rule& rule, ArgLocation const& arg, std::vector<std::pair<int, int>> const& columns, TopKRules const& candidates,
+            std::vector<std::pair<int, int>>& survivors
+        );
+
+        /**
+         * Apply an update operation to a rule.
+         *
+         * @since 2.6
+         */
+        UpdateStatus applyOperation(Rule& rule, RuleOperation const& operation) const;
+
+        /**
+         * Apply the operations to the copies of `rule` and add the updated rules to the candidate list by
+         * `checkThenAddRule()`. If `evaluationThreads` is larger than 1, the updated rules are evaluated concurrently. The
+         * rules are still checked in the order of the operations. However, if two operations produce the same rule, the
+         * one inserted into the fingerprint cache first is kept, which may be a later one than in a single thread. So the
+         * candidate list may differ in the order of ties and in the rules admitted after such a duplicate.
+         *
+         * @return The number of added candidates
+         * @since 2.6
+         */
+        int evaluateOperations(Rule& rule, std::vector<RuleOperation> const& operations, TopKRules& candidates);
+
+        /**
+         * The score that a specialization/generalization of `originalRule` has to beat to be added to the candidate list by
+         * `checkThenAddRule()`, i.e., the score of `originalRule` or the k-th best score in the full candidate list. It is
+         * passed to the updated rules as the cutoff of evaluation, so hopeless candidates are abandoned during counting.
+         *
+         * @since 2.6
+         */
+        double admissionScore(Rule const& originalRule, TopKRules const& candidates) const;
 
         /**
          * Check the status of updated rule and add to a candidate list if the update is successful and the evaluation score
@@ -281,10 +724,12 @@ namespace sinc {
          * @param updatedRule The updated rule
          * @param originalRule The original rule
          * @param candidates The candidate list
+         * NOTE: This method is thread-safe. Overriding methods should also lock `candidateMutex` before updating shared members.
+         *
          * @return 1 if the update is successful and the updated rule is better than the original one; 0 otherwise.
          * @throws InterruptedSignal Thrown when the workflow should be interrupted
          */
-        virtual int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates);
+        virtual int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates);
 
         /**
          * Select rule r as one of the beams in the next iteration of rule mining. Shared operations for beams may be added
@@ -301,6 +746,115 @@ namespace sinc {
         int updateKbAndDependencyGraph(Rule& rule);
     };
 
+    /**
+     * The outputs of a single relation miner. Relation miners may run concurrently, so each of them writes its hypothesis,
+     * dependency edges, and logs into its own workspace. The workspaces are merged into the global structures in the order
+     * of the target relations, so the merged results are independent of the number of threads.
+     *
+     * NOTE: The entailment flags are not buffered here, as a miner only marks the records in its target relation, and each
+     * relation is the target of at most one miner.
+     *
+     * @since 2.6
+     */
+    struct MinerWorkspace {
+        /** A mapping from predicates to the nodes in the dependency graph of this miner */
+        RelationMiner::nodeMapType predicate2NodeMap;
+        /** The dependency edges found by this miner */
+        RelationMiner::depGraphType dependencyGraph;
+        /** The rules found by this miner */
+        std::vector<Rule*> hypothesis;
+        /** The buffer of logs if the miner does not write to the global logger directly */
+        std::ostringstream logBuffer;
+        /** The logger of the miner, either the global logger or `logBuffer` */
+        std::ostream* logger = nullptr;
+    };
+
+    /**
+     * An append-only journal of the relations that have been compressed. A record is appended and flushed after each
+     * relation miner is done. It contains the rules found, the counterexamples, the entailment flags of the target relation,
+     * and the dependency edges of the entailed records. An interrupted compression is resumed by restoring the records into
+     * the compressed KB and the dependency graph, and skipping the relations in the journal.
+     *
+     * The journal is a sequence of integers in the byte order of `IntWriter`:
+     *   Header: MAGIC, VERSION, #relations, #records in the KB
+     *   Record: RECORD_MAGIC, relation ID, payload length, payload, checksum of the payload
+     * A record that is truncated or corrupted (e.g., by a crash during writing) and all records after it are discarded.
+     *
+     * @since 2.6
+     */
+    class CompressionJournal {
+    public:
+        static constexpr int MAGIC = 0x534a4e4c;
+        static constexpr int VERSION = 1;
+        static constexpr int RECORD_MAGIC = 0x52454c44;
+
+        /**
+         * @param filePath The path to the journal file
+         * @param kb       The KB being compressed. A journal matches the KB only if the numbers of relations and records equal
+         */
+        CompressionJournal(fs::path const& filePath, SimpleKb& kb);
+
+        ~CompressionJournal();
+
+        /**
+         * Restore the records in the journal. Rules and dependency edges are written into the workspace, counterexamples are
+         * added to the compressed KB, and the entailment flags of the restored relations are overwritten. The journal file
+         * is truncated to the valid records so that new records can be appended.
+         *
+         * NOTE: The restored rules refer to the fingerprint cache of the journal, so the journal SHOULD be released after them.
+         *
+         * @param completedRelations The IDs of the restored relations are appended here
+         * @return Whether the journal exists and matches the KB. Nothing is restored if not.
+         * @throws SincException The journal is inconsistent with the KB
+         */
+        bool restore(SimpleCompressedKb& compressedKb, MinerWorkspace& workspace, std::vector<int>& completedRelations);
+
+        /**
+         * Open the journal for appending. If `append` is false, the file is created anew with only the header.
+         *
+         * @throws SincException The file cannot be opened
+         */
+        void open(bool const append);
+
+        /**
+         * Append the outputs of a finished relation miner and flush them to the file. The workspace SHOULD NOT have been
+         * merged yet. This function is thread-safe, as long as no other thread modifies the workspace, the counterexamples
+         * and the entailment flags of the relation.
+         *
+         * @throws SincException Write failure
+         */
+        void append(int const relationId, MinerWorkspace const& workspace, SimpleCompressedKb& compressedKb);
+
+        /** The number of records restored or appended */
+        int totalRecords() const;
+
+    protected:
+        fs::path const filePath;
+        SimpleKb& kb;
+        /** The writer of the journal. NULL if the journal has not been opened */
+        IntWriter* writer = nullptr;
+        /** Serializes the appending of records */
+        std::mutex appendMutex;
+        int records = 0;
+        /** The cache and the tabu map referred by the restored rules. They are never updated */
+        Rule::fingerprintCacheType fingerprintCache;
+        Rule::tabuMapType tabuMap;
+
+        /**
+         * Restore a record whose payload is `ints[begin, end)`.
+         *
+         * @throws SincException The payload is inconsistent with the KB
+         */
+        void restoreRecord(
+            int const relationId, std::vector<int> const& ints, size_t const begin, size_t const end, SimpleCompressedKb& compressedKb,
+            MinerWorkspace& workspace
+        );
+
+        static int checksum(std::vector<int> const& ints, size_t const begin, size_t const end);
+        static void encodePredicate(std::vector<int>& buffer, int const functor, int const arity, int const* const args);
+        static void encodeDouble(std::vector<int>& buffer, double const value);
+    };
+
     /**
      * The recovery class, retuning a compressed KB to the original version.
      * 
@@ -326,6 +880,7 @@ namespace sinc {
         static fs::path getLogFilePath(fs::path& dumpPath, const char* dumpName);
         static fs::path getStdOutFilePath(fs::path& dumpPath, const char* dumpName);
         static fs::path getStdErrFilePath(fs::path& dumpPath, const char* dumpName);
+        static fs::path getCheckpointFilePath(fs::path& dumpPath, const char* dumpName);
 
         /**
          * Create a SInC object with configurations.
@@ -339,13 +894,15 @@ namespace sinc {
          * Create a SInC object with configurations and a KB in memory. If the KB is not NULL, the input KB will be the one
          * in the memory instead of loading from file system.
          * 
-         * NOTE: The kb WILL be released by the `SInC` object
+         * NOTE: The kb WILL be released by the `SInC` object unless it is shared
          *
-         * @param config The configurations
-         * @param kb     The KB object in memory
+         * @param config   The configurations
+         * @param kb       The KB object in memory
+         * @param sharedKb Whether the KB is shared by multiple `SInC` objects that compress it one after another. A shared KB
+         *                 is not released, and its entailment is cleared before the compression (@since 2.6)
          * @throws SincException Dump path creation failure
          */
-        SInC(SincConfig* const config, SimpleKb* const kb);
+        SInC(SincConfig* const config, SimpleKb* const kb, bool const sharedKb = false);
 
         virtual ~SInC();
 
@@ -383,6 +940,8 @@ namespace sinc {
         /* Compression related data */
         /** The input KB */
         SimpleKb* kb;
+        /** Whether `kb` is shared with other `SInC` objects and should not be released (@since 2.6) */
+        bool const sharedKb;
         /** The compressed KB */
         SimpleCompressedKb* compressedKb;
         /** A mapping from predicates to the nodes in the dependency graph */
@@ -395,12 +954,69 @@ namespace sinc {
         RelationMiner::depGraphType dependencyGraph;
         /** The performance monitor */
         BaseMonitor monitor;
+        /** The number of threads assigned to each relation miner (@since 2.6) */
+        int threadsPerMiner = 1;
+        /**
+         * The memory accountant shared by all relation miners. The hard budget is `config->maxMemGByte` and the soft budget
+         * is `MemoryAccountant::DEFAULT_SOFT_RATIO` of that. It only lives during the hypothesis mining (@since 2.6)
+         */
+        MemoryAccountant* memoryAccountant = nullptr;
+        /** The deadline (ns) of the whole compression. 0 means no deadline (@since 2.6) */
+        uint64_t globalDeadline = 0;
+        /** The checkpoint journal. NULL if neither checkpointing nor resuming is enabled (@since 2.6) */
+        CompressionJournal* journal = nullptr;
 
         /**
          * Load a KB (in the format of Numerated KB)
          */
         virtual void loadKb();
 
+        /**
+         * Open the checkpoint journal if checkpointing or resuming is enabled. If resuming, the relations in the journal are
+         * restored into the compressed KB and the dependency graph. If the existing journal does not match the KB, it is left
+         * unchanged and the journal is not opened.
+         *
+         * @param completedRelations The IDs of the restored relations, which should not be mined again
+         * @throws SincException Restoration or file failure
+         * @since 2.6
+         */
+        void openJournal(std::unordered_set<int>& completedRelations);
+
+        /**
+         * Append the outputs of a finished relation miner to the checkpoint journal if it is open.
+         *
+         * @since 2.6
+         */
+        void checkpointRelation(int const relationId, MinerWorkspace const& workspace);
+
+        /**
+         * Register the memory sources and relievers shared by the relation miners (e.g., the CB pool) to the accountant.
+         * This default implementation registers nothing, and the accountant only tracks the memory by the process RSS.
+         *
+         * @since 2.6
+         */
+        virtual void registerMemorySources(MemoryAccountant& accountant);
+
+        /**
+         * Set up a newly created relation miner with the shared resources and the configurations that are not passed
+         * to the constructor (e.g., the memory accountant, the adaptive beamwidth, and the deadline).
+         *
+         * @param remainingTargets The number of target relations not started yet, including the one of `miner`
+         * @param workers          The number of relation miners that run concurrently
+         * @since 2.6
+         */
+        void prepareRelationMiner(RelationMiner* miner, int const remainingTargets, int const workers);
+
+        /**
+         * The deadline of a relation miner that starts now. It is the earlier one of the per-relation budget and a fair
+         * share of the remaining global budget, i.e., the remaining time divided by the rounds of the remaining relations
+         * among the workers. The unused time of a relation is left to the later ones.
+         *
+         * @return The deadline (ns), or 0 if there is no limit
+         * @since 2.6
+         */
+        uint64_t relationDeadline(int const remainingTargets, int const workers) const;
+
         /**
          * The relations that will be the targets of rule mining procedures. By default, all relations are the targets.
          * Results will be written into the argument references.
@@ -424,7 +1040,14 @@ namespace sinc {
         void dumpCompressedKb();
 
         virtual void showMonitor();
-        virtual RelationMiner* createRelationMiner(int const targetRelationId) = 0;
+
+        /**
+         * Create a relation miner that writes its outputs into the workspace.
+         *
+         * @param targetRelationId The target relation
+         * @param workspace        The workspace of the miner (@since 2.6)
+         */
+        virtual RelationMiner* createRelationMiner(int const targetRelationId, MinerWorkspace& workspace) = 0;
         void showConfig() const ;
         void showHypothesis() const;
         virtual void finish() = 0;
@@ -435,6 +1058,56 @@ namespace sinc {
         void compress();
 
         virtual void finalizeRelationMiner(RelationMiner* miner);
+
+        /**
+         * The number of relation miners that run concurrently, i.e., min(#threads, #targets).
+         *
+         * @since 2.6
+         */
+        int relationWorkers(int const numTargets) const;
+
+        /**
+         * The number of threads each concurrent relation miner may use to evaluate its rules.
+         *
+         * @since 2.6
+         */
+        int minerThreads(int const numTargets) const;
+
+        /**
+         * Estimate the cost of mining a relation, as: #rows * Σ_col log2(2 + #values in col). Larger relations produce
+         * larger caches and joins, and each column with more values yields more specializations with constants and more
+         * entries to group.
+         *
+         * @since 2.6
+         */
+        virtual double estimateMiningCost(int const relationId) const;
+
+        /**
+         * Sort the indices of the targets by their estimated mining cost, in descending order. Ties are kept in the
+         * original order. The most expensive relations should start first so that the last running miner is not a long one.
+         *
+         * @return The indices in `targetRelations`, in the order the miners should start
+         * @since 2.6
+         */
+        std::vector<int> scheduleRelations(int const* const targetRelations, int const numTargets) const;
+
+        /**
+         * Run the miners of all target relations with `relationWorkers()` threads. The miners are finalized and their
+         * workspaces are merged in the order of `targetRelations`.
+         *
+         * @since 2.6
+         */
+        void mineConcurrently(int const* const targetRelations, int const numTargets, MinerWorkspace* const workspaces);
+
+        /**
+         * Move the hypothesis and the dependency edges in a workspace to the compressed KB and the global dependency graph.
+         * Nodes of predicates that are already in the global graph are replaced by the existing ones. Logs in the buffer
+         * are flushed to the global logger.
+         *
+         * @since 2.6
+         */
+        void mergeWorkspace(MinerWorkspace& workspace);
+
         void logInfo(const char* msg) const;
         void logInfo(std::string const& msg) const;
         void logError(const char* msg) const;
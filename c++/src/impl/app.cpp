@@ -1,6 +1,9 @@
 #include "app.h"
 #include "sincWithCache.h"
 #include "sincWithEstimation.h"
+#include "sincBatch.h"
+#include <fstream>
+#include <thread>
 #include <gflags/gflags.h>  // Todo: gflags may not release all resource it used. Replace by parsing it manually
 
 /**
@@ -17,6 +20,14 @@ static bool validatePositiveInt(const char* flagName, int32_t value) {
     return false;
 }
 
+static bool validateNonNegativeInt(const char* flagName, int32_t value) {
+    if (0 <= value) {
+        return true;
+    }
+    std::cout << "Invalid value for -" << flagName << ": " << value << " (should be >= 0)\n";
+    return false;
+}
+
 static bool validateNonNegativeDouble(const char* flagName, double value) {
     if (0.0 <= value) {
         return true;
@@ -33,6 +44,22 @@ static bool validateNormalizedDouble(const char* flagName, double value) {
     return false;
 }
 
+static bool validateSampleRatio(const char* flagName, double value) {
+    if (0.0 < value && 1.0 >= value) {
+        return true;
+    }
+    std::cout << "Invalid value for -" << flagName << ": " << value << " (should be > 0 and <= 1)\n";
+    return false;
+}
+
+static bool validateConfidence(const char* flagName, double value) {
+    if (0.0 < value && 1.0 > value) {
+        return true;
+    }
+    std::cout << "Invalid value for -" << flagName << ": " << value << " (should be > 0 and < 1)\n";
+    return false;
+}
+
 static bool validateEvalMetric(const char* flagName, std::string const& value) {
     if (0 == value.compare("τ") || 0 == value.compare("δ") || 0 == value.compare("h")) {
         return true;
@@ -88,8 +115,26 @@ DEFINE_double(f, 0.05, "Set fact coverage threshold (Default 0.05)");
 DEFINE_double(c, 0.25, "Set fact constant threshold (Default 0.25)");
 DEFINE_double(p, 1.0, "Set stopping compression rate (Default 1.0)");
 DEFINE_double(o, 0, "Use rule mining estimation and set observation ratio (Default 0.0). If the value is set >= 1.0, estimation is turned on and the rule mining estimation model is applied.");
+DEFINE_double(s, 1.0, "Evaluate the candidate rules on this ratio of the head records, with confidence intervals of the scores. The rules selected as beams, and thus the returned rules, are re-evaluated exactly. Not applied with estimation ('-o'). 1.0 means exact evaluation (Default 1.0)");
+DEFINE_double(s_conf, 0.95, "The confidence level of the intervals of the sampled evaluations ('-s'). Candidates beyond the beamwidth are also re-evaluated exactly if their intervals overlap those in the beams (Default 0.95)");
 DEFINE_int32(M, 1024, "Set the maximum memory consumption (GByte) during compression (Default 1024)");
 DEFINE_string(B, "", "Specify a list of relation IDs that should not be set as target (separated by ',')");
+DEFINE_int32(T, 0, "Set the wall-clock budget (seconds) of the whole compression. When the budget runs out, the best rules found so far are kept and a best-effort compressed KB is dumped. 0 means no limit (Default 0)");
+DEFINE_int32(T_rel, 0, "Set the wall-clock budget (seconds) of mining each target relation. 0 means no limit (Default 0)");
+DEFINE_bool(C, false, "Append a checkpoint to the output directory after each relation is mined, so that an interrupted compression can be resumed by '--resume' (Default false)");
+DEFINE_bool(resume, false, "Resume the compression from the checkpoint in the output directory. Relations in the checkpoint are restored instead of being mined again, and the newly mined relations are appended to it (Default false)");
+DEFINE_int32(R, 1024, "Set the memory budget (MByte) of the cached blocks of KB relations that are kept across relation miners, so that later miners reuse them. 0 means nothing is kept (Default 1024)");
+DEFINE_int32(A, 0, "Turn on the adaptive beam search and set the max beamwidth (> b). The beamwidth is widened on cheap iterations and narrowed when any of the limits below is exceeded (Default 0, i.e., fixed beamwidth)");
+DEFINE_int32(A_min, 1, "The min beamwidth of the adaptive beam search (Default 1)");
+DEFINE_int32(A_cache, 0, "Narrow the adaptive beamwidth if the cache of the beams exceeds this size (MByte). 0 means no limit (Default 0)");
+DEFINE_int32(A_eval, 0, "Narrow the adaptive beamwidth if the evaluation memory exceeds this size (MByte). 0 means no limit (Default 0)");
+DEFINE_int32(A_time, 0, "Narrow the adaptive beamwidth if an iteration of the beam search takes longer than this (ms). 0 means no limit (Default 0)");
+DEFINE_string(S, "", "Run a parameter sweep by the configurations in this file, one per line. Options in a line override those in the command line. The KB is loaded once and shared by the configurations, and the i-th configuration is dumped to '<output name>_<i>'");
+
+DEFINE_string(batch, "", "Run a batch of compression jobs in this manifest file, one per line. Options in a line override those in the command line, and each job SHOULD specify its own '-I' and '-O'");
+DEFINE_string(serve, "", "Serve compression jobs from a Unix socket at this path. Each line sent to the socket is a job as those in '--batch'. Send 'stop' to finish the running jobs and exit");
+DEFINE_int32(workers, 0, "The number of worker processes running the jobs of '--batch' or '--serve' concurrently. 0 means #cores / t (Default 0)");
+DEFINE_int32(batch_mem, 0, "The total memory budget (GByte) of the concurrent jobs of '--batch' or '--serve'. A job is started only if the budgets ('-M') of the running ones leave room for it. 0 means no limit (Default 0)");
 
 DEFINE_validator(I, &validateInputPath);
 DEFINE_validator(O, &validateOutputPath);
@@ -102,11 +147,78 @@ DEFINE_validator(f, &validateNormalizedDouble);
 DEFINE_validator(c, &validateNormalizedDouble);
 DEFINE_validator(p, &validateNormalizedDouble);
 DEFINE_validator(o, &validateNonNegativeDouble);
+DEFINE_validator(s, &validateSampleRatio);
+DEFINE_validator(s_conf, &validateConfidence);
 DEFINE_validator(M, &validatePositiveInt);
+DEFINE_validator(T, &validateNonNegativeInt);
+DEFINE_validator(T_rel, &validateNonNegativeInt);
+DEFINE_validator(R, &validateNonNegativeInt);
+DEFINE_validator(A, &validateNonNegativeInt);
+DEFINE_validator(A_min, &validatePositiveInt);
+DEFINE_validator(A_cache, &validateNonNegativeInt);
+DEFINE_validator(A_eval, &validateNonNegativeInt);
+DEFINE_validator(A_time, &validateNonNegativeInt);
+DEFINE_validator(workers, &validateNonNegativeInt);
+DEFINE_validator(batch_mem, &validateNonNegativeInt);
+
+/**
+ * Set the flags by the options in a line (e.g., "-b 3 -e δ"), separated by white spaces. Invalid options do not terminate
+ * the process, as they may come from a batch job.
+ *
+ * @return Whether all options are valid. Otherwise, the reason is written to `error`
+ */
+static bool setOptions(std::string const& line, std::string& error) {
+    std::istringstream line_stream(line);
+    std::string token;
+    while (line_stream >> token) {
+        size_t const name_start = token.find_first_not_of('-');
+        if (0 == name_start || std::string::npos == name_start) {
+            error = "Not an option: " + token;
+            return false;
+        }
+        std::string name = token.substr(name_start);
+        std::string value;
+        size_t const idx = name.find('=');
+        bool has_value = std::string::npos != idx;
+        if (has_value) {
+            value = name.substr(idx + 1);
+            name = name.substr(0, idx);
+        }
+        gflags::CommandLineFlagInfo info;
+        if (!gflags::GetCommandLineFlagInfo(name.c_str(), &info)) {
+            error = "Unknown option: " + token;
+            return false;
+        }
+        if (!has_value) {
+            if (0 == info.type.compare("bool")) {
+                value = "true";
+            } else if (!(line_stream >> value)) {
+                error = "Missing value of option: " + token;
+                return false;
+            }
+        }
+        if (gflags::SetCommandLineOption(name.c_str(), value.c_str()).empty()) {
+            error = "Invalid value for " + token + ": " + value;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Whether a line in a sweep file or a manifest lists options, i.e., it is neither empty nor a comment starting with '#'.
+ */
+static bool isOptionLine(std::string const& line) {
+    size_t const idx = line.find_first_not_of(" \t\r");
+    return std::string::npos != idx && '#' != line[idx];
+}
 
 SincConfig* Main::parseConfig(int argc, char** argv) {
     gflags::ParseCommandLineFlags(&argc, &argv, false);
+    return createConfig();
+}
 
+SincConfig* Main::createConfig() {
     /* Input path & name */
     int idx = FLAGS_I.find(',');
     std::string input_path = FLAGS_I.substr(0, idx);
@@ -174,18 +286,95 @@ SincConfig* Main::parseConfig(int argc, char** argv) {
     if (0 != FLAGS_o) {
         std::cout << "Observation ratio: " << FLAGS_o << std::endl;
     }
+    if (1.0 != FLAGS_s) {
+        std::cout << "Evaluation sample ratio: " << FLAGS_s << " (confidence: " << FLAGS_s_conf << ")" << std::endl;
+    }
     if (!FLAGS_B.empty()) {
         std::cout << "Block relations: " << FLAGS_B << std::endl;
     }
+    if (0 != FLAGS_T) {
+        std::cout << "Time budget: " << FLAGS_T << " (s)" << std::endl;
+    }
+    if (0 != FLAGS_T_rel) {
+        std::cout << "Time budget per relation: " << FLAGS_T_rel << " (s)" << std::endl;
+    }
+    if (FLAGS_A > FLAGS_b) {
+        std::cout << "Adaptive beamwidth: [" << std::min(FLAGS_A_min, FLAGS_b) << ", " << FLAGS_A << "]" << std::endl;
+    }
 
-    return new sinc::SincConfig(
+    SincConfig* config = new sinc::SincConfig(
         input_path.c_str(), input_name.c_str(), output_path.c_str(), output_name.c_str(), FLAGS_t, FLAGS_v, FLAGS_r, FLAGS_B.c_str(), FLAGS_M, FLAGS_b,
         EvalMetric::getBySymbol(FLAGS_e), FLAGS_f, FLAGS_c, FLAGS_p, FLAGS_o, negkb_path.c_str(), negkb_name.c_str(), FLAGS_g, FLAGS_w
     );
+    config->totalTimeLimitMs = ((uint64_t) FLAGS_T) * 1000;
+    config->relationTimeLimitMs = ((uint64_t) FLAGS_T_rel) * 1000;
+    config->checkpoint = FLAGS_C;
+    config->resume = FLAGS_resume;
+    config->cbRetentionKb = ((size_t) FLAGS_R) * 1024;
+    config->maxBeamwidth = FLAGS_A;
+    config->minBeamwidth = FLAGS_A_min;
+    config->beamCacheLimitKb = ((size_t) FLAGS_A_cache) * 1024;
+    config->beamEvalMemLimitKb = ((size_t) FLAGS_A_eval) * 1024;
+    config->beamIterationTimeLimitMs = FLAGS_A_time;
+    config->evalSampleRatio = FLAGS_s;
+    config->evalSampleConfidence = FLAGS_s_conf;
+    return config;
+}
+
+std::vector<SincConfig*> Main::parseSweepConfigs(SincConfig const& baseConfig, const char* sweepFilePath) {
+    std::ifstream in(sweepFilePath);
+    if (!in.good()) {
+        throw SincException(std::string("Sweep file open failed: ") + sweepFilePath);
+    }
+    std::string const input_option = FLAGS_I;
+    std::vector<SincConfig*> configs;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!isOptionLine(line)) {
+            continue;
+        }
+
+        /* Options in the line are only effective for this configuration */
+        gflags::FlagSaver flag_saver;
+        std::cout << "Sweep configuration " << configs.size() << ": " << line << std::endl;
+        std::string error;
+        if (!setOptions(line, error)) {
+            for (SincConfig* const& config: configs) {
+                delete config;
+            }
+            throw SincException("Invalid sweep configuration: " + error);
+        }
+        FLAGS_I = input_option;
+        FLAGS_O = baseConfig.dumpPath.string() + ',' + baseConfig.dumpName + '_' + std::to_string(configs.size());
+        FLAGS_S = "";
+        configs.push_back(createConfig());
+    }
+    return configs;
+}
+
+SincConfig* Main::parseJobConfig(std::string const& jobLine, std::string& error) {
+    gflags::FlagSaver flag_saver;
+    if (!isOptionLine(jobLine)) {
+        error = "Empty job";
+        return nullptr;
+    }
+    if (!setOptions(jobLine, error)) {
+        return nullptr;
+    }
+    return createConfig();
 }
 
 void Main::sincMain(int argc, char** argv) {
     SincConfig* config = parseConfig(argc, argv);
+    if (!FLAGS_S.empty()) {
+        std::string const sweep_file_path = FLAGS_S;
+        sweepMain(config, sweep_file_path.c_str());
+        return;
+    }
+    if (!FLAGS_batch.empty() || !FLAGS_serve.empty()) {
+        batchMain(config);
+        return;
+    }
     SInC* sinc = nullptr;
     if (1.0 > FLAGS_o) {
         sinc = new SincWithCache(config);
@@ -195,3 +384,75 @@ void Main::sincMain(int argc, char** argv) {
     sinc->run();
     delete sinc;
 }
+
+void Main::sweepMain(SincConfig* baseConfig, const char* sweepFilePath) {
+    std::vector<SincConfig*> configs;
+    SimpleKb* kb = nullptr;
+    try {
+        configs = parseSweepConfigs(*baseConfig, sweepFilePath);
+        uint64_t const time_start = currentTimeInNano();
+        kb = new SimpleKb(baseConfig->kbName, baseConfig->basePath);
+        std::cout << "KB loaded in " << NANO_TO_MILL(currentTimeInNano() - time_start) << " ms" << std::endl;
+    } catch (std::exception const& e) {
+        std::cout << e.what() << std::endl;
+        std::cout << "Sweep failed. Abort." << std::endl;
+        for (SincConfig* const& config: configs) {
+            delete config;
+        }
+        delete baseConfig;
+        return;
+    }
+
+    /* The configurations are run back-to-back, as the entailment of the shared KB is cleared by each of them */
+    std::ofstream summary(baseConfig->dumpPath / (std::string(baseConfig->dumpName) + "_sweep.tsv"), std::ios::out);
+    summary << "#\tOutput\tBeamwidth\tMetric\tFact Coverage\tConstant Coverage\tStop Ratio\tObservation Ratio\tSample Ratio\t"
+        "Rules\tHypothesis Size\tNecessary\tCounterexamples\tSupplementary\tTime (ms)\n";
+    for (int i = 0; i < configs.size(); i++) {
+        SincConfig* const config = configs[i];
+        std::string const dump_name(config->dumpName);
+        summary << i << '\t' << dump_name << '\t' << config->beamwidth << '\t' << EvalMetric::getSymbol(config->evalMetric) << '\t'
+            << config->minFactCoverage << '\t' << config->minConstantCoverage << '\t' << config->stopCompressionRatio << '\t'
+            << config->observationRatio << '\t' << config->evalSampleRatio << '\t';
+        uint64_t const time_start = currentTimeInNano();
+        SInC* sinc = nullptr;
+        if (1.0 > config->observationRatio) {
+            sinc = new SincWithCache(config, kb, true);
+        } else {
+            sinc = new SincWithEstimation(config, kb, true);
+        }
+        sinc->run();
+        SimpleCompressedKb& ckb = sinc->getCompressedKb();
+        summary << ckb.getHypothesis().size() << '\t' << ckb.totalHypothesisSize() << '\t' << ckb.totalNecessaryRecords() << '\t'
+            << ckb.totalCounterexamples() << '\t' << ckb.totalSupplementaryConstants() << '\t'
+            << NANO_TO_MILL(currentTimeInNano() - time_start) << std::endl;
+        delete sinc;
+        std::cout << "Sweep configuration done (" << i + 1 << '/' << configs.size() << "): " << dump_name << std::endl;
+    }
+    summary.close();
+    CompliedBlock::clearPool();
+    delete kb;
+    delete baseConfig;
+}
+
+void Main::batchMain(SincConfig* baseConfig) {
+    int workers = FLAGS_workers;
+    if (0 == workers) {
+        workers = std::max(1, (int) std::thread::hardware_concurrency() / FLAGS_t);
+    }
+    std::ofstream summary(baseConfig->dumpPath / (std::string(baseConfig->dumpName) + "_batch.tsv"), std::ios::out);
+    SincBatch batch(workers, FLAGS_batch_mem, parseJobConfig, summary);
+    std::cout << "Batch workers: " << workers << std::endl;
+    try {
+        std::vector<BatchJobResult> results = FLAGS_batch.empty() ? batch.serve(FLAGS_serve) : batch.runManifest(FLAGS_batch);
+        int succeeded = 0;
+        for (BatchJobResult const& result: results) {
+            succeeded += result.succeeded ? 1 : 0;
+        }
+        std::cout << "Batch done: " << succeeded << '/' << results.size() << " jobs succeeded" << std::endl;
+    } catch (std::exception const& e) {
+        std::cout << e.what() << std::endl;
+        std::cout << "Batch failed. Abort." << std::endl;
+    }
+    summary.close();
+    delete baseConfig;
+}
\ No newline at end of file
@@ -11,6 +11,58 @@ namespace sinc {
     class Main {
     public:
         static SincConfig* parseConfig(int argc, char** argv);
+
+        /**
+         * Parse the configurations of a parameter sweep. Each non-empty line in the sweep file (except those starting with
+         * '#') lists the options of one configuration, which override the options in the command line. Options '-I' and
+         * '-O' are ignored in the file. The i-th configuration dumps to '<output name>_<i>' in the output path of
+         * `baseConfig`.
+         *
+         * NOTE: The configurations SHOULD be released by USER.
+         *
+         * @throws SincException Sweep file open failure
+         * @since 2.6
+         */
+        static std::vector<SincConfig*> parseSweepConfigs(SincConfig const& baseConfig, const char* sweepFilePath);
+
+        /**
+         * Parse the options of a batch job, which override the options in the command line. Unlike `parseConfig()`,
+         * invalid options do not terminate the process.
+         *
+         * NOTE: The configuration SHOULD be released by USER.
+         *
+         * @param jobLine The options of the job, separated by white spaces
+         * @param error   The reason if the options are invalid
+         * @return The configuration, or NULL if the options are invalid
+         * @since 2.6
+         */
+        static SincConfig* parseJobConfig(std::string const& jobLine, std::string& error);
+
         static void sincMain(int argc, char** argv);
+
+        /**
+         * Run the configurations of a parameter sweep back-to-back. The KB is loaded and indexed only once and is shared by
+         * all configurations. The CBs of the KB relations are also kept across the configurations. A summary of the
+         * configurations is written to '<output name>_sweep.tsv' in the output path.
+         *
+         * @since 2.6
+         */
+        static void sweepMain(SincConfig* baseConfig, const char* sweepFilePath);
+
+        /**
+         * Run the jobs in the manifest of '--batch', or those sent to the socket of '--serve', by a `SincBatch`. Results of
+         * the jobs are written to '<output name>_batch.tsv' in the output path.
+         *
+         * @since 2.6
+         */
+        static void batchMain(SincConfig* baseConfig);
+
+    protected:
+        /**
+         * Create a configuration object by the current values of the command line flags.
+         *
+         * @since 2.6
+         */
+        static SincConfig* createConfig();
     };
 }
\ No newline at end of file
@@ -0,0 +1,452 @@
+#include "sincBatch.h"
+#include "sincWithCache.h"
+#include "sincWithEstimation.h"
+#include <fstream>
+#include <cstring>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Helpers of pipes and sockets
+ */
+static bool writeFully(int const fd, void const* const buf, size_t const length) {
+    char const* ptr = (char const*) buf;
+    size_t written = 0;
+    while (written < length) {
+        ssize_t const n = write(fd, ptr + written, length - written);
+        if (0 > n) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        written += n;
+    }
+    return true;
+}
+
+static bool readFully(int const fd, void* const buf, size_t const length) {
+    char* ptr = (char*) buf;
+    size_t read_bytes = 0;
+    while (read_bytes < length) {
+        ssize_t const n = read(fd, ptr + read_bytes, length - read_bytes);
+        if (0 > n) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        if (0 == n) {
+            return false;
+        }
+        read_bytes += n;
+    }
+    return true;
+}
+
+static void reply(int const clientFd, std::string const& msg) {
+    send(clientFd, msg.c_str(), msg.length(), MSG_NOSIGNAL);
+}
+
+static std::string trim(std::string const& line) {
+    size_t const start = line.find_first_not_of(" \t\r");
+    if (std::string::npos == start) {
+        return "";
+    }
+    return line.substr(start, line.find_last_not_of(" \t\r") - start + 1);
+}
+
+/**
+ * SincBatch
+ */
+using sinc::SincBatch;
+using sinc::BatchJobResult;
+
+SincBatch::SincBatch(int const workers, int const _memBudgetGb, parserType _parser, std::ostream& _summary) :
+    numWorkers(std::max(1, workers)), memBudgetGb(_memBudgetGb), parser(_parser), summary(_summary) {}
+
+SincBatch::~SincBatch() {
+    closeListener();
+    shutdownWorkers();
+}
+
+std::vector<BatchJobResult> SincBatch::runManifest(fs::path const& manifestPath) {
+    std::ifstream manifest(manifestPath);
+    if (!manifest.good()) {
+        throw SincException("Manifest open failed: " + manifestPath.string());
+    }
+    std::string line;
+    int line_num = 0;
+    while (std::getline(manifest, line)) {
+        line_num++;
+        std::string const job_line = trim(line);
+        if (job_line.empty() || '#' == job_line[0]) {
+            continue;
+        }
+        std::string error;
+        if (0 > submit(job_line, error)) {
+            std::cerr << "Invalid job at line " << line_num << ": " << error << std::endl;
+        }
+    }
+    manifest.close();
+
+    startWorkers();
+    process();
+    shutdownWorkers();
+    return results;
+}
+
+std::vector<BatchJobResult> SincBatch::serve(fs::path const& socketPath) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::string const path_str = socketPath.string();
+    if (sizeof(addr.sun_path) <= path_str.length()) {
+        throw SincException("Socket path too long: " + path_str);
+    }
+    std::strncpy(addr.sun_path, path_str.c_str(), sizeof(addr.sun_path) - 1);
+    fs::remove(socketPath);
+
+    /* Fork the workers before listening so that they do not inherit the socket */
+    startWorkers();
+    listenerFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (0 > listenerFd || 0 != bind(listenerFd, (sockaddr*) &addr, sizeof(addr)) || 0 != listen(listenerFd, SOMAXCONN)) {
+        closeListener();
+        shutdownWorkers();
+        throw SincException("Socket creation failed: " + path_str);
+    }
+    process();
+    shutdownWorkers();
+    fs::remove(socketPath);
+    return results;
+}
+
+int SincBatch::submit(std::string const& jobLine, std::string& error) {
+    if (MAX_JOB_LENGTH < jobLine.length()) {
+        error = "Job too long";
+        return -1;
+    }
+    SincConfig* config = parser(jobLine, error);
+    if (nullptr == config) {
+        return -1;
+    }
+    pendingJobs.push_back(Job{nextJobId, jobLine, config->maxMemGByte});
+    delete config;
+    return nextJobId++;
+}
+
+void SincBatch::startWorkers() {
+    if (!workers.empty()) {
+        return;
+    }
+
+    /* Writing jobs to a crashed worker should fail instead of terminating the batch */
+    signal(SIGPIPE, SIG_IGN);
+    if (0 != pipe(resultFds)) {
+        throw SincException("Result pipe creation failed");
+    }
+    workers.resize(numWorkers, Worker{-1, -1, -1, 0, ""});
+    summary << "#\tStatus\tWorker\tTime (ms)\tHypothesis Size\tNecessary\tCounterexamples\tJob" << std::endl;
+    for (int i = 0; i < numWorkers; i++) {
+        spawnWorker(i);
+    }
+}
+
+void SincBatch::spawnWorker(int const idx) {
+    int job_fds[2];
+    if (0 != pipe(job_fds)) {
+        throw SincException("Job pipe creation failed");
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t const pid = fork();
+    if (0 > pid) {
+        close(job_fds[0]);
+        close(job_fds[1]);
+        throw SincException("Worker creation failed");
+    }
+    if (0 == pid) {
+        /* Close the descriptors of the batch, otherwise the other workers never see their pipes closed */
+        close(job_fds[1]);
+        close(resultFds[0]);
+        for (Worker const& worker: workers) {
+            if (0 <= worker.jobFd) {
+                close(worker.jobFd);
+            }
+        }
+        if (0 <= listenerFd) {
+            close(listenerFd);
+        }
+        for (std::pair<const int, std::string> const& kv: clients) {
+            close(kv.first);
+        }
+        workerLoop(job_fds[0], idx);
+    }
+    close(job_fds[0]);
+    Worker& worker = workers[idx];
+    worker.pid = pid;
+    worker.jobFd = job_fds[1];
+    worker.jobId = -1;
+    worker.memBudgetGb = 0;
+    worker.jobLine.clear();
+}
+
+void SincBatch::workerLoop(int const jobFd, int const idx) {
+    signal(SIGPIPE, SIG_DFL);
+    int job_id;
+    int length;
+    char buf[MAX_JOB_LENGTH];
+    while (
+        readFully(jobFd, &job_id, sizeof(job_id)) && readFully(jobFd, &length, sizeof(length)) && 0 <= length &&
+        MAX_JOB_LENGTH >= length && readFully(jobFd, buf, length)
+    ) {
+        BatchJobResult result = runJob(job_id, std::string(buf, length));
+        result.worker = idx;
+        std::cout.flush();
+        std::cerr.flush();
+        writeFully(resultFds[1], &result, sizeof(result));   // Writes no larger than `PIPE_BUF` are atomic
+    }
+    close(jobFd);
+    close(resultFds[1]);
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(0);   // The worker SHOULD NOT return to the caller of the batch
+}
+
+BatchJobResult SincBatch::runJob(int const jobId, std::string const& jobLine) const {
+    BatchJobResult result{jobId, -1, false, 0, 0, 0, 0};
+    uint64_t const time_start = currentTimeInNano();
+    std::string error;
+    SincConfig* config = parser(jobLine, error);
+    if (nullptr == config) {
+        std::cerr << "Invalid job " << jobId << ": " << error << std::endl;
+        return result;
+    }
+    SInC* sinc = nullptr;
+    try {
+        SimpleKb* kb = new SimpleKb(config->kbName, config->basePath);
+        if (0 == kb->totalRelations()) {
+            std::cerr << "Empty or missing KB in job " << jobId << ": " << config->kbName << std::endl;
+            delete kb;
+            delete config;
+            return result;
+        }
+        if (1.0 > config->observationRatio) {
+            sinc = new SincWithCache(config, kb);
+        } else {
+            sinc = new SincWithEstimation(config, kb);
+        }
+        sinc->run();
+        SimpleCompressedKb& ckb = sinc->getCompressedKb();
+        result.succeeded = true;
+        result.hypothesisSize = ckb.totalHypothesisSize();
+        result.necessaryRecords = ckb.totalNecessaryRecords();
+        result.counterexamples = ckb.totalCounterexamples();
+    } catch (std::exception const& e) {
+        std::cerr << "Job " << jobId << " failed: " << e.what() << std::endl;
+    }
+    if (nullptr != sinc) {
+        delete sinc;    // The config is released by the SInC object
+    }
+    result.timeMs = NANO_TO_MILL(currentTimeInNano() - time_start);
+    return result;
+}
+
+void SincBatch::dispatch() {
+    for (Worker& worker: workers) {
+        if (pendingJobs.empty()) {
+            return;
+        }
+        if (0 <= worker.jobId || 0 > worker.pid) {
+            continue;
+        }
+        Job const& job = pendingJobs.front();
+        if (0 < memBudgetGb && 0 < runningBudgetGb && memBudgetGb < runningBudgetGb + job.memBudgetGb) {
+            return; // Jobs are started in order, so wait for the memory of the running ones
+        }
+        int const length = job.line.length();
+        if (!writeFully(worker.jobFd, &job.id, sizeof(job.id)) || !writeFully(worker.jobFd, &length, sizeof(length)) ||
+            !writeFully(worker.jobFd, job.line.c_str(), length)) {
+            continue;   // The worker has crashed and will be replaced
+        }
+        worker.jobId = job.id;
+        worker.memBudgetGb = job.memBudgetGb;
+        worker.jobLine = job.line;
+        runningBudgetGb += job.memBudgetGb;
+        pendingJobs.pop_front();
+    }
+}
+
+void SincBatch::process() {
+    while (true) {
+        dispatch();
+        if (0 > listenerFd && pendingJobs.empty() && !hasRunningJobs()) {
+            break;
+        }
+
+        /* Wait for results and requests */
+        std::vector<pollfd> fds;
+        fds.push_back(pollfd{resultFds[0], POLLIN, 0});
+        if (0 <= listenerFd) {
+            fds.push_back(pollfd{listenerFd, POLLIN, 0});
+        }
+        for (std::pair<const int, std::string> const& kv: clients) {
+            fds.push_back(pollfd{kv.first, POLLIN, 0});
+        }
+        if (0 >= poll(fds.data(), fds.size(), POLL_INTERVAL_MS)) {
+            reapWorkers();
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            collectResults(0);
+        }
+        for (int i = 1; i < fds.size(); i++) {
+            if (0 == (fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            if (fds[i].fd == listenerFd) {
+                acceptClient();
+            } else {
+                receiveRequests(fds[i].fd);
+            }
+            if (0 > listenerFd) {
+                break;  // Stopped, and the clients are closed
+            }
+        }
+        reapWorkers();
+    }
+}
+
+void SincBatch::collectResults(int const timeoutMs) {
+    pollfd fd{resultFds[0], POLLIN, 0};
+    BatchJobResult result;
+    while (0 < poll(&fd, 1, timeoutMs) && (fd.revents & POLLIN) && readFully(resultFds[0], &result, sizeof(result))) {
+        finishJob(result);
+    }
+}
+
+void SincBatch::finishJob(BatchJobResult const& result) {
+    if (0 > result.worker || numWorkers <= result.worker) {
+        return;
+    }
+    Worker& worker = workers[result.worker];
+    if (worker.jobId != result.jobId) {
+        return;
+    }
+    summary << result.jobId << '\t' << (result.succeeded ? "OK" : "FAILED") << '\t' << result.worker << '\t' << result.timeMs << '\t'
+        << result.hypothesisSize << '\t' << result.necessaryRecords << '\t' << result.counterexamples << '\t' << worker.jobLine
+        << std::endl;
+    results.push_back(result);
+    runningBudgetGb -= worker.memBudgetGb;
+    worker.jobId = -1;
+    worker.memBudgetGb = 0;
+    worker.jobLine.clear();
+}
+
+void SincBatch::reapWorkers() {
+    for (int i = 0; i < workers.size(); i++) {
+        Worker& worker = workers[i];
+        int status;
+        if (0 > worker.pid || worker.pid != waitpid(worker.pid, &status, WNOHANG)) {
+            continue;
+        }
+
+        /* The result may have been sent before the worker exited */
+        collectResults(0);
+        std::cerr << "Worker " << i << " exited unexpectedly" << std::endl;
+        if (0 <= worker.jobId) {
+            finishJob(BatchJobResult{worker.jobId, i, false, 0, 0, 0, 0});
+        }
+        close(worker.jobFd);
+        worker.pid = -1;
+        worker.jobFd = -1;
+        spawnWorker(i);
+    }
+}
+
+void SincBatch::acceptClient() {
+    int const client_fd = accept(listenerFd, nullptr, nullptr);
+    if (0 <= client_fd) {
+        clients.emplace(client_fd, "");
+    }
+}
+
+void SincBatch::receiveRequests(int const clientFd) {
+    char buf[MAX_JOB_LENGTH];
+    ssize_t const n = read(clientFd, buf, sizeof(buf));
+    if (0 >= n) {
+        close(clientFd);
+        clients.erase(clientFd);
+        return;
+    }
+    std::string& pending = clients[clientFd];
+    pending.append(buf, n);
+    size_t line_end;
+    while (std::string::npos != (line_end = pending.find('\n'))) {
+        std::string const line = trim(pending.substr(0, line_end));
+        pending.erase(0, line_end + 1);
+        if (line.empty() || '#' == line[0]) {
+            continue;
+        }
+        if (0 == line.compare(INTERRUPT_CMD)) {
+            reply(clientFd, "stopping\n");
+            closeListener();
+            return;
+        }
+        std::string error;
+        int const job_id = submit(line, error);
+        reply(clientFd, (0 > job_id) ? ("error " + error + '\n') : ("queued " + std::to_string(job_id) + '\n'));
+    }
+    if (MAX_JOB_LENGTH < pending.length()) {
+        reply(clientFd, "error Job too long\n");
+        close(clientFd);
+        clients.erase(clientFd);
+    }
+}
+
+void SincBatch::closeListener() {
+    if (0 <= listenerFd) {
+        close(listenerFd);
+        listenerFd = -1;
+    }
+    for (std::pair<const int, std::string> const& kv: clients) {
+        close(kv.first);
+    }
+    clients.clear();
+}
+
+void SincBatch::shutdownWorkers() {
+    for (Worker& worker: workers) {
+        if (0 <= worker.jobFd) {
+            close(worker.jobFd);
+            worker.jobFd = -1;
+        }
+    }
+    for (Worker& worker: workers) {
+        if (0 < worker.pid) {
+            int status;
+            waitpid(worker.pid, &status, 0);
+            worker.pid = -1;
+        }
+    }
+    workers.clear();
+    for (int i = 0; i < 2; i++) {
+        if (0 <= resultFds[i]) {
+            close(resultFds[i]);
+            resultFds[i] = -1;
+        }
+    }
+}
+
+bool SincBatch::hasRunningJobs() const {
+    for (Worker const& worker: workers) {
+        if (0 <= worker.jobId) {
+            return true;
+        }
+    }
+    return false;
+}
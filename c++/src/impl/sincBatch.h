@@ -0,0 +1,159 @@
+#pragma once
+
+#include "../base/sinc.h"
+#include <deque>
+#include <functional>
+#include <sys/types.h>
+
+namespace sinc {
+    /**
+     * The result of a compression job in a `SincBatch`. This is sent from the worker processes to the batch through a
+     * pipe, and thus only contains plain values.
+     *
+     * @since 2.6
+     */
+    struct BatchJobResult {
+        /** The ID of the job, in the order of submission */
+        int jobId;
+        /** The index of the worker that ran the job */
+        int worker;
+        /** Whether the compressed KB is dumped. A job fails if its KB cannot be loaded or its worker crashes */
+        bool succeeded;
+        /** The wall-clock time (ms) of the job, including the time of loading the KB */
+        uint64_t timeMs;
+        int hypothesisSize;
+        int necessaryRecords;
+        int counterexamples;
+    };
+
+    /**
+     * Compress multiple KBs by a pool of worker processes. Each job is a line of command line options (e.g., "-I path,kb
+     * -O out,kb_comp -M 4") and is run by `SincWithCache` or `SincWithEstimation` on a KB loaded in a worker.
+     *
+     * Workers are processes instead of threads, as SInC keeps some states process-wide (e.g., the CB pool, the coverage
+     * thresholds and the redirection of `std::cout`). A worker runs its jobs one after another, so the memory freed by a
+     * job stays in the heap (and the allocator arenas) of the worker and is reused by the next one. The jobs are started
+     * in the order of submission when a worker is idle and the memory budgets ('-M') of the running jobs leave room for
+     * it. A crashed worker fails its job and is replaced by a new one.
+     *
+     * NOTE: The process SHOULD NOT have other threads when the batch starts, as the workers are forked.
+     *
+     * @since 2.6
+     */
+    class SincBatch {
+    public:
+        /** Parse a job into a configuration, or return NULL and write the reason to `error` if the job is invalid */
+        typedef std::function<SincConfig*(std::string const& jobLine, std::string& error)> parserType;
+
+        /** Jobs longer than this are rejected */
+        static constexpr int MAX_JOB_LENGTH = 4096;
+        /** The interval (ms) of checking crashed workers and socket requests */
+        static constexpr int POLL_INTERVAL_MS = 200;
+
+        /**
+         * @param workers     The number of worker processes
+         * @param memBudgetGb The total memory budget (GB) of the running jobs. 0 means no limit
+         * @param parser      The parser of jobs. It is called by the batch to check the jobs and by the workers to run them
+         * @param summary     Results of the jobs are written to this stream, one line per job
+         */
+        SincBatch(int const workers, int const memBudgetGb, parserType parser, std::ostream& summary);
+
+        ~SincBatch();
+
+        /**
+         * Run the jobs in a manifest file, one per line. Empty lines and those starting with '#' are skipped. Invalid jobs
+         * are reported to `std::cerr` and skipped.
+         *
+         * @return The results of the jobs, in the order they are finished
+         * @throws SincException Manifest open or worker creation failure
+         */
+        std::vector<BatchJobResult> runManifest(fs::path const& manifestPath);
+
+        /**
+         * Serve jobs sent to a Unix socket, one per line. The reply to each job is "queued <job ID>" or "error <reason>".
+         * After "stop" is received, the server stops accepting jobs and returns when the queued jobs are done.
+         *
+         * @return The results of the jobs, in the order they are finished
+         * @throws SincException Socket or worker creation failure
+         */
+        std::vector<BatchJobResult> serve(fs::path const& socketPath);
+
+    protected:
+        struct Job {
+            int id;
+            std::string line;
+            int memBudgetGb;
+        };
+
+        struct Worker {
+            pid_t pid;
+            /** The write end of the pipe sending jobs to the worker */
+            int jobFd;
+            /** The job ID the worker is running, -1 if idle */
+            int jobId;
+            int memBudgetGb;
+            std::string jobLine;
+        };
+
+        int const numWorkers;
+        int const memBudgetGb;
+        parserType parser;
+        std::ostream& summary;
+        std::vector<Worker> workers;
+        std::deque<Job> pendingJobs;
+        std::vector<BatchJobResult> results;
+        /** The pipe through which the workers send `BatchJobResult` back */
+        int resultFds[2]{-1, -1};
+        int nextJobId = 0;
+        int runningBudgetGb = 0;
+        /** The socket accepting clients. -1 if not serving or stopped */
+        int listenerFd = -1;
+        /** The connected clients and their unfinished lines */
+        std::unordered_map<int, std::string> clients;
+
+        /**
+         * Parse a job and queue it.
+         *
+         * @return The job ID, or -1 if the job is invalid
+         */
+        int submit(std::string const& jobLine, std::string& error);
+
+        void startWorkers();
+        void spawnWorker(int const idx);
+
+        /**
+         * Run the jobs received from the batch until the pipe is closed. This never returns.
+         */
+        [[noreturn]] void workerLoop(int const jobFd, int const idx);
+
+        BatchJobResult runJob(int const jobId, std::string const& jobLine) const;
+
+        /**
+         * Send pending jobs to idle workers.
+         */
+        void dispatch();
+
+        /**
+         * Run until all queued jobs are done and no more job will come.
+         */
+        void process();
+
+        void collectResults(int const timeoutMs);
+        void finishJob(BatchJobResult const& result);
+
+        /**
+         * Replace crashed workers. Their jobs are marked as failed.
+         */
+        void reapWorkers();
+        void acceptClient();
+        void receiveRequests(int const clientFd);
+        void closeListener();
+
+        /**
+         * Close the job pipes and wait for all workers to exit.
+         */
+        void shutdownWorkers();
+
+        bool hasRunningJobs() const;
+    };
+}
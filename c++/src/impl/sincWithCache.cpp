@@ -3,10 +3,13 @@
 #include <cmath>
 #include <algorithm>
 #include <sys/resource.h>
+#include <thread>
+#include <limits>
 
 /** This var is used for calculating the maximum memory cost during evaluation */
-static size_t _evaluation_memory_cost = 0;
+static thread_local size_t _evaluation_memory_cost = 0;
 static double max_gv_bindings = 0;
+static std::mutex max_gv_bindings_mutex;
 
 /**
  * MatchedSubCbs
@@ -107,15 +110,30 @@ size_t std::hash<const CbOprMatchSlicesTwoCbs>::operator()(const CbOprMatchSlice
  * CompliedBlock
  */
 using sinc::CompliedBlock;
+using sinc::CbHolder;
 using sinc::IntTable;
 using sinc::MatchedSubCbs;
 
+CbHolder::CbHolder() {
+    CompliedBlock::registerHolder(this);
+}
+
+CbHolder::~CbHolder() {
+    CompliedBlock::release(*this);
+    CompliedBlock::unregisterHolder(this);
+}
+
 std::vector<CompliedBlock*> CompliedBlock::pool;
+std::vector<int> CompliedBlock::freeIds;
+std::unordered_set<CbHolder*> CompliedBlock::holders;
+std::mutex CompliedBlock::poolMutex;
 std::unordered_map<void*, CompliedBlock*> CompliedBlock::mapCreation;
 std::unordered_map<CbOprGetSlice, CompliedBlock*> CompliedBlock::mapGetSlice;
 std::unordered_map<CbOprSplitSlices, std::vector<CompliedBlock*>*> CompliedBlock::mapSplitSlices;
 std::unordered_map<CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*> CompliedBlock::mapMatchSlicesOneCb;
 std::unordered_map<CbOprMatchSlicesTwoCbs, MatchedSubCbs*> CompliedBlock::mapMatchSlicesTwoCbs;
+std::atomic<size_t> CompliedBlock::poolMemoryCost(0);
+size_t CompliedBlock::retentionBudget = 0;
 size_t CompliedBlock::numCreation = 0;
 size_t CompliedBlock::numCreationHit = 0;
 size_t CompliedBlock::numGetSlice = 0;
@@ -127,150 +145,217 @@ size_t CompliedBlock::numMatchSlices1Hit = 0;
 size_t CompliedBlock::numMatchSlices2 = 0;
 size_t CompliedBlock::numMatchSlices2Hit = 0;
 
+namespace sinc {
+    /**
+     * This table releases the array of rows when it is destroyed. It is only used by the deprecated `CompliedBlock::create()`.
+     */
+    class RowArrayTable : public IntTable {
+    public:
+        RowArrayTable(int** const rows, int const totalRows, int const totalCols, bool const maintainRows) :
+            IntTable(rows, totalRows, totalCols), rows(rows), maintainRows(maintainRows) {}
+
+        ~RowArrayTable() {
+            if (maintainRows) {
+                delete[] rows;
+            }
+        }
+
+    protected:
+        int** const rows;
+        bool const maintainRows;
+    };
+}
+
 CompliedBlock* CompliedBlock::create(int** const complianceSet, int const totalRows, int const totalCols, bool maintainComplianceSet) {
-    // numCreation++;
-    // std::unordered_map<void *, sinc::CompliedBlock*>::iterator itr = mapCreation.find(complianceSet);
-    // if (mapCreation.end() == itr) {
-    //     CompliedBlock* cb = new CompliedBlock(pool.size(), complianceSet, totalRows, totalCols, maintainComplianceSet);
-    //     registerCb(cb);
-    //     mapCreation.emplace(complianceSet, cb);
-    //     return cb;
-    // } else {
-    //     numCreationHit++;
-    //     return itr->second;
-    // }
-    CompliedBlock* cb = new CompliedBlock(pool.size(), complianceSet, totalRows, totalCols, maintainComplianceSet);
+    std::lock_guard<std::mutex> lock(poolMutex);
+    CompliedBlock* cb = new CompliedBlock(
+        allocateId(), new RowArrayTable(complianceSet, totalRows, totalCols, maintainComplianceSet), true
+    );
     registerCb(cb);
     return cb;
 }
 
-CompliedBlock* CompliedBlock::create(
-    int** _complianceSet, int const _totalRows, int const _totalCols, IntTable* _indices,
-    bool _maintainComplianceSet, bool _maintainIndices
-) {
+CompliedBlock* CompliedBlock::create(IntTable* const table, bool maintainTable, CbHolder* const holder) {
+    std::lock_guard<std::mutex> lock(poolMutex);
     numCreation++;
-    std::unordered_map<void *, sinc::CompliedBlock*>::iterator itr = mapCreation.find(_complianceSet);
+    std::unordered_map<void *, sinc::CompliedBlock*>::iterator itr = mapCreation.find(table);
     if (mapCreation.end() == itr) {
-        CompliedBlock* cb = new CompliedBlock(pool.size(), _complianceSet, _totalRows, _totalCols, _indices, _maintainComplianceSet, _maintainIndices);
+        CompliedBlock* cb = new CompliedBlock(allocateId(), table, maintainTable);
         registerCb(cb);
-        mapCreation.emplace(_complianceSet, cb);
+        mapCreation.emplace(table, cb);
+        hold(holder, cb);
         return cb;
     } else {
         numCreationHit++;
+        itr->second->usage++;
+        hold(holder, itr->second);
         return itr->second;
     }
 }
 
-CompliedBlock* CompliedBlock::getSlice(const CompliedBlock& cb, int const col, int const val) {
-    numGetSlice++;
+int* CompliedBlock::sliceRowIds(CompliedBlock const& cb, IntTable::sliceType const& slice) {
+    int const total_rows = slice.size();
+    int* const row_ids = new int[total_rows];
+    for (int i = 0; i < total_rows; i++) {
+        row_ids[i] = cb.base->rowIdOf(slice[i]);
+    }
+    return row_ids;
+}
+
+CompliedBlock* CompliedBlock::createBySlice(CompliedBlock const& cb, int* const rowIds, int const totalRows) {
+    CompliedBlock* new_cb = new CompliedBlock(allocateId(), cb.base, rowIds, totalRows, cb.totalCols);
+    registerCb(new_cb);
+    return new_cb;
+}
+
+CompliedBlock* CompliedBlock::getSlice(const CompliedBlock& cb, int const col, int const val, CbHolder* const holder) {
     CbOprGetSlice opr(cb.id, col, val);
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        numGetSlice++;
+        cb.usage++;
+        std::unordered_map<sinc::CbOprGetSlice, sinc::CompliedBlock*>::iterator itr = mapGetSlice.find(opr);
+        if (mapGetSlice.end() != itr) {
+            numGetSliceHit++;
+            hold(holder, itr->second);
+            return itr->second;
+        }
+    }
+    IntTable::sliceType* slice = cb.getIndices().getSlice(col, val);
+    if (nullptr == slice) {
+        return nullptr;
+    }
+    int const total_rows = slice->size();
+    int* const row_ids = sliceRowIds(cb, *slice);
+    IntTable::releaseSlice(slice);
+
+    std::lock_guard<std::mutex> lock(poolMutex);
     std::unordered_map<sinc::CbOprGetSlice, sinc::CompliedBlock*>::iterator itr = mapGetSlice.find(opr);
-    if (mapGetSlice.end() == itr) {
-        IntTable::sliceType* slice = cb.getIndices().getSlice(col, val);
-        if (nullptr != slice) { // assertion: must be non-empty
-            CompliedBlock* new_cb = new CompliedBlock(pool.size(), toArray<int*>(*slice), slice->size(), cb.totalCols, true);
-            registerCb(new_cb);
-            mapGetSlice.emplace(opr, new_cb);
-            IntTable::releaseSlice(slice);
-            return new_cb;
-        } else {
-            IntTable::releaseSlice(slice);
-            return nullptr;
-        }
-    } else {
-        numGetSliceHit++;
+    if (mapGetSlice.end() != itr) {
+        delete[] row_ids;
+        hold(holder, itr->second);
         return itr->second;
     }
+    CompliedBlock* new_cb = createBySlice(cb, row_ids, total_rows);
+    mapGetSlice.emplace(opr, new_cb);
+    hold(holder, new_cb);
+    return new_cb;
 }
 
-std::vector<CompliedBlock*> const& CompliedBlock::splitSlices(const CompliedBlock& cb, int const col) {
-    numSplitSlices++;
+std::vector<CompliedBlock*> const& CompliedBlock::splitSlices(const CompliedBlock& cb, int const col, CbHolder* const holder) {
     CbOprSplitSlices opr(cb.id, col);
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        numSplitSlices++;
+        cb.usage++;
+        std::unordered_map<sinc::CbOprSplitSlices, std::vector<sinc::CompliedBlock*>*>::iterator itr = mapSplitSlices.find(opr);
+        if (mapSplitSlices.end() != itr) {
+            numSplitSlicesHit++;
+            hold(holder, itr->second);
+            return *(itr->second);
+        }
+    }
+    IntTable::slicesType* slices = cb.getIndices().splitSlices(col);
+    std::vector<std::pair<int*, int>> row_ids;
+    row_ids.reserve(slices->size());
+    for (IntTable::sliceType* slice: *slices) {
+        row_ids.emplace_back(sliceRowIds(cb, *slice), slice->size());
+    }
+    IntTable::releaseSlices(slices);
+
+    std::lock_guard<std::mutex> lock(poolMutex);
     std::unordered_map<sinc::CbOprSplitSlices, std::vector<sinc::CompliedBlock*>*>::iterator itr = mapSplitSlices.find(opr);
-    if (mapSplitSlices.end() == itr) {
-        IntTable::slicesType* slices = cb.getIndices().splitSlices(col);
-        std::vector<CompliedBlock*>* cbs = new std::vector<CompliedBlock*>();
-        cbs->reserve(slices->size());
-        for (IntTable::sliceType* slice: *slices) {
-            CompliedBlock* new_cb = new CompliedBlock(pool.size(), toArray<int*>(*slice), slice->size(), cb.totalCols, true);
-            registerCb(new_cb);
-            cbs->push_back(new_cb);
-        }
-        mapSplitSlices.emplace(opr, cbs);
-        IntTable::releaseSlices(slices);
-        return *cbs;
-    } else {
-        numSplitSlicesHit++;
+    if (mapSplitSlices.end() != itr) {
+        for (std::pair<int*, int> const& ids: row_ids) {
+            delete[] ids.first;
+        }
+        hold(holder, itr->second);
         return *(itr->second);
     }
+    std::vector<CompliedBlock*>* cbs = new std::vector<CompliedBlock*>();
+    cbs->reserve(row_ids.size());
+    for (std::pair<int*, int> const& ids: row_ids) {
+        cbs->push_back(createBySlice(cb, ids.first, ids.second));
+    }
+    mapSplitSlices.emplace(opr, cbs);
+    hold(holder, cbs);
+    return *cbs;
 }
 
 const MatchedSubCbs* CompliedBlock::matchSlices(
-    const CompliedBlock& cb1, int const col1, const CompliedBlock& cb2, int const col2
+    const CompliedBlock& cb1, int const col1, const CompliedBlock& cb2, int const col2, CbHolder* const holder
 ) {
     /* Map symmetric operations into one entry. The CB with smaller ID goes the first */
-    int _id1, _col1, _id2, _col2;
+    CompliedBlock const* _cb1;
+    CompliedBlock const* _cb2;
+    int _col1, _col2;
     if (cb1.id <= cb2.id) {
-        _id1 = cb1.id;
+        _cb1 = &cb1;
         _col1 = col1;
-        _id2 = cb2.id;
+        _cb2 = &cb2;
         _col2 = col2;
     } else {
-        _id1 = cb2.id;
+        _cb1 = &cb2;
         _col1 = col2;
-        _id2 = cb1.id;
+        _cb2 = &cb1;
         _col2 = col1;
     }
-    numMatchSlices2++;
-    CbOprMatchSlicesTwoCbs opr(_id1, _col1, _id2, _col2);
+    CbOprMatchSlicesTwoCbs opr(_cb1->id, _col1, _cb2->id, _col2);
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        numMatchSlices2++;
+        cb1.usage++;
+        cb2.usage++;
+        std::unordered_map<sinc::CbOprMatchSlicesTwoCbs, sinc::MatchedSubCbs*>::iterator itr = mapMatchSlicesTwoCbs.find(opr);
+        if (mapMatchSlicesTwoCbs.end() != itr) {
+            numMatchSlices2Hit++;
+            hold(holder, itr->second);
+            return itr->second;
+        }
+    }
+    MatchedSubTables* slices = IntTable::matchSlices(_cb1->getIndices(), _col1, _cb2->getIndices(), _col2);
+    int const num_slices = slices->slices1->size();
+    std::vector<std::pair<int*, int>> row_ids1;
+    std::vector<std::pair<int*, int>> row_ids2;
+    row_ids1.reserve(num_slices);
+    row_ids2.reserve(num_slices);
+    for (int i = 0; i < num_slices; i++) {
+        IntTable::sliceType const& slice1 = *(*(slices->slices1))[i];
+        IntTable::sliceType const& slice2 = *(*(slices->slices2))[i];
+        row_ids1.emplace_back(sliceRowIds(*_cb1, slice1), slice1.size());
+        row_ids2.emplace_back(sliceRowIds(*_cb2, slice2), slice2.size());
+    }
+    delete slices;
+
+    std::lock_guard<std::mutex> lock(poolMutex);
     std::unordered_map<sinc::CbOprMatchSlicesTwoCbs, sinc::MatchedSubCbs*>::iterator itr = mapMatchSlicesTwoCbs.find(opr);
-    if (mapMatchSlicesTwoCbs.end() == itr) {
-        MatchedSubTables* slices;
-        int arity1;
-        int arity2;
-        if (cb1.id <= cb2.id) {
-            slices = IntTable::matchSlices(cb1.getIndices(), col1, cb2.getIndices(), col2);
-            arity1 = cb1.totalCols;
-            arity2 = cb2.totalCols;
-        } else {
-            slices = IntTable::matchSlices(cb2.getIndices(), col2, cb1.getIndices(), col1);
-            arity1 = cb2.totalCols;
-            arity2 = cb1.totalCols;
-        }
-        int const num_slices = slices->slices1->size();
-        if (0 == num_slices) {
-            mapMatchSlicesTwoCbs.emplace(opr, nullptr);
-            delete slices;
-            return nullptr;
-        }
-        MatchedSubCbs* sub_cbs = new MatchedSubCbs();
-        sub_cbs->cbs1.reserve(num_slices);
-        sub_cbs->cbs2.reserve(num_slices);
+    if (mapMatchSlicesTwoCbs.end() != itr) {
         for (int i = 0; i < num_slices; i++) {
-            IntTable::sliceType& slice1 = *(*(slices->slices1))[i];
-            CompliedBlock* new_cb1 = new CompliedBlock(
-                pool.size(), toArray<int*>(slice1), slice1.size(), arity1, true
-            );
-            registerCb(new_cb1);
-            sub_cbs->cbs1.push_back(new_cb1);
-
-            IntTable::sliceType& slice2 = *(*(slices->slices2))[i];
-            CompliedBlock* new_cb2 = new CompliedBlock(
-                pool.size(), toArray<int*>(slice2), slice2.size(), arity2, true
-            );
-            registerCb(new_cb2);
-            sub_cbs->cbs2.push_back(new_cb2);
+            delete[] row_ids1[i].first;
+            delete[] row_ids2[i].first;
         }
-        mapMatchSlicesTwoCbs.emplace(opr, sub_cbs);
-        delete slices;
-        return sub_cbs;
-    } else {
-        numMatchSlices2Hit++;
+        hold(holder, itr->second);
         return itr->second;
     }
+    if (0 == num_slices) {
+        mapMatchSlicesTwoCbs.emplace(opr, nullptr);
+        return nullptr;
+    }
+    MatchedSubCbs* sub_cbs = new MatchedSubCbs();
+    sub_cbs->cbs1.reserve(num_slices);
+    sub_cbs->cbs2.reserve(num_slices);
+    for (int i = 0; i < num_slices; i++) {
+        sub_cbs->cbs1.push_back(createBySlice(*_cb1, row_ids1[i].first, row_ids1[i].second));
+        sub_cbs->cbs2.push_back(createBySlice(*_cb2, row_ids2[i].first, row_ids2[i].second));
+    }
+    mapMatchSlicesTwoCbs.emplace(opr, sub_cbs);
+    hold(holder, sub_cbs);
+    return sub_cbs;
 }
 
-const std::vector<CompliedBlock*>* CompliedBlock::matchSlices(const CompliedBlock& cb, int const col1, int const col2) {
+const std::vector<CompliedBlock*>* CompliedBlock::matchSlices(
+    const CompliedBlock& cb, int const col1, int const col2, CbHolder* const holder
+) {
     int _col1, _col2;
     if (col1 <= col2) {
         _col1 = col1;
@@ -279,33 +364,51 @@ const std::vector<CompliedBlock*>* CompliedBlock::matchSlices(const CompliedBloc
         _col1 = col2;
         _col2 = col1;
     }
-    numMatchSlices1++;
     CbOprMatchSlicesOneCb opr(cb.id, _col1, _col2);
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        numMatchSlices1++;
+        cb.usage++;
+        std::unordered_map<sinc::CbOprMatchSlicesOneCb, std::vector<sinc::CompliedBlock*>*>::iterator itr = mapMatchSlicesOneCb.find(opr);
+        if (mapMatchSlicesOneCb.end() != itr) {
+            numMatchSlices1Hit++;
+            hold(holder, itr->second);
+            return itr->second;
+        }
+    }
+    IntTable::slicesType* slices = cb.getIndices().matchSlices(col1, col2);
+    std::vector<std::pair<int*, int>> row_ids;
+    row_ids.reserve(slices->size());
+    for (IntTable::sliceType* const& slice: *slices) {
+        row_ids.emplace_back(sliceRowIds(cb, *slice), slice->size());
+    }
+    IntTable::releaseSlices(slices);
+
+    std::lock_guard<std::mutex> lock(poolMutex);
     std::unordered_map<sinc::CbOprMatchSlicesOneCb, std::vector<sinc::CompliedBlock*>*>::iterator itr = mapMatchSlicesOneCb.find(opr);
-    if (mapMatchSlicesOneCb.end() == itr) {
-        IntTable::slicesType* slices = cb.getIndices().matchSlices(col1, col2);
-        if (slices->empty()) {
-            mapMatchSlicesOneCb.emplace(opr, nullptr);
-            IntTable::releaseSlices(slices);
-            return nullptr;
-        }
-        std::vector<CompliedBlock*>* sub_cbs = new std::vector<CompliedBlock*>();
-        sub_cbs->reserve(slices->size());
-        for (IntTable::sliceType* const& slice: *slices) {
-            CompliedBlock* new_cb = new CompliedBlock(pool.size(), toArray<int*>(*slice), slice->size(), cb.totalCols, true);
-            registerCb(new_cb);
-            sub_cbs->push_back(new_cb);
-        }
-        mapMatchSlicesOneCb.emplace(opr, sub_cbs);
-        IntTable::releaseSlices(slices);
-        return sub_cbs;
-    } else {
-        numMatchSlices1Hit++;
+    if (mapMatchSlicesOneCb.end() != itr) {
+        for (std::pair<int*, int> const& ids: row_ids) {
+            delete[] ids.first;
+        }
+        hold(holder, itr->second);
         return itr->second;
     }
+    if (row_ids.empty()) {
+        mapMatchSlicesOneCb.emplace(opr, nullptr);
+        return nullptr;
+    }
+    std::vector<CompliedBlock*>* sub_cbs = new std::vector<CompliedBlock*>();
+    sub_cbs->reserve(row_ids.size());
+    for (std::pair<int*, int> const& ids: row_ids) {
+        sub_cbs->push_back(createBySlice(cb, ids.first, ids.second));
+    }
+    mapMatchSlicesOneCb.emplace(opr, sub_cbs);
+    hold(holder, sub_cbs);
+    return sub_cbs;
 }
 
 void CompliedBlock::reserveMemSpace(SimpleKb const& kb) {
+    std::lock_guard<std::mutex> lock(poolMutex);
     int num_relations = kb.totalRelations();
     mapCreation.reserve(num_relations);
     std::vector<SimpleRelation*> const& relations = *(kb.getRelations());
@@ -337,11 +440,40 @@ void CompliedBlock::reserveMemSpace(SimpleKb const& kb) {
     pool.reserve(est_pool_size);
 }
 
-void CompliedBlock::clearPool() {
-    for (CompliedBlock* const& cbp: pool) {
-        delete cbp;
+void CompliedBlock::clearPool(bool const retainBaseCbs) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    std::unordered_map<void*, CompliedBlock*> retained_creation;
+    std::unordered_map<CbOprGetSlice, CompliedBlock*> retained_get_slice;
+    std::unordered_map<CbOprSplitSlices, std::vector<CompliedBlock*>*> retained_split_slices;
+    std::unordered_map<CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*> retained_match_slices_one_cb;
+    std::unordered_map<CbOprMatchSlicesTwoCbs, MatchedSubCbs*> retained_match_slices_two_cbs;
+    std::vector<bool> const retained = (retainBaseCbs && 0 < retentionBudget) ? selectRetainedCbs(
+        retained_creation, retained_get_slice, retained_split_slices, retained_match_slices_one_cb, retained_match_slices_two_cbs
+    ) : std::vector<bool>(pool.size(), false);
+
+    /* Retained CBs are renumbered in their original order, so the symmetric operations keep the smaller ID first */
+    std::vector<int> new_ids(pool.size(), -1);
+    std::vector<CompliedBlock*> retained_cbs;
+    size_t retained_cost = 0;
+    for (int old_id = 0; old_id < pool.size(); old_id++) {
+        CompliedBlock* const cbp = pool[old_id];
+        if (retained[old_id]) {
+            new_ids[old_id] = retained_cbs.size();
+            cbp->id = retained_cbs.size();
+            cbp->usage /= 2;    // Recent usage weighs more
+            cbp->references = 0;
+            cbp->retained = true;
+            retained_cbs.push_back(cbp);
+            retained_cost += cbp->memoryCost() + sizeof(CompliedBlock*);
+        } else {
+            delete cbp;
+        }
     }
     pool.clear();
+    freeIds.clear();
+    for (CbHolder* const& holder: holders) {
+        holder->cbs.clear();
+    }
     mapCreation.clear();
     mapGetSlice.clear();
     for (std::pair<const CbOprSplitSlices, std::vector<CompliedBlock*>*> const& kv: mapSplitSlices) {
@@ -360,76 +492,486 @@ void CompliedBlock::clearPool() {
         }
     }
     mapMatchSlicesTwoCbs.clear();
+
+    /* Restore the retained CBs and their operations with the new IDs */
+    pool.insert(pool.end(), retained_cbs.begin(), retained_cbs.end());
+    mapCreation.insert(retained_creation.begin(), retained_creation.end());
+    for (std::pair<const CbOprGetSlice, CompliedBlock*> const& kv: retained_get_slice) {
+        mapGetSlice.emplace(CbOprGetSlice(new_ids[kv.first.id], kv.first.col, kv.first.val), kv.second);
+    }
+    for (std::pair<const CbOprSplitSlices, std::vector<CompliedBlock*>*> const& kv: retained_split_slices) {
+        mapSplitSlices.emplace(CbOprSplitSlices(new_ids[kv.first.id], kv.first.col), kv.second);
+    }
+    for (std::pair<const CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*> const& kv: retained_match_slices_one_cb) {
+        mapMatchSlicesOneCb.emplace(CbOprMatchSlicesOneCb(new_ids[kv.first.id], kv.first.col1, kv.first.col2), kv.second);
+    }
+    for (std::pair<const CbOprMatchSlicesTwoCbs, MatchedSubCbs*> const& kv: retained_match_slices_two_cbs) {
+        mapMatchSlicesTwoCbs.emplace(
+            CbOprMatchSlicesTwoCbs(new_ids[kv.first.id1], kv.first.col1, new_ids[kv.first.id2], kv.first.col2), kv.second
+        );
+    }
+    poolMemoryCost = retained_cost;
+}
+
+void CompliedBlock::release(CbHolder& holder) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    std::vector<CompliedBlock*> unheld;
+    for (CompliedBlock* const& cb: holder.cbs) {
+        cb->references--;
+        if (0 == cb->references) {
+            unheld.push_back(cb);
+        }
+    }
+    holder.cbs.clear();
+    if (unheld.empty()) {
+        return;
+    }
+
+    /* The previously retained CBs are selected again together with the released ones */
+    for (CompliedBlock* const& cb: pool) {
+        if (nullptr != cb && cb->retained) {
+            unheld.push_back(cb);
+        }
+    }
+    retainUnheldCbs(unheld);
+    std::vector<bool> removed(pool.size(), false);
+    for (CompliedBlock* const& cb: unheld) {
+        removed[cb->id] = !cb->retained;
+    }
+    removeCbs(removed);
+}
+
+void CompliedBlock::retainUnheldCbs(std::vector<CompliedBlock*> const& unheld) {
+    for (CompliedBlock* const& cb: unheld) {
+        cb->retained = false;
+    }
+    if (0 == retentionBudget) {
+        return;
+    }
+    std::vector<bool> is_unheld(pool.size(), false);
+    for (CompliedBlock* const& cb: unheld) {
+        is_unheld[cb->id] = true;
+    }
+
+    /* Group the unheld results of the operations by the operated CBs */
+    std::unordered_map<int, std::vector<CompliedBlock*>> single_cb_results;
+    std::vector<std::pair<std::pair<int, int>, std::vector<CompliedBlock*>>> two_cbs_results;
+    std::unordered_map<int, std::vector<int>> two_cbs_result_idxs;
+    auto add_unheld = [&is_unheld](std::vector<CompliedBlock*>& results, std::vector<CompliedBlock*> const& cbs) {
+        for (CompliedBlock* const& cb: cbs) {
+            if (is_unheld[cb->id]) {
+                results.push_back(cb);
+            }
+        }
+    };
+    for (std::pair<const CbOprGetSlice, CompliedBlock*> const& kv: mapGetSlice) {
+        if (is_unheld[kv.second->id]) {
+            single_cb_results[kv.first.id].push_back(kv.second);
+        }
+    }
+    for (std::pair<const CbOprSplitSlices, std::vector<CompliedBlock*>*> const& kv: mapSplitSlices) {
+        add_unheld(single_cb_results[kv.first.id], *(kv.second));
+    }
+    for (std::pair<const CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*> const& kv: mapMatchSlicesOneCb) {
+        if (nullptr != kv.second) {
+            add_unheld(single_cb_results[kv.first.id], *(kv.second));
+        }
+    }
+    for (std::pair<const CbOprMatchSlicesTwoCbs, MatchedSubCbs*> const& kv: mapMatchSlicesTwoCbs) {
+        if (nullptr != kv.second) {
+            two_cbs_result_idxs[kv.first.id1].push_back(two_cbs_results.size());
+            if (kv.first.id1 != kv.first.id2) {
+                two_cbs_result_idxs[kv.first.id2].push_back(two_cbs_results.size());
+            }
+            two_cbs_results.emplace_back(std::pair<int, int>(kv.first.id1, kv.first.id2), std::vector<CompliedBlock*>());
+            add_unheld(two_cbs_results.back().second, kv.second->cbs1);
+            add_unheld(two_cbs_results.back().second, kv.second->cbs2);
+        }
+    }
+
+    /* Keep the most frequently used base CBs within the budget. Held base CBs cost nothing but their unheld results */
+    std::vector<CompliedBlock*> bases;
+    for (std::pair<void* const, CompliedBlock*> const& kv: mapCreation) {
+        if (!kv.second->maintainBase) {
+            bases.push_back(kv.second);
+        }
+    }
+    std::sort(bases.begin(), bases.end(), [](CompliedBlock* const& a, CompliedBlock* const& b) {
+        return (a->usage != b->usage) ? a->usage > b->usage : a->id < b->id;
+    });
+    auto cost_of = [&is_unheld](CompliedBlock* const& cb) {
+        return is_unheld[cb->id] ? cb->memoryCost() + sizeof(CompliedBlock*) : 0;
+    };
+    std::vector<bool> selected(pool.size(), false);
+    size_t retained_cost = 0;
+    std::vector<CompliedBlock*> kept;
+    for (CompliedBlock* const& base: bases) {
+        kept.clear();
+        kept.push_back(base);
+        std::unordered_map<int, std::vector<CompliedBlock*>>::const_iterator single_itr = single_cb_results.find(base->id);
+        if (single_cb_results.end() != single_itr) {
+            kept.insert(kept.end(), single_itr->second.begin(), single_itr->second.end());
+        }
+        std::unordered_map<int, std::vector<int>>::const_iterator two_itr = two_cbs_result_idxs.find(base->id);
+        if (two_cbs_result_idxs.end() != two_itr) {
+            for (int const& idx: two_itr->second) {
+                std::pair<std::pair<int, int>, std::vector<CompliedBlock*>> const& results = two_cbs_results[idx];
+                int const another_id = (base->id == results.first.first) ? results.first.second : results.first.first;
+                if (base->id == another_id || selected[another_id]) {
+                    kept.insert(kept.end(), results.second.begin(), results.second.end());
+                }
+            }
+        }
+        size_t cost = 0;
+        for (CompliedBlock* const& cb: kept) {
+            cost += cost_of(cb);
+        }
+        if (retained_cost + cost <= retentionBudget) {
+            retained_cost += cost;
+            selected[base->id] = true;
+            for (CompliedBlock* const& cb: kept) {
+                cb->retained = is_unheld[cb->id];
+            }
+        }
+    }
+}
+
+void CompliedBlock::removeCbs(std::vector<bool> const& removed) {
+    for (std::unordered_map<void*, CompliedBlock*>::iterator itr = mapCreation.begin(); mapCreation.end() != itr;) {
+        if (removed[itr->second->id]) {
+            itr = mapCreation.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    for (std::unordered_map<CbOprGetSlice, CompliedBlock*>::iterator itr = mapGetSlice.begin(); mapGetSlice.end() != itr;) {
+        if (removed[itr->first.id] || removed[itr->second->id]) {
+            itr = mapGetSlice.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    auto any_removed = [&removed](std::vector<CompliedBlock*> const& cbs) {
+        for (CompliedBlock* const& cb: cbs) {
+            if (removed[cb->id]) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (std::unordered_map<CbOprSplitSlices, std::vector<CompliedBlock*>*>::iterator itr = mapSplitSlices.begin(); mapSplitSlices.end() != itr;) {
+        if (removed[itr->first.id] || any_removed(*(itr->second))) {
+            delete itr->second;
+            itr = mapSplitSlices.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    for (
+        std::unordered_map<CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*>::iterator itr = mapMatchSlicesOneCb.begin();
+        mapMatchSlicesOneCb.end() != itr;
+    ) {
+        if (removed[itr->first.id] || (nullptr != itr->second && any_removed(*(itr->second)))) {
+            if (nullptr != itr->second) {
+                delete itr->second;
+            }
+            itr = mapMatchSlicesOneCb.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    for (
+        std::unordered_map<CbOprMatchSlicesTwoCbs, MatchedSubCbs*>::iterator itr = mapMatchSlicesTwoCbs.begin();
+        mapMatchSlicesTwoCbs.end() != itr;
+    ) {
+        if (
+            removed[itr->first.id1] || removed[itr->first.id2] ||
+            (nullptr != itr->second && (any_removed(itr->second->cbs1) || any_removed(itr->second->cbs2)))
+        ) {
+            if (nullptr != itr->second) {
+                delete itr->second;
+            }
+            itr = mapMatchSlicesTwoCbs.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    for (int id = 0; id < removed.size(); id++) {
+        if (removed[id]) {
+            poolMemoryCost -= pool[id]->memoryCost() + sizeof(CompliedBlock*);
+            delete pool[id];
+            pool[id] = nullptr;
+            freeIds.push_back(id);
+        }
+    }
+}
+
+void CompliedBlock::setRetentionBudget(size_t const budget) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    retentionBudget = budget;
+}
+
+std::vector<bool> CompliedBlock::selectRetainedCbs(
+    std::unordered_map<void*, CompliedBlock*>& retainedCreation, std::unordered_map<CbOprGetSlice, CompliedBlock*>& retainedGetSlice,
+    std::unordered_map<CbOprSplitSlices, std::vector<CompliedBlock*>*>& retainedSplitSlices,
+    std::unordered_map<CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*>& retainedMatchSlicesOneCb,
+    std::unordered_map<CbOprMatchSlicesTwoCbs, MatchedSubCbs*>& retainedMatchSlicesTwoCbs
+) {
+    /* Base CBs are those of external tables. The cost of a base CB includes the results of the operations on it */
+    std::unordered_map<int, size_t> base_costs;
+    for (std::pair<void* const, CompliedBlock*> const& kv: mapCreation) {
+        if (!kv.second->maintainBase) {
+            base_costs.emplace(kv.second->id, kv.second->memoryCost() + sizeof(CompliedBlock*));
+        }
+    }
+    auto slices_cost = [](std::vector<CompliedBlock*> const* cbs) {
+        size_t cost = sizeof(std::vector<CompliedBlock*>) + sizeof(CompliedBlock*) * cbs->capacity();
+        for (CompliedBlock* const& cb: *cbs) {
+            cost += cb->memoryCost() + sizeof(CompliedBlock*);
+        }
+        return cost;
+    };
+    for (std::pair<const CbOprGetSlice, CompliedBlock*> const& kv: mapGetSlice) {
+        std::unordered_map<int, size_t>::iterator itr = base_costs.find(kv.first.id);
+        if (base_costs.end() != itr) {
+            itr->second += kv.second->memoryCost() + sizeof(CompliedBlock*);
+        }
+    }
+    for (std::pair<const CbOprSplitSlices, std::vector<CompliedBlock*>*> const& kv: mapSplitSlices) {
+        std::unordered_map<int, size_t>::iterator itr = base_costs.find(kv.first.id);
+        if (base_costs.end() != itr) {
+            itr->second += slices_cost(kv.second);
+        }
+    }
+    for (std::pair<const CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*> const& kv: mapMatchSlicesOneCb) {
+        std::unordered_map<int, size_t>::iterator itr = base_costs.find(kv.first.id);
+        if (base_costs.end() != itr && nullptr != kv.second) {
+            itr->second += slices_cost(kv.second);
+        }
+    }
+    for (std::pair<const CbOprMatchSlicesTwoCbs, MatchedSubCbs*> const& kv: mapMatchSlicesTwoCbs) {
+        std::unordered_map<int, size_t>::iterator itr = base_costs.find(kv.first.id1);
+        if (base_costs.end() != itr && base_costs.end() != base_costs.find(kv.first.id2) && nullptr != kv.second) {
+            itr->second += kv.second->calcMemoryCost();
+            for (CompliedBlock* const& cb: kv.second->cbs1) {
+                itr->second += cb->memoryCost() + sizeof(CompliedBlock*);
+            }
+            for (CompliedBlock* const& cb: kv.second->cbs2) {
+                itr->second += cb->memoryCost() + sizeof(CompliedBlock*);
+            }
+        }
+    }
+
+    /* Keep the most frequently used base CBs within the budget */
+    std::vector<int> base_ids;
+    base_ids.reserve(base_costs.size());
+    for (std::pair<const int, size_t> const& kv: base_costs) {
+        base_ids.push_back(kv.first);
+    }
+    std::sort(base_ids.begin(), base_ids.end(), [](int const& a, int const& b) {
+        return (pool[a]->usage != pool[b]->usage) ? pool[a]->usage > pool[b]->usage : a < b;
+    });
+    std::vector<bool> selected(pool.size(), false);
+    size_t retained_cost = 0;
+    for (int const& id: base_ids) {
+        size_t const cost = base_costs[id];
+        if (retained_cost + cost <= retentionBudget) {
+            retained_cost += cost;
+            selected[id] = true;
+        }
+    }
+    std::vector<bool> retained(selected);
+
+    /* Move the operations on the retained base CBs out of the indices */
+    for (std::pair<void* const, CompliedBlock*> const& kv: mapCreation) {
+        if (selected[kv.second->id]) {
+            retainedCreation.emplace(kv.first, kv.second);
+        }
+    }
+    for (std::unordered_map<CbOprGetSlice, CompliedBlock*>::iterator itr = mapGetSlice.begin(); mapGetSlice.end() != itr;) {
+        if (selected[itr->first.id]) {
+            retained[itr->second->id] = true;
+            retainedGetSlice.emplace(itr->first, itr->second);
+            itr = mapGetSlice.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    for (std::unordered_map<CbOprSplitSlices, std::vector<CompliedBlock*>*>::iterator itr = mapSplitSlices.begin(); mapSplitSlices.end() != itr;) {
+        if (selected[itr->first.id]) {
+            for (CompliedBlock* const& cb: *(itr->second)) {
+                retained[cb->id] = true;
+            }
+            retainedSplitSlices.emplace(itr->first, itr->second);
+            itr = mapSplitSlices.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    for (
+        std::unordered_map<CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*>::iterator itr = mapMatchSlicesOneCb.begin();
+        mapMatchSlicesOneCb.end() != itr;
+    ) {
+        if (selected[itr->first.id]) {
+            if (nullptr != itr->second) {
+                for (CompliedBlock* const& cb: *(itr->second)) {
+                    retained[cb->id] = true;
+                }
+            }
+            retainedMatchSlicesOneCb.emplace(itr->first, itr->second);
+            itr = mapMatchSlicesOneCb.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    for (
+        std::unordered_map<CbOprMatchSlicesTwoCbs, MatchedSubCbs*>::iterator itr = mapMatchSlicesTwoCbs.begin();
+        mapMatchSlicesTwoCbs.end() != itr;
+    ) {
+        if (selected[itr->first.id1] && selected[itr->first.id2]) {
+            if (nullptr != itr->second) {
+                for (CompliedBlock* const& cb: itr->second->cbs1) {
+                    retained[cb->id] = true;
+                }
+                for (CompliedBlock* const& cb: itr->second->cbs2) {
+                    retained[cb->id] = true;
+                }
+            }
+            retainedMatchSlicesTwoCbs.emplace(itr->first, itr->second);
+            itr = mapMatchSlicesTwoCbs.erase(itr);
+        } else {
+            itr++;
+        }
+    }
+    return retained;
+}
+
+size_t CompliedBlock::releaseRetainedCbs() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    std::vector<bool> removed(pool.size(), false);
+    for (CompliedBlock* const& cb: pool) {
+        if (nullptr != cb && cb->retained) {
+            removed[cb->id] = true;
+        }
+    }
+    size_t const cost_before = poolMemoryCost;
+    removeCbs(removed);
+    return cost_before - poolMemoryCost;
+}
+
+size_t CompliedBlock::trackedMemoryCost() {
+    return poolMemoryCost;
 }
 
 size_t CompliedBlock::totalNumCbs() {
-    return pool.size();
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return pool.size() - freeIds.size();
+}
+
+size_t CompliedBlock::totalRetainedCbs() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    size_t total = 0;
+    for (CompliedBlock* const& cb: pool) {
+        if (nullptr != cb && cb->retained) {
+            total++;
+        }
+    }
+    return total;
+}
+
+size_t CompliedBlock::retainedMemoryCost() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    size_t size = 0;
+    for (CompliedBlock* const& cb: pool) {
+        if (nullptr != cb && cb->retained) {
+            size += cb->memoryCost() + sizeof(CompliedBlock*);
+        }
+    }
+    return size;
 }
 
 size_t CompliedBlock::getNumCreation() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numCreation;
 }
 
 size_t CompliedBlock::getNumCreationHit() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numCreationHit;
 }
 
 size_t CompliedBlock::getNumCreationIndices() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return mapCreation.size();
 }
 
 size_t CompliedBlock::getNumGetSlice() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numGetSlice;
 }
 
 size_t CompliedBlock::getNumGetSliceHit() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numGetSliceHit;
 }
 
 size_t CompliedBlock::getNumGetSliceIndices() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return mapGetSlice.size();
 }
 
 size_t CompliedBlock::getNumSplitSlices() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numSplitSlices;
 }
 
 size_t CompliedBlock::getNumSplitSlicesHit() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numSplitSlicesHit;
 }
 
 size_t CompliedBlock::getNumSplitSlicesIndices() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return mapSplitSlices.size();
 }
 
 size_t CompliedBlock::getNumMatchSlices1() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numMatchSlices1;
 }
 
 size_t CompliedBlock::getNumMatchSlices1Hit() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numMatchSlices1Hit;
 }
 
 size_t CompliedBlock::getNumMatchSlices1Indices() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return mapMatchSlicesOneCb.size();
 }
 
 size_t CompliedBlock::getNumMatchSlices2() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numMatchSlices2;
 }
 
 size_t CompliedBlock::getNumMatchSlices2Hit() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return numMatchSlices2Hit;
 }
 
 size_t CompliedBlock::getNumMatchSlices2Indices() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     return mapMatchSlicesTwoCbs.size();
 }
 
 size_t CompliedBlock::totalCbMemoryCost() {
+    std::lock_guard<std::mutex> lock(poolMutex);
     size_t size = sizeof(pool) + sizeof(CompliedBlock*) * pool.capacity();
     for (CompliedBlock* const& cb: pool) {
-        size += cb->memoryCost();
+        if (nullptr != cb) {
+            size += cb->memoryCost();
+        }
     }
     size += sizeOfUnorderedMap(
         mapCreation.bucket_count(), mapCreation.max_load_factor(), sizeof(std::pair<void*, CompliedBlock*>), sizeof(mapCreation)
@@ -466,31 +1008,57 @@ size_t CompliedBlock::totalCbMemoryCost() {
 }
 
 CompliedBlock::~CompliedBlock() {
-    if (mainTainComplianceSet) {
-        delete[] complianceSet;
+    delete[] rowIds;
+    if (nullptr != indices.load() && maintainIndices) {
+        delete indices.load();
     }
-    if (maintainIndices) {
-        delete indices;
+    if (maintainBase) {
+        delete base;
     }
 }
 
 void CompliedBlock::buildIndices() {
-    if (nullptr == indices) {
-        indices = new IntTable(complianceSet, totalRows, totalCols);
-        maintainIndices = true;
+    if (nullptr != indices.load(std::memory_order_acquire)) {
+        return;
     }
+    std::call_once(indicesBuilt, [this]() {
+        if (nullptr != indices.load(std::memory_order_relaxed)) {
+            return;
+        }
+        int** rows = new int*[totalRows];
+        for (int i = 0; i < totalRows; i++) {
+            rows[i] = (*base)[rowIds[i]];
+        }
+        IntTable* const table = new IntTable(rows, totalRows, totalCols);
+        delete[] rows;  // The table copies the pointers
+        maintainIndices = true;
+        poolMemoryCost += table->memoryCost();
+        indices.store(table, std::memory_order_release);
+    });
 }
 
 int CompliedBlock::getId() const {
     return id;
 }
 
-int* const* CompliedBlock::getComplianceSet() const {
-    return complianceSet;
+int* CompliedBlock::getRow(int const idx) const {
+    return (*base)[(nullptr == rowIds) ? idx : rowIds[idx]];
+}
+
+int CompliedBlock::getRowId(int const idx) const {
+    return (nullptr == rowIds) ? idx : rowIds[idx];
+}
+
+int* CompliedBlock::getFirstRow() const {
+    return firstRow;
+}
+
+const IntTable& CompliedBlock::getBase() const {
+    return *base;
 }
 
 const IntTable& CompliedBlock::getIndices() const {
-    return *indices;
+    return *indices.load(std::memory_order_acquire);
 }
 
 int CompliedBlock::getTotalRows() const {
@@ -503,11 +1071,15 @@ int CompliedBlock::getTotalCols() const {
 
 size_t CompliedBlock::memoryCost() const {
     size_t size = sizeof(CompliedBlock);
-    if (mainTainComplianceSet) {
-        size += sizeof(int*) * totalRows + sizeof(int);
+    if (nullptr != rowIds) {
+        size += sizeof(int) * totalRows + sizeof(int);
+    }
+    IntTable const* const table = indices.load(std::memory_order_acquire);
+    if (nullptr != table && maintainIndices) {
+        size += table->memoryCost();
     }
-    if (maintainIndices) {
-        size += indices->memoryCost();
+    if (maintainBase) {
+        size += base->memoryCost();
     }
     return size;
 }
@@ -516,7 +1088,7 @@ void CompliedBlock::showComplianceSet() const {
     std::cout << "Compliance Set:\n";
     for (int i = 0; i < totalRows; i++) {
         for (int j = 0; j < totalCols; j++) {
-            std::cout << complianceSet[i][j] << ',';
+            std::cout << getRow(i)[j] << ',';
         }
         std::cout << std::endl;
     }
@@ -526,27 +1098,68 @@ void CompliedBlock::showAll() const {
     std::cout << "Compliance Set:\n";
     for (int i = 0; i < totalRows; i++) {
         for (int j = 0; j < totalCols; j++) {
-            std::cout << complianceSet[i][j] << ',';
+            std::cout << getRow(i)[j] << ',';
         }
         std::cout << std::endl;
     }
     std::cout << "Indices:\n";
-    indices->showRows();
+    indices.load()->showRows();
 }
 
 void CompliedBlock::registerCb(CompliedBlock* cb) {
-    pool.push_back(cb);
+    pool[cb->id] = cb;
+    poolMemoryCost += cb->memoryCost() + sizeof(CompliedBlock*);
 }
 
-CompliedBlock::CompliedBlock(
-    int const _id, int** _complianceSet, int const _totalRows, int const _totalCols, bool _maintainComplianceSet
-): id(_id), complianceSet(_complianceSet), totalRows(_totalRows), totalCols(_totalCols), indices(nullptr),
-    mainTainComplianceSet(_maintainComplianceSet), maintainIndices(false) {}
+int CompliedBlock::allocateId() {
+    if (freeIds.empty()) {
+        pool.push_back(nullptr);
+        return pool.size() - 1;
+    }
+    int const id = freeIds.back();
+    freeIds.pop_back();
+    return id;
+}
 
-CompliedBlock::CompliedBlock(int const _id, int** _complianceSet, int const _totalRows, int const _totalCols, IntTable* _indices,
-    bool _maintainComplianceSet, bool _maintainIndices
-) : id(_id), complianceSet(_complianceSet), totalRows(_totalRows), totalCols(_totalCols), indices(_indices),
-    mainTainComplianceSet(_maintainComplianceSet), maintainIndices(_maintainIndices && nullptr != _indices) {}
+void CompliedBlock::hold(CbHolder* const holder, CompliedBlock* const cb) {
+    if (nullptr != holder && holder->cbs.insert(cb).second) {
+        cb->references++;
+        cb->retained = false;
+    }
+}
+
+void CompliedBlock::hold(CbHolder* const holder, std::vector<CompliedBlock*> const* const cbs) {
+    if (nullptr != holder && nullptr != cbs) {
+        for (CompliedBlock* const& cb: *cbs) {
+            hold(holder, cb);
+        }
+    }
+}
+
+void CompliedBlock::hold(CbHolder* const holder, MatchedSubCbs const* const subCbs) {
+    if (nullptr != holder && nullptr != subCbs) {
+        hold(holder, &(subCbs->cbs1));
+        hold(holder, &(subCbs->cbs2));
+    }
+}
+
+void CompliedBlock::registerHolder(CbHolder* const holder) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    holders.insert(holder);
+}
+
+void CompliedBlock::unregisterHolder(CbHolder* const holder) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    holders.erase(holder);
+}
+
+CompliedBlock::CompliedBlock(int const _id, IntTable* const _table, bool _maintainTable) :
+    id(_id), base(_table), rowIds(nullptr), firstRow((0 < _table->getTotalRows()) ? (*_table)[0] : nullptr), indices(_table),
+    totalRows(_table->getTotalRows()), totalCols(_table->getTotalCols()), maintainBase(_maintainTable), maintainIndices(false) {}
+
+CompliedBlock::CompliedBlock(int const _id, IntTable* const _base, int* const _rowIds, int const _totalRows, int const _totalCols) :
+    id(_id), base(_base), rowIds(_rowIds), firstRow((*_base)[_rowIds[0]]), indices(nullptr), totalRows(_totalRows),
+    totalCols(_totalCols), maintainBase(false), maintainIndices(false) {}
 
 /**
  * CachedSincPerfMonitor
@@ -619,6 +1232,9 @@ void CachedSincPerfMonitor::show(std::ostream& os) {
         CompliedBlock::getNumMatchSlices2Indices(),
         maxCbPoolIdxSize
     );
+    if (0 < maxRetainedCbs) {
+        printf(os, "# Retained across miners: %lu CBs (%s)\n\n", maxRetainedCbs, formatMemorySize(maxRetainedCbMemCost).c_str());
+    }
 
     os << "--- Cache Statistics ---\n";
     printf(
@@ -705,20 +1321,27 @@ bool std::equal_to<const VarInfo*>::operator()(const VarInfo *r1, const VarInfo
  */
 using sinc::CacheFragment;
 
-CacheFragment::CacheFragment(IntTable* const firstRelation, int const relationSymbol) {
+const int CacheFragment::DEFAULT_PARALLEL_MIN_ENTRIES = 65536;
+int CacheFragment::parallelMinEntries = CacheFragment::DEFAULT_PARALLEL_MIN_ENTRIES;
+
+CacheFragment::CacheFragment(IntTable* const firstRelation, int const relationSymbol, CbHolder* const cbHolder) :
+    cbHolder(cbHolder)
+{
     entries = new entriesType();
+    entriesReferences = new std::atomic<int>(1);
 
     partAssignedRule.emplace_back(relationSymbol, firstRelation->getTotalCols());
     entryType* first_entry = new entryType();
-    CompliedBlock* cb = CompliedBlock::create(
-        firstRelation->getAllRows(), firstRelation->getTotalRows(), firstRelation->getTotalCols(), firstRelation, false, false
-    );
+    CompliedBlock* cb = CompliedBlock::create(firstRelation, false, cbHolder);
     first_entry->push_back(cb);
     entries->push_back(first_entry);
 }
 
-CacheFragment::CacheFragment(CompliedBlock* const firstCb, int const relationSymbol) {
+CacheFragment::CacheFragment(CompliedBlock* const firstCb, int const relationSymbol, CbHolder* const cbHolder) :
+    cbHolder(cbHolder)
+{
     entries = new entriesType();
+    entriesReferences = new std::atomic<int>(1);
 
     partAssignedRule.emplace_back(relationSymbol, firstCb->getTotalCols());
     entryType* first_entry = new entryType();
@@ -726,18 +1349,19 @@ CacheFragment::CacheFragment(CompliedBlock* const firstCb, int const relationSym
     entries->push_back(first_entry);
 }
 
-CacheFragment::CacheFragment(int const relationSymbol, int const arity) {
+CacheFragment::CacheFragment(int const relationSymbol, int const arity, CbHolder* const cbHolder) : cbHolder(cbHolder) {
     entries = new entriesType();
+    entriesReferences = new std::atomic<int>(1);
     partAssignedRule.emplace_back(relationSymbol, arity);
 }
 
 CacheFragment::CacheFragment(const CacheFragment& another) : partAssignedRule(another.partAssignedRule),
-    entries(new entriesType()), varInfoList(another.varInfoList) 
+    entries(another.entries), entriesReferences(another.entriesReferences), varInfoList(another.varInfoList),
+    cbHolder(another.cbHolder), lvColumns(another.lvColumns)
 {
-    entries->reserve(another.entries->size());
-    for (entryType* const& entry: *(another.entries)) {
-        entries->push_back(new entryType(*entry));
-    }
+    (*entriesReferences)++;
+    std::lock_guard<std::mutex> lock(another.summaryMutex);
+    combinationSummaries = another.combinationSummaries;
 }
 
 CacheFragment::~CacheFragment() {
@@ -749,17 +1373,21 @@ void CacheFragment::updateCase1a(int const tabIdx, int const colIdx, int const v
     if (vid < varInfoList.size() && !varInfoList[vid].isEmpty()) {
         /* Filter the two columns */
         VarInfo& var_info = varInfoList[vid];
+        std::vector<int> sources;
         if (var_info.isPlv) {
             /* Split by the two columns */
             var_info.isPlv = false;
-            splitCacheEntries(var_info.tabIdx, var_info.colIdx, tabIdx, colIdx);
+            splitCacheEntries(var_info.tabIdx, var_info.colIdx, tabIdx, colIdx, sources);
+            updateLvColumns(sources, vid);
         } else {
             /* Match the new column to the original */
-            matchCacheEntries(var_info.tabIdx, var_info.colIdx, tabIdx, colIdx);
+            matchCacheEntries(var_info.tabIdx, var_info.colIdx, tabIdx, colIdx, sources);
+            updateLvColumns(sources, -1);
         }
     } else {
-        /* Record as a PLV */
+        /* Record as a PLV. The entries are not changed */
         addVarInfo(vid, tabIdx, colIdx, true);
+        lvColumns.resize(varInfoList.size());
     }
 }
 
@@ -769,13 +1397,16 @@ void CacheFragment::updateCase1b(IntTable* const newRelation, int const relation
     VarInfo& var_info = varInfoList[vid];    // Assertion: this shall NOT be empty
 
     /* Filter the two columns */
+    std::vector<int> sources;
     if (var_info.isPlv) {
         /* Split by the two columns */
         var_info.isPlv = false;
-        splitCacheEntries(var_info.tabIdx, var_info.colIdx, newRelation, colIdx);
+        splitCacheEntries(var_info.tabIdx, var_info.colIdx, newRelation, colIdx, sources);
+        updateLvColumns(sources, vid);
     } else {
         /* Match the new column to the original */
-        matchCacheEntries(var_info.tabIdx, var_info.colIdx, newRelation, colIdx);
+        matchCacheEntries(var_info.tabIdx, var_info.colIdx, newRelation, colIdx, sources);
+        updateLvColumns(sources, -1);
     }
 }
 
@@ -796,19 +1427,33 @@ void CacheFragment::updateCase1c(CacheFragment const& fragment, int const tabIdx
     }
 
     /* Merge entries */
+    const2SourcesMapType merging_const_2_sources_map;
     const2EntriesMapType* merging_frag_const_2_entries_map = calcConst2EntriesMap(
-        fragment.getEntries(), tabIdx, colIdx, fragment.getPartAssignedRule()[tabIdx].getArity()
+        fragment.getEntries(), tabIdx, colIdx, fragment.getPartAssignedRule()[tabIdx].getArity(), cbHolder,
+        merging_const_2_sources_map
     );
     VarInfo& var_info = varInfoList[vid];    // Assertion: this shall NOT be empty
+    std::vector<int> base_sources;
+    std::vector<int> merging_sources;
     if (var_info.isPlv) {
         var_info.isPlv = false;
+        const2SourcesMapType base_const_2_sources_map;
         const2EntriesMapType* base_frag_const_2_entries_map = calcConst2EntriesMap(
-            *entries, var_info.tabIdx, var_info.colIdx, partAssignedRule[var_info.tabIdx].getArity()
+            *entries, var_info.tabIdx, var_info.colIdx, partAssignedRule[var_info.tabIdx].getArity(), cbHolder,
+            base_const_2_sources_map
+        );
+        mergeFragmentEntries(
+            *base_frag_const_2_entries_map, base_const_2_sources_map, *merging_frag_const_2_entries_map,
+            merging_const_2_sources_map, base_sources, merging_sources
         );
-        mergeFragmentEntries(*base_frag_const_2_entries_map, *merging_frag_const_2_entries_map);
         releaseConst2EntryMap(base_frag_const_2_entries_map);
+        updateLvColumns(base_sources, vid, &fragment, &merging_sources);
     } else {
-        mergeFragmentEntries(*entries, var_info.tabIdx, var_info.colIdx, *merging_frag_const_2_entries_map);
+        mergeFragmentEntries(
+            *entries, var_info.tabIdx, var_info.colIdx, *merging_frag_const_2_entries_map, merging_const_2_sources_map,
+            base_sources, merging_sources
+        );
+        updateLvColumns(base_sources, -1, &fragment, &merging_sources);
     }
     releaseConst2EntryMap(merging_frag_const_2_entries_map);
 }
@@ -821,7 +1466,9 @@ void CacheFragment::updateCase2a(int const tabIdx1, int const colIdx1, int const
     partAssignedRule[tabIdx2].setArg(colIdx2, var_arg);
 
     /* Modify cache entries */
-    splitCacheEntries(tabIdx1, colIdx1, tabIdx2, colIdx2);
+    std::vector<int> sources;
+    splitCacheEntries(tabIdx1, colIdx1, tabIdx2, colIdx2, sources);
+    updateLvColumns(sources, newVid);
 }
 
 void CacheFragment::updateCase2b(
@@ -835,7 +1482,9 @@ void CacheFragment::updateCase2b(
     new_pred.setArg(colIdx1, var_arg);
 
     /* Modify cache entries */
-    splitCacheEntries(tabIdx2, colIdx2, newRelation, colIdx1);
+    std::vector<int> sources;
+    splitCacheEntries(tabIdx2, colIdx2, newRelation, colIdx1, sources);
+    updateLvColumns(sources, newVid);
 }
 
 void CacheFragment::updateCase2c(
@@ -860,15 +1509,24 @@ void CacheFragment::updateCase2c(
     }
 
     /* Merge entries */
+    const2SourcesMapType merging_const_2_sources_map;
     const2EntriesMapType* merging_frag_const_2_entries_map = calcConst2EntriesMap(
-        fragment.getEntries(), tabIdx2, colIdx2, fragment.getPartAssignedRule()[tabIdx2].getArity()
+        fragment.getEntries(), tabIdx2, colIdx2, fragment.getPartAssignedRule()[tabIdx2].getArity(), cbHolder,
+        merging_const_2_sources_map
     );
+    const2SourcesMapType base_const_2_sources_map;
     const2EntriesMapType* base_frag_const_2_entries_map = calcConst2EntriesMap(
-        *entries, tabIdx, colIdx, partAssignedRule[tabIdx].getArity()
+        *entries, tabIdx, colIdx, partAssignedRule[tabIdx].getArity(), cbHolder, base_const_2_sources_map
+    );
+    std::vector<int> base_sources;
+    std::vector<int> merging_sources;
+    mergeFragmentEntries(
+        *base_frag_const_2_entries_map, base_const_2_sources_map, *merging_frag_const_2_entries_map,
+        merging_const_2_sources_map, base_sources, merging_sources
     );
-    mergeFragmentEntries(*base_frag_const_2_entries_map, *merging_frag_const_2_entries_map);
     releaseConst2EntryMap(merging_frag_const_2_entries_map);
     releaseConst2EntryMap(base_frag_const_2_entries_map);
+    updateLvColumns(base_sources, newVid, &fragment, &merging_sources);
 }
 
 void CacheFragment::updateCase3(int const tabIdx, int const colIdx, int const constant) {
@@ -876,7 +1534,9 @@ void CacheFragment::updateCase3(int const tabIdx, int const colIdx, int const co
     partAssignedRule[tabIdx].setArg(colIdx, ARG_CONSTANT(constant));
 
     /* Modify cache entries */
-    assignCacheEntries(tabIdx, colIdx, constant);
+    std::vector<int> sources;
+    assignCacheEntries(tabIdx, colIdx, constant, sources);
+    updateLvColumns(sources, -1);
 }
 
 void CacheFragment::buildIndices() {
@@ -889,253 +1549,83 @@ void CacheFragment::buildIndices() {
 
 bool CacheFragment::hasLv(int const vid) const {
     return (vid < varInfoList.size()) && !varInfoList[vid].isEmpty();
-}
-
-int CacheFragment::countCombinations(std::vector<int> const& vids) const {
-    std::vector<VarInfo> lvs;
-    std::vector<int> plv_col_index_lists[partAssignedRule.size()];    // Table index is the index of the array
-    std::vector<int> tab_idxs_with_plvs;
-    lvs.reserve(vids.size());
-    tab_idxs_with_plvs.reserve(vids.size());
-    for (int const& vid: vids) {
-        VarInfo const& var_info = varInfoList[vid];    // This shall NOT be empty
-        if (var_info.isPlv) {
-            if (plv_col_index_lists[var_info.tabIdx].empty()) {
-                tab_idxs_with_plvs.push_back(var_info.tabIdx);
-                plv_col_index_lists[var_info.tabIdx].reserve(vids.size());
-            }
-            plv_col_index_lists[var_info.tabIdx].push_back(var_info.colIdx);
-        } else {
-            lvs.push_back(var_info);
-        }
-    }
-    _evaluation_memory_cost += sizeof(lvs) + sizeof(VarInfo) * lvs.capacity() + sizeof(plv_col_index_lists) + 
-        sizeof(tab_idxs_with_plvs ) + sizeof(int) * tab_idxs_with_plvs.capacity();
-    for (int i = 0; i < partAssignedRule.size(); i++) {
-        _evaluation_memory_cost += sizeof(int) * plv_col_index_lists[i].capacity();
-    }
-
-    int const total_plvs = vids.size() - lvs.size();
-    int total_unique_bindings = 0;
-    if (0 == total_plvs) {
-        /* No PLV. Just count all combinations of LVs */
-        std::unordered_set<Record> lv_bindings;
-        lv_bindings.reserve(entries->size());
-        for (entryType* const& cache_entry: *entries) {
-            int* binding = new int[lvs.size()];
-            for (int i = 0; i < lvs.size(); i++) {
-                VarInfo const& lv_info = lvs[i];
-                binding[i] = (*cache_entry)[lv_info.tabIdx]->getComplianceSet()[0][lv_info.colIdx];
-            }
-            if (!lv_bindings.emplace(binding, lvs.size()).second) {
-                delete[] binding;
-            }
-        }
-        total_unique_bindings = lv_bindings.size();
-        _evaluation_memory_cost += sizeOfUnorderedSet(
-            lv_bindings.bucket_count(), lv_bindings.max_load_factor(), sizeof(Record), sizeof(lv_bindings)
-        ) + (sizeof(int) * lvs.size() + sizeof(int)) * total_unique_bindings;
-        for (Record const& r: lv_bindings) {
-            delete[] r.getArgs();
-        }
-    } else  {
-        std::unordered_map<Record, std::unordered_set<Record>*> lv_bindings_2_plv_bindings;
-        lv_bindings_2_plv_bindings.reserve(entries->size());
-        std::unordered_set<Record> plv_bindings_within_tab_sets[tab_idxs_with_plvs.size()];
-        _evaluation_memory_cost += sizeof(plv_bindings_within_tab_sets);
-        size_t _max_mem_cost_plv_bindings_within_tab_sets = 0;
-        for (entryType* const& cache_entry: *entries) {
-            /* Find LV binding first */
-            int* lv_binding = new int[lvs.size()];
-            for (int i = 0; i < lvs.size(); i++) {
-                VarInfo const& lv_info = lvs[i];
-                lv_binding[i] = (*cache_entry)[lv_info.tabIdx]->getComplianceSet()[0][lv_info.colIdx];
-            }
-
-            const Record rec_lv_binding(lv_binding, lvs.size());
-            std::unordered_set<Record>* complete_plv_bindings;
-            std::unordered_map<Record, std::unordered_set<Record>*>::iterator itr = lv_bindings_2_plv_bindings.find(rec_lv_binding);
-            if (lv_bindings_2_plv_bindings.end() == itr) {
-                complete_plv_bindings = new std::unordered_set<Record>();
-                lv_bindings_2_plv_bindings.emplace(rec_lv_binding, complete_plv_bindings);
-            } else {
-                delete[] lv_binding;
-                complete_plv_bindings = itr->second;
-            }
-
-            /* Cartesian product all the PLVs */
-            for (int i = 0; i < tab_idxs_with_plvs.size(); i++) {
-                int tab_idx = tab_idxs_with_plvs[i];
-                std::vector<int>& plv_col_idxs = plv_col_index_lists[tab_idx];
-                std::unordered_set<Record>& plv_bindings = plv_bindings_within_tab_sets[i];
-                CompliedBlock* cb = (*cache_entry)[tab_idx];
-                const int* const* compliance_records = cb->getComplianceSet();
-                for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                    const int* cs_record = compliance_records[row_idx];
-                    int* plv_binding_within_tab = new int[plv_col_idxs.size()];
-                    for (int j = 0; j < plv_col_idxs.size(); j++) {
-                        plv_binding_within_tab[j] = cs_record[plv_col_idxs[j]];
-                    }
-                    if (!plv_bindings.emplace(plv_binding_within_tab, plv_col_idxs.size()).second) {
-                        delete[] plv_binding_within_tab;
-                    }
-                }
-            }
-
-            size_t _current_mem_cost_plv_bindings_within_tab_sets = 0;
-            if (1 == tab_idxs_with_plvs.size()) {
-                /* No need to perform Cartesian product */
-                std::unordered_set<Record>& set = plv_bindings_within_tab_sets[0];
-                _current_mem_cost_plv_bindings_within_tab_sets += sizeOfUnorderedSet(
-                    set.bucket_count(), set.max_load_factor(), sizeof(Record), sizeof(set)
-                ) + (sizeof(int) * set.begin()->getArity() + sizeof(int)) * set.size();
-                for (Record const& r: set) {
-                    if (!complete_plv_bindings->insert(r).second) {
-                        delete[] r.getArgs();
-                    }
-                }
-                set.clear();
-            } else {
-                /* Cartesian product required */
-                int arg_template[total_plvs]{};
-                addCompletePlvBindings(
-                    *complete_plv_bindings, plv_bindings_within_tab_sets, arg_template, 0, 0, tab_idxs_with_plvs.size()
-                );
-
-                /* Release Cartesian product resources */
-                for (int i = 0; i < tab_idxs_with_plvs.size(); i++) {
-                    std::unordered_set<Record>& set = plv_bindings_within_tab_sets[i];
-                    _current_mem_cost_plv_bindings_within_tab_sets += sizeOfUnorderedSet(
-                        set.bucket_count(), set.max_load_factor(), sizeof(Record), sizeof(set)
-                    ) + (sizeof(int) * set.begin()->getArity() + sizeof(int)) * set.size();
-                    for (Record const& r: set) {
-                        delete[] r.getArgs();
-                    }
-                    set.clear();
-                }
-            }
-            _max_mem_cost_plv_bindings_within_tab_sets = std::max(
-                _max_mem_cost_plv_bindings_within_tab_sets, _current_mem_cost_plv_bindings_within_tab_sets
-            );
-        }
-        _evaluation_memory_cost += _max_mem_cost_plv_bindings_within_tab_sets + sizeOfUnorderedMap(
-            lv_bindings_2_plv_bindings.bucket_count(), lv_bindings_2_plv_bindings.max_load_factor(),
-            sizeof(std::pair<Record, std::unordered_set<Record>*>), sizeof(lv_bindings_2_plv_bindings)
-        );
-        for (std::pair<const Record, std::unordered_set<Record>*> const& kv: lv_bindings_2_plv_bindings) {
-            std::unordered_set<Record>& set = *(kv.second);
-            _evaluation_memory_cost += sizeOfUnorderedSet(
-                set.bucket_count(), set.max_load_factor(), sizeof(Record), sizeof(set)
-            ) + (sizeof(int) * set.begin()->getArity() + sizeof(int)) * set.size();
-            total_unique_bindings += set.size();
-            delete[] kv.first.getArgs();
-            for (Record const& r: set) {
-                delete[] r.getArgs();
-            }
-            delete kv.second;
-        }
-    }
-    return total_unique_bindings;
-}
-
-std::unordered_set<sinc::Record>* CacheFragment::enumerateCombinations(std::vector<int> const& vids) const {
-    /* Split LVs and PLVs and find the locations of the vars */
-    /* Also, group PLVs within tabs */
-    std::vector<VarInfo> lvs;
-    std::vector<int> lv_template_idxs;
-    std::vector<int> plv_col_idx_lists[partAssignedRule.size()];    // Table index is the index of the array
-    std::vector<int> plv_2_template_idx_lists[partAssignedRule.size()];
-    std::vector<int> tab_idxs_with_plvs;
-    lvs.reserve(vids.size());
-    lv_template_idxs.reserve(vids.size());
-    tab_idxs_with_plvs.reserve(vids.size());
-    for (int template_idx = 0; template_idx < vids.size(); template_idx++) {
-        VarInfo const& var_info = varInfoList[vids[template_idx]];    // This shall NOT be empty
-        if (var_info.isPlv) {
-            if (plv_col_idx_lists[var_info.tabIdx].empty()) {
-                tab_idxs_with_plvs.push_back(var_info.tabIdx);
-                plv_col_idx_lists[var_info.tabIdx].reserve(vids.size());
-                plv_2_template_idx_lists[var_info.tabIdx].reserve(vids.size());
-            }
-            plv_col_idx_lists[var_info.tabIdx].push_back(var_info.colIdx);
-            plv_2_template_idx_lists[var_info.tabIdx].push_back(template_idx);
-        } else {
-            lv_template_idxs.push_back(template_idx);
-            lvs.push_back(var_info);
+}
+
+int CacheFragment::countCombinations(std::vector<int> const& vids) const {
+    return countCombinations(vids, std::numeric_limits<int>::max());
+}
+
+int CacheFragment::countCombinations(std::vector<int> const& vids, int const cap, int const threads) const {
+    /* The number does not rely on the order of the variables */
+    std::vector<int> key(vids);
+    std::sort(key.begin(), key.end());
+    {
+        std::lock_guard<std::mutex> lock(summaryMutex);
+        std::map<std::vector<int>, int>::const_iterator itr = combinationSummaries.find(key);
+        if (combinationSummaries.end() != itr) {
+            return itr->second;
         }
     }
 
-    std::unordered_set<Record>* bindings = new std::unordered_set<Record>();
-    bindings->reserve(entries->size());
-    if (tab_idxs_with_plvs.empty()) {
-        /* No PLV. Just enumerate all combinations of LVs */
-        for (entryType* const& cache_entry: *entries) {
-            int* binding = new int[vids.size()];
-            for (int template_idx = 0; template_idx < lvs.size(); template_idx++) {
-                VarInfo const& lv_info = lvs[template_idx];
-                binding[template_idx] = (*cache_entry)[lv_info.tabIdx]->getComplianceSet()[0][lv_info.colIdx];
-            }
-            if (!bindings->emplace(binding, lvs.size()).second) {
-                delete[] binding;
-            }
-        }
-    } else  {
-        int* binding_with_only_lvs = new int[vids.size()];
-        std::unordered_set<Record> plv_bindings_within_tab_sets[tab_idxs_with_plvs.size()];
-        std::vector<int>* plv_2_template_idx_within_tab_lists[tab_idxs_with_plvs.size()];
-        for (entryType* const& cache_entry: *entries) {
-            /* Find LV binding first */
-            for (int i = 0; i < lvs.size(); i++) {
-                VarInfo const& lv_info = lvs[i];
-                binding_with_only_lvs[lv_template_idxs[i]] = (*cache_entry)[lv_info.tabIdx]->getComplianceSet()[0][lv_info.colIdx];
-            }
+    IntTupleSet** binding_sets;
+    int const num_sets = collectCombinations(vids, binding_sets, cap, threads);
+    int total_unique_bindings = 0;
+    for (int i = 0; i < num_sets; i++) {
+        total_unique_bindings += binding_sets[i]->size();
+        _evaluation_memory_cost += binding_sets[i]->memoryCost();
+        delete binding_sets[i];
+    }
+    delete[] binding_sets;
+    if (total_unique_bindings <= cap) {
+        /* Only exact numbers are kept */
+        std::lock_guard<std::mutex> lock(summaryMutex);
+        combinationSummaries.emplace(std::move(key), total_unique_bindings);
+    }
+    return total_unique_bindings;
+}
 
-            /* Cartesian product all the PLVs */
-            for (int i = 0; i < tab_idxs_with_plvs.size(); i++) {
-                int tab_idx = tab_idxs_with_plvs[i];
-                std::vector<int>& plv_col_idxs = plv_col_idx_lists[tab_idx];
-                std::unordered_set<Record>& plv_bindings = plv_bindings_within_tab_sets[i];
-                plv_2_template_idx_within_tab_lists[i] = &(plv_2_template_idx_lists[tab_idx]);
-                CompliedBlock* cb = (*cache_entry)[tab_idx];
-                const int* const* compliance_records = cb->getComplianceSet();
-                for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                    const int* cs_record = compliance_records[row_idx];
-                    int* plv_binding_within_tab = new int[plv_col_idxs.size()];
-                    for (int j = 0; j < plv_col_idxs.size(); j++) {
-                        plv_binding_within_tab[j] = cs_record[plv_col_idxs[j]];
-                    }
-                    if (!plv_bindings.emplace(plv_binding_within_tab, plv_col_idxs.size()).second) {
-                        delete[] plv_binding_within_tab;
-                    }
-                }
-            }
-            addPlvBindings2Templates(
-                    *bindings, plv_bindings_within_tab_sets, plv_2_template_idx_within_tab_lists, binding_with_only_lvs, 0,
-                    tab_idxs_with_plvs.size(), vids.size()
-            );
+std::unordered_set<sinc::Record>* CacheFragment::enumerateCombinations(std::vector<int> const& vids, int const threads) const {
+    IntTupleSet** binding_sets;
+    int const num_sets = collectCombinations(vids, binding_sets, std::numeric_limits<int>::max(), threads);
+    size_t total_unique_bindings = 0;
+    for (int i = 0; i < num_sets; i++) {
+        total_unique_bindings += binding_sets[i]->size();
+    }
 
-            /* Release Cartesian product resources */
-            for (int i = 0; i < tab_idxs_with_plvs.size(); i++) {
-                for (Record const& r: plv_bindings_within_tab_sets[i]) {
-                    delete[] r.getArgs();
-                }
-                plv_bindings_within_tab_sets[i].clear();
-            }
+    /* The sets are disjoint. Copy each combination to a record */
+    int const arity = vids.size();
+    std::unordered_set<Record>* bindings = new std::unordered_set<Record>();
+    bindings->reserve(total_unique_bindings);
+    for (int i = 0; i < num_sets; i++) {
+        IntTupleSet const& set = *binding_sets[i];
+        for (size_t j = 0; j < set.size(); j++) {
+            int* binding = new int[arity];
+            std::copy(set[j], set[j] + arity, binding);
+            bindings->emplace(binding, arity);
         }
-        delete[] binding_with_only_lvs;
+        delete binding_sets[i];
     }
+    delete[] binding_sets;
     return bindings;
 }
 
+void CacheFragment::setParallelMinEntries(int const minEntries) {
+    parallelMinEntries = minEntries;
+}
+
 bool CacheFragment::isEmpty() const {
     return entries->empty();
 }
 
 void CacheFragment::clear() {
-    for (entryType* entry: *entries) {
-        delete entry;
+    resetEntries(new entriesType());
+    {
+        std::lock_guard<std::mutex> lock(summaryMutex);
+        combinationSummaries.clear();
+    }
+    for (std::vector<int>& column: lvColumns) {
+        column.clear();
     }
-    entries->clear();
 }
 
 const CacheFragment::entriesType& CacheFragment::getEntries() const {
@@ -1147,13 +1637,15 @@ CacheFragment::entryType* CacheFragment::getEntry(int const idx) const {
 }
 
 int CacheFragment::countTableSize(int const tabIdx) const {
-    /* Rows in compliance sets are all from original KB, thus the pointer of two rows are equal iff two rows are equal */
-    std::unordered_set<const int*> records;
+    /* Rows in compliance sets of the same table are all from the same base table, thus the ids of two rows are equal iff two
+       rows are equal */
+    std::unordered_set<int> records;
     records.reserve(entries->size());
     for (entryType* entry: *entries) {
         CompliedBlock* cb = (*entry)[tabIdx];
-        const int* const* cs = cb->getComplianceSet();
-        records.insert(cs, cs + cb->getTotalRows());
+        for (int i = 0; i < cb->getTotalRows(); i++) {
+            records.insert(cb->getRowId(i));
+        }
     }
     return records.size();
 }
@@ -1170,6 +1662,17 @@ std::vector<VarInfo> const& CacheFragment::getVarInfoList() const {
     return varInfoList;
 }
 
+std::vector<int> const& CacheFragment::getLvColumn(int const vid) const {
+    return lvColumns[vid];
+}
+
+bool CacheFragment::hasCombinationSummary(std::vector<int> const& vids) const {
+    std::vector<int> key(vids);
+    std::sort(key.begin(), key.end());
+    std::lock_guard<std::mutex> lock(summaryMutex);
+    return combinationSummaries.end() != combinationSummaries.find(key);
+}
+
 size_t CacheFragment::getMemoryCost() const {
     size_t size = sizeof(CacheFragment) + sizeof(Predicate) * partAssignedRule.capacity() + sizeof(VarInfo) * varInfoList.capacity();
     size += sizeof(entriesType) + sizeof(entryType*) * entries->capacity() + sizeof(entryType) * entries->size();
@@ -1178,6 +1681,14 @@ size_t CacheFragment::getMemoryCost() const {
         total_capacity += entry->capacity();
     }
     size += total_capacity * sizeof(CompliedBlock*);
+    size += sizeof(std::vector<int>) * lvColumns.capacity();
+    for (std::vector<int> const& column: lvColumns) {
+        size += sizeof(int) * column.capacity();
+    }
+    std::lock_guard<std::mutex> lock(summaryMutex);
+    for (std::pair<const std::vector<int>, int> const& kv: combinationSummaries) {
+        size += sizeof(kv) + sizeof(int) * kv.first.capacity();
+    }
     return size;
 }
 
@@ -1198,25 +1709,30 @@ void CacheFragment::showEntries(entriesType const& entries) {
     }
 }
 
-void CacheFragment::splitCacheEntries(int const tabIdx1, int const colIdx1, int const tabIdx2, int const colIdx2) {
+void CacheFragment::splitCacheEntries(
+    int const tabIdx1, int const colIdx1, int const tabIdx2, int const colIdx2, std::vector<int>& sources
+) {
     entriesType* new_entries = new entriesType();
     if (tabIdx1 == tabIdx2) {
-        for (entryType* const& cache_entry: *entries) {
+        for (int entry_idx = 0; entry_idx < entries->size(); entry_idx++) {
+            entryType* const& cache_entry = (*entries)[entry_idx];
             CompliedBlock& cb = *(*cache_entry)[tabIdx1];
-            const std::vector<CompliedBlock*>* slices = CompliedBlock::matchSlices(cb, colIdx1, colIdx2);
+            const std::vector<CompliedBlock*>* slices = CompliedBlock::matchSlices(cb, colIdx1, colIdx2, cbHolder);
             if (nullptr != slices) {
                 for (CompliedBlock* const& new_cb: *slices) {
                     entryType* new_entry = new entryType(*cache_entry);
                     (*new_entry)[tabIdx1] = new_cb;
                     new_entries->push_back(new_entry);
+                    sources.push_back(entry_idx);
                 }
             }
         }
     } else {
-        for (entryType* const& cache_entry: *entries) {
+        for (int entry_idx = 0; entry_idx < entries->size(); entry_idx++) {
+            entryType* const& cache_entry = (*entries)[entry_idx];
             CompliedBlock& cb1 = *(*cache_entry)[tabIdx1];
             CompliedBlock& cb2 = *(*cache_entry)[tabIdx2];
-            const MatchedSubCbs* slices = CompliedBlock::matchSlices(cb1, colIdx1, cb2, colIdx2);
+            const MatchedSubCbs* slices = CompliedBlock::matchSlices(cb1, colIdx1, cb2, colIdx2, cbHolder);
             const std::vector<CompliedBlock*> *cbs1;
             const std::vector<CompliedBlock*> *cbs2;
             if (cb1.getId() <= cb2.getId()) { // Handle symmetric operations
@@ -1234,22 +1750,23 @@ void CacheFragment::splitCacheEntries(int const tabIdx1, int const colIdx1, int
                     (*new_entry)[tabIdx1] = new_cb1;
                     (*new_entry)[tabIdx2] = new_cb2;
                     new_entries->push_back(new_entry);
+                    sources.push_back(entry_idx);
                 }
             }
         }
     }
-    releaseEntries();
-    entries = new_entries;
+    resetEntries(new_entries);
 }
 
-void CacheFragment::splitCacheEntries(int const tabIdx1, int const colIdx1, IntTable* const newRelation, int const colIdx2) {
+void CacheFragment::splitCacheEntries(
+    int const tabIdx1, int const colIdx1, IntTable* const newRelation, int const colIdx2, std::vector<int>& sources
+) {
     entriesType* new_entries = new entriesType();
-    for (entryType* const& cache_entry : *entries) {
+    for (int entry_idx = 0; entry_idx < entries->size(); entry_idx++) {
+        entryType* const& cache_entry = (*entries)[entry_idx];
         CompliedBlock& cb1 = *(*cache_entry)[tabIdx1];
-        CompliedBlock& cb2 = *CompliedBlock::create(
-            newRelation->getAllRows(), newRelation->getTotalRows(), newRelation->getTotalCols(), newRelation, false, false
-        );
-        const MatchedSubCbs* slices = CompliedBlock::matchSlices(cb1, colIdx1, cb2, colIdx2);
+        CompliedBlock& cb2 = *CompliedBlock::create(newRelation, false, cbHolder);
+        const MatchedSubCbs* slices = CompliedBlock::matchSlices(cb1, colIdx1, cb2, colIdx2, cbHolder);
         const std::vector<CompliedBlock*> *cbs1;
         const std::vector<CompliedBlock*> *cbs2;
         if (cb1.getId() <= cb2.getId()) { // Handle symmetric operations
@@ -1267,79 +1784,84 @@ void CacheFragment::splitCacheEntries(int const tabIdx1, int const colIdx1, IntT
                 (*new_entry)[tabIdx1] = new_cb1;
                 new_entry->push_back(new_cb2);
                 new_entries->push_back(new_entry);
+                sources.push_back(entry_idx);
             }
         }
     }
-    releaseEntries();
-    entries = new_entries;
+    resetEntries(new_entries);
 }
 
 void CacheFragment::matchCacheEntries(
-    int const matchedTabIdx, int const matchedColIdx, int const matchingTabIdx, int const matchingColIdx
+    int const matchedTabIdx, int const matchedColIdx, int const matchingTabIdx, int const matchingColIdx,
+    std::vector<int>& sources
 ) {
     entriesType* new_entries = new entriesType();
     if (matchedTabIdx == matchingTabIdx) {
-        for (entryType* const& cache_entry : *entries) {
+        for (int entry_idx = 0; entry_idx < entries->size(); entry_idx++) {
+            entryType* const& cache_entry = (*entries)[entry_idx];
             CompliedBlock& cb = *(*cache_entry)[matchedTabIdx];
-            int const matched_constant = cb.getComplianceSet()[0][matchedColIdx];
-            CompliedBlock* new_cb = CompliedBlock::getSlice(cb, matchingColIdx, matched_constant);
+            int const matched_constant = cb.getFirstRow()[matchedColIdx];
+            CompliedBlock* new_cb = CompliedBlock::getSlice(cb, matchingColIdx, matched_constant, cbHolder);
             if (nullptr != new_cb) {
                 entryType* new_entry = new entryType(*cache_entry);
                 (*new_entry)[matchedTabIdx] = new_cb;
                 new_entries->push_back(new_entry);
+                sources.push_back(entry_idx);
             }
         }
     } else {
-        for (entryType* const& cache_entry : *entries) {
+        for (int entry_idx = 0; entry_idx < entries->size(); entry_idx++) {
+            entryType* const& cache_entry = (*entries)[entry_idx];
             CompliedBlock& matched_cb = *(*cache_entry)[matchedTabIdx];
             CompliedBlock& matching_cb = *(*cache_entry)[matchingTabIdx];
-            int const matched_constant = matched_cb.getComplianceSet()[0][matchedColIdx];
-            CompliedBlock* new_cb = CompliedBlock::getSlice(matching_cb, matchingColIdx, matched_constant);
+            int const matched_constant = matched_cb.getFirstRow()[matchedColIdx];
+            CompliedBlock* new_cb = CompliedBlock::getSlice(matching_cb, matchingColIdx, matched_constant, cbHolder);
             if (nullptr != new_cb) {
                 entryType* new_entry = new entryType(*cache_entry);
                 (*new_entry)[matchingTabIdx] = new_cb;
                 new_entries->push_back(new_entry);
+                sources.push_back(entry_idx);
             }
         }
     }
-    releaseEntries();
-    entries = new_entries;
+    resetEntries(new_entries);
 }
 
 void CacheFragment::matchCacheEntries(
-    int const matchedTabIdx, int const matchedColIdx, IntTable* const newRelation, int matchingColIdx
+    int const matchedTabIdx, int const matchedColIdx, IntTable* const newRelation, int matchingColIdx,
+    std::vector<int>& sources
 ) {
     entriesType* new_entries = new entriesType();
-    for (entryType* const& cache_entry : *entries) {
+    for (int entry_idx = 0; entry_idx < entries->size(); entry_idx++) {
+        entryType* const& cache_entry = (*entries)[entry_idx];
         CompliedBlock& matched_cb = *(*cache_entry)[matchedTabIdx];
-        int const matched_constant = matched_cb.getComplianceSet()[0][matchedColIdx];
-        CompliedBlock& new_rel_cb = *CompliedBlock::create(
-            newRelation->getAllRows(), newRelation->getTotalRows(), newRelation->getTotalCols(), newRelation, false, false
-        );
-        CompliedBlock* new_cb = CompliedBlock::getSlice(new_rel_cb, matchingColIdx, matched_constant);
+        int const matched_constant = matched_cb.getFirstRow()[matchedColIdx];
+        CompliedBlock& new_rel_cb = *CompliedBlock::create(newRelation, false, cbHolder);
+        CompliedBlock* new_cb = CompliedBlock::getSlice(new_rel_cb, matchingColIdx, matched_constant, cbHolder);
         if (nullptr != new_cb) {
             entryType* new_entry = new entryType(*cache_entry);
             new_entry->push_back(new_cb);
             new_entries->push_back(new_entry);
+            sources.push_back(entry_idx);
         }
     }
-    releaseEntries();
-    entries = new_entries;
+    resetEntries(new_entries);
 }
 
-void CacheFragment::assignCacheEntries(int const tabIdx, int const colIdx, int const constant) {
+void CacheFragment::assignCacheEntries(int const tabIdx, int const colIdx, int const constant, std::vector<int>& sources) {
     entriesType* new_entries = new entriesType();
-    for (entryType* const& cache_entry : *entries) {
+    for (int entry_idx = 0; entry_idx < entries->size(); entry_idx++) {
+        entryType* const& cache_entry = (*entries)[entry_idx];
         CompliedBlock& cb = *(*cache_entry)[tabIdx];
-        CompliedBlock* new_cb = CompliedBlock::getSlice(cb, colIdx, constant);
+        CompliedBlock* new_cb = CompliedBlock::getSlice(cb, colIdx, constant, cbHolder);
         if (nullptr != new_cb) {
             entryType* new_entry = new entryType(*cache_entry);
             (*new_entry)[tabIdx] = new_cb;
             new_entries->push_back(new_entry);
+            sources.push_back(entry_idx);
         }
     }
-    releaseEntries();
-    entries = new_entries;
+    resetEntries(new_entries);
 }
 
 void CacheFragment::addVarInfo(int const vid, int const tabIdx, int const colIdx, bool const isPlv) {
@@ -1357,14 +1879,16 @@ void CacheFragment::addVarInfo(int const vid, int const tabIdx, int const colIdx
 }
 
 CacheFragment::const2EntriesMapType* CacheFragment::calcConst2EntriesMap(
-    entriesType const& entries, int const tabIdx, int const colIdx, int const arity
+    entriesType const& entries, int const tabIdx, int const colIdx, int const arity, CbHolder* const cbHolder,
+    const2SourcesMapType& const2SourcesMap
 ) {
     const2EntriesMapType* const_2_entries_map = new const2EntriesMapType();
-    for (entryType* const& cache_entry: entries) {
+    for (int entry_idx = 0; entry_idx < entries.size(); entry_idx++) {
+        entryType* const& cache_entry = entries[entry_idx];
         CompliedBlock& cb = *(*cache_entry)[tabIdx];
-        const std::vector<CompliedBlock*>& slices = CompliedBlock::splitSlices(cb, colIdx);
+        const std::vector<CompliedBlock*>& slices = CompliedBlock::splitSlices(cb, colIdx, cbHolder);
         for (CompliedBlock* const& slice: slices) {
-            int const constant = slice->getComplianceSet()[0][colIdx];
+            int const constant = slice->getFirstRow()[colIdx];
             entriesType* entries_of_the_value;
             const2EntriesMapType::iterator itr = const_2_entries_map->find(constant);
             if (itr == const_2_entries_map->end()) {
@@ -1376,50 +1900,63 @@ CacheFragment::const2EntriesMapType* CacheFragment::calcConst2EntriesMap(
             entryType* new_entry = new entryType(*cache_entry);
             (*new_entry)[tabIdx] = slice;
             entries_of_the_value->push_back(new_entry);
+            const2SourcesMap[constant].push_back(entry_idx);
         }
     }
     return const_2_entries_map;
 }
 
 void CacheFragment::mergeFragmentEntries(
-    const2EntriesMapType const& baseConst2EntriesMap, const2EntriesMapType const& mergingConst2EntriesMap
+    const2EntriesMapType const& baseConst2EntriesMap, const2SourcesMapType const& baseConst2SourcesMap,
+    const2EntriesMapType const& mergingConst2EntriesMap, const2SourcesMapType const& mergingConst2SourcesMap,
+    std::vector<int>& baseSources, std::vector<int>& mergingSources
 ) {
     entriesType* new_entries = new entriesType();
     for (std::pair<const int, entriesType*> const& base_map_kv: baseConst2EntriesMap) {
         const2EntriesMapType::const_iterator merging_itr = mergingConst2EntriesMap.find(base_map_kv.first);
         if (mergingConst2EntriesMap.end() != merging_itr) {
-            for (entryType* base_entry: *(base_map_kv.second)) {
-                for (entryType* merging_entry: *(merging_itr->second)) {
-                    entryType* new_entry = new entryType(*base_entry);
-                    new_entry->reserve(new_entry->size() + merging_entry->size());
-                    new_entry->insert(new_entry->end(), merging_entry->begin(), merging_entry->end());
+            std::vector<int> const& base_entry_sources = baseConst2SourcesMap.at(base_map_kv.first);
+            std::vector<int> const& merging_entry_sources = mergingConst2SourcesMap.at(base_map_kv.first);
+            entriesType const& base_entries = *(base_map_kv.second);
+            entriesType const& merging_entries = *(merging_itr->second);
+            for (int i = 0; i < base_entries.size(); i++) {
+                for (int j = 0; j < merging_entries.size(); j++) {
+                    entryType* new_entry = new entryType(*base_entries[i]);
+                    new_entry->reserve(new_entry->size() + merging_entries[j]->size());
+                    new_entry->insert(new_entry->end(), merging_entries[j]->begin(), merging_entries[j]->end());
                     new_entries->push_back(new_entry);
+                    baseSources.push_back(base_entry_sources[i]);
+                    mergingSources.push_back(merging_entry_sources[j]);
                 }
             }
         }
     }
-    releaseEntries();
-    entries = new_entries;
+    resetEntries(new_entries);
 }
 
 void CacheFragment::mergeFragmentEntries(
-    entriesType const& baseEntries, int const tabIdx, int const colIdx, const2EntriesMapType const& mergingConst2EntriesMap
+    entriesType const& baseEntries, int const tabIdx, int const colIdx, const2EntriesMapType const& mergingConst2EntriesMap,
+    const2SourcesMapType const& mergingConst2SourcesMap, std::vector<int>& baseSources, std::vector<int>& mergingSources
 ) {
     entriesType* new_entries = new entriesType();
-    for (entryType* const& base_entry: baseEntries) {
-        int const constant = (*base_entry)[tabIdx]->getComplianceSet()[0][colIdx];
+    for (int entry_idx = 0; entry_idx < baseEntries.size(); entry_idx++) {
+        entryType* const& base_entry = baseEntries[entry_idx];
+        int const constant = (*base_entry)[tabIdx]->getFirstRow()[colIdx];
         const2EntriesMapType::const_iterator merging_itr = mergingConst2EntriesMap.find(constant);
         if (mergingConst2EntriesMap.end() != merging_itr) {
-            for (entryType* merging_entry: *(merging_itr->second)) {
+            std::vector<int> const& merging_entry_sources = mergingConst2SourcesMap.at(constant);
+            entriesType const& merging_entries = *(merging_itr->second);
+            for (int j = 0; j < merging_entries.size(); j++) {
                 entryType* new_entry = new entryType(*base_entry);
-                new_entry->reserve(new_entries->size() + merging_entry->size());
-                new_entry->insert(new_entry->end(), merging_entry->begin(), merging_entry->end());
+                new_entry->reserve(new_entries->size() + merging_entries[j]->size());
+                new_entry->insert(new_entry->end(), merging_entries[j]->begin(), merging_entries[j]->end());
                 new_entries->push_back(new_entry);
+                baseSources.push_back(entry_idx);
+                mergingSources.push_back(merging_entry_sources[j]);
             }
         }
     }
-    releaseEntries();
-    entries = new_entries;
+    resetEntries(new_entries);
 }
 
 void CacheFragment::releaseConst2EntryMap(const2EntriesMapType* map) {
@@ -1432,84 +1969,254 @@ void CacheFragment::releaseConst2EntryMap(const2EntriesMapType* map) {
     delete map;
 }
 
-void CacheFragment::addCompletePlvBindings(
-    std::unordered_set<Record>& completeBindings, std::unordered_set<Record>* const plvBindingSets, int* const argTemplate,
-    int const bindingSetIdx, int const templateStartIdx, int const numSets
+int CacheFragment::collectCombinations(
+    std::vector<int> const& vids, IntTupleSet** & bindingSets, int const cap, int const threads
 ) const {
-    std::unordered_set<Record> const& plv_bindings = plvBindingSets[bindingSetIdx];
-    std::unordered_set<Record>::const_iterator itr = plv_bindings.begin();
-    int binding_length = itr->getArity();   // assertion: at least one element will be in the set
-    if (bindingSetIdx == numSets - 1) {
-        /* Complete each template and add to the set */
-        while (plv_bindings.end() != itr) {
-            int* plv_binding = itr->getArgs();
-            int* copy_start = argTemplate + templateStartIdx;
-            for (int i = 0; i < binding_length; i++) {
-                copy_start[i] = plv_binding[i];
-            }
-            int template_length = templateStartIdx + binding_length;
-            int* copied_binding = new int[template_length];
-            for (int i = 0; i < template_length; i++) {
-                copied_binding[i] = argTemplate[i];
-            }
-            if (!completeBindings.emplace(copied_binding, template_length).second) {
-                delete[] copied_binding;
+    int const total_entries = entries->size();
+    int const width = vids.size();
+    int const num_threads = (total_entries >= parallelMinEntries) ? std::min(threads, total_entries) : 1;
+    if (1 >= num_threads) {
+        bindingSets = new IntTupleSet*[1]{new IntTupleSet(width, total_entries)};
+        _evaluation_memory_cost += collectCombinationsInRange(vids, 0, total_entries, bindingSets, 1, cap);
+        return 1;
+    }
+
+    /* Each thread collects the combinations in a range of entries into its own partitions */
+    IntTupleSet** local_sets = new IntTupleSet*[num_threads * num_threads];
+    std::vector<size_t> local_mem_costs(num_threads, 0);
+    int const entries_per_thread = (total_entries + num_threads - 1) / num_threads;
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (int t = 0; t < num_threads; t++) {
+        workers.emplace_back([&, t]() {
+            IntTupleSet** const partitions = local_sets + t * num_threads;
+            for (int p = 0; p < num_threads; p++) {
+                partitions[p] = new IntTupleSet(width, entries_per_thread / num_threads);
             }
-            itr++;
-        }
-    } else {
-        /* Complete part of the template and move to next recursion */
-        while (plv_bindings.end() != itr) {
-            int* plv_binding = itr->getArgs();
-            int* copy_start = argTemplate + templateStartIdx;
-            for (int i = 0; i < binding_length; i++) {
-                copy_start[i] = plv_binding[i];
-            }
-            addCompletePlvBindings(
-                    completeBindings, plvBindingSets, argTemplate, bindingSetIdx+1, templateStartIdx+binding_length, numSets
-            );
-            itr++;
-        }
+            int const begin = std::min(t * entries_per_thread, total_entries);
+            int const end = std::min(begin + entries_per_thread, total_entries);
+            local_mem_costs[t] = collectCombinationsInRange(vids, begin, end, partitions, num_threads, cap);
+        });
+    }
+    for (std::thread& worker: workers) {
+        worker.join();
+    }
+
+    /* Each thread merges one partition. The partitions are disjoint, so no lock is needed */
+    for (int p = 0; p < num_threads * num_threads; p++) {
+        _evaluation_memory_cost += local_sets[p]->memoryCost();
+    }
+    workers.clear();
+    bindingSets = new IntTupleSet*[num_threads];
+    for (int p = 0; p < num_threads; p++) {
+        workers.emplace_back([&, p]() {
+            IntTupleSet* const merged = local_sets[p];
+            for (int t = 1; t < num_threads; t++) {
+                IntTupleSet* const local_set = local_sets[t * num_threads + p];
+                for (size_t i = 0; i < local_set->size(); i++) {
+                    merged->insert((*local_set)[i]);
+                }
+                delete local_set;
+            }
+            bindingSets[p] = merged;
+        });
+    }
+    for (std::thread& worker: workers) {
+        worker.join();
+    }
+    delete[] local_sets;
+    for (size_t const& cost: local_mem_costs) {
+        _evaluation_memory_cost += cost;
+    }
+    return num_threads;
+}
+
+/**
+ * Add a tuple to one of the hash-partitioned sets.
+ *
+ * @return Whether the tuple is newly added
+ */
+static inline bool addToPartition(sinc::IntTupleSet** const sets, int const numSets, int const* const tuple) {
+    if (1 == numSets) {
+        return sets[0]->insert(tuple);
     }
+    uint64_t const hash = sinc::IntTupleSet::hashTuple(tuple, sets[0]->getWidth());
+    return sets[(hash >> 32) % numSets]->insert(tuple, hash);
 }
 
-void CacheFragment::addPlvBindings2Templates(
-    std::unordered_set<Record>& templateSet, std::unordered_set<Record>* const plvBindingSets,
-    std::vector<int>** const plv2TemplateIdxLists, int* const argTemplate, int const setIdx, int const numSets, int const templateLength
+size_t CacheFragment::collectCombinationsInRange(
+    std::vector<int> const& vids, int const begin, int const end, IntTupleSet** const bindingSets, int const numSets,
+    int const cap
 ) const {
-    std::unordered_set<Record> const& plv_bindings = plvBindingSets[setIdx];
-    std::vector<int> const& plv_2_template_idxs = *(plv2TemplateIdxLists[setIdx]);
-    if (setIdx == numSets - 1) {
-        /* Finish the last group of PLVs, add to the template set */
-        for (Record const& plv_binding: plv_bindings) {
-            for (int i = 0; i < plv_binding.getArity(); i++) {
-                argTemplate[plv_2_template_idxs[i]] = plv_binding.getArgs()[i];
-            }
-            int* copied_binding = new int[templateLength];
-            for (int i = 0; i < templateLength; i++) {
-                copied_binding[i] = argTemplate[i];
+    /* Split LVs and PLVs and find the locations of the vars */
+    /* Also, group PLVs within tabs */
+    std::vector<int const*> lv_columns;
+    std::vector<int> lv_template_idxs;
+    std::vector<int> plv_col_idx_lists[partAssignedRule.size()];    // Table index is the index of the array
+    std::vector<int> plv_2_template_idx_lists[partAssignedRule.size()];
+    std::vector<int> tab_idxs_with_plvs;
+    lv_columns.reserve(vids.size());
+    lv_template_idxs.reserve(vids.size());
+    tab_idxs_with_plvs.reserve(vids.size());
+    for (int template_idx = 0; template_idx < vids.size(); template_idx++) {
+        VarInfo const& var_info = varInfoList[vids[template_idx]];    // This shall NOT be empty
+        if (var_info.isPlv) {
+            if (plv_col_idx_lists[var_info.tabIdx].empty()) {
+                tab_idxs_with_plvs.push_back(var_info.tabIdx);
+                plv_col_idx_lists[var_info.tabIdx].reserve(vids.size());
+                plv_2_template_idx_lists[var_info.tabIdx].reserve(vids.size());
             }
-            if (!templateSet.emplace(copied_binding, templateLength).second) {
-                delete[] copied_binding;
+            plv_col_idx_lists[var_info.tabIdx].push_back(var_info.colIdx);
+            plv_2_template_idx_lists[var_info.tabIdx].push_back(template_idx);
+        } else {
+            lv_template_idxs.push_back(template_idx);
+            lv_columns.push_back(lvColumns[vids[template_idx]].data());
+        }
+    }
+    size_t mem_cost = sizeof(lv_columns) + sizeof(int*) * lv_columns.capacity() + sizeof(lv_template_idxs) +
+        sizeof(int) * lv_template_idxs.capacity() + sizeof(plv_col_idx_lists) + sizeof(plv_2_template_idx_lists) +
+        sizeof(tab_idxs_with_plvs) + sizeof(int) * tab_idxs_with_plvs.capacity();
+    for (int i = 0; i < partAssignedRule.size(); i++) {
+        mem_cost += sizeof(int) * (plv_col_idx_lists[i].capacity() + plv_2_template_idx_lists[i].capacity());
+    }
+
+    int const total_lvs = lv_columns.size();
+    int binding[vids.size()];
+    int total_added = 0;
+    if (tab_idxs_with_plvs.empty()) {
+        /* No PLV. Just collect all combinations of LVs */
+        for (int entry_idx = begin; entry_idx < end && total_added <= cap; entry_idx++) {
+            for (int i = 0; i < total_lvs; i++) {
+                binding[lv_template_idxs[i]] = lv_columns[i][entry_idx];
             }
+            total_added += addToPartition(bindingSets, numSets, binding);
         }
     } else {
-        /* Add current binding to the template and move to the next recursion */
-        for (Record const& plv_binding: plv_bindings) {
-            for (int i = 0; i < plv_binding.getArity(); i++) {
-                argTemplate[plv_2_template_idxs[i]] = plv_binding.getArgs()[i];
+        int const num_tabs_with_plvs = tab_idxs_with_plvs.size();
+        IntTupleSet* plv_bindings_within_tab_sets[num_tabs_with_plvs];
+        std::vector<int> const* plv_2_template_idx_within_tab_lists[num_tabs_with_plvs];
+        for (int i = 0; i < num_tabs_with_plvs; i++) {
+            int const tab_idx = tab_idxs_with_plvs[i];
+            plv_bindings_within_tab_sets[i] = new IntTupleSet(plv_col_idx_lists[tab_idx].size());
+            plv_2_template_idx_within_tab_lists[i] = &(plv_2_template_idx_lists[tab_idx]);
+        }
+        mem_cost += sizeof(plv_bindings_within_tab_sets) + sizeof(plv_2_template_idx_within_tab_lists);
+        int plv_binding_within_tab[vids.size()];
+        for (int entry_idx = begin; entry_idx < end && total_added <= cap; entry_idx++) {
+            entryType* const& cache_entry = (*entries)[entry_idx];
+
+            /* Find LV binding first */
+            for (int i = 0; i < total_lvs; i++) {
+                binding[lv_template_idxs[i]] = lv_columns[i][entry_idx];
+            }
+
+            /* Collect PLV bindings within each table */
+            for (int i = 0; i < num_tabs_with_plvs; i++) {
+                std::vector<int>& plv_col_idxs = plv_col_idx_lists[tab_idxs_with_plvs[i]];
+                IntTupleSet& plv_bindings = *plv_bindings_within_tab_sets[i];
+                plv_bindings.clear();
+                CompliedBlock* cb = (*cache_entry)[tab_idxs_with_plvs[i]];
+                for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
+                    const int* cs_record = cb->getRow(row_idx);
+                    for (int j = 0; j < plv_col_idxs.size(); j++) {
+                        plv_binding_within_tab[j] = cs_record[plv_col_idxs[j]];
+                    }
+                    plv_bindings.insert(plv_binding_within_tab);
+                }
             }
-            addPlvBindings2Templates(templateSet, plvBindingSets, plv2TemplateIdxLists, argTemplate, setIdx + 1, numSets, templateLength);
+
+            /* Cartesian product all the PLVs */
+            total_added += addCompletePlvBindings(
+                bindingSets, numSets, plv_bindings_within_tab_sets, plv_2_template_idx_within_tab_lists, binding, 0,
+                num_tabs_with_plvs
+            );
+        }
+        for (int i = 0; i < num_tabs_with_plvs; i++) {
+            mem_cost += plv_bindings_within_tab_sets[i]->memoryCost();
+            delete plv_bindings_within_tab_sets[i];
+        }
+    }
+    return mem_cost;
+}
+
+int CacheFragment::addCompletePlvBindings(
+    IntTupleSet** const completeBindingSets, int const numCompleteSets, IntTupleSet* const* const plvBindingSets,
+    std::vector<int> const* const* const plv2TemplateIdxLists, int* const argTemplate, int const setIdx, int const numSets
+) const {
+    int total_added = 0;
+    IntTupleSet const& plv_bindings = *plvBindingSets[setIdx];
+    std::vector<int> const& template_idxs = *plv2TemplateIdxLists[setIdx];
+    for (size_t i = 0; i < plv_bindings.size(); i++) {
+        int const* const plv_binding = plv_bindings[i];
+        for (int j = 0; j < template_idxs.size(); j++) {
+            argTemplate[template_idxs[j]] = plv_binding[j];
+        }
+        if (setIdx == numSets - 1) {
+            /* Complete the template and add to the sets */
+            total_added += addToPartition(completeBindingSets, numCompleteSets, argTemplate);
+        } else {
+            /* Complete part of the template and move to next recursion */
+            total_added += addCompletePlvBindings(
+                completeBindingSets, numCompleteSets, plvBindingSets, plv2TemplateIdxLists, argTemplate, setIdx + 1, numSets
+            );
         }
     }
+    return total_added;
 }
 
 void CacheFragment::releaseEntries() {
-    for (entryType* entry: *entries) {
-        delete entry;
+    if (0 == --(*entriesReferences)) {
+        for (entryType* entry: *entries) {
+            delete entry;
+        }
+        delete entries;
+        delete entriesReferences;
     }
-    delete entries;
     entries = nullptr;
+    entriesReferences = nullptr;
+}
+
+void CacheFragment::resetEntries(entriesType* const newEntries) {
+    releaseEntries();
+    entries = newEntries;
+    entriesReferences = new std::atomic<int>(1);
+}
+
+void CacheFragment::updateLvColumns(
+    std::vector<int> const& sources, int const newLv, CacheFragment const* const merged,
+    std::vector<int> const* const mergedSources
+) {
+    {
+        std::lock_guard<std::mutex> lock(summaryMutex);
+        combinationSummaries.clear();
+    }
+    std::vector<std::vector<int>> new_columns(varInfoList.size());
+    for (int vid = 0; vid < varInfoList.size(); vid++) {
+        VarInfo const& var_info = varInfoList[vid];
+        if (var_info.isEmpty() || var_info.isPlv) {
+            continue;
+        }
+        std::vector<int>& column = new_columns[vid];
+        column.reserve(entries->size());
+        if (vid == newLv) {
+            /* The arguments of a newly assigned LV are not recorded yet */
+            for (entryType* const& entry: *entries) {
+                column.push_back((*entry)[var_info.tabIdx]->getFirstRow()[var_info.colIdx]);
+            }
+        } else if (vid < lvColumns.size() && !lvColumns[vid].empty()) {
+            std::vector<int> const& prev_column = lvColumns[vid];
+            for (int const& source: sources) {
+                column.push_back(prev_column[source]);
+            }
+        } else if (nullptr != merged && vid < merged->lvColumns.size() && !merged->lvColumns[vid].empty()) {
+            std::vector<int> const& merged_column = merged->lvColumns[vid];
+            for (int const& source: *mergedSources) {
+                column.push_back(merged_column[source]);
+            }
+        }
+        /* Otherwise, the previous entries are empty, and so are the current ones */
+    }
+    lvColumns.swap(new_columns);
 }
 
 /**
@@ -1545,12 +2252,12 @@ bool TabInfo::operator==(const TabInfo &another) const {
  * CachedRule
  */
 using sinc::CachedRule;
-size_t CachedRule::cumulatedCacheEntryMemoryCost = 0;
+std::atomic<size_t> CachedRule::cumulatedCacheEntryMemoryCost(0);
 
 CachedRule::CachedRule(
     int const headPredSymbol, int const arity, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap, SimpleKb& _kb,
-    std::unordered_set<Record> const* counterexamples
-) : Rule(headPredSymbol, arity, fingerprintCache, category2TabuSetMap), kb(_kb)
+    std::unordered_set<Record> const* counterexamples, CbHolder* const _cbHolder
+) : Rule(headPredSymbol, arity, fingerprintCache, category2TabuSetMap), kb(_kb), cbHolder(_cbHolder)
 {
     /* Initialize the E+-cache & T-cache */
     SimpleRelation* head_relation = kb.getRelation(headPredSymbol);
@@ -1578,7 +2285,7 @@ CachedRule::CachedRule(
     //         headPredSymbol
     //     );
     // }
-    posCache = new CacheFragment(head_relation, headPredSymbol);
+    posCache = new CacheFragment(head_relation, headPredSymbol, cbHolder);
     maintainPosCache = true;
     // maintainEntCache = true;
 
@@ -1617,7 +2324,8 @@ CachedRule::CachedRule(
     // delete split_records;
 }
 
-CachedRule::CachedRule(const CachedRule& another) : Rule(another), kb(another.kb), posCache(another.posCache), maintainPosCache(false),
+CachedRule::CachedRule(const CachedRule& another) : Rule(another), kb(another.kb), cbHolder(another.cbHolder), posCache(another.posCache),
+    maintainPosCache(false),
     // entCache(another.entCache), maintainEntCache(false), 
     allCache(another.allCache), maintainAllCache(false),
     // cegCache(another.cegCache), maintainCegCache(false),
@@ -1625,7 +2333,7 @@ CachedRule::CachedRule(const CachedRule& another) : Rule(another), kb(another.kb
 {}
 
 CachedRule::~CachedRule() {
-    cumulatedCacheEntryMemoryCost -= getCacheEntryMemoryCost();
+    cumulatedCacheEntryMemoryCost -= cumulatedCacheEntryMemoryCostShare;
     if (maintainPosCache) {
         delete posCache;
     }
@@ -1682,27 +2390,24 @@ sinc::EvidenceBatch* CachedRule::getEvidenceAndMarkEntailment() {
         /* Find the grounding body */
         int** grounding_template = new int*[structure.size()];
         for (int pred_idx = FIRST_BODY_PRED_IDX; pred_idx < structure.size(); pred_idx++) {
-            grounding_template[pred_idx] = (*cache_entry)[pred_idx]->getComplianceSet()[0];
+            grounding_template[pred_idx] = (*cache_entry)[pred_idx]->getFirstRow();
         }
 
-        /* Find all entailed records */
+        /* Find all entailed records. Rows of head CBs are identified by row ids in the target relation */
         CompliedBlock const& cb = *(*cache_entry)[HEAD_PRED_IDX];
-        int* const* head_records = cb.getComplianceSet();
         if (1 < cb.getTotalRows()) {
             for (int i = 0; i < cb.getTotalRows(); i++) {
-                int* head_record = head_records[i];
-                if (target_relation.entailIfNot(head_record)) {
+                if (target_relation.entailIfNotById(cb.getRowId(i))) {
                     int** grounding = new int*[structure.size()];
                     std::copy(grounding_template + 1, grounding_template + structure.size(), grounding + 1);
-                    grounding[HEAD_PRED_IDX] = head_record;
+                    grounding[HEAD_PRED_IDX] = cb.getRow(i);
                     evidence_batch->evidenceList.push_back(grounding);
                 }
             }
             delete[] grounding_template;
         } else {
-            int* head_record = head_records[0];
-            if (target_relation.entailIfNot(head_record)) {
-                grounding_template[HEAD_PRED_IDX] = head_record;
+            if (target_relation.entailIfNotById(cb.getRowId(0))) {
+                grounding_template[HEAD_PRED_IDX] = cb.getFirstRow();
                 evidence_batch->evidenceList.push_back(grounding_template);
             } else {
                 delete[] grounding_template;
@@ -1781,7 +2486,7 @@ std::unordered_set<sinc::Record>* CachedRule::getCounterexamples() const {
         for (int frag_idx = 0; frag_idx < allCache->size(); frag_idx++) {
             if (!gvids_in_all_cache_fragments[frag_idx].empty()) {
                 valid_frag_indices.push_back(frag_idx);
-                bindings_in_fragments[frag_idx] = (*allCache)[frag_idx]->enumerateCombinations(gvids_in_all_cache_fragments[frag_idx]); // TODO: Directly instantiate bindings to template, so that the following function call can be removed
+                bindings_in_fragments[frag_idx] = (*allCache)[frag_idx]->enumerateCombinations(gvids_in_all_cache_fragments[frag_idx], evalThreads); // TODO: Directly instantiate bindings to template, so that the following function call can be removed
             }
         }
         generateHeadTemplates(
@@ -1837,7 +2542,9 @@ std::unordered_set<sinc::Record>* CachedRule::getCounterexamples() const {
 }
 
 void CachedRule::releaseMemory() {
-    cumulatedCacheEntryMemoryCost -= getCacheEntryMemoryCost();
+    cumulatedCacheEntryMemoryCost -= cumulatedCacheEntryMemoryCostShare;
+    cumulatedCacheEntryMemoryCostShare = 0;
+    cacheEntryMemoryCost = 0;
     if (maintainPosCache) {
         delete posCache;
         maintainPosCache = false;
@@ -1933,8 +2640,9 @@ size_t CachedRule::getCacheEntryMemoryCost() {
 }
 
 size_t CachedRule::addCumulatedCacheEntryMemoryCost(CachedRule* rule) {
-    cumulatedCacheEntryMemoryCost += rule->getCacheEntryMemoryCost();
-    return cumulatedCacheEntryMemoryCost;
+    size_t const cost = rule->getCacheEntryMemoryCost();
+    rule->cumulatedCacheEntryMemoryCostShare += cost;
+    return cumulatedCacheEntryMemoryCost += cost;
 }
 
 size_t CachedRule::getCumulatedCacheEntryMemoryCost() {
@@ -1981,18 +2689,19 @@ void CachedRule::obtainAllCache() {
 double CachedRule::recordCoverage() {
     int new_pos_ent = 0;
     SimpleRelation const& head_relation = *kb.getRelation(getHead().getPredSymbol());
-    std::unordered_set<const void*> used_rows;
+    std::vector<bool> used_rows(head_relation.getTotalRows(), false);
     std::unordered_set<const void*> used_cbs;
-    used_rows.reserve(head_relation.getTotalRows());
     used_cbs.reserve(posCache->getEntries().size());
     for (CacheFragment::entryType* const& entry: posCache->getEntries()) {
         CompliedBlock const* cb = (*entry)[HEAD_PRED_IDX];
         if (used_cbs.emplace(cb).second) {
-            int* const* const rows = cb->getComplianceSet();
             for (int i = 0; i < cb->getTotalRows(); i++) {
-                int* const row = rows[i];
-                if (used_rows.emplace(row).second && !head_relation.isEntailed(row)) {
-                    new_pos_ent++;
+                int const row_id = cb->getRowId(i);
+                if (!used_rows[row_id]) {
+                    used_rows[row_id] = true;
+                    if (!head_relation.isEntailedById(row_id)) {
+                        new_pos_ent++;
+                    }
                 }
             }
         }
@@ -2000,6 +2709,154 @@ double CachedRule::recordCoverage() {
     return ((double) new_pos_ent) / kb.getRelation(getHead().getPredSymbol())->getTotalRows();
 }
 
+std::vector<int> CachedRule::countCase5PosEntailments(
+    int const predIdx, int const argIdx, std::vector<int> const& constants
+) const {
+    std::vector<int> counts(constants.size(), 0);
+    std::unordered_map<int, int> const_2_idx;
+    const_2_idx.reserve(constants.size());
+    for (int i = 0; i < constants.size(); i++) {
+        const_2_idx.emplace(constants[i], i);
+    }
+
+    /* A head row is entailed by the specialization of a constant if it is in an entry where the argument can be the constant.
+       The E+-cache is indexed in the same way as the rule structure. The new positive head rows are grouped by constants */
+    SimpleRelation const& head_relation = *kb.getRelation(getHead().getPredSymbol());
+    std::vector<std::vector<int>> const_rows(constants.size());
+    std::vector<int> const_indices;
+    for (CacheFragment::entryType* const& entry: posCache->getEntries()) {
+        CompliedBlock const& head_cb = *(*entry)[HEAD_PRED_IDX];
+        if (HEAD_PRED_IDX == predIdx) {
+            for (int i = 0; i < head_cb.getTotalRows(); i++) {
+                std::unordered_map<int, int>::const_iterator itr = const_2_idx.find(head_cb.getRow(i)[argIdx]);
+                int const row_id = head_cb.getRowId(i);
+                if (const_2_idx.end() != itr && !head_relation.isEntailedById(row_id)) {
+                    const_rows[itr->second].push_back(row_id);
+                }
+            }
+        } else {
+            CompliedBlock const& cb = *(*entry)[predIdx];
+            const_indices.clear();
+            for (int i = 0; i < cb.getTotalRows(); i++) {
+                std::unordered_map<int, int>::const_iterator itr = const_2_idx.find(cb.getRow(i)[argIdx]);
+                if (const_2_idx.end() != itr) {
+                    const_indices.push_back(itr->second);
+                }
+            }
+            std::sort(const_indices.begin(), const_indices.end());
+            const_indices.erase(std::unique(const_indices.begin(), const_indices.end()), const_indices.end());
+            for (int const& const_idx: const_indices) {
+                std::vector<int>& rows = const_rows[const_idx];
+                for (int i = 0; i < head_cb.getTotalRows(); i++) {
+                    int const row_id = head_cb.getRowId(i);
+                    if (!head_relation.isEntailedById(row_id)) {
+                        rows.push_back(row_id);
+                    }
+                }
+            }
+        }
+    }
+
+    /* A head row may be in multiple entries, so duplications are removed by the flags, which are reset for each constant */
+    std::vector<bool> used_rows(head_relation.getTotalRows(), false);
+    for (int i = 0; i < constants.size(); i++) {
+        std::vector<int>& rows = const_rows[i];
+        for (int const& row_id: rows) {
+            if (!used_rows[row_id]) {
+                used_rows[row_id] = true;
+                counts[i]++;
+            }
+        }
+        for (int const& row_id: rows) {
+            used_rows[row_id] = false;
+        }
+        std::vector<int>().swap(rows);
+    }
+    return counts;
+}
+
+std::vector<int> CachedRule::countJoinPosEntailments(
+    int const predIdx, int const argIdx, std::vector<std::pair<int, int>> const& columns
+) const {
+    /* Group the new positive head rows by the arguments at the location */
+    SimpleRelation const& head_relation = *kb.getRelation(getHead().getPredSymbol());
+    std::unordered_map<int, std::vector<int>> arg_2_rows;
+    std::vector<int> args;
+    for (CacheFragment::entryType* const& entry: posCache->getEntries()) {
+        CompliedBlock const& head_cb = *(*entry)[HEAD_PRED_IDX];
+        if (HEAD_PRED_IDX == predIdx) {
+            for (int i = 0; i < head_cb.getTotalRows(); i++) {
+                int const row_id = head_cb.getRowId(i);
+                if (!head_relation.isEntailedById(row_id)) {
+                    arg_2_rows[head_cb.getRow(i)[argIdx]].push_back(row_id);
+                }
+            }
+        } else {
+            CompliedBlock const& cb = *(*entry)[predIdx];
+            args.clear();
+            for (int i = 0; i < cb.getTotalRows(); i++) {
+                args.push_back(cb.getRow(i)[argIdx]);
+            }
+            std::sort(args.begin(), args.end());
+            args.erase(std::unique(args.begin(), args.end()), args.end());
+            for (int const& arg: args) {
+                std::vector<int>& rows = arg_2_rows[arg];
+                for (int i = 0; i < head_cb.getTotalRows(); i++) {
+                    int const row_id = head_cb.getRowId(i);
+                    if (!head_relation.isEntailedById(row_id)) {
+                        rows.push_back(row_id);
+                    }
+                }
+            }
+        }
+    }
+
+    for (std::pair<const int, std::vector<int>>& kv: arg_2_rows) {
+        std::sort(kv.second.begin(), kv.second.end());
+        kv.second.erase(std::unique(kv.second.begin(), kv.second.end()), kv.second.end());
+    }
+
+    /* Probe each column. A head row may be linked to multiple arguments, so duplications are removed by the flags */
+    std::vector<int> counts(columns.size(), 0);
+    std::vector<bool> used_rows(head_relation.getTotalRows(), false);
+    std::vector<int> used_row_ids;
+    for (int i = 0; i < columns.size(); i++) {
+        SimpleRelation const& relation = *kb.getRelation(columns[i].first);
+        int* const values = relation.valuesInColumn(columns[i].second);
+        int const num_values = relation.numValuesInColumn(columns[i].second);
+        auto count_rows = [&](std::vector<int> const& rows) {
+            for (int const& row_id: rows) {
+                if (!used_rows[row_id]) {
+                    used_rows[row_id] = true;
+                    used_row_ids.push_back(row_id);
+                }
+            }
+        };
+        if (num_values < arg_2_rows.size()) {
+            for (int j = 0; j < num_values; j++) {
+                std::unordered_map<int, std::vector<int>>::const_iterator itr = arg_2_rows.find(values[j]);
+                if (arg_2_rows.end() != itr) {
+                    count_rows(itr->second);
+                }
+            }
+        } else {
+            for (std::pair<const int, std::vector<int>> const& kv: arg_2_rows) {
+                if (std::binary_search(values, values + num_values, kv.first)) {
+                    count_rows(kv.second);
+                }
+            }
+        }
+        counts[i] = used_row_ids.size();
+        for (int const& row_id: used_row_ids) {
+            used_rows[row_id] = false;
+        }
+        used_row_ids.clear();
+    }
+    return counts;
+}
+
+const int CachedRule::MIN_SAMPLED_ENTRIES = 32;
+
 sinc::Eval CachedRule::calculateEval() {
     _evaluation_memory_cost = 0;
     evaluationMemoryCost = 0;
@@ -2041,51 +2898,98 @@ sinc::Eval CachedRule::calculateEval() {
     }
     _evaluation_memory_cost += sizeof(gvs_in_all_cache_fragments);
 
-    /* Count the number of entailments */
-    double all_ent = pow(kb.totalConstants(), head_uv_cnt + head_only_lvs.size());
-    double _gv_bindings = 1;
-    for (int i = 0; i < allCache->size(); i++) {
-        std::vector<int> const& vids = gvs_in_all_cache_fragments[i];
-        _evaluation_memory_cost += sizeof(int) * vids.capacity();
-        size_t _cost = _evaluation_memory_cost;
-        if (!vids.empty()) {
-            CacheFragment const& fragment = *(*allCache)[i];
-            int num_combinations = fragment.countCombinations(vids);
-            all_ent *= num_combinations;
-            _gv_bindings *= num_combinations;
-            evaluationMemoryCost = std::max(evaluationMemoryCost, _evaluation_memory_cost);
-            _evaluation_memory_cost = _cost;
-        }
-    }
-    max_gv_bindings = std::max(max_gv_bindings, _gv_bindings);
+    /* Count the positive entailments first. The number is exact and bounds the number of all entailments */
+    /* If sampled, the head CBs are the sampling units: a CB is included iff the hash of its first row falls below the
+       sample ratio, so the head records are sampled in clusters, and the same records are sampled across the candidates.
+       The numbers are estimated by the Horvitz-Thompson estimator, whose variance is estimated from the sampled CBs */
     int new_pos_ent = 0;
     int already_ent = 0;
+    double pos_ent_var = 0;
     SimpleRelation const& head_relation = *kb.getRelation(head_pred.getPredSymbol());
-    std::unordered_set<const void*> used_rows;
+    bool const sampling = 1.0 > evalSampleRatio && MIN_SAMPLED_ENTRIES <= evalSampleRatio * posCache->getEntries().size();
+    uint64_t const sample_threshold = sampling ? evalSampleRatio * std::numeric_limits<uint64_t>::max() : 0;
+    auto cb_sampled = [sample_threshold](CompliedBlock const* const cb) {
+        uint64_t h = cb->getRowId(0) + 0x9e3779b97f4a7c15ULL;  // SplitMix64 finalizer
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return (h ^ (h >> 31)) < sample_threshold;
+    };
+    std::vector<bool> used_rows(head_relation.getTotalRows(), false);
     std::unordered_set<const void*> used_cbs;
-    used_rows.reserve(head_relation.getTotalRows());
     used_cbs.reserve(posCache->getEntries().size());
     for (CacheFragment::entryType* const& entry: posCache->getEntries()) {
         CompliedBlock const* cb = (*entry)[HEAD_PRED_IDX];
-        if (used_cbs.emplace(cb).second) {
-            int* const* const rows = cb->getComplianceSet();
+        if (used_cbs.emplace(cb).second && (!sampling || (0 < cb->getTotalRows() && cb_sampled(cb)))) {
+            int cb_pos_ent = 0;
             for (int i = 0; i < cb->getTotalRows(); i++) {
-                int* const row = rows[i];
-                if (used_rows.emplace(row).second) {
-                    if (head_relation.isEntailed(row)) {
+                int const row_id = cb->getRowId(i);
+                if (!used_rows[row_id]) {
+                    used_rows[row_id] = true;
+                    if (head_relation.isEntailedById(row_id)) {
                         already_ent++;
                     } else {
-                        new_pos_ent++;
+                        cb_pos_ent++;
                     }
                 }
             }
-        }
-    }
-    _evaluation_memory_cost += sizeOfUnorderedSet(
-        used_rows.bucket_count(), used_rows.max_load_factor(), sizeof(void*), sizeof(used_rows)
-    ) + sizeOfUnorderedSet(
+            new_pos_ent += cb_pos_ent;
+            pos_ent_var += (double) cb_pos_ent * cb_pos_ent;
+        }
+    }
+    double pos_ent = new_pos_ent;
+    double pos_ent_lower = new_pos_ent;
+    double pos_ent_upper = new_pos_ent;
+    double already_ent_est = already_ent;
+    if (sampling) {
+        pos_ent = new_pos_ent / evalSampleRatio;
+        already_ent_est = already_ent / evalSampleRatio;
+        double const half_width = evalSampleZ * std::sqrt(pos_ent_var * (1 - evalSampleRatio)) / evalSampleRatio;
+        pos_ent_upper = std::min(pos_ent + half_width, (double) head_relation.getTotalRows() - already_ent);
+        pos_ent = std::min(pos_ent, pos_ent_upper);
+        pos_ent_lower = std::max(pos_ent - half_width, (double) new_pos_ent);
+    }
+    _evaluation_memory_cost += sizeof(used_rows) + used_rows.capacity() / 8 + sizeOfUnorderedSet(
         used_cbs.bucket_count(), used_cbs.max_load_factor(), sizeof(void*), sizeof(used_cbs)
     );
+
+    /* Count the number of entailments */
+    /* If the rule certainly cannot beat the cutoff score, stop counting once the lower bound of the entailments reaches the
+       bound given by the cutoff (all remaining fragments contribute at least one combination) */
+    double const prev_comp_ratio = eval.value(EvalMetric::Value::CompressionRatio);
+    double const prev_info_gain = eval.value(EvalMetric::Value::InfoGain);
+    double const max_all_ent = Eval::maxAllEtls(
+        cutoffMetric, evalCutoff, pos_ent_upper, length, prev_comp_ratio, prev_info_gain
+    ) + already_ent_est;
+    double all_ent = pow(kb.totalConstants(), head_uv_cnt + head_only_lvs.size());
+    double _gv_bindings = 1;
+    for (int i = 0; i < allCache->size() && !evalAbandoned; i++) {
+        std::vector<int> const& vids = gvs_in_all_cache_fragments[i];
+        _evaluation_memory_cost += sizeof(int) * vids.capacity();
+        size_t _cost = _evaluation_memory_cost;
+        if (!vids.empty()) {
+            CacheFragment const& fragment = *(*allCache)[i];
+            double const cap = (0 < all_ent) ? std::floor(max_all_ent / all_ent) : max_all_ent;
+            bool const bounded = cap < std::numeric_limits<int>::max();
+            int num_combinations = fragment.countCombinations(
+                vids, bounded ? std::max(cap, 0.0) : std::numeric_limits<int>::max(), evalThreads
+            );
+            evalAbandoned = all_ent * num_combinations > max_all_ent && Eval(
+                pos_ent_upper, all_ent * num_combinations - already_ent_est, length, prev_comp_ratio, prev_info_gain
+            ).value(cutoffMetric) <= evalCutoff;
+            if (bounded && num_combinations > cap && !evalAbandoned) {
+                /* The bound is not tight enough due to rounding errors. Count the exact number */
+                num_combinations = fragment.countCombinations(vids, std::numeric_limits<int>::max(), evalThreads);
+            }
+            all_ent *= num_combinations;
+            _gv_bindings *= num_combinations;
+            evaluationMemoryCost = std::max(evaluationMemoryCost, _evaluation_memory_cost);
+            _evaluation_memory_cost = _cost;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(max_gv_bindings_mutex);
+        max_gv_bindings = std::max(max_gv_bindings, _gv_bindings);
+    }
     // evaluationMemoryCost = std::max(evaluationMemoryCost, _evaluation_memory_cost);
     // int already_ceg = cegCache->countTableSize(HEAD_PRED_IDX);
     long rss_finished = getMaxRss();
@@ -2093,10 +2997,16 @@ sinc::Eval CachedRule::calculateEval() {
 
     /* Update evaluation score */
     /* Those already proved should be excluded from the entire entailment set. Otherwise, they are counted as negative ones */
-    return Eval(
-        new_pos_ent, all_ent - already_ent, length, 
-        eval.value(EvalMetric::Value::CompressionRatio), eval.value(EvalMetric::Value::InfoGain)
-    );
+    /* If the evaluation is abandoned, `all_ent` is a lower bound and the score is optimistic */
+    /* If sampled, `all_ent` is still exact, and the estimated positive entailments never exceed it */
+    if (sampling) {
+        double const rest_ent = std::max(all_ent - already_ent_est, (double) new_pos_ent);
+        evalSampled = true;
+        evalLowerBound = Eval(std::min(pos_ent_lower, rest_ent), rest_ent, length, prev_comp_ratio, prev_info_gain);
+        evalUpperBound = Eval(std::min(pos_ent_upper, rest_ent), rest_ent, length, prev_comp_ratio, prev_info_gain);
+        return Eval(std::min(pos_ent, rest_ent), rest_ent, length, prev_comp_ratio, prev_info_gain);
+    }
+    return Eval(new_pos_ent, all_ent - already_ent, length, prev_comp_ratio, prev_info_gain);
     // return Eval(
     //     new_pos_ent, all_ent - already_ent - already_ceg, length, 
     //     eval.value(EvalMetric::Value::CompressionRatio), eval.value(EvalMetric::Value::InfoGain)
@@ -2200,7 +3110,7 @@ sinc::UpdateStatus CachedRule::specCase2HandlerPostPruning(int const predSymbol,
     }
     if (nullptr == updated_fragment) {
         /* The LV has not been included in body yet. Create a new fragment */
-        updated_fragment = new CacheFragment(new_relation, predSymbol);
+        updated_fragment = new CacheFragment(new_relation, predSymbol, cbHolder);
         updated_fragment->updateCase1a(0, argIdx, varId);
         predIdx2AllCacheTableInfo.emplace_back(allCache->size(), 0);
         allCache->push_back(updated_fragment);
@@ -2311,7 +3221,7 @@ sinc::UpdateStatus CachedRule::specCase4HandlerPostPruning(
     if (HEAD_PRED_IDX == predIdx2) {   // One is the head and the other is not
         /* Create a new fragment for the new predicate */
         predIdx2AllCacheTableInfo.emplace_back(allCache->size(), 0);
-        CacheFragment* fragment = new CacheFragment(new_relation, predSymbol);
+        CacheFragment* fragment = new CacheFragment(new_relation, predSymbol, cbHolder);
         fragment->updateCase1a(0, argIdx1, new_vid);
         allCache->push_back(fragment);
     } else {    // Both are in the body
@@ -2483,33 +3393,37 @@ RelationMinerWithCachedRule::RelationMinerWithCachedRule(
 
 RelationMinerWithCachedRule::~RelationMinerWithCachedRule() {
     for (Rule::fingerprintCacheType* const& cache: fingerprintCaches) {
-        for (const Fingerprint* const& fp: *cache) {
-            delete fp;
-        }
         delete cache;
     }
 }
 
+void RelationMinerWithCachedRule::run() {
+    RelationMiner::run();
+    monitor.maxCbPoolSize = std::max(monitor.maxCbPoolSize, CompliedBlock::totalNumCbs());
+    size_t total_idx = CompliedBlock::getNumCreationIndices() + CompliedBlock::getNumGetSliceIndices() + CompliedBlock::getNumSplitSlicesIndices() + CompliedBlock::getNumMatchSlices1Indices() + CompliedBlock::getNumMatchSlices2Indices();
+    monitor.maxCbPoolIdxSize = std::max(monitor.maxCbPoolIdxSize, total_idx);
+
+    /* The CBs of the KB relations are kept for the later miners */
+    CompliedBlock::release(cbHolder);
+    monitor.maxRetainedCbs = std::max(monitor.maxRetainedCbs, CompliedBlock::totalRetainedCbs());
+    monitor.maxRetainedCbMemCost = std::max(monitor.maxRetainedCbMemCost, CompliedBlock::retainedMemoryCost() / 1024);
+}
+
 size_t RelationMinerWithCachedRule::getFingerprintCacheMemCost() const {
     size_t size = sizeof(fingerprintCaches) + sizeof(Rule::fingerprintCacheType*) * fingerprintCaches.capacity();
     for (Rule::fingerprintCacheType* const& cache: fingerprintCaches) {
-        size += sizeOfUnorderedSet(
-            cache->bucket_count(), cache->max_load_factor(), sizeof(Fingerprint*), sizeof(Rule::fingerprintCacheType)
-        );
-        for (const Fingerprint* const& fp: *cache) {
-            size += fp->getMemCost();
-        }
+        size += cache->getMemCost();
     }
     return size;
 }
 
 size_t RelationMinerWithCachedRule::getTabuMapMemCost() const {
     size_t size = sizeof(Rule::tabuMapType) + sizeOfUnorderedMap(
-        tabuMap.bucket_count(), tabuMap.max_load_factor(), sizeof(std::pair<MultiSet<int>*, Rule::fingerprintCacheType*>), sizeof(tabuMap)
-    );
-    for (std::pair<MultiSet<int>*, Rule::fingerprintCacheType*> const& kv: tabuMap) {
+        tabuMap.bucket_count(), tabuMap.max_load_factor(), sizeof(std::pair<MultiSet<int>*, Rule::tabuSetType*>), sizeof(tabuMap)
+    ) + tabuMap.getIndexMemCost();
+    for (std::pair<MultiSet<int>*, Rule::tabuSetType*> const& kv: tabuMap) {
         size += kv.first->getMemoryCost();
-        Rule::fingerprintCacheType const& cache = *(kv.second);
+        Rule::tabuSetType const& cache = *(kv.second);
         size += sizeOfUnorderedSet(cache.bucket_count(), cache.max_load_factor(), sizeof(Fingerprint*), sizeof(cache));
     }
     return size;
@@ -2517,12 +3431,40 @@ size_t RelationMinerWithCachedRule::getTabuMapMemCost() const {
 
 sinc::Rule* RelationMinerWithCachedRule::getStartRule() {
     Rule::fingerprintCacheType* cache = new Rule::fingerprintCacheType();
-    fingerprintCaches.push_back(cache);
-    CachedRule* rule =  new CachedRule(targetRelation, kb.getRelation(targetRelation)->getTotalCols(), *cache, tabuMap, kb, &counterexamples);
+    {
+        std::lock_guard<std::shared_mutex> lock(tabuMap.getMutex());
+        fingerprintCaches.push_back(cache);
+    }
+    CachedRule* rule =  new CachedRule(
+        targetRelation, kb.getRelation(targetRelation)->getTotalCols(), *cache, tabuMap, kb, &counterexamples, &cbHolder
+    );
     monitor.cacheEntryMemCost = std::max(monitor.cacheEntryMemCost, CachedRule::addCumulatedCacheEntryMemoryCost(rule));
     return rule;
 }
 
+void RelationMinerWithCachedRule::addMemorySources(MemoryAccountant& accountant, std::vector<int>& ids) {
+    ids.push_back(accountant.addSource([this]() {
+        std::shared_lock<std::shared_mutex> lock(tabuMap.getMutex());
+        return getFingerprintCacheMemCost() + getTabuMapMemCost();
+    }));
+    ids.push_back(accountant.addSource([this]() {
+        return evalScratchMemCost.load();
+    }));
+}
+
+void RelationMinerWithCachedRule::measureBeamPressure(
+    std::vector<Rule*> const& candidates, AdaptiveBeamwidth::Pressure& pressure
+) {
+    size_t cache_cost = 0;
+    for (Rule* const& r: candidates) {
+        cache_cost += ((CachedRule*) r)->getCacheEntryMemoryCost();
+    }
+    std::lock_guard<std::recursive_mutex> lock(candidateMutex);
+    pressure.cacheKb = cache_cost / 1024;
+    pressure.evalMemKb = iterationEvalMemCost / 1024;
+    iterationEvalMemCost = 0;
+}
+
 void RelationMinerWithCachedRule::selectAsBeam(Rule* r) {
     CachedRule* rule = (CachedRule*) r;
     rule->updateCacheIndices();
@@ -2532,9 +3474,10 @@ void RelationMinerWithCachedRule::selectAsBeam(Rule* r) {
 }
 
 int RelationMinerWithCachedRule::checkThenAddRule(
-    UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates
+    UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates
 ) {
     CachedRule* rule = (CachedRule*) updatedRule;
+    std::lock_guard<std::recursive_mutex> lock(candidateMutex);
     if (UpdateStatus::Normal == updateStatus) {
         monitor.posCacheEntriesTotal += rule->getPosCache().getEntries().size();
         // monitor.entCacheEntriesTotal += rule->getEntCache().getEntries().size();
@@ -2560,10 +3503,53 @@ int RelationMinerWithCachedRule::checkThenAddRule(
     monitor.copyTime += rule->getCopyTime();
     monitor.cacheEntryMemCost = std::max(monitor.cacheEntryMemCost, CachedRule::addCumulatedCacheEntryMemoryCost(rule));
     monitor.maxEvalMemCost = std::max(monitor.maxEvalMemCost, rule->getEvaluationMemoryCost());
+    evalScratchMemCost = monitor.maxEvalMemCost;
+    iterationEvalMemCost = std::max(iterationEvalMemCost, rule->getEvaluationMemoryCost());
 
     return RelationMiner::checkThenAddRule(updateStatus, updatedRule, originalRule, candidates);
 }
 
+void RelationMinerWithCachedRule::screenCase5Constants(
+    Rule& rule, ArgLocation const& arg, std::vector<int> const& constants, TopKRules const& candidates,
+    std::vector<int>& survivors
+) {
+    std::vector<int> const pos_counts = ((CachedRule&) rule).countCase5PosEntailments(arg.predIdx, arg.argIdx, constants);
+    double const admission_score = admissionScore(rule, candidates);
+    survivors.clear();
+    for (int i = 0; i < constants.size(); i++) {
+        if (isPromisingSpecialization(rule, pos_counts[i], admission_score)) {
+            survivors.push_back(constants[i]);
+        } else {
+            boundPrunedRules++;
+        }
+    }
+}
+
+void RelationMinerWithCachedRule::screenJoinColumns(
+    Rule& rule, ArgLocation const& arg, std::vector<std::pair<int, int>> const& columns, TopKRules const& candidates,
+    std::vector<std::pair<int, int>>& survivors
+) {
+    std::vector<int> const pos_counts = ((CachedRule&) rule).countJoinPosEntailments(arg.predIdx, arg.argIdx, columns);
+    double const admission_score = admissionScore(rule, candidates);
+    survivors.clear();
+    for (int i = 0; i < columns.size(); i++) {
+        if (isPromisingSpecialization(rule, pos_counts[i], admission_score)) {
+            survivors.push_back(columns[i]);
+        } else {
+            boundPrunedRules++;
+        }
+    }
+}
+
+bool RelationMinerWithCachedRule::isPromisingSpecialization(Rule const& rule, int const posEtls, double const minScore) const {
+    /* The best case of a specialization is that it entails no negative record */
+    Eval const& eval = rule.getEval();
+    return Rule::MinFactCoverage < ((double) posEtls) / kb.getRelation(targetRelation)->getTotalRows() && Eval(
+        posEtls, posEtls, rule.getLength() + 1, eval.value(EvalMetric::Value::CompressionRatio),
+        eval.value(EvalMetric::Value::InfoGain)
+    ).value(evalMetric) > minScore;
+}
+
 /**
  * SincWithCache
  */
@@ -2571,22 +3557,26 @@ using sinc::SincWithCache;
 
 SincWithCache::SincWithCache(SincConfig* const config) : SInC(config) {}
 
-SincWithCache::SincWithCache(SincConfig* const config, SimpleKb* const kb) : SInC(config, kb) {}
+SincWithCache::SincWithCache(SincConfig* const config, SimpleKb* const kb, bool const sharedKb) : SInC(config, kb, sharedKb) {}
 
 void SincWithCache::getTargetRelations(int* & targetRelationIds, int& numTargets) {
     SInC::getTargetRelations(targetRelationIds, numTargets);
     CompliedBlock::reserveMemSpace(*kb);
+    CompliedBlock::setRetentionBudget(config->cbRetentionKb * 1024);
 }
 
 sinc::SincRecovery* SincWithCache::createRecovery() {
     return nullptr; // Todo: Implement here
 }
 
-sinc::RelationMiner* SincWithCache::createRelationMiner(int const targetRelationNum) {
-    return new RelationMinerWithCachedRule(
-        *kb, targetRelationNum, config->evalMetric, config->beamwidth, config->maxMemGByte * 1024 * 1024, config->stopCompressionRatio, predicate2NodeMap,
-        dependencyGraph, compressedKb->getHypothesis(), compressedKb->getCounterexampleSet(targetRelationNum), *logger
+sinc::RelationMiner* SincWithCache::createRelationMiner(int const targetRelationNum, MinerWorkspace& workspace) {
+    RelationMinerWithCachedRule* miner = new RelationMinerWithCachedRule(
+        *kb, targetRelationNum, config->evalMetric, config->beamwidth, config->maxMemGByte * 1024 * 1024, config->stopCompressionRatio,
+        workspace.predicate2NodeMap, workspace.dependencyGraph, workspace.hypothesis, compressedKb->getCounterexampleSet(targetRelationNum),
+        *workspace.logger
     );
+    miner->setEvaluationThreads(threadsPerMiner);
+    return miner;
 }
 
 void SincWithCache::finalizeRelationMiner(RelationMiner* miner) {
@@ -2612,10 +3602,10 @@ void SincWithCache::finalizeRelationMiner(RelationMiner* miner) {
     monitor.fingerprintCacheMemCost = std::max(monitor.fingerprintCacheMemCost, rel_miner->getFingerprintCacheMemCost());
     monitor.tabuMapMemCost = std::max(monitor.tabuMapMemCost, rel_miner->getTabuMapMemCost());
     monitor.maxEvalMemCost = std::max(monitor.maxEvalMemCost, rel_miner->monitor.maxEvalMemCost);
-    monitor.maxCbPoolSize = std::max(monitor.maxCbPoolSize, CompliedBlock::totalNumCbs());
-    size_t total_idx = CompliedBlock::getNumCreationIndices() + CompliedBlock::getNumGetSliceIndices() + CompliedBlock::getNumSplitSlicesIndices() + CompliedBlock::getNumMatchSlices1Indices() + CompliedBlock::getNumMatchSlices2Indices();
-    monitor.maxCbPoolIdxSize = std::max(monitor.maxCbPoolIdxSize, total_idx);
-    CompliedBlock::clearPool();
+    monitor.maxCbPoolSize = std::max(monitor.maxCbPoolSize, rel_miner->monitor.maxCbPoolSize);
+    monitor.maxCbPoolIdxSize = std::max(monitor.maxCbPoolIdxSize, rel_miner->monitor.maxCbPoolIdxSize);
+    monitor.maxRetainedCbs = std::max(monitor.maxRetainedCbs, rel_miner->monitor.maxRetainedCbs);
+    monitor.maxRetainedCbMemCost = std::max(monitor.maxRetainedCbMemCost, rel_miner->monitor.maxRetainedCbMemCost);
 
     /* Log memory usage */
     rusage usage;
@@ -2638,5 +3628,11 @@ void SincWithCache::showMonitor() {
 }
 
 void SincWithCache::finish() {
-    CompliedBlock::clearPool();
+    CompliedBlock::clearPool(sharedKb);
+}
+
+void SincWithCache::registerMemorySources(MemoryAccountant& accountant) {
+    accountant.addSource(CompliedBlock::trackedMemoryCost);
+    accountant.addSource(CachedRule::getCumulatedCacheEntryMemoryCost);
+    accountant.addReliever(CompliedBlock::releaseRetainedCbs);
 }
@@ -3,6 +3,10 @@
 #include "../base/sinc.h"
 #include "../kb/intTable.h"
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <mutex>
+#include <atomic>
 
 namespace sinc {
     /**
@@ -145,6 +149,33 @@ struct std::hash<const sinc::CbOprMatchSlicesTwoCbs> {
 };
 
 namespace sinc {
+    /**
+     * The CBs referred to by one user of the CB pool (e.g., a relation miner). The CB operations add the returned CBs to
+     * the holder, and the CBs are released by `CompliedBlock::release()` once no holder refers to them. Therefore, a
+     * finishing miner releases its own CBs while the CBs shared with the running miners are kept.
+     *
+     * NOTE: The set is guarded by the pool lock of `CompliedBlock`
+     *
+     * @since 2.6
+     */
+    class CbHolder {
+    public:
+        CbHolder();
+
+        /**
+         * Release the held CBs
+         */
+        ~CbHolder();
+
+        CbHolder(const CbHolder&) = delete;
+        CbHolder& operator=(const CbHolder&) = delete;
+
+    protected:
+        std::unordered_set<CompliedBlock*> cbs;
+
+        friend class CompliedBlock;
+    };
+
     /**
      * A simplified complied block structure. All instances of CB are maintained in a pool. This pool can be used to retrieve and
      * release related memory resources. Statistics of CBs, e.g., the number of generated CBs and memory consumption, can also be
@@ -154,6 +185,14 @@ namespace sinc {
      * and two overloads of `matchSlices()`. The four functions encapsulates corresponding functions of `IntTable` and manages the
      * creation of CBs, so that there will be no duplicated CBs in the pool.
      * 
+     * In v2.6, the compliance set is no longer an array of row pointers. Instead, each CB refers to a base table (typically the
+     * `SimpleRelation` where the rows are from) and stores the rows as 32-bit row ids in the base table (see `IntTable::rowIdOf()`).
+     * The ids can be used directly with the entailment flags of the relation.
+     * 
+     * Also in v2.6, CBs are referred to by `CbHolder`s. When a holder is released, the CBs no longer held by any holder
+     * are removed from the pool, except the base CBs (and the results of the operations on them) kept within the retention
+     * budget. The IDs of the removed CBs are reused by the new ones.
+     * 
      * @since 2.0
      */
     class CompliedBlock {
@@ -170,16 +209,15 @@ namespace sinc {
         static CompliedBlock* create(int** const complianceSet, int const totalRows, int const totalCols, bool maintainComplianceSet);
 
         /**
-         * Create a new CB and register it to the pool
+         * Create a new CB that contains all rows in a table and register it to the pool. The table is both the base table and the
+         * indices of the CB. CBs of the same table will NOT be duplicated.
          * 
-         * NOTE: Neither `complianceSet` nor `indices` should be `nullptr`
+         * NOTE: `table` should NOT be `nullptr`
          * 
-         * NOTE: The pointers `complianceSet` WILL be maintained by this CB object
+         * @param maintainTable Whether `table` WILL be maintained by this CB object
+         * @param holder        The holder of the returned CB (@since 2.6)
          */
-        static CompliedBlock* create(
-            int** const complianceSet, int const totalRows, int const totalCols, IntTable* indices,
-            bool maintainComplianceSet, bool maintainIndices
-        );
+        static CompliedBlock* create(IntTable* const table, bool maintainTable, CbHolder* const holder = nullptr);
 
         /**
          * This function encapsulates the `getSlice()` function of `IntTable`. It retrieves the results and corresponding CBs if they
@@ -189,7 +227,7 @@ namespace sinc {
          * 
          * @since 2.5
          */
-        static CompliedBlock* getSlice(const CompliedBlock& cb, int const col, int const val);
+        static CompliedBlock* getSlice(const CompliedBlock& cb, int const col, int const val, CbHolder* const holder = nullptr);
 
         /**
          * This function encapsulates the `splitSlices()` function of `IntTable`. It retrieves the results and corresponding CBs if
@@ -197,7 +235,7 @@ namespace sinc {
          * 
          * @since 2.5
          */
-        static std::vector<CompliedBlock*> const& splitSlices(const CompliedBlock& cb, int const col);
+        static std::vector<CompliedBlock*> const& splitSlices(const CompliedBlock& cb, int const col, CbHolder* const holder = nullptr);
 
         /**
          * This function encapsulates the `matchSlices()` function of `IntTable`. It retrieves the results and corresponding CBs if
@@ -219,7 +257,9 @@ namespace sinc {
          * 
          * @since 2.5
          */
-        static const MatchedSubCbs* matchSlices(const CompliedBlock& cb1, int const col1, const CompliedBlock& cb2, int const col2);
+        static const MatchedSubCbs* matchSlices(
+            const CompliedBlock& cb1, int const col1, const CompliedBlock& cb2, int const col2, CbHolder* const holder = nullptr
+        );
 
         /**
          * This function encapsulates the `matchSlices()` function of `IntTable`. It retrieves the results and corresponding CBs if
@@ -229,7 +269,9 @@ namespace sinc {
          * 
          * @since 2.5
          */
-        static const std::vector<CompliedBlock*>* matchSlices(const CompliedBlock& cb, int const col1, int const col2);
+        static const std::vector<CompliedBlock*>* matchSlices(
+            const CompliedBlock& cb, int const col1, int const col2, CbHolder* const holder = nullptr
+        );
 
         /**
          * This method estimates the amount of memory space for the CB pool and update maps
@@ -241,15 +283,71 @@ namespace sinc {
         /**
          * Release all pointers in the pool and clear the pool. All indices of CB update operations will also be cleared.
          * 
+         * If `retainBaseCbs` is true, CBs that are created from external tables (e.g., the relations in the KB) and the
+         * results of the operations directly on them (i.e., `getSlice()`, `splitSlices()`, and `matchSlices()`) are kept in
+         * the pool with their indices, as they do not change across relation miners. The most frequently used base CBs are
+         * kept first, as long as the memory cost of the kept CBs is within the retention budget. The kept CBs are renumbered
+         * from 0 in their original order.
+         * 
+         * NOTE: The holders are emptied, as the CBs they refer to may be released
+         * 
          * @since 2.4
          */
-        static void clearPool();
+        static void clearPool(bool const retainBaseCbs = false);
+
+        /**
+         * Release the CBs in `holder` and empty it. The CBs that are no longer held by any holder are removed from the pool,
+         * together with the indices of the operations on them or resulting in them. The most frequently used base CBs and the
+         * results of the operations on them are kept (like `clearPool(true)`) within the retention budget, as they may be
+         * reused by the later miners.
+         *
+         * @since 2.6
+         */
+        static void release(CbHolder& holder);
+
+        /**
+         * Set the memory budget (in bytes) of the CBs kept by `clearPool(true)` and `release()`. 0 means no CB is kept.
+         * 
+         * @since 2.6
+         */
+        static void setRetentionBudget(size_t const budget);
+
+        /**
+         * Remove the CBs kept by `release()` that are not held by any holder, together with the indices of the operations on
+         * them or resulting in them, to relieve memory pressure. The CBs held by the running miners are not affected.
+         *
+         * @return The amount of released memory (in bytes) of the CBs
+         * @since 2.6
+         */
+        static size_t releaseRetainedCbs();
+
+        /**
+         * The memory cost of the CBs in the pool, which is tracked when the CBs are created and indexed. This does not
+         * iterate over the pool as `totalCbMemoryCost()`.
+         *
+         * @since 2.6
+         */
+        static size_t trackedMemoryCost();
 
         /**
          * Count the total number of CBs in the pool
          */
         static size_t totalNumCbs();
 
+        /**
+         * Count the CBs kept by `release()` that are not held by any holder
+         *
+         * @since 2.6
+         */
+        static size_t totalRetainedCbs();
+
+        /**
+         * The memory cost of the CBs counted by `totalRetainedCbs()`
+         *
+         * @since 2.6
+         */
+        static size_t retainedMemoryCost();
+
         static size_t getNumCreation();
         static size_t getNumCreationHit();
         static size_t getNumCreationIndices();
@@ -274,12 +372,38 @@ namespace sinc {
         ~CompliedBlock();
 
         /**
-         * Build the indices if it is null
+         * Build the indices if it is null. CBs are shared by concurrent relation miners, so the indices are built only once
+         * even if this method is called by different threads at the same time. `getIndices()` is valid after this method
+         * returns.
          */
         void buildIndices();
 
         int getId() const;
-        int* const* getComplianceSet() const;
+
+        /**
+         * Get the idx-th row in the compliance set. The parameter should satisfy: 0 <= idx < totalRows.
+         */
+        int* getRow(int const idx) const;
+
+        /**
+         * Get the row id (in the base table) of the idx-th row in the compliance set.
+         * 
+         * @since 2.6
+         */
+        int getRowId(int const idx) const;
+
+        /**
+         * Get the first row in the compliance set. The pointer is cached in the CB so that arguments of LV columns (which are the
+         * same in all rows) can be read without looking up the base table.
+         * 
+         * @since 2.6
+         */
+        int* getFirstRow() const;
+
+        /**
+         * @since 2.6
+         */
+        const IntTable& getBase() const;
         const IntTable& getIndices() const;
         int getTotalRows() const;
         int getTotalCols() const;
@@ -296,7 +420,21 @@ namespace sinc {
         void showAll() const;
 
     protected:
+        /** NOTE: The slots of the removed CBs are `nullptr` until their IDs are reused */
         static std::vector<CompliedBlock*> pool;
+        /** The IDs of the removed CBs (@since 2.6) */
+        static std::vector<int> freeIds;
+        /** The registered holders, which are emptied when the pool is cleared (@since 2.6) */
+        static std::unordered_set<CbHolder*> holders;
+        /**
+         * This lock guards the pool and the operation maps, as the caches of rules may be updated by different threads. The
+         * operations hold the lock only to look up and insert the results. The slices are calculated without the lock, and
+         * if the same operation is done by another thread meanwhile, the calculated slices are discarded. Therefore, there
+         * are still no duplicated CBs in the pool.
+         *
+         * @since 2.6
+         */
+        static std::mutex poolMutex;
         /** This map is for fetching CBs by creation */
         static std::unordered_map<void*, CompliedBlock*> mapCreation;
         /** NOTE: The values will NOT be `nullptr` */
@@ -307,6 +445,10 @@ namespace sinc {
         static std::unordered_map<CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*> mapMatchSlicesOneCb;
         /** NOTE: The values MAY be `nullptr` */
         static std::unordered_map<CbOprMatchSlicesTwoCbs, MatchedSubCbs*> mapMatchSlicesTwoCbs;
+        /** The memory cost of the CBs in the pool (@since 2.6) */
+        static std::atomic<size_t> poolMemoryCost;
+        /** The memory budget (in bytes) of the CBs kept across `clearPool(true)` (@since 2.6) */
+        static size_t retentionBudget;
 
         /* Statistics of update operations */
         static size_t numCreation;
@@ -321,12 +463,27 @@ namespace sinc {
         static size_t numMatchSlices2Hit;
 
         /** Unique ID of the CB object. This is the same as the index of this object in the pool. */
-        int const id;
-        int** const complianceSet;
-        IntTable* indices;
+        int id;
+        /** The number of holders referring to this CB (@since 2.6) */
+        int references = 0;
+        /** Whether this CB is kept by `release()` without being held (@since 2.6) */
+        bool retained = false;
+        /** The number of operations on this CB, which ranks the base CBs for retention (@since 2.6) */
+        mutable size_t usage = 0;
+        /** The table where the rows are from */
+        IntTable* const base;
+        /** The compliance set denoted by row ids in `base`. If this is `nullptr`, the CB contains all rows in `base` */
+        int* const rowIds;
+        /** The cached pointer to the first row in the compliance set */
+        int* const firstRow;
+        /** The indices are published by `buildIndices()` after being built (@since 2.6) */
+        std::atomic<IntTable*> indices;
+        /** This flag guards the construction of `indices` (@since 2.6) */
+        std::once_flag indicesBuilt;
         int const totalRows;
         int const totalCols;
-        bool mainTainComplianceSet;
+        bool maintainBase;
+        /** NOTE: This is written before `indices` is published, so it SHOULD be read only if `indices` is not `nullptr` */
         bool maintainIndices;
 
         /**
@@ -335,20 +492,99 @@ namespace sinc {
         static void registerCb(CompliedBlock* cb);
 
         /**
-         * NOTE: The pointer `complianceSet` WILL be maintained by this CB object
+         * Get an ID for a new CB. The IDs of the removed CBs are reused first.
+         * 
+         * NOTE: `poolMutex` SHOULD be locked by the caller
+         * 
+         * @since 2.6
+         */
+        static int allocateId();
+
+        /**
+         * Add the CB(s) to the holder if `holder` is not `nullptr`.
+         * 
+         * NOTE: `poolMutex` SHOULD be locked by the caller
+         * 
+         * @since 2.6
+         */
+        static void hold(CbHolder* const holder, CompliedBlock* const cb);
+        static void hold(CbHolder* const holder, std::vector<CompliedBlock*> const* const cbs);
+        static void hold(CbHolder* const holder, MatchedSubCbs const* const subCbs);
+
+        /**
+         * Register/Unregister a holder so that it is emptied when the pool is cleared (@since 2.6)
+         */
+        static void registerHolder(CbHolder* const holder);
+        static void unregisterHolder(CbHolder* const holder);
+
+        /**
+         * Select the CBs that are kept by `release()` among the CBs that are not held. The base CBs are ranked by usage,
+         * and a base CB is kept together with the results of the operations on it (the operations on two CBs are counted
+         * when both are kept) within the retention budget.
+         * 
+         * NOTE: `poolMutex` SHOULD be locked by the caller
+         * 
+         * @param unheld The CBs that are not held, i.e., the released and the previously retained
+         * @since 2.6
          */
-        CompliedBlock(int const id, int** const complianceSet, int const totalRows, int const totalCols, bool maintainComplianceSet);
+        static void retainUnheldCbs(std::vector<CompliedBlock*> const& unheld);
 
         /**
-         * @param complianceSet This parameter shall NOT be `nullptr`
-         * @param indices This parameter shall NOT be `nullptr`
+         * Remove the CBs from the pool. The indices of the operations on them or resulting in them are also removed.
          * 
-         * NOTE: The pointers `complianceSet` and `indices` WILL be maintained by this CB object
+         * NOTE: `poolMutex` SHOULD be locked by the caller
+         * 
+         * @param removed The flags of the removed CBs, indexed by IDs
+         * @since 2.6
          */
-        CompliedBlock(
-            int const id, int** const complianceSet, int const totalRows, int const totalCols, IntTable* indices,
-            bool maintainComplianceSet, bool maintainIndices
+        static void removeCbs(std::vector<bool> const& removed);
+
+        friend class CbHolder;
+
+        /**
+         * Select the CBs kept by `clearPool(true)` and move the indices of their operations to the argument maps, keyed by
+         * the old IDs. The returned flags are indexed by the old IDs.
+         * 
+         * NOTE: `poolMutex` SHOULD be locked by the caller
+         * 
+         * @since 2.6
+         */
+        static std::vector<bool> selectRetainedCbs(
+            std::unordered_map<void*, CompliedBlock*>& retainedCreation, std::unordered_map<CbOprGetSlice, CompliedBlock*>& retainedGetSlice,
+            std::unordered_map<CbOprSplitSlices, std::vector<CompliedBlock*>*>& retainedSplitSlices,
+            std::unordered_map<CbOprMatchSlicesOneCb, std::vector<CompliedBlock*>*>& retainedMatchSlicesOneCb,
+            std::unordered_map<CbOprMatchSlicesTwoCbs, MatchedSubCbs*>& retainedMatchSlicesTwoCbs
         );
+
+        /**
+         * Convert a slice of rows in the base table of a CB to row ids in the base table.
+         * 
+         * NOTE: The returned array SHOULD be maintained by USER
+         * 
+         * @since 2.6
+         */
+        static int* sliceRowIds(CompliedBlock const& cb, IntTable::sliceType const& slice);
+
+        /**
+         * Create a CB with rows in the base table of another CB and register it to the pool.
+         * 
+         * NOTE: `poolMutex` SHOULD be locked by the caller
+         * 
+         * NOTE: The pointer `rowIds` WILL be maintained by the new CB object
+         */
+        static CompliedBlock* createBySlice(CompliedBlock const& cb, int* const rowIds, int const totalRows);
+
+        /**
+         * Create a CB containing all rows in `table`. `table` is also used as the indices of the CB.
+         */
+        CompliedBlock(int const id, IntTable* const table, bool maintainTable);
+
+        /**
+         * @param rowIds This parameter shall NOT be `nullptr`
+         * 
+         * NOTE: The pointer `rowIds` WILL be maintained by this CB object
+         */
+        CompliedBlock(int const id, IntTable* const base, int* const rowIds, int const totalRows, int const totalCols);
     };
 
     /**
@@ -380,6 +616,9 @@ namespace sinc {
         size_t cbMemCost = 0;
         size_t maxCbPoolSize = 0;
         size_t maxCbPoolIdxSize = 0;
+        /** The max number and memory cost of the CBs kept across relation miners (@since 2.6) */
+        size_t maxRetainedCbs = 0;
+        size_t maxRetainedCbMemCost = 0;
         size_t cacheEntryMemCost = 0;
         size_t fingerprintCacheMemCost = 0;
         size_t tabuMapMemCost = 0;
@@ -465,8 +704,9 @@ namespace sinc {
      *   2c: Merge two fragments by converting two UVs to a new LV (one UV in one fragment, the other UV in the other fragment)
      *   3: Convert a UV to a constant
      * 
-     * NOTE: It is hard to manage "copy-on-write" on the level of `CacheFragment`. Therefore, `CacheFragment`s are simply copied
-     * in the copy constructor.
+     * NOTE: A list of cache entries is never modified once built. Each update builds a new list instead. Therefore, copies of a
+     * fragment share the same list, and the list is released with the last fragment referring to it. Copying a fragment does
+     * not copy any entry.
      * 
      * @since 2.2
      */
@@ -475,19 +715,27 @@ namespace sinc {
         typedef std::vector<CompliedBlock*> entryType;
         typedef std::vector<entryType*> entriesType;
 
-        CacheFragment(IntTable* const firstRelation, int const relationSymbol); // Todo: Refine `const` modifier for all parameters
+        /** The default minimum number of entries to count/enumerate combinations in parallel */
+        static const int DEFAULT_PARALLEL_MIN_ENTRIES;
+
+        /**
+         * @param cbHolder The holder of the CBs in this fragment and its copies (@since 2.6)
+         */
+        CacheFragment(IntTable* const firstRelation, int const relationSymbol, CbHolder* const cbHolder = nullptr); // Todo: Refine `const` modifier for all parameters
 
         // CacheFragment(std::vector<int*> const& rows, int const relationSymbol, int const arity);
 
         /**
          * Construct an object by an existing CB.
+         * 
+         * NOTE: `firstCb` SHOULD have been added to `cbHolder` by the caller
         */
-        CacheFragment(CompliedBlock* const firstCb, int const relationSymbol);
+        CacheFragment(CompliedBlock* const firstCb, int const relationSymbol, CbHolder* const cbHolder = nullptr);
 
         /**
          * This constructor is used to construct an empty fragment
          */
-        CacheFragment(int const relationSymbol, int const arity);
+        CacheFragment(int const relationSymbol, int const arity, CbHolder* const cbHolder = nullptr);
 
         CacheFragment(const CacheFragment& another);
 
@@ -549,12 +797,24 @@ namespace sinc {
         bool hasLv(int const vid) const;
 
         /**
-         * This method returns the number of unique combinations of all listed variables.
+         * This method returns the number of unique combinations of all listed variables. The exact numbers are kept as the
+         * evaluation summaries of the fragment, so the same count is not repeated until the fragment is updated. The
+         * summaries are copied with the fragment.
          *
          * NOTE: the listed variables must NOT contain duplications and LVs that are not presented in this fragment.
          */
         int countCombinations(std::vector<int> const& vids) const;
 
+        /**
+         * This method counts the unique combinations of all listed variables, but stops once the number exceeds `cap`. In
+         * that case, the returned value is larger than `cap` and is a lower bound of the exact number.
+         *
+         * NOTE: the listed variables must NOT contain duplications and LVs that are not presented in this fragment.
+         *
+         * @since 2.6
+         */
+        int countCombinations(std::vector<int> const& vids, int const cap, int const threads = 1) const;
+
         /**
          * This method returns the set of combinations of all listed variables.
          *
@@ -563,7 +823,14 @@ namespace sinc {
          * NOTE: The returned pointer to the set and the pointers returned by `getArgs()` of each record SHOULD be
          * maintained by USER
          */
-        std::unordered_set<Record>* enumerateCombinations(std::vector<int> const& vids) const;
+        std::unordered_set<Record>* enumerateCombinations(std::vector<int> const& vids, int const threads = 1) const;
+
+        /**
+         * Set the minimum number of entries in a fragment to count/enumerate combinations with more than one thread.
+         *
+         * @since 2.6
+         */
+        static void setParallelMinEntries(int const minEntries);
 
         bool isEmpty() const;
 
@@ -584,6 +851,22 @@ namespace sinc {
 
         std::vector<VarInfo> const& getVarInfoList() const;
 
+        /**
+         * Get the arguments of an LV in all entries, in the order of the entries.
+         * 
+         * NOTE: The LV should be presented in this fragment and should NOT be a PLV.
+         * 
+         * @since 2.6
+         */
+        std::vector<int> const& getLvColumn(int const vid) const;
+
+        /**
+         * Check whether the number of combinations of the listed variables is kept in the evaluation summaries.
+         *
+         * @since 2.6
+         */
+        bool hasCombinationSummary(std::vector<int> const& vids) const;
+
         size_t getMemoryCost() const;
 
         static void showEntry(entryType const& entry);
@@ -592,24 +875,53 @@ namespace sinc {
 
     protected:
         typedef std::unordered_map<int, entriesType*> const2EntriesMapType;
+        /** The indices of the source entries of the entries in a `const2EntriesMapType` (@since 2.6) */
+        typedef std::unordered_map<int, std::vector<int>> const2SourcesMapType;
 
         /** Partially assigned rule structure for this fragment. Predicate symbols are unnecessary here, but useful for debugging */
         std::vector<Predicate> partAssignedRule;
-        /** Compact cache entries, each entry is a list of CB */
+        /** Compact cache entries, each entry is a list of CB. The list is immutable and may be shared by copies of the fragment */
         entriesType* entries; // Todo: If CB can be fully copy-on-write, that is, no two CBs in the memory contains the same compliance set, the specialization and counting can be faster
+        /** The number of fragments sharing `entries` (@since 2.6) */
+        std::atomic<int>* entriesReferences;
         /** A list of LV info. Each index is the ID of an LV */
         std::vector<VarInfo> varInfoList;
+        /** The holder of the CBs produced by the updates of this fragment. `nullptr` means the CBs are not held (@since 2.6) */
+        CbHolder* cbHolder;
+        /**
+         * Columnar copies of the LV arguments in the entries. `lvColumns[vid][i]` is the argument of LV `vid` in the ith entry.
+         * Columns of PLVs and unused variable IDs are empty. The columns are extended along with the entries in each update,
+         * so that counting and enumerating combinations are sequential scans over integer arrays.
+         */
+        std::vector<std::vector<int>> lvColumns;
+        /**
+         * The evaluation summaries of this fragment. The keys are the sorted lists of variables, and the values are the exact
+         * numbers of combinations. The summaries are cleared after each update. (@since 2.6)
+         */
+        mutable std::map<std::vector<int>, int> combinationSummaries;
+        /** The fragment may be shared by rules evaluated in different threads, so the summaries are guarded (@since 2.6) */
+        mutable std::mutex summaryMutex;
+        /** The minimum number of entries in a fragment to count/enumerate combinations in parallel */
+        static int parallelMinEntries;
 
         /**
          * Split cache entries according to two columns in the fragment.
+         *
+         * @param sources Output: The index of the previous entry that each new entry is derived from (@since 2.6)
          */
-        void splitCacheEntries(int const tabIdx1, int const colIdx1, int const tabIdx2, int const colIdx2);
+        void splitCacheEntries(
+            int const tabIdx1, int const colIdx1, int const tabIdx2, int const colIdx2, std::vector<int>& sources
+        );
 
         /**
          * Append a new relation and split cache entries according to two columns in the fragment. One column is in one of
          * the original relations, and the other is in the appended relation.
+         *
+         * @param sources Output: The index of the previous entry that each new entry is derived from (@since 2.6)
          */
-        void splitCacheEntries(int const tabIdx1, int const colIdx1, IntTable* const newRelation, int const colIdx2);
+        void splitCacheEntries(
+            int const tabIdx1, int const colIdx1, IntTable* const newRelation, int const colIdx2, std::vector<int>& sources
+        );
 
         /**
          * Match a column to another that has already been assigned an LV.
@@ -618,19 +930,30 @@ namespace sinc {
          * @param matchedColIdx  The index of the column of the assigned LV
          * @param matchingTabIdx The index of the table containing the matching column
          * @param matchingColIdx The index of the matching column
+         * @param sources        Output: The index of the previous entry that each new entry is derived from (@since 2.6)
          */
-        void matchCacheEntries(int const matchedTabIdx, int const matchedColIdx, int const matchingTabIdx, int const matchingColIdx);
+        void matchCacheEntries(
+            int const matchedTabIdx, int const matchedColIdx, int const matchingTabIdx, int const matchingColIdx,
+            std::vector<int>& sources
+        );
 
         /**
          * Append a new relation and match a column to another that has already been assigned an LV. The matching column is
          * in the appended relation.
+         *
+         * @param sources Output: The index of the previous entry that each new entry is derived from (@since 2.6)
          */
-        void matchCacheEntries(int const matchedTabIdx, int const matchedColIdx, IntTable* const newRelation, int matchingColIdx);
+        void matchCacheEntries(
+            int const matchedTabIdx, int const matchedColIdx, IntTable* const newRelation, int matchingColIdx,
+            std::vector<int>& sources
+        );
 
         /**
          * Filter a constant symbol at a certain column.
+         *
+         * @param sources Output: The index of the previous entry that each new entry is derived from (@since 2.6)
          */
-        void assignCacheEntries(int const tabIdx, int const colIdx, int const constant);
+        void assignCacheEntries(int const tabIdx, int const colIdx, int const constant, std::vector<int>& sources);
 
         /**
          * Add a used LV info to the fragment.
@@ -642,63 +965,117 @@ namespace sinc {
 
         /**
          * This helper function splits and gathers entries with same value at a certain column.
+         *
+         * @param const2SourcesMap Output: The indices in `entries` that the gathered entries are derived from (@since 2.6)
          */
-        static const2EntriesMapType* calcConst2EntriesMap(entriesType const& entries, int const tabIdx, int const colIdx, int const arity);
+        static const2EntriesMapType* calcConst2EntriesMap(
+            entriesType const& entries, int const tabIdx, int const colIdx, int const arity, CbHolder* const cbHolder,
+            const2SourcesMapType& const2SourcesMap
+        );
 
         /**
          * This helper function merges two batches entries that have already been gathered by the targeting columns.
          * 
          * NOTE: This method updates `entries`
+         *
+         * @param baseSources    Output: The index of the base entry that each new entry is derived from (@since 2.6)
+         * @param mergingSources Output: The index of the merging entry that each new entry is derived from (@since 2.6)
          */
         void mergeFragmentEntries(
-            const2EntriesMapType const& baseConst2EntriesMap, const2EntriesMapType const& mergingConst2EntriesMap
+            const2EntriesMapType const& baseConst2EntriesMap, const2SourcesMapType const& baseConst2SourcesMap,
+            const2EntriesMapType const& mergingConst2EntriesMap, const2SourcesMapType const& mergingConst2SourcesMap,
+            std::vector<int>& baseSources, std::vector<int>& mergingSources
         );
 
         /**
          * This helper function merges a batch of entries gathered by mering value to a list of base entries
          * 
          * NOTE: This method updates `entries`
+         *
+         * @param baseSources    Output: The index of the base entry that each new entry is derived from (@since 2.6)
+         * @param mergingSources Output: The index of the merging entry that each new entry is derived from (@since 2.6)
          */
         void mergeFragmentEntries(
-            entriesType const& baseEntries, int const tabIdx, int const colIdx, const2EntriesMapType const& mergingConst2EntriesMap
+            entriesType const& baseEntries, int const tabIdx, int const colIdx, const2EntriesMapType const& mergingConst2EntriesMap,
+            const2SourcesMapType const& mergingConst2SourcesMap, std::vector<int>& baseSources, std::vector<int>& mergingSources
         );
 
         static void releaseConst2EntryMap(const2EntriesMapType* map);
 
         /**
-         * Recursively compute the cartesian product of binding values of grouped PLVs and add each combination in the product
-         * to the binding set.
+         * Collect the unique combinations of the listed variables (in the order of `vids`). The combinations are
+         * hash-partitioned into disjoint sets. If there are more than `parallelMinEntries` entries, the entries are split
+         * across `threads` threads. Each thread collects into its local partitions, and then each partition is
+         * merged by one thread, so no lock is required.
          *
-         * @param completeBindings the binding set
-         * @param plvBindingSets the binding values of the grouped PLVs
-         * @param template the template array to hold the binding combination
-         * @param bindingSetIdx the index of the binding set in current recursion
-         * @param templateStartIdx the starting index of the template for the PLV bindings
-         * @param numSets              The number of elements in `plvBindingSets[]`
+         * @param bindingSets Output: The disjoint sets of the combinations. The array and the sets SHOULD be deleted by USER.
+         * @param cap Collection in a range of entries stops once more than `cap` combinations are found in the range
+         * @param threads The number of threads that the collection may use
+         * @return The number of sets in `bindingSets`
+         * @since 2.6
          */
-        void addCompletePlvBindings(
-            std::unordered_set<Record>& completeBindings, std::unordered_set<Record>* const plvBindingSets, int* const argTemplate,
-            int const bindingSetIdx, int const templateStartIdx, int const numSets
+        int collectCombinations(
+            std::vector<int> const& vids, IntTupleSet** & bindingSets, int const cap, int const threads
         ) const;
 
         /**
-         * Recursively add PLV bindings to a given template
+         * Add the combinations of the listed variables in the entries [begin, end) to the hash-partitioned sets. Stop once
+         * more than `cap` new combinations are added.
          *
-         * @param templateSet          The set of finished templates
+         * @return The memory cost (in bytes) of the temporary structures
+         * @since 2.6
+         */
+        size_t collectCombinationsInRange(
+            std::vector<int> const& vids, int const begin, int const end, IntTupleSet** const bindingSets, int const numSets,
+            int const cap
+        ) const;
+
+        /**
+         * Recursively compute the cartesian product of binding values of grouped PLVs, place each combination in the product
+         * into the template and add the template to the binding sets.
+         *
+         * @param completeBindingSets  The hash-partitioned sets of complete bindings
+         * @param numCompleteSets      The number of elements in `completeBindingSets[]`
          * @param plvBindingSets       The bindings of PLVs grouped by predicate
-         * @param plv2TemplateIdxLists The linked arguments in the head for each PLV
-         * @param template             An argument list template
+         * @param plv2TemplateIdxLists The positions in the template for each PLV
+         * @param argTemplate          An argument list template
          * @param setIdx               The index of the PLV group
          * @param numSets              The number of elements in `plvBindingSets[]`
-         * @param templateLength       The length of `argTemplate[]`
+         * @return The number of newly added bindings
          */
-        void addPlvBindings2Templates(
-            std::unordered_set<Record>& templateSet, std::unordered_set<Record>* const plvBindingSets,
-            std::vector<int>** const plv2TemplateIdxLists, int* const argTemplate, int const setIdx, int const numSets,
-            int const templateLength
+        int addCompletePlvBindings(
+            IntTupleSet** const completeBindingSets, int const numCompleteSets, IntTupleSet* const* const plvBindingSets,
+            std::vector<int> const* const* const plv2TemplateIdxLists, int* const argTemplate, int const setIdx,
+            int const numSets
         ) const;
 
+        /**
+         * Release the reference to the entries. The entries are released if no other fragment refers to them.
+         */
         void releaseEntries();
+
+        /**
+         * Replace the entries with a newly built list. The list WILL be maintained by this fragment and its copies.
+         *
+         * @since 2.6
+         */
+        void resetEntries(entriesType* const newEntries);
+
+        /**
+         * Extend `lvColumns` to the entries rebuilt by an update. The arguments of an LV are copied from the column of the
+         * source entry, and only the arguments of `newLv`, which was not an LV before the update, are read from the CBs. As
+         * this is called after each update, the evaluation summaries are also cleared here.
+         *
+         * @param sources       The index of the previous entry that each current entry is derived from
+         * @param newLv         The ID of the newly assigned LV, -1 if none
+         * @param merged        The fragment merged in the update, `nullptr` if none
+         * @param mergedSources The index of the entry in `merged` that each current entry is derived from
+         * @since 2.6
+         */
+        void updateLvColumns(
+            std::vector<int> const& sources, int const newLv, CacheFragment const* const merged = nullptr,
+            std::vector<int> const* const mergedSources = nullptr
+        );
     };
 
     /**
@@ -731,6 +1108,14 @@ namespace sinc {
      */
     class CachedRule : public Rule {
     public:
+        /**
+         * The evaluation is sampled only if the expected number of sampled entries in the P-cache is no less than this, as
+         * the confidence intervals of smaller samples are not reliable.
+         *
+         * @since 2.6
+         */
+        static const int MIN_SAMPLED_ENTRIES;
+
         /**
          * Initialize the most general rule.
          *
@@ -739,10 +1124,11 @@ namespace sinc {
          * @param fingerprintCache    The cache of the used fingerprints
          * @param category2TabuSetMap The tabu set of pruned fingerprints
          * @param kb                  The original KB
+         * @param cbHolder            The holder of the CBs in the caches of this rule and its specializations (@since 2.6)
          */
         CachedRule(
             int const headPredSymbol, int const arity, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap,
-            SimpleKb& kb, std::unordered_set<Record> const* counterexamples
+            SimpleKb& kb, std::unordered_set<Record> const* counterexamples, CbHolder* const cbHolder = nullptr
         );
 
         CachedRule(const CachedRule& another);
@@ -769,7 +1155,8 @@ namespace sinc {
         size_t getCacheEntryMemoryCost();
 
         /**
-         * This method add the cache entry memory cost of `rule` into the cumulated monitor.
+         * This method add the cache entry memory cost of `rule` into the cumulated monitor. The added cost is subtracted
+         * when the caches of the rule are released, so only rules added here are subtracted from the cumulated cost.
          * 
          * @return The updated amount of memory
          */
@@ -778,9 +1165,36 @@ namespace sinc {
 
         size_t getEvaluationMemoryCost() const;
 
+        /**
+         * Count the new positive entailments of the case 5 specializations that convert an argument to each of the
+         * constants. The counts are collected in one pass over the E+-cache, and no cache is updated.
+         *
+         * NOTE: The argument should be empty.
+         *
+         * @return `counts[i]` is the number of new positive entailments if the argument is converted to `constants[i]`
+         * @since 2.6
+         */
+        std::vector<int> countCase5PosEntailments(int const predIdx, int const argIdx, std::vector<int> const& constants) const;
+
+        /**
+         * Count the new positive entailments of the case 2/4 specializations that join an argument to each of the columns.
+         * The arguments at the location are grouped in one pass over the E+-cache, and each column is probed by the sorted
+         * values in it. No cache is updated.
+         *
+         * @param predIdx, argIdx The location of an empty argument (case 4) or an occurrence of an LV (case 2)
+         * @param columns         The joined columns, as pairs of relation IDs and column indices
+         * @return `counts[i]` is the number of new positive entailments if the argument is joined to `columns[i]`
+         * @since 2.6
+         */
+        std::vector<int> countJoinPosEntailments(
+            int const predIdx, int const argIdx, std::vector<std::pair<int, int>> const& columns
+        ) const;
+
     protected:
         /** The original KB */
         SimpleKb& kb;
+        /** The holder of the CBs in the caches (@since 2.6) */
+        CbHolder* const cbHolder;
         /** The cache for the positive entailments (E+-cache) (not entailed). One cache fragment is sufficient as all
          *  predicates are linked to the head. */
         CacheFragment* posCache;
@@ -816,8 +1230,10 @@ namespace sinc {
         uint64_t allCacheIndexingTime = 0;
         // uint64_t cegCacheIndexingTime = 0;
         size_t cacheEntryMemoryCost = 0;
+        /** The cache entry memory cost of this rule that is added to `cumulatedCacheEntryMemoryCost` (@since 2.6) */
+        size_t cumulatedCacheEntryMemoryCostShare = 0;
         size_t evaluationMemoryCost = 0;
-        static size_t cumulatedCacheEntryMemoryCost;
+        static std::atomic<size_t> cumulatedCacheEntryMemoryCost;
 
         /** If this object does not maintain the E+-cache, get a copy of the cache */
         void obtainPosCache();
@@ -929,17 +1345,45 @@ namespace sinc {
 
         ~RelationMinerWithCachedRule();
 
+        /**
+         * Release the CBs of this miner after the conventional process. The CBs shared with other running miners are kept.
+         *
+         * @since 2.6
+         */
+        void run() override;
+
         size_t getFingerprintCacheMemCost() const;
         size_t getTabuMapMemCost() const;
 
     protected:
         std::vector<Rule::fingerprintCacheType*> fingerprintCaches; // Todo: This may be moved to the basic `SInC` class
+        /** The CBs in the caches of the rules of this miner (@since 2.6) */
+        CbHolder cbHolder;
+        /** The maximum evaluation memory cost of the generated rules, readable by the memory accountant (@since 2.6) */
+        std::atomic<size_t> evalScratchMemCost{0};
+        /** The maximum evaluation memory cost of the rules generated in the current iteration (@since 2.6) */
+        size_t iterationEvalMemCost = 0;
 
         /**
          * Create a rule with compact caching and tabu set.
          */
         Rule* getStartRule() override;
 
+        /**
+         * Register the fingerprint caches, the tabu map, and the evaluation scratch of this miner as memory sources.
+         *
+         * @since 2.6
+         */
+        void addMemorySources(MemoryAccountant& accountant, std::vector<int>& ids) override;
+
+        /**
+         * The cache size is the cost of the cache entries of the candidates, and the evaluation memory is the max of the
+         * rules generated in the iteration.
+         *
+         * @since 2.6
+         */
+        void measureBeamPressure(std::vector<Rule*> const& candidates, AdaptiveBeamwidth::Pressure& pressure) override;
+
         /**
          * When a rule r is selected as beam, update its cache indices. The rule r here is a "CachedRule".
          */
@@ -948,7 +1392,37 @@ namespace sinc {
         /**
          * Record monitoring information compared to the super implementation
          */
-        int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates) override;
+        int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates) override;
+
+        /**
+         * Count the positive entailments of all the constants in a batch, and drop the constants that certainly fail the fact
+         * coverage or cannot beat the parent rule or the candidates even if no negative entailment is produced.
+         *
+         * @since 2.6
+         */
+        void screenCase5Constants(
+            Rule& rule, ArgLocation const& arg, std::vector<int> const& constants, TopKRules const& candidates,
+            std::vector<int>& survivors
+        ) override;
+
+        /**
+         * Count the positive entailments of all the joined columns in a batch, and drop the columns in the same way as
+         * `screenCase5Constants()`.
+         *
+         * @since 2.6
+         */
+        void screenJoinColumns(
+            Rule& rule, ArgLocation const& arg, std::vector<std::pair<int, int>> const& columns, TopKRules const& candidates,
+            std::vector<std::pair<int, int>>& survivors
+        ) override;
+
+        /**
+         * Check whether a specialization of `rule` with `posEtls` new positive entailments may pass the fact coverage and
+         * beat `minScore`. The specialization is assumed to entail no negative record.
+         *
+         * @since 2.6
+         */
+        bool isPromisingSpecialization(Rule const& rule, int const posEtls, double const minScore) const;
     };
 
     /**
@@ -959,7 +1433,7 @@ namespace sinc {
     class SincWithCache : public SInC {
     public:
         SincWithCache(SincConfig* const config);
-        SincWithCache(SincConfig* const config, SimpleKb* const kb);
+        SincWithCache(SincConfig* const config, SimpleKb* const kb, bool const sharedKb = false);
 
         /**
          * This overridden function added a reservation of memory space for the CB pool and indices after the conventional process.
@@ -972,9 +1446,22 @@ namespace sinc {
         CachedSincPerfMonitor monitor;
 
         SincRecovery* createRecovery() override;
-        RelationMiner* createRelationMiner(int const targetRelationNum) override;
+        RelationMiner* createRelationMiner(int const targetRelationNum, MinerWorkspace& workspace) override;
         void finalizeRelationMiner(RelationMiner* miner) override;
         void showMonitor() override;
+
+        /**
+         * Release the CB pool. If the KB is shared, the CBs of the KB relations are retained for the next compression of
+         * the KB, and the pool SHOULD be cleared by the owner of the KB before releasing it (@since 2.6).
+         */
         void finish() override;
+
+        /**
+         * Register the CB pool and the cache fragments as memory sources, and the release of the retained CBs in the CB
+         * pool as a reliever.
+         *
+         * @since 2.6
+         */
+        void registerMemorySources(MemoryAccountant& accountant) override;
     };
 }
\ No newline at end of file
@@ -724,8 +724,9 @@ void EstSincPerfMonitor::show(std::ostream& os) {
 using sinc::EstRule;
 
 EstRule::EstRule(
-    int const headPredSymbol, int const arity, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap, SimpleKb& _kb
-) : Rule(headPredSymbol, arity, fingerprintCache, category2TabuSetMap), kb(_kb), bodyVarLinkManager(&structure, 0)
+    int const headPredSymbol, int const arity, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap, SimpleKb& _kb,
+    CbHolder* const _cbHolder
+) : Rule(headPredSymbol, arity, fingerprintCache, category2TabuSetMap), kb(_kb), cbHolder(_cbHolder), bodyVarLinkManager(&structure, 0)
 {
     /* Initialize the E+-cache & T-cache */
     SimpleRelation* head_relation = kb.getRelation(headPredSymbol);
@@ -733,25 +734,21 @@ EstRule::EstRule(
     std::vector<int*> const& non_entailed_record_vector = *(split_records->nonEntailedRecords);
     std::vector<int*> const& entailed_record_vector = *(split_records->entailedRecords);
     if (0 == entailed_record_vector.size()) {
-        posCache = new CacheFragment(head_relation, headPredSymbol);
-        entCache = new CacheFragment(headPredSymbol, arity);
+        posCache = new CacheFragment(head_relation, headPredSymbol, cbHolder);
+        entCache = new CacheFragment(headPredSymbol, arity, cbHolder);
     } else if (0 == non_entailed_record_vector.size()) {
         /* No record to entail, E+-cache and T-cache are both empty */
-        posCache = new CacheFragment(headPredSymbol, arity);
-        entCache = new CacheFragment(headPredSymbol, arity);
+        posCache = new CacheFragment(headPredSymbol, arity, cbHolder);
+        entCache = new CacheFragment(headPredSymbol, arity, cbHolder);
     } else {
         int** non_entailed_records = toArray(non_entailed_record_vector);
         int** entailed_records = toArray(entailed_record_vector);
         IntTable* non_entailed_record_table = new IntTable(non_entailed_records, non_entailed_record_vector.size(), arity);
         IntTable* entailed_record_table = new IntTable(entailed_records, entailed_record_vector.size(), arity);
-        posCache = new CacheFragment(
-            CompliedBlock::create(non_entailed_records, non_entailed_record_vector.size(), arity, non_entailed_record_table, true, true), 
-            headPredSymbol
-        );
-        entCache = new CacheFragment(
-            CompliedBlock::create(entailed_records, entailed_record_vector.size(), arity, entailed_record_table, true, true),
-            headPredSymbol
-        );
+        delete[] non_entailed_records;  // The tables copy the pointers
+        delete[] entailed_records;
+        posCache = new CacheFragment(CompliedBlock::create(non_entailed_record_table, true, cbHolder), headPredSymbol, cbHolder);
+        entCache = new CacheFragment(CompliedBlock::create(entailed_record_table, true, cbHolder), headPredSymbol, cbHolder);
     }
     maintainPosCache = true;
     maintainEntCache = true;
@@ -769,7 +766,8 @@ EstRule::EstRule(
     delete split_records;
 }
 
-EstRule::EstRule(const EstRule& another) : Rule(another), kb(another.kb), posCache(another.posCache), maintainPosCache(false),
+EstRule::EstRule(const EstRule& another) : Rule(another), kb(another.kb), cbHolder(another.cbHolder), posCache(another.posCache),
+    maintainPosCache(false),
     entCache(another.entCache), maintainEntCache(false), allCache(another.allCache), maintainAllCache(false),
     predIdx2AllCacheTableInfo(another.predIdx2AllCacheTableInfo), bodyVarLinkManager(another.bodyVarLinkManager, &structure) {}
 
@@ -829,7 +827,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
             for (int arg_idx = 0; arg_idx < cb->getTotalCols(); arg_idx++) {
                 MultiSet<int>& arg_set = arg_sets[arg_idx];
                 for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                    int* record = cb->getComplianceSet()[row_idx];
+                    int* record = cb->getRow(row_idx);
                     arg_set.add(record[arg_idx]);
                 }
             }
@@ -842,14 +840,14 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
             for (int arg_idx = 0; arg_idx < cb->getTotalCols(); arg_idx++) {
                 MultiSet<int>& arg_set = arg_sets[arg_idx];
                 for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                    int* record = cb->getComplianceSet()[row_idx];
+                    int* record = cb->getRow(row_idx);
                     arg_set.add(record[arg_idx]);
                 }
             }
         }
         CompliedBlock const* head_cb = (*cache_entry)[HEAD_PRED_IDX];
         for (int row_idx = 0; row_idx < head_cb->getTotalRows(); row_idx++) {
-            entailed_records.insert(head_cb->getComplianceSet()[row_idx]);
+            entailed_records.insert(head_cb->getRow(row_idx));
         }
     }
     for (int pred_idx = FIRST_BODY_PRED_IDX; pred_idx < structure.size(); pred_idx++) {
@@ -860,7 +858,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
             for (int arg_idx = 0; arg_idx < cb->getTotalCols(); arg_idx++) {
                 MultiSet<int>& arg_set = arg_sets[arg_idx];
                 for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                    int* record = cb->getComplianceSet()[row_idx];
+                    int* record = cb->getRow(row_idx);
                     arg_set.add(record[arg_idx]);
                 }
             }
@@ -906,7 +904,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
                 for (CacheFragment::entryType* cache_entry: posCache->getEntries()) {
                     CompliedBlock const* cb = (*cache_entry)[vacant.predIdx];
                     for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                        int* record = cb->getComplianceSet()[row_idx];
+                        int* record = cb->getRow(row_idx);
                         remaining_rows += (record[another_arg_idx] == record[vacant.argIdx]) ? 1 : 0;
                     }
                 }
@@ -920,7 +918,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
                     for (CacheFragment::entryType* cache_entry : entCache->getEntries()) {
                         CompliedBlock const* cb = (*cache_entry)[vacant.predIdx];
                         for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                            int* record = cb->getComplianceSet()[row_idx];
+                            int* record = cb->getRow(row_idx);
                             remaining_rows += (record[another_arg_idx] == record[vacant.argIdx]) ? 1 : 0;
                         }
                     }
@@ -936,7 +934,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
                     for (CacheFragment::entryType* cache_entry: (*allCache)[tab_info.fragmentIdx]->getEntries()) {
                         CompliedBlock const* cb = (*cache_entry)[tab_info.tabIdx];
                         for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                            int* record = cb->getComplianceSet()[row_idx];
+                            int* record = cb->getRow(row_idx);
                             remaining_rows += (record[another_arg_idx] == record[vacant.argIdx]) ? 1 : 0;
                         }
                     }
@@ -1125,7 +1123,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
                 for (CacheFragment::entryType* cache_entry: posCache->getEntries()) {
                     CompliedBlock const* cb = (*cache_entry)[empty_arg_loc_1.predIdx];
                     for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                        int* record = cb->getComplianceSet()[row_idx];
+                        int* record = cb->getRow(row_idx);
                         remaining_rows += (record[empty_arg_loc_1.argIdx] == record[empty_arg_loc_2.argIdx]) ? 1 : 0;
                     }
                 }
@@ -1139,7 +1137,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
                     for (CacheFragment::entryType* cache_entry: entCache->getEntries()) {
                         CompliedBlock const* cb = (*cache_entry)[empty_arg_loc_1.predIdx];
                         for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                            int* record = cb->getComplianceSet()[row_idx];
+                            int* record = cb->getRow(row_idx);
                             remaining_rows += (record[empty_arg_loc_1.argIdx] == record[empty_arg_loc_2.argIdx]) ? 1 : 0;
                         }
                     }
@@ -1155,7 +1153,7 @@ std::vector<SpecOprWithScore*>* EstRule::estimateSpecializations() {
                     for (CacheFragment::entryType* cache_entry: (*allCache)[tab_info.fragmentIdx]->getEntries()) {
                         CompliedBlock const* cb = (*cache_entry)[tab_info.tabIdx];
                         for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
-                            int* record = cb->getComplianceSet()[row_idx];
+                            int* record = cb->getRow(row_idx);
                             remaining_rows += (record[empty_arg_loc_1.argIdx] == record[empty_arg_loc_2.argIdx]) ? 1 : 0;
                         }
                     }
@@ -1434,16 +1432,15 @@ sinc::EvidenceBatch* EstRule::getEvidenceAndMarkEntailment() {
         /* Find the grounding body */
         int** grounding_template = new int*[structure.size()];
         for (int pred_idx = FIRST_BODY_PRED_IDX; pred_idx < structure.size(); pred_idx++) {
-            grounding_template[pred_idx] = (*cache_entry)[pred_idx]->getComplianceSet()[0];
+            grounding_template[pred_idx] = (*cache_entry)[pred_idx]->getFirstRow();
         }
 
-        /* Find all entailed records */
+        /* Find all entailed records. Head records are rows in the target relation, so the row ids are calculated directly */
         CompliedBlock const& cb = *(*cache_entry)[HEAD_PRED_IDX];
-        int* const* head_records = cb.getComplianceSet();
         if (1 < cb.getTotalRows()) {
             for (int i = 0; i < cb.getTotalRows(); i++) {
-                int* head_record = head_records[i];
-                if (target_relation.entailIfNot(head_record)) {
+                int* head_record = cb.getRow(i);
+                if (target_relation.entailIfNotById(target_relation.rowIdOf(head_record))) {
                     int** grounding = new int*[structure.size()];
                     std::copy(grounding_template + 1, grounding_template + structure.size(), grounding + 1);
                     grounding[HEAD_PRED_IDX] = head_record;
@@ -1452,8 +1449,8 @@ sinc::EvidenceBatch* EstRule::getEvidenceAndMarkEntailment() {
             }
             delete[] grounding_template;
         } else {
-            int* head_record = head_records[0];
-            if (target_relation.entailIfNot(head_record)) {
+            int* head_record = cb.getFirstRow();
+            if (target_relation.entailIfNotById(target_relation.rowIdOf(head_record))) {
                 grounding_template[HEAD_PRED_IDX] = head_record;
                 evidence_batch->evidenceList.push_back(grounding_template);
             } else {
@@ -1533,7 +1530,7 @@ std::unordered_set<sinc::Record>* EstRule::getCounterexamples() const {
         for (int frag_idx = 0; frag_idx < allCache->size(); frag_idx++) {
             if (!gvids_in_all_cache_fragments[frag_idx].empty()) {
                 valid_frag_indices.push_back(frag_idx);
-                bindings_in_fragments[frag_idx] = (*allCache)[frag_idx]->enumerateCombinations(gvids_in_all_cache_fragments[frag_idx]); // TODO: Directly instantiate bindings to template, so that the following function call can be removed
+                bindings_in_fragments[frag_idx] = (*allCache)[frag_idx]->enumerateCombinations(gvids_in_all_cache_fragments[frag_idx], evalThreads); // TODO: Directly instantiate bindings to template, so that the following function call can be removed
             }
         }
         generateHeadTemplates(
@@ -1720,7 +1717,7 @@ sinc::Eval EstRule::calculateEval() {
         std::vector<int> const& vids = gvs_in_all_cache_fragments[i];
         if (!vids.empty()) {
             CacheFragment const& fragment = *(*allCache)[i];
-            all_ent *= fragment.countCombinations(vids);
+            all_ent *= fragment.countCombinations(vids, std::numeric_limits<int>::max(), evalThreads);
         }
     }
     int new_pos_ent = posCache->countTableSize(HEAD_PRED_IDX);
@@ -1821,7 +1818,7 @@ sinc::UpdateStatus EstRule::specCase2HandlerPostPruning(int const predSymbol, in
     }
     if (nullptr == updated_fragment) {
         /* The LV has not been included in body yet. Create a new fragment */
-        updated_fragment = new CacheFragment(new_relation, predSymbol);
+        updated_fragment = new CacheFragment(new_relation, predSymbol, cbHolder);
         updated_fragment->updateCase1a(0, argIdx, varId);
         predIdx2AllCacheTableInfo.emplace_back(allCache->size(), 0);
         allCache->push_back(updated_fragment);
@@ -1924,7 +1921,7 @@ sinc::UpdateStatus EstRule::specCase4HandlerPostPruning(
     if (HEAD_PRED_IDX == predIdx2) {   // One is the head and the other is not
         /* Create a new fragment for the new predicate */
         predIdx2AllCacheTableInfo.emplace_back(allCache->size(), 0);
-        CacheFragment* fragment = new CacheFragment(new_relation, predSymbol);
+        CacheFragment* fragment = new CacheFragment(new_relation, predSymbol, cbHolder);
         fragment->updateCase1a(0, argIdx1, new_vid);
         allCache->push_back(fragment);
     } else {    // Both are in the body
@@ -2090,18 +2087,20 @@ EstRelationMiner::EstRelationMiner(
 
 EstRelationMiner::~EstRelationMiner() {
     for (Rule::fingerprintCacheType* const& cache: fingerprintCaches) {
-        for (const Fingerprint* const& fp: *cache) {
-            delete fp;
-        }
         delete cache;
     }
 }
 
+void EstRelationMiner::run() {
+    RelationMiner::run();
+    CompliedBlock::release(cbHolder);
+}
+
 using sinc::Rule;
 Rule* EstRelationMiner::getStartRule() {
     Rule::fingerprintCacheType* cache = new Rule::fingerprintCacheType();
     fingerprintCaches.push_back(cache);
-    return new EstRule(targetRelation, kb.getRelation(targetRelation)->getTotalCols(), *cache, tabuMap, kb);
+    return new EstRule(targetRelation, kb.getRelation(targetRelation)->getTotalCols(), *cache, tabuMap, kb, &cbHolder);
 }
 
 void EstRelationMiner::selectAsBeam(Rule* r) {
@@ -2114,15 +2113,16 @@ void EstRelationMiner::selectAsBeam(Rule* r) {
 
 Rule* EstRelationMiner::findRule() {
     /* Create the beams */
-    Rule** beams = new Rule*[beamwidth]{};
-    beams[0] = getStartRule();
+    std::vector<Rule*> beams;
+    beams.push_back(getStartRule());
+    TopKRules top_candidates(beamwidth);
 
     /* Find a local optimum (there is certainly a local optimum in the search routine) */
     while (true) {
         /* Find the candidates in the next round according to current beams */
-        Rule** top_candidates = new Rule*[beamwidth]{};
-        std::vector<SpecOprWithScore*>** estimated_spec_lists = new std::vector<SpecOprWithScore*>*[beamwidth]{};
-        for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
+        top_candidates.clear();
+        std::vector<SpecOprWithScore*>** estimated_spec_lists = new std::vector<SpecOprWithScore*>*[beams.size()]{};
+        for (int i = 0; i < beams.size(); i++) {
             Rule* const r = beams[i];
             selectAsBeam(r);
             logFormatter.printf("Extend: %s\n", r->toString(kb.getRelationNames()).c_str());
@@ -2139,73 +2139,62 @@ Rule* EstRelationMiner::findRule() {
             monitor.maxEstIdxCost = std::max(monitor.maxEstIdxCost, ((EstRule*)r)->getEstIdxMemCost());
         }
         findEstimatedSpecializations(beams, estimated_spec_lists, top_candidates);
-        for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
+        for (int i = 0; i < beams.size(); i++) {
             for (SpecOprWithScore* const& s: *(estimated_spec_lists[i])) {
                 delete s;
             }
             delete estimated_spec_lists[i];
         }
         delete[] estimated_spec_lists;
+        std::vector<Rule*> const candidates = top_candidates.ranked();
+
+        /* Find the best in beams */
+        Rule* best_beam = beams[0];
+        double best_beam_score = best_beam->getEval().value(evalMetric);
+        for (int i = 1; i < beams.size(); i++) {
+            double const score = beams[i]->getEval().value(evalMetric);
+            if (best_beam_score < score) {
+                best_beam = beams[i];
+                best_beam_score = score;
+            }
+        }
 
-        if (!shouldContinue) {
+        if (!shouldContinue || deadlineReached()) {
             /* Stop the finding procedure at the current stage and return the best rule */
-            Rule* best_rule = beams[0];
-            for (int i = 1; i < beamwidth && nullptr != beams[i]; i++) {
-                if (best_rule->getEval().value(evalMetric) < beams[i]->getEval().value(evalMetric)) {
-                    delete best_rule;
-                    best_rule = beams[i];
-                } else {
-                    delete beams[i];
-                }
+            Rule* best_rule = best_beam;
+            if (nullptr != top_candidates.best() && best_beam_score < top_candidates.bestScore()) {
+                best_rule = top_candidates.best();
             }
-            for (int i = 0; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                if (best_rule->getEval().value(evalMetric) < top_candidates[i]->getEval().value(evalMetric)) {
-                    delete best_rule;
-                    best_rule = top_candidates[i];
-                } else {
-                    delete top_candidates[i];
+            for (Rule* const& r: beams) {
+                if (best_rule != r) {
+                    delete r;
                 }
             }
-            if (nullptr != best_rule) {
-                if (!best_rule->getEval().useful()) {
-                    delete best_rule;
-                    best_rule = nullptr;
+            for (Rule* const& r: candidates) {
+                if (best_rule != r) {
+                    delete r;
                 }
             }
-            return best_rule;
-        }
-
-        /* Find the best in beams and candidates */
-        Rule* best_beam = beams[0];
-        for (int i = 1; i < beamwidth && nullptr != beams[i]; i++) {
-            if (best_beam->getEval().value(evalMetric) < beams[i]->getEval().value(evalMetric)) {
-                best_beam = beams[i];
-            }
-        }
-        Rule* best_candidate = nullptr;
-        if (nullptr != top_candidates[0]) {
-            best_candidate = top_candidates[0];
-            for (int i = 1; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                if (best_candidate->getEval().value(evalMetric) < top_candidates[i]->getEval().value(evalMetric)) {
-                    best_candidate = top_candidates[i];
-                }
+            if (!best_rule->getEval().useful()) {
+                delete best_rule;
+                best_rule = nullptr;
             }
+            return best_rule;
         }
 
         /* If there is a local optimum and it is the best among all, return the rule */
-        if (nullptr == best_candidate || best_beam->getEval().value(evalMetric) >= best_candidate->getEval().value(evalMetric)) {
+        Rule* const best_candidate = top_candidates.best();
+        if (nullptr == best_candidate || best_beam_score >= top_candidates.bestScore()) {
             /* If the best is not useful, return NULL */
             Rule* const ret = best_beam->getEval().useful() ? best_beam : nullptr;
-            for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
-                if (ret != beams[i]) {
-                    delete beams[i];
+            for (Rule* const& r: beams) {
+                if (ret != r) {
+                    delete r;
                 }
             }
-            delete[] beams;
-            for (int i = 0; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                delete top_candidates[i];
+            for (Rule* const& r: candidates) {
+                delete r;
             }
-            delete[] top_candidates;
             return ret;
         }
 
@@ -2215,34 +2204,30 @@ Rule* EstRelationMiner::findRule() {
         const Eval& best_eval = best_candidate->getEval();
         if (stopCompressionRatio <= best_eval.value(EvalMetric::Value::CompressionRatio) || 0 == best_eval.getNegEtls()) {
             Rule* const ret = best_eval.useful() ? best_candidate : nullptr;
-            for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
-                delete beams[i];
+            for (Rule* const& r: beams) {
+                delete r;
             }
-            delete[] beams;
-            for (int i = 0; i < beamwidth && nullptr != top_candidates[i]; i++) {
-                if (ret != top_candidates[i]) {
-                    delete top_candidates[i];
+            for (Rule* const& r: candidates) {
+                if (ret != r) {
+                    delete r;
                 }
             }
-            delete[] top_candidates;
             return ret;
         }
 
         /* Update the beams */
-        for (int i = 0; i < beamwidth && nullptr != beams[i]; i++) {
-            delete beams[i];
+        for (Rule* const& r: beams) {
+            delete r;
         }
-        delete[] beams;
-        beams = top_candidates;
+        beams = candidates;
     }
 }
 
 void EstRelationMiner::findEstimatedSpecializations(
-    Rule** beams, std::vector<SpecOprWithScore*>** estimatedSpecLists, Rule** topCandidates
+    std::vector<Rule*> const& beams, std::vector<SpecOprWithScore*>** estimatedSpecLists, TopKRules& topCandidates
 ) {
     int observations = (int) std::round(beamwidth * observationRatio);
-    int num_beams = 1;  // at least 1 beam in the "beams" array
-    for (; num_beams < beamwidth && nullptr != beams[num_beams]; num_beams++); // find the exact number of beams in the array
+    int const num_beams = beams.size();
     int idxs[num_beams]{};
     for (int i = 0; i < observations; i++) {
         int best_rule_idx = -1;
@@ -2267,14 +2252,15 @@ void EstRelationMiner::findEstimatedSpecializations(
         Rule* copy = beams[best_rule_idx]->clone();
         UpdateStatus status = best_spec->opr->specialize(*copy);
         checkThenAddRule(status, copy, *(beams[best_rule_idx]), topCandidates);
-        if (maxMemKByte < getMaxRss()) {
+        if (miningInterrupted()) {
             return;
         }
     }
 }
 
-int EstRelationMiner::checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates) {
+int EstRelationMiner::checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates) {
     EstRule* rule = (EstRule*) updatedRule;
+    std::lock_guard<std::recursive_mutex> lock(candidateMutex);
     if (UpdateStatus::Normal == updateStatus) {
         monitor.posCacheEntriesTotal += rule->getPosCache().getEntries().size();
         monitor.entCacheEntriesTotal += rule->getEntCache().getEntries().size();
@@ -2309,7 +2295,7 @@ using sinc::SincRecovery;
 using sinc::RelationMiner;
 SincWithEstimation::SincWithEstimation(SincConfig* const config) : SInC(config) {}
 
-SincWithEstimation::SincWithEstimation(SincConfig* const config, SimpleKb* const kb) : SInC(config, kb) {}
+SincWithEstimation::SincWithEstimation(SincConfig* const config, SimpleKb* const kb, bool const sharedKb) : SInC(config, kb, sharedKb) {}
 
 void SincWithEstimation::getTargetRelations(int* & targetRelationIds, int& numTargets) {
     SInC::getTargetRelations(targetRelationIds, numTargets);
@@ -2320,11 +2306,11 @@ SincRecovery* SincWithEstimation::createRecovery() {
     return nullptr; // Todo: Implement here
 }
 
-RelationMiner* SincWithEstimation::createRelationMiner(int const targetRelationNum) {
+RelationMiner* SincWithEstimation::createRelationMiner(int const targetRelationNum, MinerWorkspace& workspace) {
     return new EstRelationMiner(
         *kb, targetRelationNum, config->evalMetric, config->beamwidth, config->maxMemGByte * 1024 * 1024, config->observationRatio, config->stopCompressionRatio,
-        predicate2NodeMap, dependencyGraph, compressedKb->getHypothesis(), compressedKb->getCounterexampleSet(targetRelationNum),
-        *logger
+        workspace.predicate2NodeMap, workspace.dependencyGraph, workspace.hypothesis, compressedKb->getCounterexampleSet(targetRelationNum),
+        *workspace.logger
     );
 }
 
@@ -2347,7 +2333,6 @@ void SincWithEstimation::finalizeRelationMiner(RelationMiner* miner) {
     monitor.totalGeneratedRules += rel_miner->monitor.totalGeneratedRules;
     monitor.copyTime += rel_miner->monitor.copyTime;
     monitor.maxEstIdxCost = std::max(monitor.maxEstIdxCost, rel_miner->monitor.maxEstIdxCost);
-    CompliedBlock::clearPool();
 
     /* Log memory usage */
     rusage usage;
@@ -345,7 +345,8 @@ namespace sinc {
     class EstRule : public Rule {
     public:
         EstRule(
-            int const headPredSymbol, int const arity, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap, SimpleKb& kb
+            int const headPredSymbol, int const arity, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap, SimpleKb& kb,
+            CbHolder* const cbHolder = nullptr
         );
 
         EstRule(const EstRule& another);
@@ -380,6 +381,7 @@ namespace sinc {
 
         /* Followings are members in `CachedRule` */
         SimpleKb& kb;
+        CbHolder* const cbHolder;
         CacheFragment* posCache;
         CacheFragment* entCache;
         std::vector<CacheFragment*>* allCache;
@@ -472,8 +474,14 @@ namespace sinc {
 
         ~EstRelationMiner();
 
+        /**
+         * Release the CBs of this miner after the conventional process.
+         */
+        void run() override;
+
     protected:
         std::vector<Rule::fingerprintCacheType*> fingerprintCaches;
+        CbHolder cbHolder;
         /** The ratio (>=1) that extends the number of rules that are actually specialized according to the estimations */
         double const observationRatio;
 
@@ -489,12 +497,14 @@ namespace sinc {
 
         Rule* findRule() override;
 
-        void findEstimatedSpecializations(Rule** beams, std::vector<SpecOprWithScore*>** estimatedSpecLists, Rule** topCandidates);
+        void findEstimatedSpecializations(
+            std::vector<Rule*> const& beams, std::vector<SpecOprWithScore*>** estimatedSpecLists, TopKRules& topCandidates
+        );
 
         /**
          * Record monitoring information compared to the super implementation
          */
-        int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates) override;
+        int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates) override;
     };
 
     /**
@@ -507,7 +517,7 @@ namespace sinc {
     class SincWithEstimation : public SInC {
     public:
         SincWithEstimation(SincConfig* const config);
-        SincWithEstimation(SincConfig* const config, SimpleKb* const kb);
+        SincWithEstimation(SincConfig* const config, SimpleKb* const kb, bool const sharedKb = false);
 
         /**
          * This overridden function added a reservation of memory space for the CB pool and indices after the conventional process.
@@ -520,7 +530,7 @@ namespace sinc {
         EstSincPerfMonitor monitor;
 
         SincRecovery* createRecovery() override;
-        RelationMiner* createRelationMiner(int const targetRelationNum) override;
+        RelationMiner* createRelationMiner(int const targetRelationNum, MinerWorkspace& workspace) override;
         void finalizeRelationMiner(RelationMiner* miner) override;
         void showMonitor() override;
         void finish() override;
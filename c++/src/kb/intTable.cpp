@@ -145,6 +145,10 @@ int* IntTable::operator[](int i) const {
     return sortedRowsByCols[0][i];
 }
 
+int IntTable::rowIdOf(int* const row) const {
+    return whereIs(row);
+}
+
 IntTable::sliceType* IntTable::getSlice(int const col, int const val) const {
     int* const values_by_cols = valuesByCols[col];
     int const idx = std::lower_bound(values_by_cols, values_by_cols + valuesByColsLengths[col], val) - values_by_cols;
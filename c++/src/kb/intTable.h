@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 
 namespace sinc {
     class MatchedSubTables;
@@ -90,6 +91,16 @@ namespace sinc {
          */
         int* operator[](int i) const;
 
+        /**
+         * Returns the row id of a row in the table. The id of a row is its offset w.r.t. alphabetical order, i.e., `(*this)[id]`
+         * is the row itself.
+         * 
+         * NOTE: The row SHOULD be one of the row pointers stored in this table.
+         * 
+         * @since 2.6
+         */
+        virtual int rowIdOf(int* const row) const;
+
         /**
          * Get a slice of the table where for every row r in the slice, r[col]=val.
          * 
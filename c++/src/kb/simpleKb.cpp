@@ -6,6 +6,7 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <set>
 
 namespace fs = std::filesystem;
 
@@ -42,8 +43,9 @@ double SimpleRelation::minConstantCoverage = DEFAULT_MIN_CONSTANT_COVERAGE;
 int** SimpleRelation::loadFile(const path& filePath, int const arity, int const totalRecords) {
     IntReader reader(filePath.c_str());
     int** records = new int*[totalRecords];
+    int* const block = new int[(size_t)totalRecords * arity];
     for (int i = 0; i < totalRecords; i++) {
-        int* record = new int[arity];
+        int* record = block + (size_t)i * arity;
         for (int arg_idx = 0; arg_idx < arity; arg_idx++) {
             record[arg_idx] = reader.next();
         }
@@ -55,21 +57,18 @@ int** SimpleRelation::loadFile(const path& filePath, int const arity, int const
 
 SimpleRelation::SimpleRelation(const std::string& _name, int const _id, int** _records, int const _arity, int const _totalRecords) : 
     IntTable(_records, _totalRecords, _arity), name(strdup(_name.c_str())), id(_id), maintainRecords(false),
-    entailmentFlags(new int[NUM_FLAG_INTS(_totalRecords)]{0}), flagLength(NUM_FLAG_INTS(_totalRecords)) {}
+    rowBlock(compactRows(false)), entailmentFlags(new int[NUM_FLAG_INTS(_totalRecords)]{0}),
+    flagLength(NUM_FLAG_INTS(_totalRecords)) {}
 
 SimpleRelation::SimpleRelation(
             const std::string& _name, int const _id, int const _arity, int const _totalRecords, const path& _filePath
 ) : IntTable(loadFile(_filePath, _arity, _totalRecords), _totalRecords, _arity, true), name(strdup(_name.c_str())), id(_id),
-    maintainRecords(true), entailmentFlags(new int[NUM_FLAG_INTS(_totalRecords)]{0}), flagLength(NUM_FLAG_INTS(_totalRecords)) {}
+    maintainRecords(true), rowBlock(compactRows(true)), entailmentFlags(new int[NUM_FLAG_INTS(_totalRecords)]{0}),
+    flagLength(NUM_FLAG_INTS(_totalRecords)) {}
 
 SimpleRelation::~SimpleRelation() {
     free((void*)name);  // as `strdup()` uses `malloc()`
-    if (maintainRecords) {
-        int** const rows = sortedRowsByCols[0];
-        for (int i = 0; i < totalRows; i++) {
-            delete[] rows[i];
-        }
-    }
+    delete[] rowBlock;
     delete[] entailmentFlags;
 }
 
@@ -121,6 +120,22 @@ bool SimpleRelation::entailIfNot(int* const record) {
     return false;
 }
 
+bool SimpleRelation::isEntailedById(int const rowId) const {
+    return 0 != entailment(rowId);
+}
+
+bool SimpleRelation::entailIfNotById(int const rowId) {
+    if (0 == entailment(rowId)) {
+        setEntailmentFlag(rowId);
+        return true;
+    }
+    return false;
+}
+
+int SimpleRelation::rowIdOf(int* const row) const {
+    return (row - rowBlock) / totalCols;
+}
+
 int SimpleRelation::totalEntailedRecords() const {
     int cnt = 0;
     for (int i = 0; i < flagLength; i++) {
@@ -129,6 +144,22 @@ int SimpleRelation::totalEntailedRecords() const {
     return cnt;
 }
 
+int const* SimpleRelation::getEntailmentFlags() const {
+    return entailmentFlags;
+}
+
+int SimpleRelation::getFlagLength() const {
+    return flagLength;
+}
+
+void SimpleRelation::setEntailmentFlags(int const* const flags) {
+    std::copy(flags, flags + flagLength, entailmentFlags);
+}
+
+void SimpleRelation::clearEntailmentFlags() {
+    std::fill(entailmentFlags, entailmentFlags + flagLength, 0);
+}
+
 std::vector<int>** SimpleRelation::getPromisingConstants() const {
     std::vector<int>** promising_constants_by_cols = new std::vector<int>*[totalCols];
     int threshold = (int) ceil(totalRows * minConstantCoverage);
@@ -236,9 +267,7 @@ SplitRecords* SimpleRelation::splitByEntailment() const {
 size_t SimpleRelation::memoryCost() const {
     size_t size = IntTable::memoryCost() - sizeof(IntTable) + sizeof(SimpleRelation);
     size += sizeof(int) * flagLength + sizeof(char) * (strlen(name) + 1);
-    if (maintainRecords) {
-        size += sizeof(int) * totalRows * totalCols;    // size of records
-    }
+    size += sizeof(int) * totalRows * totalCols;    // size of records
     return size;
 }
 
@@ -254,6 +283,54 @@ int SimpleRelation::entailment(int const idx) const {
     return entailmentFlags[idx / BITS_PER_INT] & (0x1 << (idx % BITS_PER_INT));
 }
 
+int* SimpleRelation::compactRows(bool const rowsInBlock) {
+    int** const alphabetical_rows = sortedRowsByCols[0];
+    if (!rowsInBlock) {
+        /* Copy the rows in alphabetical order. The rows in other orders are located by binary search */
+        int* const block = new int[(size_t)totalRows * totalCols];
+        for (int col = 1; col < totalCols; col++) {
+            int** const sorted_rows = sortedRowsByCols[col];
+            for (int i = 0; i < totalRows; i++) {
+                int const idx = std::lower_bound(
+                    alphabetical_rows, alphabetical_rows + totalRows, sorted_rows[i], comparator
+                ) - alphabetical_rows;
+                sorted_rows[i] = block + (size_t)idx * totalCols;
+            }
+        }
+        for (int i = 0; i < totalRows; i++) {
+            std::copy(alphabetical_rows[i], alphabetical_rows[i] + totalCols, block + (size_t)i * totalCols);
+            alphabetical_rows[i] = block + (size_t)i * totalCols;
+        }
+        return block;
+    }
+
+    /* The rows are in one block, but not in alphabetical order. Find the target position of each row */
+    int* const block = (0 == totalRows) ? nullptr : *std::min_element(alphabetical_rows, alphabetical_rows + totalRows);
+    std::vector<int> new_positions(totalRows);
+    for (int i = 0; i < totalRows; i++) {
+        new_positions[(alphabetical_rows[i] - block) / totalCols] = i;
+    }
+    for (int col = 1; col < totalCols; col++) {
+        int** const sorted_rows = sortedRowsByCols[col];
+        for (int i = 0; i < totalRows; i++) {
+            sorted_rows[i] = block + (size_t)new_positions[(sorted_rows[i] - block) / totalCols] * totalCols;
+        }
+    }
+    for (int i = 0; i < totalRows; i++) {
+        alphabetical_rows[i] = block + (size_t)i * totalCols;
+    }
+
+    /* Move the rows to their positions along the cycles of the permutation */
+    for (int i = 0; i < totalRows; i++) {
+        while (new_positions[i] != i) {
+            int const target = new_positions[i];
+            std::swap_ranges(block + (size_t)i * totalCols, block + (size_t)(i + 1) * totalCols, block + (size_t)target * totalCols);
+            std::swap(new_positions[i], new_positions[target]);
+        }
+    }
+    return block;
+}
+
 /**
  * SimpleKb
  */
@@ -339,7 +416,9 @@ SimpleKb::SimpleKb(
 
 SimpleKb::SimpleKb(const SimpleKb& another) : name(strdup(another.name)),
     relations(new std::vector<SimpleRelation*>(*(another.relations))), relationNames(new const char*[another.relations->size()]),
-    relationNameMap(new std::unordered_map<std::string, SimpleRelation*>(*(another.relationNameMap)))
+    relationNameMap(new std::unordered_map<std::string, SimpleRelation*>(*(another.relationNameMap))),
+    promisingConstantCoverage(another.promisingConstantCoverage), columnOffsets(another.columnOffsets),
+    columnOverlaps(another.columnOverlaps)
 {
     if (nullptr == another.promisingConstants) {
         promisingConstants = nullptr;
@@ -463,11 +542,22 @@ void SimpleKb::setAsNotEntailed(int const relationId, int* const record) {
 }
 
 void SimpleKb::updatePromisingConstants() {
+    if (nullptr != promisingConstants && SimpleRelation::minConstantCoverage != promisingConstantCoverage) {
+        releasePromisingConstants();
+        promisingConstants = nullptr;
+    }
     if (nullptr == promisingConstants) {
         promisingConstants = new std::vector<int>**[relations->size()];
         for (int i = 0; i < relations->size(); i++) {
             promisingConstants[i] = (*relations)[i]->getPromisingConstants();
         }
+        promisingConstantCoverage = SimpleRelation::minConstantCoverage;
+    }
+}
+
+void SimpleKb::clearEntailment() {
+    for (SimpleRelation* const& relation: *relations) {
+        relation->clearEntailmentFlags();
     }
 }
 
@@ -475,6 +565,59 @@ std::vector<int>** SimpleKb::getPromisingConstants(int relId) const {
     return promisingConstants[relId];
 }
 
+void SimpleKb::updateColumnOverlaps() {
+    if (!columnOffsets.empty()) {
+        return;
+    }
+
+    /* Collect the columns where each constant appears */
+    int total_cols = 0;
+    columnOffsets.reserve(relations->size());
+    for (SimpleRelation* const& relation: *relations) {
+        columnOffsets.push_back(total_cols);
+        total_cols += relation->getTotalCols();
+    }
+    std::vector<std::vector<int>> columns_of_constants(constants + 1);
+    for (SimpleRelation* const& relation: *relations) {
+        for (int col = 0; col < relation->getTotalCols(); col++) {
+            int const col_idx = columnOffsets[relation->id] + col;
+            int* const values = relation->valuesInColumn(col);
+            for (int i = 0; i < relation->numValuesInColumn(col); i++) {
+                columns_of_constants[values[i]].push_back(col_idx);
+            }
+        }
+    }
+
+    /* Constants of the same type appear in the same columns. Each distinct column list only needs to be handled once */
+    std::set<std::vector<int>> column_groups;
+    for (std::vector<int>& columns: columns_of_constants) {
+        if (!columns.empty()) {
+            column_groups.insert(std::move(columns));
+        }
+    }
+    columns_of_constants.clear();
+    columnOverlaps.assign(total_cols, std::vector<int>());
+    for (std::vector<int> const& columns: column_groups) {
+        for (int const& col_idx: columns) {
+            std::vector<int>& overlaps = columnOverlaps[col_idx];
+            overlaps.insert(overlaps.end(), columns.begin(), columns.end());
+        }
+    }
+    for (std::vector<int>& overlaps: columnOverlaps) {
+        std::sort(overlaps.begin(), overlaps.end());
+        overlaps.erase(std::unique(overlaps.begin(), overlaps.end()), overlaps.end());
+        overlaps.shrink_to_fit();
+    }
+}
+
+bool SimpleKb::columnsOverlap(int const relId1, int const col1, int const relId2, int const col2) const {
+    if (columnOffsets.empty()) {
+        return true;
+    }
+    std::vector<int> const& overlaps = columnOverlaps[columnOffsets[relId1] + col1];
+    return std::binary_search(overlaps.begin(), overlaps.end(), columnOffsets[relId2] + col2);
+}
+
 const char* SimpleKb::getName() const {
     return name;
 }
@@ -518,6 +661,10 @@ size_t SimpleKb::memoryCost() const {
         }
     }
     size += sizeof(std::vector<int>**) * relations->size();
+    size += sizeof(int) * columnOffsets.capacity() + sizeof(std::vector<int>) * columnOverlaps.capacity();
+    for (std::vector<int> const& overlaps: columnOverlaps) {
+        size += sizeof(int) * overlaps.capacity();
+    }
     for (std::pair<const std::string, SimpleRelation*> const& kv: *relationNameMap) {
         size += sizeof(kv) + sizeof(char) * (kv.first.length() + 1);
     }
@@ -67,6 +67,10 @@ namespace sinc {
      *     records are stored in the file in order, i.e., in the order of: 1st row 1st col, 1st row 2nd col, ..., ith row
      *     jth col, ith row (j+1)th col, ...
      *
+     * In memory, all records are kept in one contiguous block in alphabetical order. Therefore, the row id of a record (i.e., the
+     * offset w.r.t. alphabetical order, which is also the index of the entailment flag) can be calculated from the pointer of the
+     * record in constant time.
+     *
      * @since 2.1
      */
     class SimpleRelation : public IntTable {
@@ -79,14 +83,17 @@ namespace sinc {
         /** The ID number of the relation */
         int const id;
         /** 
-         * Denote whether records should be maintained by this object. If `true`, the records will be released in destructor.
+         * Denote whether the input records are maintained by this object.
          * 
-         * This will be set to `true` if the object is constructed by loading from files.
+         * This will be set to `true` if the object is constructed by loading from files, where the records are loaded into
+         * `rowBlock` and sorted in place. Otherwise, the records in the table are copies in `rowBlock`. Either way, `rowBlock`
+         * will be released in destructor.
          */
         bool maintainRecords;
 
         /**
          * This method loads a relation file as a 2D array of integers. Please refer to "KbRelation" for the file format.
+         * The records are allocated in one block, in the order of the file (@since 2.6).
          *
          * @param filePath     The file containing the relation data
          * @param arity        The arity of the relation
@@ -96,6 +103,8 @@ namespace sinc {
 
         /**
          * Create a relation directly from a list of records
+         * 
+         * NOTE: The input records SHOULD be maintained by USER. The relation keeps copies of them.
          */
         SimpleRelation(const std::string& name, int const id, int** records, int const arity, int const totalRecords);
 
@@ -146,11 +155,64 @@ namespace sinc {
          */
         bool entailIfNot(int* const record);
 
+        /**
+         * Check whether the record with the row id is entailed. The parameter should satisfy: 0 <= rowId < totalRows.
+         * 
+         * @since 2.6
+         */
+        bool isEntailedById(int const rowId) const;
+
+        /**
+         * If the record with the row id has not been marked as entailed, mark the record as entailed and return true. Otherwise,
+         * return false. The parameter should satisfy: 0 <= rowId < totalRows.
+         * 
+         * @since 2.6
+         */
+        bool entailIfNotById(int const rowId);
+
+        /**
+         * The row id is calculated by the offset of the pointer in `rowBlock`. No search is performed.
+         * 
+         * NOTE: The row SHOULD be one of the rows in this relation (e.g., rows returned by `getAllRows()`, `getSlice()`, etc.).
+         * 
+         * @since 2.6
+         */
+        int rowIdOf(int* const row) const override;
+
         /**
          * Return the total number of entailed records in this relation.
          */
         int totalEntailedRecords() const;
 
+        /**
+         * The entailment flags of the records. The ith bit is set if the ith row has been marked as entailed. There are
+         * `getFlagLength()` integers in the array.
+         * 
+         * @since 2.6
+         */
+        int const* getEntailmentFlags() const;
+
+        /**
+         * The number of integers of the entailment flags.
+         * 
+         * @since 2.6
+         */
+        int getFlagLength() const;
+
+        /**
+         * Overwrite the entailment flags by a copy of `flags`, which SHOULD contain `getFlagLength()` integers.
+         * 
+         * @since 2.6
+         */
+        void setEntailmentFlags(int const* const flags);
+
+        /**
+         * Mark all records as not entailed.
+         * 
+         * @since 2.6
+         */
+        void clearEntailmentFlags();
+
         /**
          * Find the promising constants according to current records.
          * 
@@ -198,6 +260,8 @@ namespace sinc {
         size_t memoryCost() const override;
 
     protected:
+        /** All records in the relation, stored in alphabetical order. The ith row starts at `rowBlock + i * totalCols` */
+        int* const rowBlock;
         /** The flags are used to denote whether a record has been marked entailed */
         int* const entailmentFlags;
         /** The number of integers of the array `entailmentFlags` */
@@ -219,6 +283,18 @@ namespace sinc {
          * @return 0 if the bit is 0, non-zero otherwise.
          */
         int entailment(int const idx) const;
+
+        /**
+         * Arrange all rows in one contiguous block in alphabetical order and redirect the row pointers in the table to the
+         * block. If the rows are already in one block (as allocated by `loadFile()`), they are reordered in place.
+         * Otherwise, they are copied to a new block and the original rows are left to the caller.
+         * 
+         * @param rowsInBlock Whether the rows are already in one block
+         * @return The block of rows
+         * 
+         * @since 2.6
+         */
+        int* compactRows(bool const rowsInBlock);
     };
 
     /**
@@ -344,13 +420,42 @@ namespace sinc {
          */
         void setAsNotEntailed(int const relationId, int* const record);
 
+        /**
+         * Find the promising constants of all relations. The constants are found again only if
+         * `SimpleRelation::minConstantCoverage` has changed since the last update.
+         */
         void updatePromisingConstants();
 
+        /**
+         * Mark all records in the KB as not entailed, so that the KB can be compressed again.
+         * 
+         * @since 2.6
+         */
+        void clearEntailment();
+
         /**
          * NOTE: the pointers in the array should NOT be released by USER.
          */
         std::vector<int>** getPromisingConstants(int relId) const;
 
+        /**
+         * Build the index of column pairs sharing at least one constant. Joining two columns without any common constant
+         * produces no record, so such joins can be skipped without evaluating them. The index is sparse, i.e., only the
+         * overlapping pairs are stored.
+         *
+         * @since 2.6
+         */
+        void updateColumnOverlaps();
+
+        /**
+         * Check whether two columns share at least one constant.
+         *
+         * NOTE: This returns `true` if the index has not been built by `updateColumnOverlaps()`.
+         *
+         * @since 2.6
+         */
+        bool columnsOverlap(int const relId1, int const col1, int const relId2, int const col2) const;
+
         /**
          * NOTE: the pointer should NOT be released by USER.
          */
@@ -384,6 +489,12 @@ namespace sinc {
          * relation is at `(*promisingConstants[r][c])[i]`
          */
         std::vector<int>*** promisingConstants;
+        /** The constant coverage threshold of the current `promisingConstants` (@since 2.6) */
+        double promisingConstantCoverage = -1.0;
+        /** The index of the first column of each relation in `columnOverlaps` (@since 2.6) */
+        std::vector<int> columnOffsets;
+        /** `columnOverlaps[i]` is the ordered list of columns sharing at least one constant with column `i` (@since 2.6) */
+        std::vector<std::vector<int>> columnOverlaps;
         /** The total number of constants in the KB */
         int constants;
 
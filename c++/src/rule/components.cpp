@@ -1,7 +1,9 @@
 #include "components.h"
 #include <cmath>
+#include <limits>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 /**
  * EvalMetric
@@ -69,7 +71,7 @@ Eval::Eval(double const _posEtls, double const _allEtls, int const _ruleLength,
     infoGain = previousInfoGain + posEtls * (info_prev - info_now);
 }
 
-Eval::Eval(const Eval& another) : posEtls(another.posEtls), negEtls(another.negEtls), allEtls(another.negEtls),
+Eval::Eval(const Eval& another) : posEtls(another.posEtls), negEtls(another.negEtls), allEtls(another.allEtls),
     ruleLength(another.ruleLength), compRatio(another.compRatio), compCapacity(another.compCapacity), infoGain(another.infoGain) {}
 
 double Eval::value(EvalMetric::Value type) const {
@@ -89,6 +91,51 @@ bool Eval::useful() const {
     return 0 < compCapacity;
 }
 
+double Eval::maxAllEtls(
+    EvalMetric::Value type, double const cutoff, double const posEtls, int const ruleLength, double const previousCompRatio,
+    double const previousInfoGain
+) {
+    double const inf = std::numeric_limits<double>::infinity();
+    switch (type) {
+        case EvalMetric::CompressionCapacity:
+            /* pos - (all - pos) - len > cutoff */
+            return 2 * posEtls - ruleLength - cutoff;
+        case EvalMetric::CompressionRatio:
+            /* pos / (all + len) > cutoff */
+            return (0 >= cutoff) ? inf : posEtls / cutoff - ruleLength;
+        case EvalMetric::InfoGain: {
+            /* prev_gain + pos * (-log(prev_ratio + 0.01) + log(ratio + 0.01)) > cutoff */
+            if (0 >= posEtls) {
+                return (previousInfoGain > cutoff) ? inf : -1;
+            }
+            double const min_ratio = std::exp(
+                (cutoff - previousInfoGain) / posEtls + std::log(previousCompRatio + 0.01)
+            ) - 0.01;
+            return (0 >= min_ratio) ? inf : posEtls / min_ratio - ruleLength;
+        }
+        default:
+            return inf;
+    }
+}
+
+double Eval::optimisticSpecializationScore(EvalMetric::Value type) const {
+    double const length = ruleLength + 1;
+    switch (type) {
+        case EvalMetric::CompressionCapacity:
+            return posEtls - length;
+        case EvalMetric::CompressionRatio:
+            return posEtls / (posEtls + length);
+        case EvalMetric::InfoGain: {
+            /* The gain `pos * (log(ratio + 0.01) - log(prev_ratio + 0.01))` is maximized either by keeping all positive
+               entailments or by keeping none */
+            double const gain = posEtls * (std::log(posEtls / (posEtls + length) + 0.01) - std::log(compRatio + 0.01));
+            return infoGain + std::max(gain, 0.0);
+        }
+        default:
+            return std::numeric_limits<double>::infinity();
+    }
+}
+
 double Eval::getAllEtls() const {
     return allEtls;
 }
@@ -308,6 +355,19 @@ Fingerprint::Fingerprint(const std::vector<Predicate>& _rule) : rule(_rule) {
     /* Calculate hash code */
     hashCode = classedStructure[0].hash() * 31 + equivalenceClasses.hash();
 
+    /* Calculate binding signature */
+    bindingSignature = 0;
+    for (PredicateWithClass const& pred_with_class: classedStructure) {
+        for (int arg_idx = 0; arg_idx < pred_with_class.arity; arg_idx++) {
+            if (1 < pred_with_class.classArgs[arg_idx]->getSize()) {
+                uint64_t h = ((uint64_t) pred_with_class.functor) * 0x9e3779b97f4a7c15ULL + arg_idx;
+                h ^= h >> 29;
+                h *= 0xbf58476d1ce4e5b9ULL;
+                bindingSignature |= 1ULL << ((h >> 32) & 63);
+            }
+        }
+    }
+
     delete[] lv_equiv_classes;
 }
 
@@ -346,6 +406,10 @@ bool Fingerprint::generalizationOf(const Fingerprint& another) const {
     if (rule.size() > another.rule.size()) {
         return false;
     }
+    if (0 != (bindingSignature & ~another.bindingSignature)) {
+        /* Some argument bound in this rule is free in the other */
+        return false;
+    }
     const PredicateWithClass& head = classedStructure[0];
     const PredicateWithClass& another_head = another.classedStructure[0];
     if (!generalizationOf(head, another_head)) {
@@ -374,6 +438,70 @@ bool Fingerprint::generalizationOf(const Fingerprint& another) const {
     return true;
 }
 
+uint64_t Fingerprint::getBindingSignature() const {
+    return bindingSignature;
+}
+
+/** A 64-bit mixer (the finalizer of SplitMix64) */
+static inline uint64_t mixHash(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+uint64_t Fingerprint::canonicalHash(const std::vector<Predicate>& rule) {
+    /* Mirror the construction of the equivalence classes, but only accumulate the hashes of the members. The hash of a
+     * multiset is the sum of the mixed hashes of its elements */
+    int max_lv_id = -1;
+    for (Predicate const& predicate: rule) {
+        for (int arg_idx = 0; arg_idx < predicate.getArity(); arg_idx++) {
+            int argument = predicate.getArg(arg_idx);
+            if (ARG_IS_VARIABLE(argument)) {
+                max_lv_id = std::max(max_lv_id, ARG_DECODE(argument));
+            }
+        }
+    }
+    std::vector<uint64_t> lv_class_hashes(max_lv_id + 1, 0);
+    uint64_t classes_hash = 0;
+    for (Predicate const& predicate: rule) {
+        for (int arg_idx = 0; arg_idx < predicate.getArity(); arg_idx++) {
+            int argument = predicate.getArg(arg_idx);
+            uint64_t indicator_hash = mixHash((((uint64_t) predicate.getPredSymbol()) << 32) | arg_idx);
+            if (ARG_IS_EMPTY(argument)) {
+                classes_hash += mixHash(indicator_hash);
+            } else if (ARG_IS_VARIABLE(argument)) {
+                lv_class_hashes[ARG_DECODE(argument)] += indicator_hash;
+            } else {
+                classes_hash += mixHash(indicator_hash + mixHash(~((uint64_t) ARG_DECODE(argument))));
+            }
+        }
+    }
+    for (uint64_t const& lv_class_hash: lv_class_hashes) {
+        classes_hash += mixHash(lv_class_hash);
+    }
+
+    /* The head is compared in order */
+    Predicate const& head = rule[0];
+    uint64_t head_hash = ((uint64_t) head.getPredSymbol()) * 31 + head.getArity();
+    for (int arg_idx = 0; arg_idx < head.getArity(); arg_idx++) {
+        int argument = head.getArg(arg_idx);
+        uint64_t indicator_hash = mixHash((((uint64_t) head.getPredSymbol()) << 32) | arg_idx);
+        uint64_t class_hash;
+        if (ARG_IS_EMPTY(argument)) {
+            class_hash = mixHash(indicator_hash);
+        } else if (ARG_IS_VARIABLE(argument)) {
+            class_hash = mixHash(lv_class_hashes[ARG_DECODE(argument)]);
+        } else {
+            class_hash = mixHash(indicator_hash + mixHash(~((uint64_t) ARG_DECODE(argument))));
+        }
+        head_hash = head_hash * 31 + class_hash;
+    }
+    return mixHash(head_hash) ^ classes_hash;
+}
+
 bool Fingerprint::operator==(const Fingerprint &another) const {
     return classedStructure[0] == another.classedStructure[0] && equivalenceClasses == another.equivalenceClasses;
 }
@@ -401,6 +529,127 @@ bool Fingerprint::generalizationOf(const PredicateWithClass& predicate, const Pr
     return true;
 }
 
+/**
+ * FingerprintCache
+ */
+using sinc::FingerprintCache;
+FingerprintCache::~FingerprintCache() {
+    clear();
+}
+
+bool FingerprintCache::insert(
+    const std::vector<Predicate>& rule, uint64_t const hash, Fingerprint*& fingerprint, bool& releaseFingerprint
+) {
+    std::pair<entryMapType::iterator, entryMapType::iterator> range = entries.equal_range(hash);
+    if (range.first != range.second) {
+        /* Hash collision: check with the full fingerprints */
+        if (nullptr == fingerprint) {
+            fingerprint = new Fingerprint(rule);
+            releaseFingerprint = true;
+        }
+        for (entryMapType::iterator itr = range.first; itr != range.second; itr++) {
+            if (*fingerprintOf(itr->second) == *fingerprint) {
+                return false;
+            }
+        }
+    }
+    Entry& entry = entries.emplace(hash, Entry{std::vector<int>(), nullptr})->second;
+    if (nullptr != fingerprint && releaseFingerprint) {
+        entry.fingerprint = fingerprint;
+        releaseFingerprint = false;
+    } else {
+        encode(rule, entry.encodedRule);
+    }
+    return true;
+}
+
+void FingerprintCache::adopt(
+    const std::vector<Predicate>& rule, uint64_t const hash, Fingerprint*& fingerprint, bool& releaseFingerprint
+) {
+    if (!releaseFingerprint) {
+        return;
+    }
+    std::vector<int> encoded_rule;
+    encode(rule, encoded_rule);
+    std::pair<entryMapType::iterator, entryMapType::iterator> range = entries.equal_range(hash);
+    for (entryMapType::iterator itr = range.first; itr != range.second; itr++) {
+        Entry& entry = itr->second;
+        if (nullptr == entry.fingerprint && entry.encodedRule == encoded_rule) {
+            /* The entry is added by the same structure */
+            entry.fingerprint = fingerprint;
+            std::vector<int>().swap(entry.encodedRule);
+            releaseFingerprint = false;
+            return;
+        }
+        if (*fingerprintOf(entry) == *fingerprint) {
+            delete fingerprint;
+            fingerprint = entry.fingerprint;
+            releaseFingerprint = false;
+            return;
+        }
+    }
+    entries.emplace(hash, Entry{std::vector<int>(), fingerprint});
+    releaseFingerprint = false;
+}
+
+size_t FingerprintCache::size() const {
+    return entries.size();
+}
+
+void FingerprintCache::clear() {
+    for (std::pair<const uint64_t, Entry> const& kv: entries) {
+        if (nullptr != kv.second.fingerprint) {
+            delete kv.second.fingerprint;
+        }
+    }
+    entries.clear();
+}
+
+size_t FingerprintCache::getMemCost() const {
+    size_t size = sizeof(FingerprintCache) + sinc::sizeOfUnorderedMap(
+        entries.bucket_count(), entries.max_load_factor(), sizeof(std::pair<const uint64_t, Entry>), sizeof(entries)
+    );
+    for (std::pair<const uint64_t, Entry> const& kv: entries) {
+        size += sizeof(int) * kv.second.encodedRule.capacity();
+        if (nullptr != kv.second.fingerprint) {
+            size += kv.second.fingerprint->getMemCost();
+        }
+    }
+    return size;
+}
+
+void FingerprintCache::encode(const std::vector<Predicate>& rule, std::vector<int>& encodedRule) {
+    size_t length = 0;
+    for (Predicate const& predicate: rule) {
+        length += 2 + predicate.getArity();
+    }
+    encodedRule.reserve(length);
+    for (Predicate const& predicate: rule) {
+        encodedRule.push_back(predicate.getPredSymbol());
+        encodedRule.push_back(predicate.getArity());
+        for (int arg_idx = 0; arg_idx < predicate.getArity(); arg_idx++) {
+            encodedRule.push_back(predicate.getArg(arg_idx));
+        }
+    }
+}
+
+Fingerprint* FingerprintCache::fingerprintOf(Entry& entry) {
+    if (nullptr == entry.fingerprint) {
+        std::vector<Predicate> rule;
+        for (int i = 0; i < entry.encodedRule.size(); ) {
+            int const arity = entry.encodedRule[i + 1];
+            Predicate& predicate = rule.emplace_back(entry.encodedRule[i], arity);
+            for (int arg_idx = 0; arg_idx < arity; arg_idx++) {
+                predicate.setArg(arg_idx, entry.encodedRule[i + 2 + arg_idx]);
+            }
+            i += 2 + arity;
+        }
+        entry.fingerprint = new Fingerprint(rule);
+        std::vector<int>().swap(entry.encodedRule);
+    }
+    return entry.fingerprint;
+}
+
 size_t std::hash<Fingerprint>::operator()(const Fingerprint& r) const {
     return r.hash();
 }
@@ -95,6 +95,28 @@ namespace sinc {
          */
         bool useful() const;
 
+        /**
+         * Calculate the bound of the number of all entailments such that the score of a rule is still higher than `cutoff`.
+         * The scores of all metrics decrease as `allEtls` increases when the other arguments are fixed. Therefore, a rule
+         * cannot beat `cutoff` if its number of entailments is no less than the returned value.
+         *
+         * @return The bound of `allEtls`. Infinity if there is no bound, and a negative value if no `allEtls` is feasible.
+         * @since 2.6
+         */
+        static double maxAllEtls(
+            EvalMetric::Value type, double const cutoff, double const posEtls, int const ruleLength,
+            double const previousCompRatio, double const previousInfoGain
+        );
+
+        /**
+         * An upper bound of the score of any specialization of the rule evaluated by this object. A specialization adds
+         * one to the rule length and never increases the number of positive entailments, so the best case is a rule that
+         * keeps all positive entailments and has no negative one.
+         *
+         * @since 2.6
+         */
+        double optimisticSpecializationScore(EvalMetric::Value type) const;
+
         double getAllEtls() const;
         double getPosEtls() const;
         double getNegEtls() const;
@@ -257,6 +279,24 @@ namespace sinc {
          */
         bool generalizationOf(const Fingerprint& another) const;
 
+        /**
+         * A bloom signature of the argument positions, denoted by (functor, argument index), that are bound to a non-trivial
+         * equivalence class (i.e., shared with other arguments or assigned a constant). If this fingerprint is a
+         * generalization of another, the signature of this one is a subset of that of the other.
+         *
+         * @since 2.6
+         */
+        uint64_t getBindingSignature() const;
+
+        /**
+         * Calculate a 64-bit hash of the canonical form of a rule structure without building the fingerprint. Rules of
+         * equivalent fingerprints (i.e., the same up to variable renaming and the order of body predicates) always have the
+         * same canonical hash.
+         *
+         * @since 2.6
+         */
+        static uint64_t canonicalHash(const std::vector<Predicate>& rule);
+
         bool operator==(const Fingerprint &another) const;
         size_t hash() const;
         static void releaseEquivalenceClass(equivalenceClassType* equivalenceClass);
@@ -273,9 +313,70 @@ namespace sinc {
         const std::vector<Predicate> rule;
         /** Fingerprint object are not modifiable. Thus hashCode can be calculated during construction and stored. */
         size_t hashCode;
+        /** The binding signature is also calculated during construction */
+        uint64_t bindingSignature;
 
         static bool generalizationOf(const PredicateWithClass& predicate, const PredicateWithClass& specializedPredicate);
     };
+
+    /**
+     * The cache of the fingerprints of all used rules. Rules are filtered by their canonical hashes first. A cached rule
+     * is stored in a compact encoding of its structure, and the full fingerprint is only built when another rule of the
+     * same canonical hash comes, or when the fingerprint is taken over by the cache (e.g., for the tabu sets).
+     *
+     * NOTE: Fingerprints in the cache are released by the cache.
+     *
+     * @since 2.6
+     */
+    class FingerprintCache {
+    public:
+        FingerprintCache() = default;
+        FingerprintCache(const FingerprintCache& another) = delete;
+        ~FingerprintCache();
+
+        /**
+         * Add a rule to the cache if no equivalent rule is in the cache.
+         *
+         * @param rule The structure of the rule
+         * @param hash The canonical hash of the rule
+         * @param fingerprint The fingerprint of the rule, or NULL if not built. If the full check is needed, the fingerprint
+         * is built here and assigned to this reference.
+         * @param releaseFingerprint Whether the caller should release `fingerprint`. This is set to `false` if the cache takes
+         * over the fingerprint.
+         * @return Whether the rule is added
+         */
+        bool insert(
+            const std::vector<Predicate>& rule, uint64_t const hash, Fingerprint*& fingerprint, bool& releaseFingerprint
+        );
+
+        /**
+         * Let the cache take over the fingerprint of a rule. If the cache has already kept an equivalent fingerprint, the
+         * fingerprint of the rule is released and replaced by the one in the cache.
+         *
+         * NOTE: `fingerprint` SHOULD NOT be NULL.
+         */
+        void adopt(const std::vector<Predicate>& rule, uint64_t const hash, Fingerprint*& fingerprint, bool& releaseFingerprint);
+
+        size_t size() const;
+        void clear();
+        size_t getMemCost() const;
+
+    protected:
+        /** A cached rule is either in the encoded form or with the fingerprint */
+        struct Entry {
+            std::vector<int> encodedRule;
+            Fingerprint* fingerprint;
+        };
+        typedef std::unordered_multimap<uint64_t, Entry> entryMapType;
+
+        entryMapType entries;
+
+        /** Encode the rule structure as a sequence of: functor, arity, arguments */
+        static void encode(const std::vector<Predicate>& rule, std::vector<int>& encodedRule);
+
+        /** Make sure the entry has the fingerprint */
+        static Fingerprint* fingerprintOf(Entry& entry);
+    };
 }
 
 /**
@@ -1,6 +1,7 @@
 #include "rule.h"
 #include "../util/common.h"
 #include <sstream>
+#include <cmath>
 #include "../util/util.h"
 
 /**
@@ -9,6 +10,7 @@
 using sinc::Rule;
 using sinc::ParsedPred;
 using sinc::ParsedArg;
+using sinc::MultiSet;
 
 double Rule::MinFactCoverage = DEFAULT_MIN_FACT_COVERAGE;
 
@@ -159,6 +161,50 @@ std::string Rule::toString(const std::vector<ParsedPred*>& parsedStructure) {
     return os.str();
 }
 
+uint64_t Rule::TabuMap::categorySignature(MultiSet<int> const& functors) {
+    uint64_t signature = 0;
+    for (std::pair<const int, int> const& kv: functors.getCntMap()) {
+        for (int occurrence = 0; occurrence < kv.second; occurrence++) {
+            uint64_t h = ((uint64_t) kv.first) * 0x9e3779b97f4a7c15ULL + occurrence;
+            h ^= h >> 29;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            signature |= 1ULL << ((h >> 32) & 63);
+        }
+    }
+    return signature;
+}
+
+void Rule::TabuMap::addFingerprint(MultiSet<int>* functors, const Fingerprint* fingerprint) {
+    iterator itr = find(functors);
+    if (end() == itr) {
+        /* Put new category */
+        tabuSetType* tabu_set = new tabuSetType();
+        tabu_set->insert(fingerprint);
+        emplace(functors, tabu_set);
+        categories.push_back(Category{functors, categorySignature(*functors), tabu_set});
+    } else {
+        /* Add to existing category */
+        itr->second->insert(fingerprint);
+        delete functors;
+    }
+}
+
+std::vector<Rule::TabuMap::Category> const& Rule::TabuMap::getCategories() const {
+    return categories;
+}
+
+void Rule::TabuMap::clear() {
+    std::unordered_map<MultiSet<int>*, tabuSetType*>::clear();
+    categories.clear();
+}
+
+std::shared_mutex& Rule::TabuMap::getMutex() const {
+    return mutex;
+}
+
+size_t Rule::TabuMap::getIndexMemCost() const {
+    return sizeof(Category) * categories.capacity();
+}
 
 Rule::Rule(int const headPredSymbol, int const arity, fingerprintCacheType& _fingerprintCache, tabuMapType& _category2TabuSetMap) :
     fingerprintCache(_fingerprintCache), category2TabuSetMap(_category2TabuSetMap), fingerprint(nullptr), releaseFingerprint(false),
@@ -166,12 +212,40 @@ Rule::Rule(int const headPredSymbol, int const arity, fingerprintCacheType& _fin
 {
     structure.emplace_back(headPredSymbol, arity);
     updateFingerprint();
-    std::pair<fingerprintCacheType::iterator, bool> ret = fingerprintCache.insert(fingerprint);
-    releaseFingerprint = !ret.second;
+    std::lock_guard<std::shared_mutex> lock(category2TabuSetMap.getMutex());
+    fingerprintCache.insert(structure, canonicalHash, fingerprint, releaseFingerprint);
+}
+
+Rule::Rule(
+    std::vector<Predicate> const& _structure, Eval const& _eval, fingerprintCacheType& _fingerprintCache, tabuMapType& _category2TabuSetMap
+) : fingerprintCache(_fingerprintCache), category2TabuSetMap(_category2TabuSetMap), structure(_structure), fingerprint(nullptr),
+    releaseFingerprint(false), length(MIN_LENGTH), eval(_eval)
+{
+    /* Each constant adds one to the length, and so does each extra occurrence of a limited variable */
+    for (int pred_idx = 0; pred_idx < structure.size(); pred_idx++) {
+        Predicate const& predicate = structure[pred_idx];
+        for (int arg_idx = 0; arg_idx < predicate.getArity(); arg_idx++) {
+            int const argument = predicate.getArg(arg_idx);
+            if (ARG_IS_VARIABLE(argument)) {
+                int const var_id = ARG_DECODE(argument);
+                while (limitedVarArgs.size() <= var_id) {
+                    limitedVarArgs.push_back(new std::vector<ArgLocation>());
+                }
+                if (!limitedVarArgs[var_id]->empty()) {
+                    length++;
+                }
+                limitedVarArgs[var_id]->emplace_back(pred_idx, arg_idx);
+            } else if (ARG_IS_CONSTANT(argument)) {
+                length++;
+            }
+        }
+    }
+    updateFingerprint();
 }
 
 Rule::Rule(const Rule& another) : fingerprintCache(another.fingerprintCache), category2TabuSetMap(another.category2TabuSetMap),
-    fingerprint(another.fingerprint), releaseFingerprint(false), length(another.length), eval(another.eval),
+    canonicalHash(another.canonicalHash), fingerprint(another.releaseFingerprint ? nullptr : another.fingerprint),
+    releaseFingerprint(false), length(another.length), eval(another.eval),
     structure(another.structure)
 {
     limitedVarArgs.reserve(another.limitedVarArgs.size());
@@ -392,6 +466,12 @@ Eval const& Rule::getEval() const {
 
 using sinc::Fingerprint;
 Fingerprint const& Rule::getFingerprint() const {
+    if (nullptr == fingerprint) {
+        uint64_t time_start = sinc::currentTimeInNano();
+        fingerprint = new Fingerprint(structure);
+        releaseFingerprint = true;
+        fingerprintCreationTime += sinc::currentTimeInNano() - time_start;
+    }
     return *fingerprint;
 }
 
@@ -445,6 +525,67 @@ std::string Rule::toDumpString() const {
     return os.str();
 }
 
+void Rule::setEvalCutoff(EvalMetric::Value const metric, double const cutoff) {
+    cutoffMetric = metric;
+    evalCutoff = cutoff;
+}
+
+bool Rule::isEvalAbandoned() const {
+    return evalAbandoned;
+}
+
+void Rule::setEvalSampling(double const ratio, double const confidence) {
+    evalSampleRatio = std::min(std::max(ratio, 0.0), 1.0);
+
+    /* Find z such that P(|Z| <= z) = confidence for the standard normal Z, i.e., erf(z / sqrt(2)) = confidence */
+    double low = 0;
+    double high = 10;
+    for (int i = 0; i < 64; i++) {
+        double const mid = (low + high) / 2;
+        if (std::erf(mid / std::sqrt(2.0)) < confidence) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    evalSampleZ = (low + high) / 2;
+}
+
+bool Rule::isEvalSampled() const {
+    return evalSampled;
+}
+
+void Rule::setEvalThreads(int const threads) {
+    evalThreads = std::max(threads, 1);
+}
+
+double Rule::getEvalLowerBound(EvalMetric::Value const metric) const {
+    if (!evalSampled) {
+        return eval.value(metric);
+    }
+    /* The scores are not always monotonic in the positive entailments (e.g., the information gain) */
+    return std::min(evalLowerBound.value(metric), evalUpperBound.value(metric));
+}
+
+double Rule::getEvalUpperBound(EvalMetric::Value const metric) const {
+    if (!evalSampled) {
+        return eval.value(metric);
+    }
+    return std::max(evalLowerBound.value(metric), evalUpperBound.value(metric));
+}
+
+void Rule::verifyEval() {
+    if (!evalSampled) {
+        return;
+    }
+    double const ratio = evalSampleRatio;
+    evalSampleRatio = 1.0;
+    evalCutoff = -std::numeric_limits<double>::infinity();
+    eval = baseEval;
+    updateEval();
+    evalSampleRatio = ratio;
+}
+
 uint64_t Rule::getFingerprintCreationTime() const {
     return fingerprintCreationTime;
 }
@@ -458,11 +599,11 @@ uint64_t Rule::getEvalTime() const {
 }
 
 bool Rule::operator==(const Rule &another) const {
-    return *fingerprint == another.getFingerprint();
+    return canonicalHash == another.canonicalHash && getFingerprint() == another.getFingerprint();
 }
 
 size_t Rule::hash() const {
-    return fingerprint->hash();
+    return canonicalHash;
 }
 
 size_t Rule::memoryCost() const {
@@ -478,7 +619,9 @@ void Rule::updateFingerprint() {
     if (releaseFingerprint) {
         delete fingerprint;
     }
-    fingerprint = new Fingerprint(structure);
+    fingerprint = nullptr;
+    releaseFingerprint = false;
+    canonicalHash = Fingerprint::canonicalHash(structure);
     fingerprintCreationTime += sinc::currentTimeInNano() - time_start;
 }
 
@@ -651,70 +794,38 @@ bool Rule::isInvalid() {
 
 bool Rule::cacheHit() {
     uint64_t time_start = sinc::currentTimeInNano();
-    releaseFingerprint = !fingerprintCache.insert(fingerprint).second;
+    bool inserted;
+    {
+        std::lock_guard<std::shared_mutex> lock(category2TabuSetMap.getMutex());
+        inserted = fingerprintCache.insert(structure, canonicalHash, fingerprint, releaseFingerprint);
+    }
     pruningTime += sinc::currentTimeInNano() - time_start;
-    return releaseFingerprint;
+    return !inserted;
 }
 
 bool Rule::tabuHit() {
     uint64_t time_start = sinc::currentTimeInNano();
-    for (int subset_size = 0; subset_size < structure.size(); subset_size++) {
-        std::unordered_set<MultiSet<int>*>* category_subsets = categorySubsets(subset_size);
-        for (MultiSet<int>* const& category_subset : *category_subsets) {
-            tabuMapType::iterator itr = category2TabuSetMap.find(category_subset);
-            if (category2TabuSetMap.end() == itr) {
-                continue;
-            }
-            fingerprintCacheType* tabu_set = itr->second;
-            for (const Fingerprint* const& rfp : *tabu_set) {
-                if (rfp->generalizationOf(*fingerprint)) {
-                    for (MultiSet<int>* const& category_subset : *category_subsets) {
-                        delete category_subset;
-                    }
-                    delete category_subsets;
-                    pruningTime += sinc::currentTimeInNano() - time_start;
-                    return true;
-                }
-            }
-        }
-        for (MultiSet<int>* const& category_subset : *category_subsets) {
-            delete category_subset;
-        }
-        delete category_subsets;
-    }
-    pruningTime += sinc::currentTimeInNano() - time_start;
-    return false;
-}
-
-using sinc::MultiSet;
-std::unordered_set<MultiSet<int>*>* Rule::categorySubsets(int const subsetSize) const {
-    std::unordered_set<MultiSet<int>*>* subsets = new std::unordered_set<MultiSet<int>*>();
-    if (0 == subsetSize) {
-        subsets->insert(new MultiSet<int>());
-    } else {
-        int functorTemplate[subsetSize]{0};
-        templateSubsetsHandler(subsets, functorTemplate, subsetSize, subsetSize - 1, FIRST_BODY_PRED_IDX);
+    MultiSet<int> functor_mset;
+    for (int pred_idx = FIRST_BODY_PRED_IDX; pred_idx < structure.size(); pred_idx++) {
+        functor_mset.add(structure[pred_idx].getPredSymbol());
     }
-    return subsets;
-}
-
-void Rule::templateSubsetsHandler(
-    std::unordered_set<MultiSet<int>*>* const subsets, int* const templateArr, int const arrLength, int const depth, int const startIdx
-) const {
-    if (0 < depth) {
-        for (int pred_idx = startIdx; pred_idx < structure.size(); pred_idx++) {
-            templateArr[depth] = structure[pred_idx].getPredSymbol();
-            templateSubsetsHandler(subsets, templateArr, arrLength, depth-1, pred_idx+1);
+    uint64_t const signature = TabuMap::categorySignature(functor_mset);
+    getFingerprint();   // built before the lock, as it is owned by this rule
+    std::shared_lock<std::shared_mutex> lock(category2TabuSetMap.getMutex());
+    for (TabuMap::Category const& category: category2TabuSetMap.getCategories()) {
+        /* Screen the categories by signature first, and then check the multisets */
+        if (0 != (category.signature & ~signature) || !category.functors->subsetOf(functor_mset)) {
+            continue;
         }
-    } else {
-        for (int pred_idx = startIdx; pred_idx < structure.size(); pred_idx++) {
-            templateArr[depth] = structure[pred_idx].getPredSymbol();
-            MultiSet<int>* category = new MultiSet<int>(templateArr, arrLength);
-            if (!subsets->insert(category).second) {
-                delete category;
+        for (const Fingerprint* const& rfp : *(category.tabuSet)) {
+            if (rfp->generalizationOf(getFingerprint())) {
+                pruningTime += sinc::currentTimeInNano() - time_start;
+                return true;
             }
         }
     }
+    pruningTime += sinc::currentTimeInNano() - time_start;
+    return false;
 }
 
 bool Rule::insufficientCoverage() {
@@ -733,21 +844,17 @@ void Rule::add2TabuMap() {
     for (int pred_idx = FIRST_BODY_PRED_IDX; pred_idx < structure.size(); pred_idx++) {
         functor_mset->add(structure[pred_idx].getPredSymbol());
     }
-    tabuMapType::iterator itr = category2TabuSetMap.find(functor_mset);
-    if (category2TabuSetMap.end() == itr) {
-        /* Put new category */
-        fingerprintCacheType* tabu_set = new fingerprintCacheType();
-        tabu_set->insert(fingerprint);
-        category2TabuSetMap.emplace(functor_mset, tabu_set);
-    } else {
-        /* Add to existing category */
-        itr->second->insert(fingerprint);
-        delete functor_mset;
-    }
+    getFingerprint();
+    std::lock_guard<std::shared_mutex> lock(category2TabuSetMap.getMutex());
+    fingerprintCache.adopt(structure, canonicalHash, fingerprint, releaseFingerprint);
+    category2TabuSetMap.addFingerprint(functor_mset, fingerprint);
 }
 
 void Rule::updateEval() {
     uint64_t time_start = sinc::currentTimeInNano();
+    evalAbandoned = false;
+    evalSampled = false;
+    baseEval = eval;
     eval = calculateEval();
     evalTime += sinc::currentTimeInNano() - time_start;
 }
@@ -882,6 +989,10 @@ using sinc::BareRule;
 BareRule::BareRule(int const headPredSymbol, int arity, fingerprintCacheType& _fingerprintCache, tabuMapType& _category2TabuSetMap) :
     Rule(headPredSymbol, arity, _fingerprintCache, _category2TabuSetMap), returningEval(Eval(0, 0, 0)) {}
 
+BareRule::BareRule(
+    std::vector<Predicate> const& _structure, Eval const& _eval, fingerprintCacheType& _fingerprintCache, tabuMapType& _category2TabuSetMap
+) : Rule(_structure, _eval, _fingerprintCache, _category2TabuSetMap), returningEval(_eval) {}
+
 BareRule::BareRule(const BareRule& another) : Rule(another), returningEval(Eval(another.returningEval)),
     returningCounterexamples(another.returningCounterexamples), returningEvidence(another.returningEvidence) {}
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <unordered_set>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
 #include "components.h"
 
 /** The index of the head predicate */
@@ -16,15 +19,71 @@ namespace sinc {
      * The class of the basic rule structure. The class defines the basic structure of a rule and the basic operations that
      * manipulates the structure.
      * 
-     * NOTE: Rule objects will insert fingerprint pointers to the `fingerprintCache`. The pointers in the set SHOULD be released
-     * by USER, before destruction of the set.
+     * NOTE: Rule objects will insert fingerprints to the `fingerprintCache`, and the cached fingerprints are released by the
+     * cache. The fingerprint of a rule is built lazily, and it is only built if needed by the tabu map or by a collision of
+     * the canonical hashes in the cache.
      *
      * @since 1.0
      */
     class Rule {
     public:
-        typedef std::unordered_set<const Fingerprint*> fingerprintCacheType;
-        typedef std::unordered_map<MultiSet<int>*, fingerprintCacheType*> tabuMapType;
+        typedef FingerprintCache fingerprintCacheType;
+        typedef std::unordered_set<const Fingerprint*> tabuSetType;
+
+        /**
+         * The tabu map groups the fingerprints of pruned rules by the multiset of body functors (the category). Besides the
+         * hash map, each category is indexed by a bloom signature of the multiset, so that the categories that are subsets
+         * of a rule's category can be screened by bitwise checks instead of enumerating all sub-multisets of the rule.
+         *
+         * NOTE: Use `addFingerprint()` to modify the map, otherwise the index is not updated. The keys and the tabu sets in
+         * the map SHOULD be released by USER, before `clear()` or destruction of the map. The fingerprints in the tabu sets
+         * are owned by the fingerprint cache.
+         *
+         * NOTE: A tabu map is shared by the rules of a relation miner, and so are the fingerprint caches of the miner. The
+         * rules may be updated by different threads, so both the map and the caches are guarded by `getMutex()`.
+         *
+         * @since 2.6
+         */
+        class TabuMap : public std::unordered_map<MultiSet<int>*, tabuSetType*> {
+        public:
+            /** An indexed category */
+            struct Category {
+                MultiSet<int>* functors;
+                uint64_t signature;
+                tabuSetType* tabuSet;
+            };
+
+            /**
+             * Calculate the signature of a functor multiset. Each element is hashed together with its occurrence number,
+             * thus if `A` is a sub-multiset of `B`, the signature of `A` is a subset of that of `B`.
+             */
+            static uint64_t categorySignature(MultiSet<int> const& functors);
+
+            /**
+             * Add a fingerprint to the category. If the category is not in the map, it is added and indexed, and the map
+             * takes over the pointer `functors`. Otherwise, `functors` is released.
+             */
+            void addFingerprint(MultiSet<int>* functors, const Fingerprint* fingerprint);
+
+            /** NOTE: The returned reference should NOT be modified */
+            std::vector<Category> const& getCategories() const;
+
+            /**
+             * The lock of the map and the fingerprint caches sharing it. Checks of the tabu sets share the lock, while
+             * updates of the map or the caches hold it exclusively.
+             *
+             * @since 2.6
+             */
+            std::shared_mutex& getMutex() const;
+
+            void clear();
+            size_t getIndexMemCost() const;
+
+        protected:
+            std::vector<Category> categories;
+            mutable std::shared_mutex mutex;
+        };
+        typedef TabuMap tabuMapType;
 
         /** The threshold of the coverage value for pruning */
         static double MinFactCoverage;
@@ -75,6 +134,15 @@ namespace sinc {
          */
         Rule(int const headPredSymbol, int const arity, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap);
 
+        /**
+         * Restore a rule from its structure (e.g., a rule loaded from a checkpoint). The limited variables and the length
+         * are inferred from the arguments. The restored rule is not added to the fingerprint cache.
+         *
+         * @param structure The predicates of the rule, where the first one is the head
+         * @since 2.6
+         */
+        Rule(std::vector<Predicate> const& structure, Eval const& eval, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap);
+
         Rule(const Rule& another);
 
         virtual ~Rule();
@@ -204,6 +272,66 @@ namespace sinc {
          */
         std::string toDumpString() const;
 
+        /**
+         * Set the score that the evaluation of this rule should beat. If the rule certainly cannot beat `cutoff` under the
+         * metric, the evaluation may be abandoned before the exact numbers of entailments are counted. In this case,
+         * `getEval()` returns an optimistic evaluation, whose score is no higher than `cutoff`.
+         *
+         * @since 2.6
+         */
+        void setEvalCutoff(EvalMetric::Value const metric, double const cutoff);
+
+        /**
+         * Whether the last evaluation was abandoned due to the cutoff score.
+         *
+         * @since 2.6
+         */
+        bool isEvalAbandoned() const;
+
+        /**
+         * Set the ratio of the head records that the following evaluations are based on. If the ratio is less than 1, an
+         * implementation may count the positive entailments in a sample of the head records and estimate the score, with
+         * a confidence interval at the given level. Implementations that do not sample ignore this setting.
+         *
+         * @param ratio      The sample ratio in (0, 1]. 1 means exact evaluation
+         * @param confidence The confidence level of the intervals, in (0, 1)
+         * @since 2.6
+         */
+        void setEvalSampling(double const ratio, double const confidence);
+
+        /**
+         * Whether the last evaluation was estimated on a sample of the head records.
+         *
+         * @since 2.6
+         */
+        bool isEvalSampled() const;
+
+        /**
+         * Set the number of threads that the following evaluations may use. The caller should not pass more threads than
+         * it owns, as the evaluation is not aware of other concurrent evaluations. Implementations that do not evaluate
+         * concurrently ignore this setting.
+         *
+         * @since 2.6
+         */
+        void setEvalThreads(int const threads);
+
+        /**
+         * The lower/upper bound of the score under the metric, at the confidence level of the sampled evaluation. The
+         * bounds are the score itself if the evaluation is exact.
+         *
+         * @since 2.6
+         */
+        double getEvalLowerBound(EvalMetric::Value const metric) const;
+        double getEvalUpperBound(EvalMetric::Value const metric) const;
+
+        /**
+         * Re-evaluate the rule exactly if the last evaluation was sampled. The exact evaluation is not abandoned by the
+         * cutoff score.
+         *
+         * @since 2.6
+         */
+        void verifyEval();
+
         uint64_t getFingerprintCreationTime() const;
         uint64_t getPruningTime() const;
         uint64_t getEvalTime() const;
@@ -221,20 +349,41 @@ namespace sinc {
         std::vector<Predicate> structure;
         /** The arguments that are assigned to limited variables of certain IDs */
         std::vector<std::vector<ArgLocation>*> limitedVarArgs;
-        /** The fingerprint of the rule */
-        Fingerprint* fingerprint;
+        /** The canonical hash of the rule structure */
+        uint64_t canonicalHash;
+        /** The fingerprint of the rule. This is NULL if the fingerprint has not been built */
+        mutable Fingerprint* fingerprint;
         /** 
          * Whether the pointer of the fingerprint should be released in destructor.
          * 
-         * This is `true` when a newly created fingerprint has failed to be added to the fingerprint cache set.
+         * This is `true` when the fingerprint is built by this rule but not taken over by the fingerprint cache.
          */
-        bool releaseFingerprint;
+        mutable bool releaseFingerprint;
         /** The rule length */
         int length;
         Eval eval;
+        /** The metric of `evalCutoff` */
+        EvalMetric::Value cutoffMetric = EvalMetric::Value::CompressionRatio;
+        /** The score that the evaluation should beat. The evaluation is exact if this is -inf */
+        double evalCutoff = -std::numeric_limits<double>::infinity();
+        /** Whether the last evaluation is abandoned and only gives an optimistic score */
+        bool evalAbandoned = false;
+        /** The ratio of the head records sampled in the evaluation. The evaluation is exact if this is 1 (@since 2.6) */
+        double evalSampleRatio = 1.0;
+        /** The z-score of the confidence level of the sampled evaluation (@since 2.6) */
+        double evalSampleZ = 0;
+        /** Whether the last evaluation is estimated on a sample of the head records (@since 2.6) */
+        bool evalSampled = false;
+        /** The number of threads that the evaluation may use (@since 2.6) */
+        int evalThreads = 1;
+        /** The evaluations at the lower/upper bounds of the estimated positive entailments (@since 2.6) */
+        Eval evalLowerBound{0, 0, 0};
+        Eval evalUpperBound{0, 0, 0};
+        /** The evaluation before the last update, which provides the previous scores to the re-evaluation (@since 2.6) */
+        Eval baseEval{0, 0, 0};
 
         /* Performance monitoring members (measured in nanoseconds) */
-        uint64_t fingerprintCreationTime = 0;
+        mutable uint64_t fingerprintCreationTime = 0;
         uint64_t pruningTime = 0;
         uint64_t evalTime = 0;
 
@@ -248,8 +397,7 @@ namespace sinc {
         bool isInvalid();
 
         /**
-         * Check if the rule structure has already been verified and added to the cache. If not, add the rule fingerprint to
-         * the cache.
+         * Check if the rule structure has already been verified and added to the cache. If not, add the rule to the cache.
          */
         bool cacheHit();
 
@@ -258,24 +406,6 @@ namespace sinc {
          */
         bool tabuHit();
 
-        /**
-         * Enumerate the subcategories of the rule of a certain size.
-         * 
-         * NOTE: The returned pointer and pointers in the set SHOULD all be maintained by USER.
-         *
-         * @param subsetSize The size of the subcategories
-         * @return A set of subcategories
-         */
-        std::unordered_set<MultiSet<int>*>* categorySubsets(int const subsetSize) const;
-
-        /**
-         * Handler for enumerating the subcategories.
-         */
-        void templateSubsetsHandler(
-            std::unordered_set<MultiSet<int>*>* const subsets, int* const templateArr, int const arrLength, int const depth,
-            int const startIdx
-        ) const;
-
         /**
          * Check if the coverage of the rule is below the threshold. If so, add the fingerprint to the tabu set.
          */
@@ -444,6 +574,7 @@ namespace sinc {
         std::unordered_set<Record>* returningCounterexamples = nullptr;
 
         BareRule(int const headPredSymbol, int arity, fingerprintCacheType& fingerprintCacheType, tabuMapType& category2TabuSetMap);
+        BareRule(std::vector<Predicate> const& structure, Eval const& eval, fingerprintCacheType& fingerprintCache, tabuMapType& category2TabuSetMap);
         BareRule(const BareRule& another);
         ~BareRule();
         BareRule* clone() const override;
@@ -5,6 +5,8 @@
 #include <chrono>
 #include <stdarg.h>
 #include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
 
 /**
  * MultiSet
@@ -197,6 +199,9 @@ template class std::equal_to<MultiSet<sinc::MultiSet<sinc::ArgIndicator*>*>*>;
 using sinc::IntWriter;
 IntWriter::IntWriter(const char* filePath) : ofs(std::ofstream(filePath, std::ios::out | std::ios::binary)) {}
 
+IntWriter::IntWriter(const char* filePath, bool const append) :
+    ofs(std::ofstream(filePath, std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc))) {}
+
 void IntWriter::write(const int& i) {
     ofs.put(i);
     ofs.put(i >> 8);
@@ -204,6 +209,11 @@ void IntWriter::write(const int& i) {
     ofs.put(i >> 24);
 }
 
+bool IntWriter::flush() {
+    ofs.flush();
+    return ofs.good();
+}
+
 void IntWriter::close() {
     ofs.close();
 }
@@ -265,6 +275,141 @@ int DisjointSet::totalSets() {
     return cnt;
 }
 
+/**
+ * IntTupleSet
+ */
+using sinc::IntTupleSet;
+
+IntTupleSet::IntTupleSet(int const _width, size_t const expectedSize) : width(_width), numTuples(0) {
+    tupleCapacity = std::max(expectedSize, (size_t)4);
+    tuples = new int[tupleCapacity * width];
+    hashes = new uint64_t[tupleCapacity];
+    size_t num_slots = 8;
+    while (num_slots < tupleCapacity * 2) {
+        num_slots <<= 1;
+    }
+    slots = new uint32_t[num_slots];
+    slotMask = num_slots - 1;
+    std::fill(slots, slots + num_slots, EMPTY_SLOT);
+}
+
+IntTupleSet::~IntTupleSet() {
+    delete[] tuples;
+    delete[] hashes;
+    delete[] slots;
+}
+
+bool IntTupleSet::insert(int const* const tuple) {
+    return insert(tuple, hashTuple(tuple, width));
+}
+
+bool IntTupleSet::insert(int const* const tuple, uint64_t const hash) {
+    size_t slot = findSlot(tuple, hash);
+    if (EMPTY_SLOT != slots[slot]) {
+        return false;
+    }
+    if (numTuples == tupleCapacity) {
+        size_t const new_capacity = tupleCapacity * 2;
+        int* new_tuples = new int[new_capacity * width];
+        std::copy(tuples, tuples + numTuples * width, new_tuples);
+        delete[] tuples;
+        tuples = new_tuples;
+        uint64_t* new_hashes = new uint64_t[new_capacity];
+        std::copy(hashes, hashes + numTuples, new_hashes);
+        delete[] hashes;
+        hashes = new_hashes;
+        tupleCapacity = new_capacity;
+    }
+    std::copy(tuple, tuple + width, tuples + numTuples * width);
+    hashes[numTuples] = hash;
+    slots[slot] = numTuples;
+    numTuples++;
+    if (numTuples * 2 > slotMask + 1) {
+        /* Keep the load factor under 0.5 */
+        growSlots();
+    }
+    return true;
+}
+
+bool IntTupleSet::contains(int const* const tuple) const {
+    return EMPTY_SLOT != slots[findSlot(tuple, hashTuple(tuple, width))];
+}
+
+int const* IntTupleSet::operator[](size_t const idx) const {
+    return tuples + idx * width;
+}
+
+size_t IntTupleSet::size() const {
+    return numTuples;
+}
+
+int IntTupleSet::getWidth() const {
+    return width;
+}
+
+void IntTupleSet::clear() {
+    if (numTuples * 8 < slotMask + 1) {
+        /* Only a few slots are occupied. Locate and reset them by the hash values */
+        for (size_t i = 0; i < numTuples; i++) {
+            size_t slot = hashes[i] & slotMask;
+            while (slots[slot] != i) {
+                slot = (slot + 1) & slotMask;
+            }
+            slots[slot] = EMPTY_SLOT;
+        }
+    } else {
+        std::fill(slots, slots + slotMask + 1, EMPTY_SLOT);
+    }
+    numTuples = 0;
+}
+
+size_t IntTupleSet::memoryCost() const {
+    return sizeof(IntTupleSet) + tupleCapacity * (sizeof(int) * width + sizeof(uint64_t)) + (slotMask + 1) * sizeof(uint32_t);
+}
+
+uint64_t IntTupleSet::hashTuple(int const* const tuple, int const width) {
+    uint64_t h = width;
+    for (int i = 0; i < width; i++) {
+        h = (h ^ (uint32_t)tuple[i]) * 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+size_t IntTupleSet::findSlot(int const* const tuple, uint64_t const hash) const {
+    size_t slot = hash & slotMask;
+    while (EMPTY_SLOT != slots[slot]) {
+        uint32_t const idx = slots[slot];
+        if (hashes[idx] == hash) {
+            int const* const stored = tuples + (size_t)idx * width;
+            bool equal = true;
+            for (int i = 0; i < width && equal; i++) {
+                equal = stored[i] == tuple[i];
+            }
+            if (equal) {
+                return slot;
+            }
+        }
+        slot = (slot + 1) & slotMask;
+    }
+    return slot;
+}
+
+void IntTupleSet::growSlots() {
+    size_t const num_slots = (slotMask + 1) * 2;
+    delete[] slots;
+    slots = new uint32_t[num_slots];
+    slotMask = num_slots - 1;
+    std::fill(slots, slots + num_slots, EMPTY_SLOT);
+    for (size_t i = 0; i < numTuples; i++) {
+        size_t slot = hashes[i] & slotMask;
+        while (EMPTY_SLOT != slots[slot]) {
+            slot = (slot + 1) & slotMask;
+        }
+        slots[slot] = i;
+    }
+}
+
 /**
  * ComparableArray
  */
@@ -426,3 +571,115 @@ long sinc::getMaxRss() {
     getrusage(RUSAGE_SELF, &usage);
     return usage.ru_maxrss;
 }
+
+long sinc::getCurrentRss() {
+    std::ifstream statm("/proc/self/statm");
+    long total_pages, resident_pages;
+    if (statm >> total_pages >> resident_pages) {
+        return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+    return getMaxRss();
+}
+
+/**
+ * MemoryAccountant
+ */
+using sinc::MemoryAccountant;
+
+MemoryAccountant::MemoryAccountant(size_t const _softBudgetKb, size_t const _hardBudgetKb, int const _sampleInterval) :
+    softBudgetKb(std::min(_softBudgetKb, _hardBudgetKb)), hardBudgetKb(_hardBudgetKb), sampleInterval(std::max(1, _sampleInterval)) {}
+
+int MemoryAccountant::addSource(sourceType const& source) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    sources.emplace_back(nextId, source);
+    return nextId++;
+}
+
+void MemoryAccountant::removeSource(int const id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    sources.erase(std::remove_if(sources.begin(), sources.end(), [id](std::pair<int, sourceType> const& p) {
+        return p.first == id;
+    }), sources.end());
+}
+
+int MemoryAccountant::addReliever(relieverType const& reliever) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    relievers.emplace_back(nextId, reliever);
+    return nextId++;
+}
+
+void MemoryAccountant::removeReliever(int const id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    relievers.erase(std::remove_if(relievers.begin(), relievers.end(), [id](std::pair<int, relieverType> const& p) {
+        return p.first == id;
+    }), relievers.end());
+}
+
+void MemoryAccountant::calibrate() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    size_t const rss = getCurrentRss();
+    size_t const tracked = trackedKb();
+    baselineKb = (rss > tracked) ? rss - tracked : 0;
+}
+
+MemoryAccountant::Level MemoryAccountant::check() {
+    if (0 == (++checks % sampleInterval)) {
+        return sample();
+    }
+    return (Level) level.load();
+}
+
+MemoryAccountant::Level MemoryAccountant::sample() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    usageKb = baselineKb + trackedKb();
+    peakUsageKb = std::max(peakUsageKb, usageKb);
+    if (usageKb > softBudgetKb) {
+        softExceeded++;
+        for (std::pair<int, relieverType> const& p: relievers) {
+            relievedKb += p.second() / 1024;
+            usageKb = baselineKb + trackedKb();
+            if (usageKb <= softBudgetKb) {
+                break;
+            }
+        }
+    }
+    Level const new_level = (usageKb > hardBudgetKb) ? Hard : ((usageKb > softBudgetKb) ? Soft : Normal);
+    level = new_level;
+    return new_level;
+}
+
+size_t MemoryAccountant::getSoftBudgetKb() const {
+    return softBudgetKb;
+}
+
+size_t MemoryAccountant::getHardBudgetKb() const {
+    return hardBudgetKb;
+}
+
+size_t MemoryAccountant::getUsageKb() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return usageKb;
+}
+
+size_t MemoryAccountant::getPeakUsageKb() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return peakUsageKb;
+}
+
+int MemoryAccountant::getSoftExceeded() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return softExceeded;
+}
+
+size_t MemoryAccountant::getRelievedKb() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return relievedKb;
+}
+
+size_t MemoryAccountant::trackedKb() const {
+    size_t total = 0;
+    for (std::pair<int, sourceType> const& p: sources) {
+        total += p.second();
+    }
+    return total / 1024;
+}
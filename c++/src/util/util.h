@@ -5,6 +5,9 @@
 #include <fstream>
 #include <array>
 #include <cstdint>
+#include <functional>
+#include <mutex>
+#include <atomic>
 
 namespace sinc {
     /**
@@ -132,11 +135,26 @@ namespace sinc {
          */
         IntWriter(const char* filePath);
 
+        /**
+         * Construct a writer that appends to the end of the target file if `append` is true
+         *
+         * @since 2.6
+         */
+        IntWriter(const char* filePath, bool const append);
+
         /**
          * Write an integer to the file
          */
         void write(const int& i);
 
+        /**
+         * Flush the written integers to the file
+         *
+         * @return Whether all integers have been written successfully
+         * @since 2.6
+         */
+        bool flush();
+
         void close();
 
     private:
@@ -201,6 +219,96 @@ namespace sinc {
         int* const sets;
         int length;
     };
+
+    /**
+     * An open-addressing hash set of fixed-width integer tuples. All tuples are copied into one contiguous block, and the
+     * slots in the table only store the indices of the tuples in the block (linear probing). Therefore, no memory is
+     * allocated for each single tuple, and the probing sequence stays in a few cache lines.
+     *
+     * NOTE: Tuples can only be added. The inserted tuples are kept in the order of insertion and can be accessed by indices.
+     *
+     * @since 2.6
+     */
+    class IntTupleSet {
+    public:
+        /**
+         * Create an empty set.
+         *
+         * @param width The number of integers in each tuple
+         * @param expectedSize The expected number of tuples in the set. The table is pre-allocated accordingly.
+         */
+        IntTupleSet(int const width, size_t const expectedSize = 16);
+
+        IntTupleSet(IntTupleSet const& another) = delete;
+
+        ~IntTupleSet();
+
+        /**
+         * Copy a tuple into the set.
+         *
+         * @return Whether the tuple is newly added
+         */
+        bool insert(int const* const tuple);
+
+        /**
+         * Copy a tuple into the set with its hash value pre-computed by `hashTuple()`.
+         *
+         * @return Whether the tuple is newly added
+         */
+        bool insert(int const* const tuple, uint64_t const hash);
+
+        bool contains(int const* const tuple) const;
+
+        /**
+         * Return the `idx`-th inserted tuple. The pointer is invalidated when new tuples are inserted.
+         */
+        int const* operator[](size_t const idx) const;
+
+        size_t size() const;
+
+        int getWidth() const;
+
+        /**
+         * Remove all tuples. The allocated space is kept for reuse.
+         */
+        void clear();
+
+        /**
+         * The memory cost of the set, in bytes.
+         */
+        size_t memoryCost() const;
+
+        /**
+         * Hash a tuple of `width` integers. The hash values of equal tuples are identical in different sets.
+         */
+        static uint64_t hashTuple(int const* const tuple, int const width);
+
+    protected:
+        /** The value of an empty slot */
+        static constexpr uint32_t EMPTY_SLOT = 0xffffffff;
+
+        int const width;
+        /** The block of all tuples. Each tuple takes `width` consecutive integers */
+        int* tuples;
+        /** The hash values of the tuples, in the order of the block */
+        uint64_t* hashes;
+        size_t numTuples;
+        /** The max number of tuples that `tuples` and `hashes` can hold */
+        size_t tupleCapacity;
+        /** The indices of the tuples. The length is a power of 2 */
+        uint32_t* slots;
+        size_t slotMask;
+
+        /**
+         * Find the slot of the tuple. If the tuple is not in the set, the returned slot is empty.
+         */
+        size_t findSlot(int const* const tuple, uint64_t const hash) const;
+
+        /**
+         * Double the slots and re-arrange the indices by the recorded hash values.
+         */
+        void growSlots();
+    };
 }
 
 namespace sinc {
@@ -360,4 +468,118 @@ namespace sinc {
     size_t sizeOfUnorderedSet(size_t bucketCount, float maxLoadFactor, size_t sizeOfValueType, size_t sizeOfObject);
 
     long getMaxRss();
+
+    /**
+     * Get the current resident set size (KB) of the process. Unlike `getMaxRss()`, this value decreases when memory is
+     * returned to the OS. If the value is not available, the peak RSS is returned.
+     *
+     * @since 2.6
+     */
+    long getCurrentRss();
+
+    /**
+     * The memory accountant keeps track of the memory used by the registered components (e.g., the CB pool, the caches and
+     * the fingerprint/tabu maps) with their memory cost estimations, and checks the usage against a soft and a hard budget.
+     * The usage is the sum of the registered sources plus a baseline, which is the RSS of the untracked parts measured by
+     * `calibrate()`.
+     *
+     * When the soft budget is exceeded, the registered relievers are invoked in order to release memory (back-pressure),
+     * until the usage is below the soft budget again. The user should then reduce memory demand, e.g., by extending fewer
+     * beams. Mining should stop only if the hard budget is exceeded.
+     *
+     * The sources are evaluated at most once in every `sampleInterval` checks, so the check can be done for every
+     * candidate rule.
+     *
+     * NOTE: All methods are thread-safe.
+     *
+     * @since 2.6
+     */
+    class MemoryAccountant {
+    public:
+        enum Level {
+            /** The usage is within the soft budget */
+            Normal,
+            /** The usage exceeds the soft budget but is within the hard one */
+            Soft,
+            /** The usage exceeds the hard budget */
+            Hard
+        };
+
+        /** A source returns the memory cost (in bytes) of a component */
+        typedef std::function<size_t()> sourceType;
+        /** A reliever tries to release memory and returns the amount of released memory (in bytes) */
+        typedef std::function<size_t()> relieverType;
+
+        static constexpr double DEFAULT_SOFT_RATIO = 0.9;
+        static const int DEFAULT_SAMPLE_INTERVAL = 64;
+
+        /**
+         * @param softBudgetKb The soft budget (KB)
+         * @param hardBudgetKb The hard budget (KB)
+         */
+        MemoryAccountant(size_t const softBudgetKb, size_t const hardBudgetKb, int const sampleInterval = DEFAULT_SAMPLE_INTERVAL);
+
+        /**
+         * Register a memory source.
+         *
+         * @return The ID of the source, which is used to remove it
+         */
+        int addSource(sourceType const& source);
+        void removeSource(int const id);
+
+        /**
+         * Register a reliever. Relievers are invoked in the order they are added.
+         *
+         * @return The ID of the reliever, which is used to remove it
+         */
+        int addReliever(relieverType const& reliever);
+        void removeReliever(int const id);
+
+        /**
+         * Set the baseline as the current RSS minus the memory cost of the sources.
+         */
+        void calibrate();
+
+        /**
+         * Check the memory usage against the budgets. The sources are evaluated only on every `sampleInterval` calls, and the
+         * level of the last sample is returned otherwise.
+         */
+        Level check();
+
+        /**
+         * Evaluate the sources and check the usage. Relievers are invoked if the soft budget is exceeded.
+         */
+        Level sample();
+
+        size_t getSoftBudgetKb() const;
+        size_t getHardBudgetKb() const;
+        /** The usage (KB) of the last sample */
+        size_t getUsageKb() const;
+        /** The max usage (KB) of all samples */
+        size_t getPeakUsageKb() const;
+        /** The number of samples that exceeded the soft budget */
+        int getSoftExceeded() const;
+        /** The total amount of memory (KB) released by the relievers */
+        size_t getRelievedKb() const;
+
+    protected:
+        size_t const softBudgetKb;
+        size_t const hardBudgetKb;
+        int const sampleInterval;
+        std::vector<std::pair<int, sourceType>> sources;
+        std::vector<std::pair<int, relieverType>> relievers;
+        int nextId = 0;
+        size_t baselineKb = 0;
+        size_t usageKb = 0;
+        size_t peakUsageKb = 0;
+        int softExceeded = 0;
+        size_t relievedKb = 0;
+        std::atomic<int> checks{0};
+        std::atomic<int> level{Normal};
+        /** This lock guards the sources, the relievers and the statistics */
+        mutable std::recursive_mutex mutex;
+
+        /** Sum up the sources (KB). The lock SHOULD be held */
+        size_t trackedKb() const;
+    };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "../../src/base/sinc.h"
 #include <filesystem>
+#include <cmath>
 #include "../kb/testKbUtils.h"
 
 #define MEM_DIR "/dev/shm"
@@ -26,10 +27,7 @@ public:
     }
 
     ~RelationMiner4Test() {
-        for (const Fingerprint* const& fp: cache) {
-            delete fp;
-        }
-        for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+        for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
             delete kv.first;
             delete kv.second;
         }
@@ -41,10 +39,7 @@ public:
 
 protected:
     Rule* getStartRule() override {
-        for (const Fingerprint* const& fp: cache) {
-            delete fp;
-        }
-        for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+        for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
             delete kv.first;
             delete kv.second;
         }
@@ -53,7 +48,7 @@ protected:
         return new BareRule(targetRelation, kb.getRelation(targetRelation)->getTotalCols(), cache, tabuMap);
     }
 
-    int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates) override {
+    int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates) override {
         return RelationMiner::checkThenAddRule(updateStatus, updatedRule, *badRule, candidates);
     }
 
@@ -178,31 +173,20 @@ TEST_F(TestRelationMiner, TestFindSpecialization1) {
         *kb, rel_family->id, EvalMetric::Value::CompressionCapacity, beamwidth, 1.0,
         node_map, dependency_graph, hypothesis, counterexamples, std::cout
     );
-    Rule* spec_rules[beamwidth] {};
+    TopKRules spec_rules(beamwidth);
     int actual_spec_cnt = miner.findSpecializations(base_rule, spec_rules);
     std::unordered_set<std::string> actual_specs;
-    for (int i = 0; i < beamwidth; i++) {
-        Rule* rule = spec_rules[i];
-        if (nullptr == rule) {
-            break;
-        }
+    for (Rule* const& rule: spec_rules.ranked()) {
         actual_specs.insert(rule->toDumpString(rel_names));
     }
     EXPECT_EQ(expected_specs.size(), actual_spec_cnt);
     EXPECT_EQ(expected_specs, actual_specs);
 
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
-    for (int i = 0; i < beamwidth; i++) {
-        Rule* rule = spec_rules[i];
-        if (nullptr == rule) {
-            break;
-        }
+    for (Rule* const& rule: spec_rules.ranked()) {
         delete rule;
     }
 }
@@ -275,33 +259,88 @@ TEST_F(TestRelationMiner, TestFindSpecialization2) {
         *kb, rel_family->id, EvalMetric::Value::CompressionCapacity, beamwidth, 1.0,
         node_map, dependency_graph, hypothesis, counterexamples, std::cout
     );
-    Rule* spec_rules[beamwidth]{};
+    TopKRules spec_rules(beamwidth);
     int actual_spec_cnt = miner.findSpecializations(base_rule, spec_rules);
     std::unordered_set<std::string> actual_specs;
-    for (int i = 0; i < beamwidth; i++) {
-        Rule* rule = spec_rules[i];
-        if (nullptr == rule) {
-            break;
-        }
+    for (Rule* const& rule: spec_rules.ranked()) {
         actual_specs.insert(rule->toDumpString(rel_names));
     }
     EXPECT_EQ(expected_specs.size(), actual_spec_cnt);
     EXPECT_EQ(expected_specs, actual_specs);
 
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
+        delete kv.first;
+        delete kv.second;
+    }
+    for (Rule* const& rule: spec_rules.ranked()) {
+        delete rule;
+    }
+}
+
+TEST_F(TestRelationMiner, TestFindSpecializationWithColumnOverlaps) {
+    /* The same KB as the fixture, with the column overlap index */
+    int*** const rels = new int**[4] {
+        new int*[2] {new int[3] {1, 2, 3}, new int[3] {1, 2, 4}},
+        new int*[2] {new int[2] {2, 3}, new int[2] {4, 6}},
+        new int*[2] {new int[2] {1, 3}, new int[2] {2, 4}},
+        new int*[1] {new int[1] {2}}
+    };
+    SimpleKb* const indexed_kb = new SimpleKb(kbName, rels, relNames, arities, totalRows, 4);
+    indexed_kb->updatePromisingConstants();
+    indexed_kb->updateColumnOverlaps();
+
+    Rule::fingerprintCacheType cache;
+    Rule::tabuMapType tabuMap;
+    BareRule base_rule(indexed_kb->getRelation("family")->id, 3, cache, tabuMap);
+    const char* rel_names[4] {relNames[0].c_str(), relNames[1].c_str(), relNames[2].c_str(), relNames[3].c_str()};
+
+    /* Columns of "family" share no constant with each other */
+    std::unordered_set<std::string> expected_specs({
+        "family(X0,?,?):-mother(X0,?)",
+        "family(?,X0,?):-mother(X0,?)",
+        "family(?,?,X0):-mother(?,X0)",
+        "family(?,X0,?):-father(X0,?)",
+        "family(?,?,X0):-father(X0,?)",
+        "family(?,?,X0):-father(?,X0)",
+        "family(?,X0,?):-isMale(X0)",
+        "family(1,?,?):-",
+        "family(?,2,?):-"
+    });
+
+    RelationMiner::nodeMapType node_map;
+    RelationMiner::depGraphType dependency_graph;
+    std::vector<Rule*> hypothesis;
+    std::unordered_set<Record> counterexamples;
+    int beamwidth = expected_specs.size() * 2;
+    RelationMiner4Test miner(
+        *indexed_kb, base_rule.getPredicate(HEAD_PRED_IDX).getPredSymbol(), EvalMetric::Value::CompressionCapacity, beamwidth,
+        1.0, node_map, dependency_graph, hypothesis, counterexamples, std::cout
+    );
+    TopKRules spec_rules(beamwidth);
+    int actual_spec_cnt = miner.findSpecializations(base_rule, spec_rules);
+    std::unordered_set<std::string> actual_specs;
+    for (Rule* const& rule: spec_rules.ranked()) {
+        actual_specs.insert(rule->toDumpString(rel_names));
     }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    EXPECT_EQ(expected_specs.size(), actual_spec_cnt);
+    EXPECT_EQ(expected_specs, actual_specs);
+    EXPECT_EQ(17, miner.infeasibleJoins);
+
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
-    for (int i = 0; i < beamwidth; i++) {
-        Rule* rule = spec_rules[i];
-        if (nullptr == rule) {
-            break;
-        }
+    for (Rule* const& rule: spec_rules.ranked()) {
         delete rule;
     }
+    delete indexed_kb;
+    for (int rel_idx = 0; rel_idx < 4; rel_idx++) {
+        for (int row_idx = 0; row_idx < totalRows[rel_idx]; row_idx++) {
+            delete[] rels[rel_idx][row_idx];
+        }
+        delete[] rels[rel_idx];
+    }
+    delete[] rels;
 }
 
 TEST_F(TestRelationMiner, TestFindGeneralization) {
@@ -341,35 +380,140 @@ TEST_F(TestRelationMiner, TestFindGeneralization) {
         *kb, rel_family->id, EvalMetric::Value::CompressionCapacity, beamwidth, 1.0,
         node_map, dependency_graph, hypothesis, counterexamples, std::cout
     );
-    Rule* spec_rules[beamwidth]{};
+    TopKRules spec_rules(beamwidth);
     int actual_spec_cnt = miner.findGeneralizations(base_rule, spec_rules);
     std::unordered_set<std::string> actual_specs;
-    for (int i = 0; i < beamwidth; i++) {
-        Rule* rule = spec_rules[i];
-        if (nullptr == rule) {
-            break;
-        }
+    for (Rule* const& rule: spec_rules.ranked()) {
         actual_specs.insert(rule->toDumpString(rel_names));
     }
     EXPECT_EQ(expected_specs.size(), actual_spec_cnt);
     EXPECT_EQ(expected_specs, actual_specs);
 
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
-    for (int i = 0; i < beamwidth; i++) {
-        Rule* rule = spec_rules[i];
-        if (nullptr == rule) {
-            break;
-        }
+    for (Rule* const& rule: spec_rules.ranked()) {
         delete rule;
     }
 }
 
+TEST_F(TestRelationMiner, TestDeadline) {
+    SimpleRelation* rel_family = kb->getRelation("family");
+    RelationMiner::nodeMapType node_map;
+    RelationMiner::depGraphType dep_graph;
+    std::vector<Rule*> hypothesis;
+    std::unordered_set<Record> counterexamples;
+    std::ostringstream os;
+    RelationMiner4Test miner(
+        *kb, rel_family->id, EvalMetric::Value::CompressionCapacity, 5, 1.0, node_map, dep_graph, hypothesis, counterexamples, os
+    );
+    EXPECT_FALSE(miner.deadlineReached());
+    miner.setDeadline(currentTimeInNano() + 3600000000000UL);
+    EXPECT_FALSE(miner.deadlineReached());
+
+    /* No rule is searched after the deadline */
+    miner.setDeadline(1);
+    EXPECT_TRUE(miner.deadlineReached());
+    miner.run();
+    EXPECT_TRUE(hypothesis.empty());
+    EXPECT_TRUE(miner.timedOut);
+    EXPECT_NE(std::string::npos, os.str().find("Time budget exhausted"));
+}
+
+TEST(TestTopKRules, TestAddAndRank) {
+    Rule::fingerprintCacheType cache;
+    Rule::tabuMapType tabuMap;
+    Rule* rules[6];
+    for (int i = 0; i < 6; i++) {
+        rules[i] = new BareRule(i, 2, cache, tabuMap);
+    }
+
+    TopKRules top_k(3);
+    EXPECT_TRUE(top_k.empty());
+    EXPECT_EQ(nullptr, top_k.best());
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), top_k.threshold());
+    EXPECT_EQ(nullptr, top_k.add(rules[0], 2.0));
+    EXPECT_EQ(nullptr, top_k.add(rules[1], 5.0));
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), top_k.threshold());
+    EXPECT_EQ(nullptr, top_k.add(rules[2], 3.0));
+    EXPECT_TRUE(top_k.full());
+    EXPECT_DOUBLE_EQ(2.0, top_k.threshold());
+    EXPECT_EQ(rules[1], top_k.best());
+    EXPECT_DOUBLE_EQ(5.0, top_k.bestScore());
+
+    /* A rule is admitted only if it is better than the lowest one. Ties are broken by the order of addition */
+    EXPECT_EQ(rules[3], top_k.add(rules[3], 2.0));
+    EXPECT_EQ(rules[0], top_k.add(rules[3], 3.0));
+    EXPECT_DOUBLE_EQ(3.0, top_k.threshold());
+    EXPECT_EQ(rules[3], top_k.add(rules[4], 6.0));
+    EXPECT_EQ(rules[4], top_k.best());
+    EXPECT_EQ(rules[2], top_k.add(rules[5], 5.0));
+    std::vector<Rule*> expected_ranks{rules[4], rules[1], rules[5]};
+    EXPECT_EQ(expected_ranks, top_k.ranked());
+    EXPECT_DOUBLE_EQ(5.0, top_k.threshold());
+
+    top_k.clear();
+    EXPECT_TRUE(top_k.empty());
+    EXPECT_EQ(nullptr, top_k.best());
+    EXPECT_EQ(nullptr, top_k.add(rules[0], 1.0));
+    EXPECT_EQ(rules[0], top_k.best());
+
+    /* Change the capacity */
+    top_k.reset(1);
+    EXPECT_TRUE(top_k.empty());
+    EXPECT_EQ(1, top_k.capacity());
+    EXPECT_EQ(nullptr, top_k.add(rules[1], 1.0));
+    EXPECT_EQ(rules[2], top_k.add(rules[2], 1.0));
+    EXPECT_DOUBLE_EQ(1.0, top_k.threshold());
+    top_k.reset(5);
+    EXPECT_EQ(5, top_k.capacity());
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(nullptr, top_k.add(rules[i], i));
+    }
+    EXPECT_TRUE(top_k.full());
+    EXPECT_EQ(rules[4], top_k.best());
+
+    for (int i = 0; i < 6; i++) {
+        delete rules[i];
+    }
+}
+
+TEST(TestAdaptiveBeamwidth, TestAdjust) {
+    std::string reason;
+    AdaptiveBeamwidth fixed(5);
+    EXPECT_FALSE(fixed.adaptive());
+    EXPECT_FALSE(fixed.adjust(AdaptiveBeamwidth::Pressure{0, 0, 0}, reason));
+    EXPECT_EQ(5, fixed.width());
+
+    /* Widen by one on cheap iterations, and halve when any limit is exceeded */
+    AdaptiveBeamwidth controller(3, 2, 5, 100, 0, 1000);
+    EXPECT_TRUE(controller.adaptive());
+    EXPECT_EQ(3, controller.width());
+    EXPECT_TRUE(controller.adjust(AdaptiveBeamwidth::Pressure{50, 100000, 500}, reason));
+    EXPECT_EQ(4, controller.width());
+    EXPECT_TRUE(controller.adjust(AdaptiveBeamwidth::Pressure{0, 0, 0}, reason));
+    EXPECT_EQ(5, controller.width());
+    EXPECT_FALSE(controller.adjust(AdaptiveBeamwidth::Pressure{0, 0, 0}, reason));
+
+    /* Unchanged if a pressure is between half of the limit and the limit */
+    controller.adjust(AdaptiveBeamwidth::Pressure{101, 0, 0}, reason);
+    EXPECT_EQ(2, controller.width());
+    EXPECT_FALSE(controller.adjust(AdaptiveBeamwidth::Pressure{70, 0, 0}, reason));
+    EXPECT_EQ(2, controller.width());
+    EXPECT_TRUE(controller.adjust(AdaptiveBeamwidth::Pressure{0, 0, 0}, reason));
+    EXPECT_TRUE(controller.adjust(AdaptiveBeamwidth::Pressure{0, 0, 0}, reason));
+    EXPECT_TRUE(controller.adjust(AdaptiveBeamwidth::Pressure{0, 0, 0}, reason));
+    EXPECT_EQ(5, controller.width());
+
+    EXPECT_TRUE(controller.adjust(AdaptiveBeamwidth::Pressure{101, 0, 2000}, reason));
+    EXPECT_EQ(2, controller.width());
+    EXPECT_NE(std::string::npos, reason.find("cache"));
+    EXPECT_NE(std::string::npos, reason.find("time"));
+    EXPECT_FALSE(controller.adjust(AdaptiveBeamwidth::Pressure{200, 0, 0}, reason));
+    EXPECT_EQ(2, controller.width());
+}
+
 using sinc::test::TestKbManager;
 
 class TestSinc : public testing::Test {
@@ -409,6 +553,43 @@ public:
         return *kb;
     }
 
+    BaseMonitor const& getMonitor() const {
+        return monitor;
+    }
+
+    double getMiningCost(int const relationId) const {
+        return estimateMiningCost(relationId);
+    }
+
+    std::vector<int> getSchedule(int const* const targetRelations, int const numTargets) const {
+        return scheduleRelations(targetRelations, numTargets);
+    }
+
+    uint64_t getRelationDeadline(
+        uint64_t const relationTimeLimitMs, uint64_t const deadline, int const remainingTargets, int const workers
+    ) {
+        config->relationTimeLimitMs = relationTimeLimitMs;
+        globalDeadline = deadline;
+        return relationDeadline(remainingTargets, workers);
+    }
+
+    void setCheckpoint(bool const checkpoint, bool const resume) {
+        config->checkpoint = checkpoint;
+        config->resume = resume;
+    }
+
+    fs::path getCheckpointPath() const {
+        return getCheckpointFilePath(config->dumpPath, config->dumpName);
+    }
+
+    size_t totalDependencyEdges() const {
+        size_t edges = 0;
+        for (std::pair<RelationMiner::nodeType* const, std::unordered_set<RelationMiner::nodeType*>*> const& kv: dependencyGraph) {
+            edges += kv.second->size();
+        }
+        return edges;
+    }
+
 protected:
     SincRecovery* createRecovery() override {
         return nullptr;
@@ -549,10 +730,7 @@ protected:
         }
 
         ~RelationMiner4SincTest() {
-            for (const Fingerprint* const& fp: cache) {
-                delete fp;
-            }
-            for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+            for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
                 delete kv.first;
                 delete kv.second;
             }
@@ -616,17 +794,17 @@ protected:
             return nullptr;
         }
 
-        int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, Rule** candidates) override {
+        int checkThenAddRule(UpdateStatus updateStatus, Rule* const updatedRule, Rule& originalRule, TopKRules& candidates) override {
             return 1;
         }
 
         void selectAsBeam(Rule* r) override {}
     };
 
-    RelationMiner* createRelationMiner(int const targetRelationId) override {
+    RelationMiner* createRelationMiner(int const targetRelationId, MinerWorkspace& workspace) override {
         return new RelationMiner4SincTest(
-            *kb, targetRelationId, config->evalMetric, config->beamwidth, config->stopCompressionRatio, predicate2NodeMap, dependencyGraph,
-            compressedKb->getHypothesis(), compressedKb->getCounterexampleSet(targetRelationId), *logger
+            *kb, targetRelationId, config->evalMetric, config->beamwidth, config->stopCompressionRatio, workspace.predicate2NodeMap,
+            workspace.dependencyGraph, workspace.hypothesis, compressedKb->getCounterexampleSet(targetRelationId), *workspace.logger
         );
     }
 };
@@ -708,6 +886,141 @@ TEST_F(TestSinc, TestCompression) {
     delete[] entailed_records[2];
 }
 
+TEST_F(TestSinc, TestRelationSchedule) {
+    Sinc4Test sinc(TestKbManager::MEM_DIR_PATH.c_str(), testKb->getKbName());
+    sinc.run();
+    SimpleKb& kb = sinc.getKb();
+
+    SimpleRelation* rel_family = kb.getRelation("family");
+    double expected_cost = 0;
+    for (int col = 0; col < rel_family->getTotalCols(); col++) {
+        expected_cost += std::log2(2.0 + rel_family->numValuesInColumn(col));
+    }
+    expected_cost *= rel_family->getTotalRows();
+    EXPECT_DOUBLE_EQ(expected_cost, sinc.getMiningCost(rel_family->id));
+
+    int targets[3] {0, 1, 2};
+    std::vector<int> schedule = sinc.getSchedule(targets, 3);
+    ASSERT_EQ(3, schedule.size());
+    std::unordered_set<int> scheduled(schedule.begin(), schedule.end());
+    EXPECT_EQ(3, scheduled.size());
+    for (int i = 1; i < 3; i++) {
+        EXPECT_GE(sinc.getMiningCost(targets[schedule[i-1]]), sinc.getMiningCost(targets[schedule[i]]));
+    }
+
+    /* Every miner is reported in the monitor */
+    std::vector<BaseMonitor::RelationSchedule> const& reported = sinc.getMonitor().relationSchedules;
+    ASSERT_EQ(3, reported.size());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(kb.getRelation(i)->name, reported[i].relation);
+        EXPECT_DOUBLE_EQ(sinc.getMiningCost(i), reported[i].estimatedCost);
+        EXPECT_EQ(i, reported[i].startOrder);
+    }
+}
+
+TEST_F(TestSinc, TestRelationDeadline) {
+    Sinc4Test sinc(TestKbManager::MEM_DIR_PATH.c_str(), testKb->getKbName());
+    sinc.run();
+    uint64_t const second = 1000000000UL;
+    EXPECT_EQ(0, sinc.getRelationDeadline(0, 0, 3, 1));
+
+    /* Per-relation budget only */
+    uint64_t before = currentTimeInNano();
+    uint64_t deadline = sinc.getRelationDeadline(2000, 0, 3, 1);
+    EXPECT_GE(deadline, before + 2 * second);
+    EXPECT_LE(deadline, currentTimeInNano() + 2 * second);
+
+    /* The remaining global budget is shared by the rounds of the remaining relations */
+    before = currentTimeInNano();
+    uint64_t const global_deadline = before + 60 * second;
+    deadline = sinc.getRelationDeadline(0, global_deadline, 3, 1);
+    EXPECT_GE(deadline, before + 19 * second);
+    EXPECT_LE(deadline, currentTimeInNano() + 20 * second);
+    deadline = sinc.getRelationDeadline(0, global_deadline, 3, 2);
+    EXPECT_GE(deadline, before + 29 * second);
+    EXPECT_LE(deadline, currentTimeInNano() + 30 * second);
+    deadline = sinc.getRelationDeadline(0, global_deadline, 1, 4);
+    EXPECT_GE(deadline, before + 59 * second);
+    EXPECT_LE(deadline, global_deadline);
+
+    /* The earlier one of the two budgets */
+    deadline = sinc.getRelationDeadline(2000, global_deadline, 3, 1);
+    EXPECT_LE(deadline, currentTimeInNano() + 2 * second);
+
+    /* Relations started after the global deadline are stopped immediately */
+    before = currentTimeInNano();
+    deadline = sinc.getRelationDeadline(2000, before - second, 3, 1);
+    EXPECT_LE(deadline, currentTimeInNano());
+}
+
+TEST_F(TestSinc, TestCheckpointResume) {
+    Sinc4Test sinc1(TestKbManager::MEM_DIR_PATH.c_str(), testKb->getKbName());
+    sinc1.setCheckpoint(true, false);
+    sinc1.run();
+    fs::path checkpoint_path = sinc1.getCheckpointPath();
+    ASSERT_TRUE(fs::exists(checkpoint_path));
+    size_t const checkpoint_size = fs::file_size(checkpoint_path);
+    std::unordered_set<std::string> expected_rules;
+    for (Rule* const& rule: sinc1.getCompressedKb().getHypothesis()) {
+        expected_rules.insert(rule->toDumpString(sinc1.getKb().getRelationNames()));
+    }
+    ASSERT_EQ(4, expected_rules.size());
+
+    /* Resume a crash during writing the last record: the corrupted record is discarded and the relation is mined again.
+       The resumed compression appends the relation to the journal even if checkpointing is off, so the next resumption
+       restores all relations. The SInC objects are kept until the end, as they remove the dump directory when destroyed */
+    fs::resize_file(checkpoint_path, checkpoint_size - 5);
+    std::vector<Sinc4Test*> resumed_sincs;
+    for (bool const checkpoint: {false, true}) {
+        int const resumed_relations = checkpoint ? 3 : 2;
+        Sinc4Test* sinc2 = new Sinc4Test(TestKbManager::MEM_DIR_PATH.c_str(), testKb->getKbName());
+        resumed_sincs.push_back(sinc2);
+        sinc2->setCheckpoint(checkpoint, true);
+        sinc2->run();
+        SimpleKb& kb = sinc2->getKb();
+        SimpleCompressedKb& ckb = sinc2->getCompressedKb();
+        EXPECT_EQ(resumed_relations, sinc2->getMonitor().resumedRelations);
+        EXPECT_EQ(3 - resumed_relations, sinc2->getMonitor().relationSchedules.size());
+        EXPECT_EQ(checkpoint_size, fs::file_size(checkpoint_path));
+
+        std::unordered_set<std::string> actual_rules;
+        for (Rule* const& rule: ckb.getHypothesis()) {
+            actual_rules.insert(rule->toDumpString(kb.getRelationNames()));
+        }
+        EXPECT_EQ(expected_rules, actual_rules);
+        EXPECT_EQ(10, ckb.totalHypothesisSize());
+        EXPECT_EQ(1, ckb.totalCounterexamples());
+        EXPECT_EQ(7, ckb.totalNecessaryRecords());
+        EXPECT_EQ(2, kb.getRelation("mother")->totalEntailedRecords());
+        EXPECT_EQ(2, kb.getRelation("father")->totalEntailedRecords());
+        EXPECT_EQ(1, kb.getRelation("family")->totalEntailedRecords());
+        EXPECT_EQ(sinc1.totalDependencyEdges(), sinc2->totalDependencyEdges());
+    }
+
+    /* A file that does not match the KB is not overwritten by resuming */
+    fs::resize_file(checkpoint_path, 3 * sizeof(int));
+    Sinc4Test* sinc4 = new Sinc4Test(TestKbManager::MEM_DIR_PATH.c_str(), testKb->getKbName());
+    resumed_sincs.push_back(sinc4);
+    sinc4->setCheckpoint(true, true);
+    sinc4->run();
+    EXPECT_EQ(0, sinc4->getMonitor().resumedRelations);
+    EXPECT_EQ(3, sinc4->getMonitor().relationSchedules.size());
+    EXPECT_EQ(4, sinc4->getCompressedKb().getHypothesis().size());
+    EXPECT_EQ(3 * sizeof(int), fs::file_size(checkpoint_path));
+
+    /* Without resuming, the checkpoint is created anew */
+    Sinc4Test* sinc3 = new Sinc4Test(TestKbManager::MEM_DIR_PATH.c_str(), testKb->getKbName());
+    resumed_sincs.push_back(sinc3);
+    sinc3->setCheckpoint(true, false);
+    sinc3->run();
+    EXPECT_EQ(0, sinc3->getMonitor().resumedRelations);
+    EXPECT_EQ(3, sinc3->getMonitor().relationSchedules.size());
+    EXPECT_EQ(checkpoint_size, fs::file_size(checkpoint_path));
+    for (int i = resumed_sincs.size() - 1; i >= 0; i--) {
+        delete resumed_sincs[i];
+    }
+}
+
 TEST(TestParseTarget, TestGetTargets1) {
     std::stringstream ss("2,4");
     std::string segment;
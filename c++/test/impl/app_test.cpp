@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "../../src/impl/app.h"
 #include <string.h>
+#include <fstream>
 
 using namespace sinc;
 
@@ -51,3 +52,98 @@ TEST(TestMain, TestParseConfig) {
     EXPECT_EQ(2.2, config->observationRatio);
     delete config;
 }
+
+TEST(TestMain, TestParseSweepConfigs) {
+    const char* argv[11] {
+        "progname",
+        "-I",
+        "inputdir,inputname",
+        "-O",
+        "outputdir,outputname",
+        "-b",
+        "5",
+        "-e",
+        "τ",
+        "-f",
+        "0.05"
+    };
+    int argc = 11;
+    SincConfig* base_config = Main::parseConfig(argc, (char**)argv);
+    std::string sweep_file_path = "/dev/shm/TestParseSweepConfigs.txt";
+    std::ofstream sweep_file(sweep_file_path);
+    sweep_file << "-b 3 -e δ\n";
+    sweep_file << "# -b 4\n";
+    sweep_file << "\n";
+    sweep_file << "  -f 0.1 -I x,y -O z,w\n";
+    sweep_file.close();
+
+    std::vector<SincConfig*> configs = Main::parseSweepConfigs(*base_config, sweep_file_path.c_str());
+    ASSERT_EQ(2, configs.size());
+    EXPECT_EQ(3, configs[0]->beamwidth);
+    EXPECT_EQ(EvalMetric::Value::CompressionCapacity, configs[0]->evalMetric);
+    EXPECT_EQ(0.05, configs[0]->minFactCoverage);
+    EXPECT_STREQ("outputdir", configs[0]->dumpPath.c_str());
+    EXPECT_STREQ("outputname_0", configs[0]->dumpName);
+    EXPECT_EQ(5, configs[1]->beamwidth);
+    EXPECT_EQ(EvalMetric::Value::CompressionRatio, configs[1]->evalMetric);
+    EXPECT_EQ(0.1, configs[1]->minFactCoverage);
+    EXPECT_STREQ("inputdir", configs[1]->basePath.c_str());
+    EXPECT_STREQ("inputname", configs[1]->kbName);
+    EXPECT_STREQ("outputdir", configs[1]->dumpPath.c_str());
+    EXPECT_STREQ("outputname_1", configs[1]->dumpName);
+
+    /* Options in the sweep file do not affect the command line ones */
+    SincConfig* config = Main::parseConfig(1, (char**)argv);
+    EXPECT_EQ(5, config->beamwidth);
+    EXPECT_EQ(0.05, config->minFactCoverage);
+    EXPECT_STREQ("outputname", config->dumpName);
+
+    EXPECT_THROW(Main::parseSweepConfigs(*base_config, "/dev/shm/TestParseSweepConfigsNonExist.txt"), SincException);
+    std::filesystem::remove(sweep_file_path);
+    for (SincConfig* const& c: configs) {
+        delete c;
+    }
+    delete config;
+    delete base_config;
+}
+
+TEST(TestMain, TestParseJobConfig) {
+    const char* argv[7] {
+        "progname",
+        "-I",
+        "inputdir,inputname",
+        "-b",
+        "5",
+        "-f",
+        "0.05"
+    };
+    int argc = 7;
+    SincConfig* base_config = Main::parseConfig(argc, (char**)argv);
+    std::string error;
+    SincConfig* config = Main::parseJobConfig("-I jobdir,jobname -O outdir,outname --b=3 -e δ -M 4", error);
+    ASSERT_NE(nullptr, config);
+    EXPECT_STREQ("jobdir", config->basePath.c_str());
+    EXPECT_STREQ("jobname", config->kbName);
+    EXPECT_STREQ("outdir", config->dumpPath.c_str());
+    EXPECT_STREQ("outname", config->dumpName);
+    EXPECT_EQ(3, config->beamwidth);
+    EXPECT_EQ(EvalMetric::Value::CompressionCapacity, config->evalMetric);
+    EXPECT_EQ(0.05, config->minFactCoverage);
+    EXPECT_EQ(4, config->maxMemGByte);
+    delete config;
+
+    /* Invalid jobs are reported instead of terminating the process */
+    EXPECT_EQ(nullptr, Main::parseJobConfig("-b 3 -no_such_option 1", error));
+    EXPECT_NE(std::string::npos, error.find("Unknown option"));
+    EXPECT_EQ(nullptr, Main::parseJobConfig("-b", error));
+    EXPECT_NE(std::string::npos, error.find("Missing value"));
+    EXPECT_EQ(nullptr, Main::parseJobConfig("b 3", error));
+    EXPECT_EQ(nullptr, Main::parseJobConfig("# -b 3", error));
+
+    /* Options of the jobs do not affect the command line ones */
+    config = Main::parseConfig(1, (char**)argv);
+    EXPECT_EQ(5, config->beamwidth);
+    EXPECT_STREQ("inputname", config->kbName);
+    delete config;
+    delete base_config;
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "../../src/impl/sincBatch.h"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MEM_DIR "/dev/shm"
+
+using namespace sinc;
+
+class TestSincBatch : public testing::Test {
+protected:
+    static constexpr const char* KB_NAME = "TestSincBatchKb";
+
+    /**
+     * Dump the KB of `TestSincWithCache.TestCompression1` to `MEM_DIR`.
+     */
+    static void SetUpTestSuite() {
+        int* relation_p[55]{};
+        int* relation_q[50]{};
+        for (int i = 0; i < 50; i++) {
+            relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+            relation_q[i] = new int[2] {i * 2 + 2, i * 2 + 1};
+        }
+        for (int i = 50; i < 55; i++) {
+            relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+        }
+        int** relations[2] {relation_p, relation_q};
+        std::string rel_names[2] {"p", "q"};
+        int arities[2] {2, 2};
+        int total_rows[2] {55, 50};
+        SimpleKb kb(KB_NAME, relations, rel_names, arities, total_rows, 2);
+        std::string mapped_names[111];
+        for (int i = 0; i < 111; i++) {
+            mapped_names[i] = "e" + std::to_string(i);
+        }
+        kb.dump(MEM_DIR, mapped_names);
+        for (int i = 0; i < 55; i++) {
+            delete[] relation_p[i];
+        }
+        for (int i = 0; i < 50; i++) {
+            delete[] relation_q[i];
+        }
+    }
+
+    static void TearDownTestSuite() {
+        fs::remove_all(fs::path(MEM_DIR) / KB_NAME);
+    }
+
+    /**
+     * Parse jobs in the form of "<KB name> <dump name> <beamwidth> <memory budget (GB)>".
+     */
+    static SincConfig* parseJob(std::string const& jobLine, std::string& error) {
+        std::istringstream iss(jobLine);
+        std::string kb_name;
+        std::string dump_name;
+        int beamwidth;
+        int mem_budget;
+        if (!(iss >> kb_name >> dump_name >> beamwidth >> mem_budget)) {
+            error = "Malformed job";
+            return nullptr;
+        }
+        SincConfig* config = new SincConfig(
+            MEM_DIR, kb_name.c_str(), MEM_DIR, dump_name.c_str(), 1, false, 0, "", mem_budget, beamwidth,
+            EvalMetric::Value::CompressionCapacity, 0.05, 0.25, 1.0, 0, "", "", 0, true
+        );
+        config->checkpoint = false;
+        return config;
+    }
+};
+
+TEST_F(TestSincBatch, TestRunManifest) {
+    fs::path manifest_path = fs::path(MEM_DIR) / "TestSincBatchManifest.txt";
+    std::ofstream manifest(manifest_path);
+    manifest << "# KB dump beamwidth memory\n";
+    manifest << std::string(KB_NAME) << " TestSincBatchComp0 5 1\n";
+    manifest << "\n";
+    manifest << "malformed job\n";
+    manifest << "  " << std::string(KB_NAME) << " TestSincBatchComp1 2 1\n";
+    manifest << "TestSincBatchNoSuchKb TestSincBatchComp2 5 1\n";
+    manifest.close();
+
+    /* The jobs run one by one as each takes the whole memory budget */
+    std::ostringstream summary;
+    SincBatch batch(2, 1, parseJob, summary);
+    std::vector<BatchJobResult> results = batch.runManifest(manifest_path);
+    ASSERT_EQ(3, results.size());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(i, results[i].jobId);
+    }
+    for (int i = 0; i < 2; i++) {
+        EXPECT_TRUE(results[i].succeeded);
+        EXPECT_LT(0, results[i].hypothesisSize);
+        EXPECT_EQ(5, results[i].counterexamples);
+        fs::path dump_path = fs::path(MEM_DIR) / ("TestSincBatchComp" + std::to_string(i));
+        EXPECT_TRUE(fs::exists(dump_path / LOG_FILE_NAME));
+        EXPECT_TRUE(fs::exists(SimpleKb::getRelInfoFilePath(dump_path.filename().c_str(), MEM_DIR)));
+        fs::remove_all(dump_path);
+    }
+    EXPECT_FALSE(results[2].succeeded);
+    fs::remove_all(fs::path(MEM_DIR) / "TestSincBatchComp2");
+
+    /* A header and a line per job */
+    std::istringstream summary_lines(summary.str());
+    std::string line;
+    int lines = 0;
+    while (std::getline(summary_lines, line)) {
+        lines++;
+    }
+    EXPECT_EQ(4, lines);
+    EXPECT_THROW(batch.runManifest(fs::path(MEM_DIR) / "TestSincBatchNoSuchManifest.txt"), SincException);
+    fs::remove(manifest_path);
+}
+
+TEST_F(TestSincBatch, TestServe) {
+    fs::path socket_path = fs::path(MEM_DIR) / "TestSincBatch.sock";
+    fs::remove(socket_path);
+    pid_t const client_pid = fork();
+    ASSERT_LE(0, client_pid);
+    if (0 == client_pid) {
+        /* The client sends a valid job, an invalid one and then stops the server */
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        int retries = 0;
+        while (0 != connect(fd, (sockaddr*) &addr, sizeof(addr)) && 100 > retries) {
+            usleep(50000);
+            retries++;
+        }
+        std::string requests = std::string(KB_NAME) + " TestSincBatchServed 5 1\nmalformed\nstop\n";
+        write(fd, requests.c_str(), requests.length());
+        std::string replies;
+        char buf[256];
+        ssize_t n;
+        while (0 < (n = read(fd, buf, sizeof(buf)))) {
+            replies.append(buf, n);
+        }
+        close(fd);
+        _exit((0 == replies.compare("queued 0\nerror Malformed job\nstopping\n")) ? 0 : 1);
+    }
+
+    std::ostringstream summary;
+    SincBatch batch(1, 0, parseJob, summary);
+    std::vector<BatchJobResult> results = batch.serve(socket_path);
+    int status;
+    ASSERT_EQ(client_pid, waitpid(client_pid, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+    ASSERT_EQ(1, results.size());
+    EXPECT_TRUE(results[0].succeeded);
+    EXPECT_EQ(5, results[0].counterexamples);
+    EXPECT_FALSE(fs::exists(socket_path));
+    fs::remove_all(fs::path(MEM_DIR) / "TestSincBatchServed");
+}
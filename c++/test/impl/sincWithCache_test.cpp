@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "../../src/impl/sincWithCache.h"
 #include <filesystem>
+#include <set>
+#include <thread>
 
 #define MEM_DIR "/dev/shm"
 
@@ -56,6 +58,285 @@ TEST(TestCompliedBlock, TestMatchSlicesTwoCB) {
     CompliedBlock::clearPool();
 }
 
+TEST(TestCompliedBlock, TestReleaseRetainedCbs) {
+    CompliedBlock::clearPool();
+    EXPECT_EQ(CompliedBlock::trackedMemoryCost(), 0);
+
+    int** rows = new int*[4] {
+        new int[2]{2, 1},
+        new int[2]{1, 1},
+        new int[2]{2, 3},
+        new int[2]{1, 3},
+    };
+    SimpleRelation relation_a("a", 0, rows, 2, 4);
+    SimpleRelation relation_b("b", 1, rows, 2, 4);
+    CbHolder finished_miner;
+    CbHolder running_miner;
+    CompliedBlock* cb_a = CompliedBlock::create(&relation_a, false, &finished_miner);
+    ASSERT_NE(CompliedBlock::getSlice(*cb_a, 1, 3, &finished_miner), nullptr);
+    CompliedBlock* cb_b = CompliedBlock::create(&relation_b, false, &running_miner);
+    CompliedBlock* slice_b = CompliedBlock::getSlice(*cb_b, 1, 3, &running_miner);
+    ASSERT_NE(slice_b, nullptr);
+    CompliedBlock::setRetentionBudget(1024 * 1024);
+    CompliedBlock::release(finished_miner);
+    EXPECT_EQ(CompliedBlock::totalRetainedCbs(), 2);
+    size_t const tracked_cost = CompliedBlock::trackedMemoryCost();
+    size_t const retained_cost = CompliedBlock::retainedMemoryCost();
+    EXPECT_GT(retained_cost, 0);
+
+    /* Only the retained CBs are released, and the pool no longer tracks the released memory */
+    EXPECT_EQ(CompliedBlock::releaseRetainedCbs(), retained_cost);
+    EXPECT_EQ(CompliedBlock::trackedMemoryCost(), tracked_cost - retained_cost);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 2);
+    EXPECT_EQ(CompliedBlock::totalRetainedCbs(), 0);
+    EXPECT_EQ(CompliedBlock::getNumGetSliceIndices(), 1);
+    EXPECT_EQ(CompliedBlock::getSlice(*cb_b, 1, 3, &running_miner), slice_b);
+    EXPECT_EQ(CompliedBlock::releaseRetainedCbs(), 0);
+
+    CompliedBlock::setRetentionBudget(0);
+    CompliedBlock::release(running_miner);
+    EXPECT_EQ(CompliedBlock::trackedMemoryCost(), 0);
+    CompliedBlock::clearPool();
+    for (int i = 0; i < 4; i++) {
+        delete[] rows[i];
+    }
+    delete[] rows;
+}
+
+TEST(TestCompliedBlock, TestRetainBaseCbs) {
+    CompliedBlock::clearPool();
+    int** rows = new int*[4] {
+        new int[2]{2, 1},
+        new int[2]{1, 1},
+        new int[2]{2, 3},
+        new int[2]{1, 3},
+    };
+    SimpleRelation relation_a("a", 0, rows, 2, 4);
+    SimpleRelation relation_b("b", 1, rows, 2, 4);
+    IntTable* table = new IntTable(rows, 4, 2);
+
+    /* CBs of external tables and the results of their operations are retained. Others are released */
+    CompliedBlock* cb_a = CompliedBlock::create(&relation_a, false);
+    CompliedBlock* cb_b = CompliedBlock::create(&relation_b, false);
+    CompliedBlock* cb_table = CompliedBlock::create(table, true);
+    CompliedBlock* slice_a = CompliedBlock::getSlice(*cb_a, 1, 3);
+    ASSERT_NE(slice_a, nullptr);
+    slice_a->buildIndices();
+    ASSERT_NE(CompliedBlock::getSlice(*slice_a, 0, 2), nullptr);
+    std::vector<CompliedBlock*> const& split_a = CompliedBlock::splitSlices(*cb_a, 0);
+    EXPECT_EQ(split_a.size(), 2);
+    MatchedSubCbs const* matched = CompliedBlock::matchSlices(*cb_a, 0, *cb_b, 0);
+    ASSERT_NE(matched, nullptr);
+    EXPECT_EQ(matched->cbs1.size(), 2);
+    CompliedBlock* slice_b = CompliedBlock::getSlice(*cb_b, 0, 1);
+    ASSERT_NE(slice_b, nullptr);
+    ASSERT_NE(CompliedBlock::getSlice(*cb_table, 1, 3), nullptr);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 13);
+
+    CompliedBlock::setRetentionBudget(1024 * 1024);
+    CompliedBlock::clearPool(true);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 10);
+    size_t const retained_cost = CompliedBlock::trackedMemoryCost();
+    EXPECT_GT(retained_cost, 0);
+    EXPECT_EQ(cb_a->getId(), 0);
+    EXPECT_EQ(cb_b->getId(), 1);
+    EXPECT_EQ(CompliedBlock::create(&relation_a, false), cb_a);
+    size_t const get_slice_hits = CompliedBlock::getNumGetSliceHit();
+    EXPECT_EQ(CompliedBlock::getSlice(*cb_a, 1, 3), slice_a);
+    EXPECT_EQ(CompliedBlock::getSlice(*cb_b, 0, 1), slice_b);
+    EXPECT_EQ(CompliedBlock::getNumGetSliceHit(), get_slice_hits + 2);
+    EXPECT_EQ(&CompliedBlock::splitSlices(*cb_a, 0), &split_a);
+    EXPECT_EQ(CompliedBlock::matchSlices(*cb_b, 0, *cb_a, 0), matched);
+    EXPECT_LT(slice_a->getId(), CompliedBlock::totalNumCbs());
+    EXPECT_EQ(slice_a->getIndices().getTotalRows(), 2);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 10);
+
+    /* Nothing is retained without budget */
+    CompliedBlock::setRetentionBudget(0);
+    CompliedBlock::clearPool(true);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 0);
+    EXPECT_EQ(CompliedBlock::trackedMemoryCost(), 0);
+
+    /* The more frequently used base CBs are retained first */
+    cb_a = CompliedBlock::create(&relation_a, false);
+    cb_b = CompliedBlock::create(&relation_b, false);
+    slice_a = CompliedBlock::getSlice(*cb_a, 1, 3);
+    CompliedBlock::getSlice(*cb_a, 1, 3);
+    CompliedBlock::getSlice(*cb_b, 1, 3);
+    CompliedBlock::setRetentionBudget(CompliedBlock::trackedMemoryCost() / 2);
+    CompliedBlock::clearPool(true);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 2);
+    EXPECT_EQ(CompliedBlock::create(&relation_a, false), cb_a);
+    EXPECT_EQ(CompliedBlock::getSlice(*cb_a, 1, 3), slice_a);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 2);
+
+    CompliedBlock::setRetentionBudget(0);
+    CompliedBlock::clearPool();
+    for (int i = 0; i < 4; i++) {
+        delete[] rows[i];
+    }
+    delete[] rows;
+}
+
+TEST(TestCompliedBlock, TestConcurrentMinersShareKbCb) {
+    CompliedBlock::clearPool();
+    int const total_rows = 400;
+    int const total_values = 20;
+    int** rows = new int*[total_rows];
+    for (int i = 0; i < total_rows; i++) {
+        rows[i] = new int[2]{i % total_values + 1, i / total_values + 1};
+    }
+    SimpleRelation relation("test", 0, rows, 2, total_rows);
+    for (int i = 0; i < total_rows; i++) {
+        delete[] rows[i];
+    }
+    delete[] rows;
+
+    /* Each miner slices the CB of the same KB relation, indexes the slices and slices them again */
+    auto mine = [&relation](std::vector<CompliedBlock*>& subSlices) {
+        CompliedBlock* cb = CompliedBlock::create(&relation, false);
+        for (int val = 1; val <= total_values; val++) {
+            CompliedBlock* slice = CompliedBlock::getSlice(*cb, 0, val);
+            slice->buildIndices();
+            subSlices.push_back(CompliedBlock::getSlice(*slice, 1, val));
+        }
+    };
+    std::vector<CompliedBlock*> expected_slices;
+    mine(expected_slices);
+    size_t const expected_cost = CompliedBlock::trackedMemoryCost();
+    size_t const expected_cbs = CompliedBlock::totalNumCbs();
+    CompliedBlock::clearPool();
+
+    std::vector<CompliedBlock*> slices1;
+    std::vector<CompliedBlock*> slices2;
+    std::thread miner1(mine, std::ref(slices1));
+    std::thread miner2(mine, std::ref(slices2));
+    miner1.join();
+    miner2.join();
+    EXPECT_EQ(slices1, slices2);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), expected_cbs);
+    EXPECT_EQ(CompliedBlock::trackedMemoryCost(), expected_cost);
+    for (CompliedBlock* const& sub_slice: slices1) {
+        ASSERT_NE(sub_slice, nullptr);
+        ASSERT_EQ(sub_slice->getTotalRows(), 1);
+        EXPECT_EQ(sub_slice->getRow(0)[0], sub_slice->getRow(0)[1]);
+    }
+
+    CompliedBlock::clearPool();
+}
+
+TEST(TestCompliedBlock, TestReleaseHolders) {
+    CompliedBlock::clearPool();
+    int** rows = new int*[4] {
+        new int[2]{2, 1},
+        new int[2]{1, 1},
+        new int[2]{2, 3},
+        new int[2]{1, 3},
+    };
+    SimpleRelation relation("a", 0, rows, 2, 4);
+    IntTable* table = new IntTable(rows, 4, 2);
+
+    /* Two miners share the CB of a KB relation and a slice of it */
+    CbHolder* holder1 = new CbHolder();
+    CbHolder holder2;
+    CompliedBlock* cb = CompliedBlock::create(&relation, false, holder1);
+    CompliedBlock* slice = CompliedBlock::getSlice(*cb, 1, 3, holder1);
+    ASSERT_NE(slice, nullptr);
+    slice->buildIndices();
+    ASSERT_NE(CompliedBlock::getSlice(*slice, 0, 2, holder1), nullptr);
+    CompliedBlock* cb_table = CompliedBlock::create(table, true, holder1);
+    ASSERT_NE(CompliedBlock::getSlice(*cb_table, 1, 3, holder1), nullptr);
+    EXPECT_EQ(CompliedBlock::create(&relation, false, &holder2), cb);
+    EXPECT_EQ(CompliedBlock::getSlice(*cb, 1, 3, &holder2), slice);
+    std::vector<CompliedBlock*> const& split = CompliedBlock::splitSlices(*cb, 0, &holder2);
+    EXPECT_EQ(split.size(), 2);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 7);
+
+    /* The first miner releases only the CBs that are not shared */
+    CompliedBlock::setRetentionBudget(0);
+    size_t const tracked_cost = CompliedBlock::trackedMemoryCost();
+    CompliedBlock::release(*holder1);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 4);
+    EXPECT_LT(CompliedBlock::trackedMemoryCost(), tracked_cost);
+    EXPECT_EQ(CompliedBlock::getNumGetSliceIndices(), 1);
+    EXPECT_EQ(CompliedBlock::getSlice(*cb, 1, 3, &holder2), slice);
+    EXPECT_EQ(slice->getIndices().getTotalRows(), 2);
+
+    /* The IDs of the released CBs are reused, and the holder is released when destroyed */
+    CompliedBlock* slice2 = CompliedBlock::getSlice(*cb, 0, 1, holder1);
+    ASSERT_NE(slice2, nullptr);
+    EXPECT_LT(slice2->getId(), 7);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 5);
+    delete holder1;
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 4);
+
+    /* The CB of the KB relation and the results of the operations on it are retained within the budget */
+    CompliedBlock::setRetentionBudget(1024 * 1024);
+    CompliedBlock::release(holder2);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 4);
+    EXPECT_EQ(CompliedBlock::totalRetainedCbs(), 4);
+    EXPECT_EQ(CompliedBlock::retainedMemoryCost(), CompliedBlock::trackedMemoryCost());
+    EXPECT_EQ(CompliedBlock::getSlice(*cb, 1, 3, &holder2), slice);
+    EXPECT_EQ(&CompliedBlock::splitSlices(*cb, 0), &split);
+    EXPECT_EQ(CompliedBlock::totalRetainedCbs(), 3);
+
+    /* Nothing is retained without budget */
+    CompliedBlock::setRetentionBudget(0);
+    CompliedBlock::release(holder2);
+    EXPECT_EQ(CompliedBlock::totalNumCbs(), 0);
+    EXPECT_EQ(CompliedBlock::trackedMemoryCost(), 0);
+
+    CompliedBlock::clearPool();
+    for (int i = 0; i < 4; i++) {
+        delete[] rows[i];
+    }
+    delete[] rows;
+}
+
+TEST(TestCompliedBlock, TestRowIds) {
+    CompliedBlock::clearPool();
+
+    int** rows = new int*[4] {
+        new int[2]{2, 1},
+        new int[2]{1, 1},
+        new int[2]{2, 3},
+        new int[2]{1, 3},
+    };
+    SimpleRelation relation("test", 0, rows, 2, 4);
+    for (int i = 0; i < 4; i++) {
+        delete[] rows[i];
+    }
+    delete[] rows;
+
+    CompliedBlock* cb = CompliedBlock::create(&relation, false);
+    EXPECT_EQ(cb, CompliedBlock::create(&relation, false));
+    EXPECT_EQ(&(cb->getBase()), &relation);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(cb->getRowId(i), i);
+        EXPECT_EQ(cb->getRow(i), relation[i]);
+    }
+
+    /* Slices refer to rows in the relation by row ids */
+    CompliedBlock* slice = CompliedBlock::getSlice(*cb, 1, 3);
+    ASSERT_NE(slice, nullptr);
+    ASSERT_EQ(slice->getTotalRows(), 2);
+    EXPECT_EQ(&(slice->getBase()), &relation);
+    for (int i = 0; i < 2; i++) {
+        EXPECT_EQ(slice->getRow(i)[1], 3);
+        EXPECT_EQ(slice->getRow(i), relation[slice->getRowId(i)]);
+    }
+    slice->buildIndices();
+    CompliedBlock* sub_slice = CompliedBlock::getSlice(*slice, 0, 2);
+    ASSERT_NE(sub_slice, nullptr);
+    ASSERT_EQ(sub_slice->getTotalRows(), 1);
+    EXPECT_EQ(sub_slice->getRowId(0), 3);   // [2, 3]
+    EXPECT_TRUE(relation.entailIfNotById(sub_slice->getRowId(0)));
+    int rec[2]{2, 3};
+    EXPECT_TRUE(relation.isEntailed(rec));
+
+    CompliedBlock::clearPool();
+}
+
 class TestCacheFragment : public testing::Test {
 protected:
     static int*** relations;
@@ -223,7 +504,7 @@ TEST_F(TestCacheFragment, TestCase1aTest1) {
     EXPECT_STREQ("p(X0,?,?)", rule2String(fragment.getPartAssignedRule()).c_str());
     CacheFragment::entriesType expected_entries({
         new CacheFragment::entryType({
-            CompliedBlock::create(rel_p->getAllRows(), rel_p->getTotalRows(), rel_p->getTotalCols(), rel_p, false, false)
+            CompliedBlock::create(rel_p, false)
         })
     });
     checkEntries(expected_entries, fragment);
@@ -281,7 +562,7 @@ TEST_F(TestCacheFragment, case1aTest2) {
     EXPECT_STREQ("p(X0,?,X2)", rule2String(fragment.getPartAssignedRule()).c_str());
     CacheFragment::entriesType expected_entries({
         new CacheFragment::entryType({
-            CompliedBlock::create(rel_p->getAllRows(), rel_p->getTotalRows(), rel_p->getTotalCols(), rel_p, false, false)
+            CompliedBlock::create(rel_p, false)
         })
     });
     checkEntries(expected_entries, fragment);
@@ -401,7 +682,7 @@ TEST_F(TestCacheFragment, case1bTest1) {
     /* frag1 */
     EXPECT_STREQ("p(X0,?,?)", rule2String(fragment.getPartAssignedRule()).c_str());
     expected_entries.push_back(new CacheFragment::entryType({
-            CompliedBlock::create(rel_p->getAllRows(), rel_p->getTotalRows(), rel_p->getTotalCols(), rel_p, false, false)
+            CompliedBlock::create(rel_p, false)
     }));
     checkEntries(expected_entries, fragment);
     clearEntries(expected_entries);
@@ -1380,6 +1661,196 @@ TEST_F(TestCacheFragment, TestCountCombinations5) {
     CompliedBlock::clearPool();
 }
 
+TEST_F(TestCacheFragment, TestCountCombinationsWithCap) {
+    SimpleRelation* rel_p = kb->getRelation(NumP);
+    SimpleRelation* rel_q = kb->getRelation(NumQ);
+
+    /* p(X, Y, ?), q(?, Z, Y), q(?, Z, ?) [X, Z] */
+    CacheFragment fragment(rel_p, NumP);
+    fragment.updateCase1a(0, 0, 0);
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 2, 0, 1, 1);
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 1, 1, 1, 2);
+    std::vector<int> vids({0, 2});
+    EXPECT_EQ(6, fragment.countCombinations(vids, 6));
+    EXPECT_EQ(6, fragment.countCombinations(vids, 10));
+    int bounded_cnt = fragment.countCombinations(vids, 2);
+    EXPECT_LT(2, bounded_cnt);
+    EXPECT_GE(6, bounded_cnt);
+    EXPECT_LT(0, fragment.countCombinations(vids, 0));
+
+    std::vector<int> lv_vids({1});
+    EXPECT_EQ(1, fragment.countCombinations(lv_vids, 0));
+    CompliedBlock::clearPool();
+}
+
+TEST_F(TestCacheFragment, TestCombinationSummaries) {
+    SimpleRelation* rel_p = kb->getRelation(NumP);
+    SimpleRelation* rel_q = kb->getRelation(NumQ);
+
+    /* p(X, Y, ?), q(?, Z, Y), q(?, Z, ?) [X, Z] */
+    CacheFragment fragment(rel_p, NumP);
+    fragment.updateCase1a(0, 0, 0);
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 2, 0, 1, 1);
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 1, 1, 1, 2);
+    std::vector<int> vids({0, 2});
+    std::vector<int> reversed_vids({2, 0});
+
+    /* Lower bounds are not kept */
+    EXPECT_LT(2, fragment.countCombinations(vids, 2));
+    EXPECT_FALSE(fragment.hasCombinationSummary(vids));
+    EXPECT_EQ(6, fragment.countCombinations(vids));
+    EXPECT_TRUE(fragment.hasCombinationSummary(vids));
+    EXPECT_TRUE(fragment.hasCombinationSummary(reversed_vids));
+    EXPECT_EQ(6, fragment.countCombinations(reversed_vids, 2));
+
+    /* Summaries are copied, and are cleared after updates */
+    CacheFragment copied_fragment(fragment);
+    EXPECT_TRUE(copied_fragment.hasCombinationSummary(vids));
+    EXPECT_EQ(6, copied_fragment.countCombinations(vids));
+    copied_fragment.buildIndices();
+    copied_fragment.updateCase3(0, 2, 3);
+    EXPECT_FALSE(copied_fragment.hasCombinationSummary(vids));
+    EXPECT_TRUE(fragment.hasCombinationSummary(vids));
+    CompliedBlock::clearPool();
+}
+
+TEST_F(TestCacheFragment, TestSharedEntries) {
+    SimpleRelation* rel_p = kb->getRelation(NumP);
+    SimpleRelation* rel_q = kb->getRelation(NumQ);
+
+    /* p(X, ?, ?), q(?, ?, X) */
+    CacheFragment* fragment = new CacheFragment(rel_p, NumP);
+    fragment->updateCase1a(0, 0, 0);
+    fragment->buildIndices();
+    fragment->updateCase1b(rel_q, NumQ, 2, 0);
+    fragment->buildIndices();
+    int const total_entries = fragment->getEntries().size();
+    EXPECT_LT(0, total_entries);
+
+    /* Copies share the entries until updated */
+    CacheFragment* copy1 = new CacheFragment(*fragment);
+    CacheFragment* copy2 = new CacheFragment(*fragment);
+    EXPECT_EQ(&(fragment->getEntries()), &(copy1->getEntries()));
+    EXPECT_EQ(&(fragment->getEntries()), &(copy2->getEntries()));
+    copy1->updateCase3(0, 1, 1);
+    EXPECT_NE(&(fragment->getEntries()), &(copy1->getEntries()));
+    EXPECT_EQ(total_entries, fragment->getEntries().size());
+    copy2->clear();
+    EXPECT_TRUE(copy2->isEmpty());
+    EXPECT_FALSE(fragment->isEmpty());
+
+    /* The entries are kept until the last copy is released */
+    CacheFragment* copy3 = new CacheFragment(*fragment);
+    delete fragment;
+    EXPECT_EQ(total_entries, copy3->getEntries().size());
+    std::vector<int> vids({0});
+    EXPECT_LT(0, copy3->countCombinations(vids));
+    delete copy1;
+    delete copy2;
+    delete copy3;
+    CompliedBlock::clearPool();
+}
+
+TEST_F(TestCacheFragment, TestLvColumns) {
+    SimpleRelation* rel_p = kb->getRelation(NumP);
+    SimpleRelation* rel_q = kb->getRelation(NumQ);
+
+    /* p(X, Y, ?), q(?, Z, Y), q(?, Z, ?) */
+    CacheFragment fragment(rel_p, NumP);
+    fragment.updateCase1a(0, 0, 0);
+    EXPECT_TRUE(fragment.getLvColumn(0).empty());   // X0 is a PLV
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 2, 0, 1, 1);
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 1, 1, 1, 2);
+    std::vector<VarInfo> const& var_info_list = fragment.getVarInfoList();
+    EXPECT_TRUE(fragment.getLvColumn(0).empty());
+    for (int vid = 1; vid < 3; vid++) {
+        std::vector<int> const& column = fragment.getLvColumn(vid);
+        VarInfo const& var_info = var_info_list[vid];
+        ASSERT_FALSE(var_info.isPlv);
+        ASSERT_EQ(column.size(), fragment.getEntries().size());
+        for (int i = 0; i < column.size(); i++) {
+            CompliedBlock const* cb = (*fragment.getEntry(i))[var_info.tabIdx];
+            for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
+                EXPECT_EQ(column[i], cb->getRow(row_idx)[var_info.colIdx]);
+            }
+        }
+    }
+
+    CacheFragment copied_fragment(fragment);
+    EXPECT_EQ(copied_fragment.getLvColumn(2), fragment.getLvColumn(2));
+    fragment.clear();
+    EXPECT_TRUE(fragment.getLvColumn(2).empty());
+    CompliedBlock::clearPool();
+}
+
+TEST_F(TestCacheFragment, TestLvColumnsOfMergedFragments) {
+    SimpleRelation* rel_p = kb->getRelation(NumP);
+    SimpleRelation* rel_q = kb->getRelation(NumQ);
+    auto expect_columns = [](CacheFragment const& fragment) {
+        std::vector<VarInfo> const& var_info_list = fragment.getVarInfoList();
+        for (int vid = 0; vid < var_info_list.size(); vid++) {
+            std::vector<int> const& column = fragment.getLvColumn(vid);
+            VarInfo const& var_info = var_info_list[vid];
+            if (var_info.isEmpty() || var_info.isPlv) {
+                EXPECT_TRUE(column.empty());
+                continue;
+            }
+            ASSERT_EQ(column.size(), fragment.getEntries().size());
+            for (int i = 0; i < column.size(); i++) {
+                CompliedBlock const* cb = (*fragment.getEntry(i))[var_info.tabIdx];
+                for (int row_idx = 0; row_idx < cb->getTotalRows(); row_idx++) {
+                    EXPECT_EQ(column[i], cb->getRow(row_idx)[var_info.colIdx]);
+                }
+            }
+        }
+    };
+
+    /* F1: p(X0, X0, ?) */
+    CacheFragment fragment1(rel_p, NumP);
+    fragment1.updateCase2a(0, 0, 0, 1, 0);
+
+    /* F2: q(X1, X1, ?) */
+    CacheFragment fragment2(rel_q, NumQ);
+    fragment2.updateCase2a(0, 0, 0, 1, 1);
+
+    /* F1 + F2: p(X0, X0, X2), q(X1, X1, X2) */
+    fragment1.buildIndices();
+    fragment2.buildIndices();
+    fragment1.updateCase2c(0, 2, fragment2, 0, 2, 2);
+    EXPECT_EQ(1, fragment1.getEntries().size());
+    expect_columns(fragment1);
+
+    /* F3: q(X3, ?, ?) */
+    CacheFragment fragment3(rel_q, NumQ);
+    fragment3.updateCase1a(0, 0, 3);
+
+    /* F1 + F3: p(X0, X0, X2), q(X1, X1, X2), q(X3, X0, ?) */
+    fragment1.buildIndices();
+    fragment3.buildIndices();
+    fragment1.updateCase1c(fragment3, 0, 1, 0);
+    EXPECT_EQ(1, fragment1.getEntries().size());
+    expect_columns(fragment1);
+
+    /* p(X0, X0, X2), q(X1, X1, X2), q(X3, X0, X4), p(?, X4, ?) */
+    fragment1.buildIndices();
+    fragment1.updateCase2b(rel_p, NumP, 1, 2, 2, 4);
+    EXPECT_EQ(2, fragment1.getEntries().size());
+    expect_columns(fragment1);
+
+    /* p(X0, X0, X2), q(X1, X1, X2), q(X3, X0, X4), p(1, X4, ?) */
+    fragment1.buildIndices();
+    fragment1.updateCase3(3, 0, 1);
+    EXPECT_EQ(1, fragment1.getEntries().size());
+    expect_columns(fragment1);
+    CompliedBlock::clearPool();
+}
+
 TEST_F(TestCacheFragment, TestEnumerateCombinations1) {
     SimpleRelation* rel_p = kb->getRelation(NumP);
     SimpleRelation* rel_q = kb->getRelation(NumQ);
@@ -1602,6 +2073,37 @@ TEST_F(TestCacheFragment, TestEnumerateCombinations7) {
     CompliedBlock::clearPool();
 }
 
+TEST_F(TestCacheFragment, TestParallelCombinations) {
+    SimpleRelation* rel_p = kb->getRelation(NumP);
+    SimpleRelation* rel_q = kb->getRelation(NumQ);
+
+    /* p(X, Y, ?), q(?, Z, Y), q(?, Z, ?) [Z, X] */
+    CacheFragment fragment(rel_p, NumP);
+    fragment.updateCase1a(0, 0, 0);
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 2, 0, 1, 1);
+    fragment.buildIndices();
+    fragment.updateCase2b(rel_q, NumQ, 1, 1, 1, 2);
+    fragment.buildIndices();
+    fragment.updateCase1a(2, 2, 3);
+    EXPECT_STREQ("p(X0,X1,?),q(?,X2,X1),q(?,X2,X3)", rule2String(fragment.getPartAssignedRule()).c_str());
+
+    std::vector<std::vector<int>> vids_list({{0, 3}, {0, 2}, {1, 2}, {3}, {0, 1, 2, 3}});
+    for (std::vector<int> const& vids: vids_list) {
+        /* Enumerate first, as the exact count is kept in the evaluation summaries */
+        CacheFragment::setParallelMinEntries(CacheFragment::DEFAULT_PARALLEL_MIN_ENTRIES);
+        std::unordered_set<Record>* expected_set = fragment.enumerateCombinations(vids);
+        CacheFragment::setParallelMinEntries(1);
+        EXPECT_EQ(expected_set->size(), fragment.countCombinations(vids, std::numeric_limits<int>::max(), 3));
+        std::unordered_set<Record>* actual_set = fragment.enumerateCombinations(vids, 3);
+        EXPECT_EQ(*expected_set, *actual_set);
+        releaseCombinationSet(expected_set);
+        releaseCombinationSet(actual_set);
+    }
+    CacheFragment::setParallelMinEntries(CacheFragment::DEFAULT_PARALLEL_MIN_ENTRIES);
+    CompliedBlock::clearPool();
+}
+
 class TestCachedRule : public testing::Test {
 protected:
     static const std::string KB_NAME;
@@ -1740,11 +2242,8 @@ protected:
     }
 
     void releaseCacheAndTabuMap() {
-        for (const Fingerprint* const& fp: cache) {
-            delete fp;
-        }
         cache.clear();
-        for (std::pair<MultiSet<int> const*, Rule::fingerprintCacheType*> const& kv: tabuMap) {
+        for (std::pair<MultiSet<int> const*, Rule::tabuSetType*> const& kv: tabuMap) {
             delete kv.first;
             delete kv.second;
         }
@@ -2876,6 +3375,191 @@ TEST_F(TestCachedRule, TestValidity2) {
     releaseCacheAndTabuMap();
 }
 
+TEST_F(TestCachedRule, TestEvalCutoff) {
+    SimpleKb* kb = kbFamily();
+
+    /* parent(X, ?) :- father(X, ?) */
+    CachedRule rule(NUM_PARENT, 2, cache, tabuMap, *kb, nullptr);
+    rule.updateCacheIndices();
+    CachedRule* rule1 = new CachedRule(rule);
+    rule1->setEvalCutoff(EvalMetric::CompressionRatio, 0.01);
+    EXPECT_EQ(UpdateStatus::Normal, rule1->specializeCase4(NUM_FATHER, 2, 0, 0, 0));
+    EXPECT_STREQ("parent(X0,?):-father(X0,?)", rule1->toDumpString(kb->getRelationNames()).c_str());
+    EXPECT_FALSE(rule1->isEvalAbandoned());
+    EXPECT_EQ(Eval(4, 4 * 16, 1), rule1->getEval());
+    delete rule1;
+    releaseCacheAndTabuMap();
+
+    /* The rule cannot beat the cutoff score and only a lower bound of the entailments is counted */
+    CachedRule rule2(NUM_PARENT, 2, cache, tabuMap, *kb, nullptr);
+    rule2.updateCacheIndices();
+    rule2.setEvalCutoff(EvalMetric::CompressionRatio, 0.5);
+    EXPECT_EQ(UpdateStatus::Normal, rule2.specializeCase4(NUM_FATHER, 2, 0, 0, 0));
+    EXPECT_TRUE(rule2.isEvalAbandoned());
+    EXPECT_EQ(4, rule2.getEval().getPosEtls());
+    EXPECT_GE(4 * 16, rule2.getEval().getAllEtls());
+    EXPECT_GE(0.5, rule2.getEval().value(EvalMetric::CompressionRatio));
+
+    delete kb;
+    releaseCacheAndTabuMap();
+}
+
+TEST_F(TestCachedRule, TestSampledEval) {
+    /* The same KB as `TestSincWithCache.TestCompression1` */
+    int* relation_p[55]{};
+    int* relation_q[50]{};
+    for (int i = 0; i < 50; i++) {
+        relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+        relation_q[i] = new int[2] {i * 2 + 2, i * 2 + 1};
+    }
+    for (int i = 50; i < 55; i++) {
+        relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+    }
+    int** relations[2] {relation_p, relation_q};
+    std::string rel_names[2] {"p", "q"};
+    int arities[2] {2, 2};
+    int total_rows[2] {55, 50};
+    SimpleKb kb("TestSampledEval", relations, rel_names, arities, total_rows, 2);
+
+    /* p(X, ?) :- q(?, X) */
+    CachedRule rule(0, 2, cache, tabuMap, kb, nullptr);
+    rule.updateCacheIndices();
+    CachedRule* exact_rule = new CachedRule(rule);
+    EXPECT_EQ(UpdateStatus::Normal, exact_rule->specializeCase4(1, 2, 1, 0, 0));
+    EXPECT_STREQ("p(X0,?):-q(?,X0)", exact_rule->toDumpString(kb.getRelationNames()).c_str());
+    EXPECT_FALSE(exact_rule->isEvalSampled());
+    Eval const exact_eval = exact_rule->getEval();
+    delete exact_rule;
+    releaseCacheAndTabuMap();
+
+    /* The head CBs are sampled, as there are 50 of them, each of a single record */
+    CachedRule rule2(0, 2, cache, tabuMap, kb, nullptr);
+    rule2.updateCacheIndices();
+    CachedRule* sampled_rule = new CachedRule(rule2);
+    sampled_rule->setEvalSampling(0.8, 0.95);
+    EXPECT_EQ(UpdateStatus::Normal, sampled_rule->specializeCase4(1, 2, 1, 0, 0));
+    EXPECT_TRUE(sampled_rule->isEvalSampled());
+    EXPECT_EQ(exact_eval.getAllEtls(), sampled_rule->getEval().getAllEtls());
+    for (EvalMetric::Value metric: {EvalMetric::CompressionRatio, EvalMetric::CompressionCapacity, EvalMetric::InfoGain}) {
+        EXPECT_LE(sampled_rule->getEvalLowerBound(metric), sampled_rule->getEval().value(metric));
+        EXPECT_GE(sampled_rule->getEvalUpperBound(metric), sampled_rule->getEval().value(metric));
+        EXPECT_LE(sampled_rule->getEvalLowerBound(metric), exact_eval.value(metric));
+        EXPECT_GE(sampled_rule->getEvalUpperBound(metric), exact_eval.value(metric));
+    }
+
+    /* The verified evaluation is exact */
+    sampled_rule->verifyEval();
+    EXPECT_FALSE(sampled_rule->isEvalSampled());
+    EXPECT_EQ(exact_eval, sampled_rule->getEval());
+    EXPECT_EQ(exact_eval.value(EvalMetric::CompressionRatio), sampled_rule->getEvalLowerBound(EvalMetric::CompressionRatio));
+    delete sampled_rule;
+    releaseCacheAndTabuMap();
+
+    /* Small P-caches are not sampled */
+    CachedRule rule3(0, 2, cache, tabuMap, kb, nullptr);
+    rule3.updateCacheIndices();
+    CachedRule* small_rule = new CachedRule(rule3);
+    small_rule->setEvalSampling(0.5, 0.95);
+    EXPECT_EQ(UpdateStatus::Normal, small_rule->specializeCase4(1, 2, 1, 0, 0));
+    EXPECT_FALSE(small_rule->isEvalSampled());
+    EXPECT_EQ(exact_eval, small_rule->getEval());
+    delete small_rule;
+    releaseCacheAndTabuMap();
+
+    for (int i = 0; i < 55; i++) {
+        delete[] relation_p[i];
+    }
+    for (int i = 0; i < 50; i++) {
+        delete[] relation_q[i];
+    }
+}
+
+TEST_F(TestCachedRule, TestCase5PosEntailments) {
+    Rule::MinFactCoverage = -1.0;
+    SimpleKb* kb = kbFamily();
+
+    /* parent(X, ?) :- father(X, ?) */
+    CachedRule rule(NUM_PARENT, 2, cache, tabuMap, *kb, nullptr);
+    rule.updateCacheIndices();
+    EXPECT_EQ(UpdateStatus::Normal, rule.specializeCase4(NUM_FATHER, 2, 0, 0, 0));
+    rule.updateCacheIndices();
+    std::vector<int> constants;
+    for (int constant = 1; constant <= kb->totalConstants(); constant++) {
+        constants.push_back(constant);
+    }
+
+    /* The batched counts equal those of the specializations */
+    for (ArgLocation const& arg: {ArgLocation(HEAD_PRED_IDX, 1), ArgLocation(FIRST_BODY_PRED_IDX, 1)}) {
+        std::vector<int> const counts = rule.countCase5PosEntailments(arg.predIdx, arg.argIdx, constants);
+        ASSERT_EQ(constants.size(), counts.size());
+        int total_pos = 0;
+        for (int i = 0; i < constants.size(); i++) {
+            CachedRule* spec_rule = rule.clone();
+            UpdateStatus const status = spec_rule->specializeCase5(arg.predIdx, arg.argIdx, constants[i]);
+            if (UpdateStatus::Normal == status) {
+                EXPECT_EQ(spec_rule->getEval().getPosEtls(), counts[i]) << "@" << arg.predIdx << ',' << constants[i];
+            } else {
+                EXPECT_EQ(0, counts[i]) << "@" << arg.predIdx << ',' << constants[i];
+            }
+            total_pos += counts[i];
+            delete spec_rule;
+        }
+        EXPECT_LT(0, total_pos);
+    }
+
+    delete kb;
+    releaseCacheAndTabuMap();
+}
+
+TEST_F(TestCachedRule, TestJoinPosEntailments) {
+    Rule::MinFactCoverage = -1.0;
+    SimpleKb* kb = kbFamily();
+
+    /* parent(X, ?) :- father(X, ?) */
+    CachedRule rule(NUM_PARENT, 2, cache, tabuMap, *kb, nullptr);
+    rule.updateCacheIndices();
+    EXPECT_EQ(UpdateStatus::Normal, rule.specializeCase4(NUM_FATHER, 2, 0, 0, 0));
+    rule.updateCacheIndices();
+    std::vector<std::pair<int, int>> columns;
+    for (SimpleRelation* const& relation: *(kb->getRelations())) {
+        for (int col = 0; col < relation->getTotalCols(); col++) {
+            columns.emplace_back(relation->id, col);
+        }
+    }
+
+    /* Case 4: The batched counts equal those of the specializations */
+    for (ArgLocation const& arg: {ArgLocation(HEAD_PRED_IDX, 1), ArgLocation(FIRST_BODY_PRED_IDX, 1)}) {
+        std::vector<int> const counts = rule.countJoinPosEntailments(arg.predIdx, arg.argIdx, columns);
+        ASSERT_EQ(columns.size(), counts.size());
+        for (int i = 0; i < columns.size(); i++) {
+            CachedRule* spec_rule = rule.clone();
+            UpdateStatus const status = spec_rule->specializeCase4(
+                columns[i].first, kb->getRelation(columns[i].first)->getTotalCols(), columns[i].second, arg.predIdx, arg.argIdx
+            );
+            if (UpdateStatus::Normal == status) {
+                EXPECT_EQ(spec_rule->getEval().getPosEtls(), counts[i]) << "@" << arg.predIdx << ',' << i;
+            }
+            delete spec_rule;
+        }
+    }
+
+    /* Case 2: X0 is at `parent[0]` */
+    std::vector<int> const counts = rule.countJoinPosEntailments(HEAD_PRED_IDX, 0, columns);
+    for (int i = 0; i < columns.size(); i++) {
+        CachedRule* spec_rule = rule.clone();
+        UpdateStatus const status = spec_rule->specializeCase2(
+            columns[i].first, kb->getRelation(columns[i].first)->getTotalCols(), columns[i].second, 0
+        );
+        if (UpdateStatus::Normal == status) {
+            EXPECT_EQ(spec_rule->getEval().getPosEtls(), counts[i]) << "@" << i;
+        }
+        delete spec_rule;
+    }
+
+    delete kb;
+    releaseCacheAndTabuMap();
+}
+
 TEST_F(TestCachedRule, TestRcPruning1) {
     Rule::MinFactCoverage = 0.44;
 
@@ -2916,7 +3600,7 @@ TEST_F(TestCachedRule, TestRcPruning2) {
     category.add(NUM_FATHER);
     Rule::tabuMapType::iterator tabu_itr = tabuMap.find(&category);
     ASSERT_NE(tabu_itr, tabuMap.end());
-    Rule::fingerprintCacheType::iterator cache_itr = tabu_itr->second->find(&(rule.getFingerprint()));
+    Rule::tabuSetType::iterator cache_itr = tabu_itr->second->find(&(rule.getFingerprint()));
     ASSERT_NE(cache_itr, tabu_itr->second->end());
 
     delete kb;
@@ -3274,4 +3958,289 @@ TEST_F(TestSincWithCache, TestCompression1) {
     for (int i = 50; i < 55; i++) {
         delete[] relation_p[i];
     }
-}
\ No newline at end of file
+}
+TEST_F(TestSincWithCache, TestParallelEvaluation) {
+    /* The same KB as `TestCompression1` */
+    int* relation_p[55]{};
+    int* relation_q[50]{};
+    for (int i = 0; i < 50; i++) {
+        int a1 = i * 2 + 1;
+        int a2 = i * 2 + 2;
+        relation_p[i] = new int[2] {a1, a2};
+        relation_q[i] = new int[2] {a2, a1};
+    }
+    for (int i = 50; i < 55; i++) {
+        relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+    }
+    int** relations[2] {relation_p, relation_q};
+    std::string rel_names[2] {"p", "q"};
+    int arities[2] {2, 2};
+    int total_rows[2] {55, 50};
+
+    /* Rules and evaluations should be the same as those found by a single thread */
+    std::vector<std::string> rule_strs[2];
+    std::vector<Eval> evals[2];
+    size_t total_counterexamples[2]{};
+    int threads[2]{1, 3};
+    for (int i = 0; i < 2; i++) {
+        SimpleKb* kb = new SimpleKb("TestSincWithCache", relations, rel_names, arities, total_rows, 2);
+        SincWithCache sinc(new SincConfig(
+            "", "", MEM_DIR, "TestSincWithCacheComp", threads[i], false, 0, "", 1024, 5, EvalMetric::Value::CompressionCapacity,
+            0.05, 0.25, 1.0, 0, "", "", 0, true
+        ), kb);
+        sinc.run();
+        SimpleCompressedKb& ckb = sinc.getCompressedKb();
+        for (Rule* const& rule: ckb.getHypothesis()) {
+            rule_strs[i].push_back(rule->toDumpString(kb->getRelationNames()));
+            evals[i].push_back(rule->getEval());
+        }
+        total_counterexamples[i] = ckb.getCounterexampleSet(0).size() + ckb.getCounterexampleSet(1).size();
+    }
+    EXPECT_EQ(2, rule_strs[0].size());
+    EXPECT_EQ(rule_strs[0], rule_strs[1]);
+    ASSERT_EQ(evals[0].size(), evals[1].size());
+    for (int i = 0; i < evals[0].size(); i++) {
+        EXPECT_EQ(evals[0][i], evals[1][i]);
+    }
+    EXPECT_EQ(total_counterexamples[0], total_counterexamples[1]);
+
+    for (int i = 0; i < 50; i++) {
+        delete[] relation_p[i];
+        delete[] relation_q[i];
+    }
+    for (int i = 50; i < 55; i++) {
+        delete[] relation_p[i];
+    }
+}
+
+TEST_F(TestSincWithCache, TestAdaptiveBeamwidth) {
+    /* The same KB as `TestCompression1` */
+    int* relation_p[55]{};
+    int* relation_q[50]{};
+    for (int i = 0; i < 50; i++) {
+        int a1 = i * 2 + 1;
+        int a2 = i * 2 + 2;
+        relation_p[i] = new int[2] {a1, a2};
+        relation_q[i] = new int[2] {a2, a1};
+    }
+    for (int i = 50; i < 55; i++) {
+        relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+    }
+    int** relations[2] {relation_p, relation_q};
+    std::string rel_names[2] {"p", "q"};
+    int arities[2] {2, 2};
+    int total_rows[2] {55, 50};
+
+    /* The rules should be found by the widened beams and by those narrowed to a single one */
+    size_t cache_limits[2]{0, 1};
+    for (int i = 0; i < 2; i++) {
+        SimpleKb* kb = new SimpleKb("TestSincWithCache", relations, rel_names, arities, total_rows, 2);
+        SincConfig* config = new SincConfig(
+            "", "", MEM_DIR, "TestSincWithCacheComp", 1, false, 0, "", 1024, 2, EvalMetric::Value::CompressionCapacity,
+            0.05, 0.25, 1.0, 0, "", "", 0, true
+        );
+        config->maxBeamwidth = 8;
+        config->minBeamwidth = 1;
+        config->beamCacheLimitKb = cache_limits[i];
+        SincWithCache sinc(config, kb);
+        sinc.run();
+        SimpleCompressedKb& ckb = sinc.getCompressedKb();
+        std::vector<Rule*>& hypothesis = ckb.getHypothesis();
+        ASSERT_EQ(2, hypothesis.size());
+        std::unordered_set<std::string> actual_rule_strs;
+        actual_rule_strs.emplace(hypothesis[0]->toDumpString(kb->getRelationNames()).c_str());
+        actual_rule_strs.emplace(hypothesis[1]->toDumpString(kb->getRelationNames()).c_str());
+        std::string rules_p[2]{"p(X0,X1):-q(X1,X0)", "p(X1,X0):-q(X0,X1)"};
+        std::string rules_q[2]{"q(X0,X1):-p(X1,X0)", "q(X1,X0):-p(X0,X1)"};
+        checkInducedRules(actual_rule_strs, rules_p, 2, 1);
+        checkInducedRules(actual_rule_strs, rules_q, 2, 1);
+        EXPECT_EQ(5, ckb.getCounterexampleSet(0).size() + ckb.getCounterexampleSet(1).size());
+    }
+
+    for (int i = 0; i < 50; i++) {
+        delete[] relation_p[i];
+        delete[] relation_q[i];
+    }
+    for (int i = 50; i < 55; i++) {
+        delete[] relation_p[i];
+    }
+}
+
+TEST_F(TestSincWithCache, TestSampledEvaluation) {
+    /* The same KB as `TestCompression1` */
+    int* relation_p[55]{};
+    int* relation_q[50]{};
+    for (int i = 0; i < 50; i++) {
+        int a1 = i * 2 + 1;
+        int a2 = i * 2 + 2;
+        relation_p[i] = new int[2] {a1, a2};
+        relation_q[i] = new int[2] {a2, a1};
+    }
+    for (int i = 50; i < 55; i++) {
+        relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+    }
+    int** relations[2] {relation_p, relation_q};
+    std::string rel_names[2] {"p", "q"};
+    int arities[2] {2, 2};
+    int total_rows[2] {55, 50};
+
+    /* The candidates are evaluated on samples, but the found rules are exactly evaluated */
+    SimpleKb* kb = new SimpleKb("TestSincWithCache", relations, rel_names, arities, total_rows, 2);
+    SincConfig* config = new SincConfig(
+        "", "", MEM_DIR, "TestSincWithCacheComp", 1, false, 0, "", 1024, 2, EvalMetric::Value::CompressionCapacity,
+        0.05, 0.25, 1.0, 0, "", "", 0, true
+    );
+    config->evalSampleRatio = 0.8;
+    config->evalSampleConfidence = 0.9;
+    SincWithCache sinc(config, kb);
+    sinc.run();
+    SimpleCompressedKb& ckb = sinc.getCompressedKb();
+    std::vector<Rule*>& hypothesis = ckb.getHypothesis();
+    ASSERT_EQ(2, hypothesis.size());
+    std::unordered_set<std::string> actual_rule_strs;
+    actual_rule_strs.emplace(hypothesis[0]->toDumpString(kb->getRelationNames()).c_str());
+    actual_rule_strs.emplace(hypothesis[1]->toDumpString(kb->getRelationNames()).c_str());
+    std::string rules_p[2]{"p(X0,X1):-q(X1,X0)", "p(X1,X0):-q(X0,X1)"};
+    std::string rules_q[2]{"q(X0,X1):-p(X1,X0)", "q(X1,X0):-p(X0,X1)"};
+    checkInducedRules(actual_rule_strs, rules_p, 2, 1);
+    checkInducedRules(actual_rule_strs, rules_q, 2, 1);
+    for (Rule* const& rule: hypothesis) {
+        EXPECT_FALSE(rule->isEvalSampled());
+        EXPECT_EQ(Eval(50, (0 == rule->getHead().getPredSymbol()) ? 50 : 55, 2), rule->getEval());
+    }
+    EXPECT_EQ(5, ckb.getCounterexampleSet(0).size() + ckb.getCounterexampleSet(1).size());
+
+    for (int i = 0; i < 50; i++) {
+        delete[] relation_p[i];
+        delete[] relation_q[i];
+    }
+    for (int i = 50; i < 55; i++) {
+        delete[] relation_p[i];
+    }
+}
+
+TEST_F(TestSincWithCache, TestSharedKb) {
+    /* The same KB as `TestCompression1` */
+    int* relation_p[55]{};
+    int* relation_q[50]{};
+    for (int i = 0; i < 50; i++) {
+        int a1 = i * 2 + 1;
+        int a2 = i * 2 + 2;
+        relation_p[i] = new int[2] {a1, a2};
+        relation_q[i] = new int[2] {a2, a1};
+    }
+    for (int i = 50; i < 55; i++) {
+        relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+    }
+    int** relations[2] {relation_p, relation_q};
+    std::string rel_names[2] {"p", "q"};
+    int arities[2] {2, 2};
+    int total_rows[2] {55, 50};
+    SimpleKb* kb = new SimpleKb("TestSincWithCache", relations, rel_names, arities, total_rows, 2);
+
+    /* Each compression of the shared KB starts from no entailment and finds the same rules */
+    int beamwidths[2]{5, 2};
+    EvalMetric::Value metrics[2]{EvalMetric::Value::CompressionCapacity, EvalMetric::Value::CompressionRatio};
+    for (int i = 0; i < 2; i++) {
+        SincWithCache* sinc = new SincWithCache(new SincConfig(
+            "", "", MEM_DIR, "TestSincWithCacheComp", 1, false, 0, "", 1024, beamwidths[i], metrics[i],
+            0.05, 0.25, 1.0, 0, "", "", 0, true
+        ), kb, true);
+        sinc->run();
+        SimpleCompressedKb& ckb = sinc->getCompressedKb();
+        std::vector<Rule*>& hypothesis = ckb.getHypothesis();
+        ASSERT_EQ(2, hypothesis.size());
+        std::unordered_set<std::string> actual_rule_strs;
+        actual_rule_strs.emplace(hypothesis[0]->toDumpString(kb->getRelationNames()).c_str());
+        actual_rule_strs.emplace(hypothesis[1]->toDumpString(kb->getRelationNames()).c_str());
+        std::string rules_p[2]{"p(X0,X1):-q(X1,X0)", "p(X1,X0):-q(X0,X1)"};
+        std::string rules_q[2]{"q(X0,X1):-p(X1,X0)", "q(X1,X0):-p(X0,X1)"};
+        checkInducedRules(actual_rule_strs, rules_p, 2, 1);
+        checkInducedRules(actual_rule_strs, rules_q, 2, 1);
+        EXPECT_EQ(5, ckb.getCounterexampleSet(0).size() + ckb.getCounterexampleSet(1).size());
+        delete sinc;
+
+        /* The shared KB and the CBs of its relations are kept */
+        EXPECT_LT(0, kb->getRelation(0)->totalEntailedRecords() + kb->getRelation(1)->totalEntailedRecords());
+        EXPECT_LT(0, CompliedBlock::totalNumCbs());
+    }
+    CompliedBlock::clearPool();
+    delete kb;
+
+    for (int i = 0; i < 50; i++) {
+        delete[] relation_p[i];
+        delete[] relation_q[i];
+    }
+    for (int i = 50; i < 55; i++) {
+        delete[] relation_p[i];
+    }
+}
+
+TEST_F(TestSincWithCache, TestConcurrentRelationMiners) {
+    /*
+     * KB:
+     * p, s: (2i+1, 2i+2) for i in [0, 55) and [0, 50) respectively
+     * q, r: (2i+2, 2i+1) for i in [0, 50) and [0, 45) respectively
+     */
+    int* relation_p[55]{};
+    int* relation_q[50]{};
+    int* relation_r[45]{};
+    int* relation_s[50]{};
+    for (int i = 0; i < 55; i++) {
+        relation_p[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+    }
+    for (int i = 0; i < 50; i++) {
+        relation_q[i] = new int[2] {i * 2 + 2, i * 2 + 1};
+        relation_s[i] = new int[2] {i * 2 + 1, i * 2 + 2};
+    }
+    for (int i = 0; i < 45; i++) {
+        relation_r[i] = new int[2] {i * 2 + 2, i * 2 + 1};
+    }
+    int** relations[4] {relation_p, relation_q, relation_r, relation_s};
+    std::string rel_names[4] {"p", "q", "r", "s"};
+    int arities[4] {2, 2, 2, 2};
+    int total_rows[4] {55, 50, 45, 50};
+
+    /* The hypothesis, counterexamples, and the necessary records should not depend on the number of threads */
+    std::vector<std::string> rule_strs[2];
+    std::vector<std::set<std::vector<int>>> counterexamples[2];
+    int fvs_records[2]{};
+    int necessary_records[2]{};
+    int threads[2]{1, 4};
+    for (int i = 0; i < 2; i++) {
+        SimpleKb* kb = new SimpleKb("TestSincWithCache", relations, rel_names, arities, total_rows, 4);
+        SincWithCache sinc(new SincConfig(
+            "", "", MEM_DIR, "TestSincWithCacheComp", threads[i], false, 0, "", 1024, 5, EvalMetric::Value::CompressionCapacity,
+            0.05, 0.25, 1.0, 0, "", "", 0, true
+        ), kb);
+        sinc.run();
+        SimpleCompressedKb& ckb = sinc.getCompressedKb();
+        for (Rule* const& rule: ckb.getHypothesis()) {
+            rule_strs[i].push_back(rule->toDumpString(kb->getRelationNames()));
+        }
+        for (int rel_id = 0; rel_id < 4; rel_id++) {
+            counterexamples[i].emplace_back();
+            for (Record const& r: ckb.getCounterexampleSet(rel_id)) {
+                counterexamples[i].back().emplace(r.getArgs(), r.getArgs() + r.getArity());
+            }
+        }
+        fvs_records[i] = ckb.totalFvsRecords();
+        necessary_records[i] = ckb.totalNecessaryRecords();
+    }
+    EXPECT_FALSE(rule_strs[0].empty());
+    EXPECT_EQ(rule_strs[0], rule_strs[1]);
+    EXPECT_EQ(counterexamples[0], counterexamples[1]);
+    EXPECT_EQ(fvs_records[0], fvs_records[1]);
+    EXPECT_EQ(necessary_records[0], necessary_records[1]);
+
+    for (int i = 0; i < 55; i++) {
+        delete[] relation_p[i];
+    }
+    for (int i = 0; i < 50; i++) {
+        delete[] relation_q[i];
+        delete[] relation_s[i];
+    }
+    for (int i = 0; i < 45; i++) {
+        delete[] relation_r[i];
+    }
+}
@@ -59,8 +59,12 @@ TEST_F(TestSimpleRelation, TestLoadFile) {
         for (int j = 0; j < 4; j++) {
             EXPECT_EQ(rows[i][j], exp_rows[i][j]) << "@(" << i << ',' << j << ')';
         }
-        delete[] rows[i];
     }
+
+    /* The rows are in one block */
+    EXPECT_EQ(rows[0] + 4, rows[1]);
+    EXPECT_EQ(rows[0] + 8, rows[2]);
+    delete[] rows[0];
     delete[] rows;
     std::filesystem::remove(relation_file_path);
 }
@@ -223,6 +227,88 @@ TEST_F(TestSimpleRelation, TestEntailIfNot) {
     delete[] records;
 }
 
+TEST_F(TestSimpleRelation, TestRowIds) {
+    int** records = new int*[5] {
+        new int[2]{3, 1},
+        new int[2]{1, 2},
+        new int[2]{2, 2},
+        new int[2]{1, 1},
+        new int[2]{2, 5},
+    };
+    SimpleRelation relation("test", 0, records, 2, 5);
+
+    /* Row ids are offsets w.r.t. alphabetical order */
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(relation.rowIdOf(relation[i]), i);
+    }
+    IntTable::sliceType* slice = relation.getSlice(1, 2);
+    ASSERT_NE(slice, nullptr);
+    ASSERT_EQ(slice->size(), 2);
+    int const id1 = relation.rowIdOf((*slice)[0]);
+    int const id2 = relation.rowIdOf((*slice)[1]);
+    EXPECT_EQ(relation[id1], (*slice)[0]);
+    EXPECT_EQ(relation[id2], (*slice)[1]);
+    EXPECT_NE(id1, id2);
+    EXPECT_TRUE(1 == id1 || 2 == id1);  // [1, 2] or [2, 2]
+    EXPECT_TRUE(1 == id2 || 2 == id2);
+    delete slice;
+
+    /* Entailment by row ids */
+    int rec1[2]{1, 2};
+    int rec2[2]{2, 5};
+    EXPECT_TRUE(relation.entailIfNotById(1));
+    EXPECT_FALSE(relation.entailIfNotById(1));
+    EXPECT_TRUE(relation.isEntailed(rec1));
+    EXPECT_TRUE(relation.isEntailedById(1));
+    relation.setAsEntailed(rec2);
+    EXPECT_TRUE(relation.isEntailedById(3));
+    EXPECT_FALSE(relation.entailIfNotById(3));
+    EXPECT_FALSE(relation.isEntailedById(0));
+    EXPECT_EQ(relation.totalEntailedRecords(), 2);
+
+    /* The relation keeps copies of the records */
+    for (int i = 0; i < 5; i++) {
+        delete[] records[i];
+    }
+    delete[] records;
+    EXPECT_EQ(relation[4][0], 3);
+    EXPECT_EQ(relation[4][1], 1);
+}
+
+TEST_F(TestSimpleRelation, TestRowIdsByLoad) {
+    path relation_file_path = path(SIMPLE_RELATION_TEST_DIR) / path("TestRowIdsByLoad.rel");
+    IntWriter writer(relation_file_path.c_str());
+    int const records[5][2] {{3, 1}, {1, 2}, {2, 2}, {1, 1}, {2, 5}};
+    for (int i = 0; i < 5; i++) {
+        writer.write(records[i][0]);
+        writer.write(records[i][1]);
+    }
+    writer.close();
+
+    /* The loaded rows are reordered alphabetically in place */
+    SimpleRelation relation("test", 0, 2, 5, relation_file_path);
+    int const exp_rows[5][2] {{1, 1}, {1, 2}, {2, 2}, {2, 5}, {3, 1}};
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(relation[i][0], exp_rows[i][0]) << "@" << i;
+        EXPECT_EQ(relation[i][1], exp_rows[i][1]) << "@" << i;
+        EXPECT_EQ(relation.rowIdOf(relation[i]), i);
+    }
+
+    /* The rows sorted by other columns point to the reordered rows */
+    IntTable::sliceType* slice = relation.getSlice(1, 1);
+    ASSERT_NE(slice, nullptr);
+    ASSERT_EQ(slice->size(), 2);
+    EXPECT_TRUE(relation[0] == (*slice)[0] || relation[0] == (*slice)[1]);  // [1, 1] and [3, 1]
+    EXPECT_TRUE(relation[4] == (*slice)[0] || relation[4] == (*slice)[1]);
+    delete slice;
+    slice = relation.getSlice(1, 5);
+    ASSERT_NE(slice, nullptr);
+    ASSERT_EQ(slice->size(), 1);
+    EXPECT_EQ(relation[3], (*slice)[0]);
+    delete slice;
+    std::filesystem::remove(relation_file_path);
+}
+
 TEST_F(TestSimpleRelation, TestPromisingConstants) {
     int** const rows = new int*[5] {
         new int[3]{1, 5, 3},
@@ -515,6 +601,52 @@ TEST_F(TestSimpleKb, TestConstructByAssign) {
     releaseRows(father_recs, 4);
 }
 
+TEST_F(TestSimpleKb, TestColumnOverlaps) {
+    int** const family_recs = new int*[4] {
+        new int[3]{4, 5, 6},
+        new int[3]{7, 8, 9},
+        new int[3]{10, 11, 12},
+        new int[3]{13, 14, 15}
+    };
+    int** const mother_recs = new int*[4] {
+        new int[2]{4, 6},
+        new int[2]{7, 9},
+        new int[2]{10, 12},
+        new int[2]{13, 15}
+    };
+    int** const father_recs = new int*[4] {
+        new int[2]{5, 6},
+        new int[2]{8, 9},
+        new int[2]{11, 12},
+        new int[2]{16, 17}
+    };
+    std::string names[3] {"family", "mother", "father"};
+    int** const recs[3] {family_recs, mother_recs, father_recs};
+    int arities[3] {3, 2, 2};
+    int total_rows[3] {4, 4, 4};
+    SimpleKb kb("test", (int***)recs, names, arities, total_rows, 3);
+
+    /* Every pair is feasible before the index is built */
+    EXPECT_TRUE(kb.columnsOverlap(0, 0, 0, 1));
+    EXPECT_TRUE(kb.columnsOverlap(1, 0, 2, 0));
+
+    kb.updateColumnOverlaps();
+    EXPECT_TRUE(kb.columnsOverlap(0, 0, 0, 0));
+    EXPECT_TRUE(kb.columnsOverlap(0, 0, 1, 0));
+    EXPECT_TRUE(kb.columnsOverlap(1, 0, 0, 0));
+    EXPECT_TRUE(kb.columnsOverlap(0, 1, 2, 0));
+    EXPECT_TRUE(kb.columnsOverlap(0, 2, 1, 1));
+    EXPECT_TRUE(kb.columnsOverlap(1, 1, 2, 1));
+    EXPECT_FALSE(kb.columnsOverlap(0, 0, 0, 1));
+    EXPECT_FALSE(kb.columnsOverlap(0, 0, 2, 1));
+    EXPECT_FALSE(kb.columnsOverlap(1, 0, 2, 0));
+    EXPECT_FALSE(kb.columnsOverlap(2, 0, 1, 0));
+
+    releaseRows(family_recs, 4);
+    releaseRows(mother_recs, 4);
+    releaseRows(father_recs, 4);
+}
+
 TEST_F(TestSimpleKb, TestDump) {
     int** const rel1 = new int*[2] {
         new int[6]{1, 2, 3, 4, 5, 6},
@@ -685,10 +817,7 @@ TEST_F(TestSimpleCompressedKb, TestConstructAndDump) {
 
     delete[] counterexamples_mother;
     delete[] counterexamples_father;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
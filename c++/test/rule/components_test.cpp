@@ -2,6 +2,8 @@
 #include "../../src/rule/components.h"
 #include "../../src/util/util.h"
 #include <vector>
+#include <cmath>
+#include <limits>
 
 using namespace sinc;
 
@@ -40,6 +42,49 @@ TEST(TestEval, TestConstructor) {
     EXPECT_TRUE(e2.useful());
 }
 
+TEST(TestEval, TestMaxAllEtls) {
+    double const prev_ratio = 0.1;
+    double const prev_gain = 2.0;
+    for (EvalMetric::Value metric: {EvalMetric::CompressionRatio, EvalMetric::CompressionCapacity, EvalMetric::InfoGain}) {
+        double const cutoff = Eval(10, 40, 2, prev_ratio, prev_gain).value(metric);
+        double const max_all = Eval::maxAllEtls(metric, cutoff, 10, 2, prev_ratio, prev_gain);
+        EXPECT_NEAR(max_all, 40, 1e-6);
+        EXPECT_GT(Eval(10, max_all - 0.5, 2, prev_ratio, prev_gain).value(metric), cutoff);
+        EXPECT_LT(Eval(10, max_all + 0.5, 2, prev_ratio, prev_gain).value(metric), cutoff);
+    }
+
+    /* No bound */
+    EXPECT_TRUE(std::isinf(Eval::maxAllEtls(EvalMetric::CompressionRatio, 0, 10, 2, 0, 0)));
+    EXPECT_TRUE(std::isinf(Eval::maxAllEtls(
+        EvalMetric::CompressionCapacity, -std::numeric_limits<double>::infinity(), 10, 2, 0, 0
+    )));
+    EXPECT_TRUE(std::isinf(Eval::maxAllEtls(EvalMetric::InfoGain, 1.0, 0, 2, 0, 2.0)));
+    EXPECT_GT(0, Eval::maxAllEtls(EvalMetric::InfoGain, 3.0, 0, 2, 0, 2.0));
+}
+
+TEST(TestEval, TestOptimisticSpecializationScore) {
+    for (EvalMetric::Value metric: {EvalMetric::CompressionRatio, EvalMetric::CompressionCapacity, EvalMetric::InfoGain}) {
+        Eval parent(10, 40, 2, 0.1, 2.0);
+        double const bound = parent.optimisticSpecializationScore(metric);
+        for (int pos = 0; pos <= 10; pos++) {
+            for (int neg: {0, 1, 5, 30}) {
+                Eval child(pos, pos + neg, 3, parent.value(EvalMetric::CompressionRatio), parent.value(EvalMetric::InfoGain));
+                EXPECT_LE(child.value(metric), bound + 1e-9);
+            }
+        }
+
+        /* The bound is reached by keeping all positive entailments only */
+        Eval best_child(10, 10, 3, parent.value(EvalMetric::CompressionRatio), parent.value(EvalMetric::InfoGain));
+        EXPECT_NEAR(best_child.value(metric), bound, 1e-9);
+    }
+
+    /* A rule entailing no positive fact cannot be specialized into a better one */
+    Eval empty(0, 5, 2, 0.3, 1.0);
+    EXPECT_EQ(empty.optimisticSpecializationScore(EvalMetric::CompressionRatio), 0.0);
+    EXPECT_EQ(empty.optimisticSpecializationScore(EvalMetric::CompressionCapacity), -3.0);
+    EXPECT_EQ(empty.optimisticSpecializationScore(EvalMetric::InfoGain), empty.value(EvalMetric::InfoGain));
+}
+
 TEST(TestPredicateWithClass, TestComparisons) {
     ArgIndicator*** const arg_indicators = new ArgIndicator**[5] {
         new ArgIndicator*[2]{ArgIndicator::variableIndicator(0, 0), ArgIndicator::variableIndicator(1, 1)},
@@ -240,6 +285,7 @@ TEST_F(TestFingerprint, TestDup) {
         Fingerprint fp2(rule2);
         EXPECT_TRUE(fp1 == fp2) << '@' << i << ", fp1 -x-> fp2";
         EXPECT_TRUE(fp2 == fp1) << '@' << i << ", fp2 -x-> fp1";
+        EXPECT_EQ(Fingerprint::canonicalHash(rule1), Fingerprint::canonicalHash(rule2)) << '@' << i;
     }
 }
 
@@ -320,16 +366,79 @@ TEST_F(TestFingerprint, TestNotDup) {
             case 4:
                 EXPECT_FALSE(fp1 == fp2) << '@' << i << "fp1 -x-> fp2";
                 EXPECT_FALSE(fp2 == fp1) << '@' << i << "fp2 -x-> fp1";
+                EXPECT_NE(Fingerprint::canonicalHash(rule1), Fingerprint::canonicalHash(rule2)) << '@' << i;
                 break;
             case 2:
             case 3:
                 EXPECT_TRUE(fp1 == fp2) << '@' << i << "fp1 -x-> fp2";
                 EXPECT_TRUE(fp2 == fp1) << '@' << i << "fp2 -x-> fp1";
+                EXPECT_EQ(Fingerprint::canonicalHash(rule1), Fingerprint::canonicalHash(rule2)) << '@' << i;
                 break;
         }
     }
 }
 
+TEST_F(TestFingerprint, TestFingerprintCache) {
+    /* 1(X0,X1):-1(X1,X0) */
+    std::vector<Predicate> rule1;
+    rule1.emplace_back(1, new int[2]{ARG_VARIABLE(0), ARG_VARIABLE(1)}, 2);
+    rule1.emplace_back(1, new int[2]{ARG_VARIABLE(1), ARG_VARIABLE(0)}, 2);
+    /* 1(X1,X0):-1(X0,X1) */
+    std::vector<Predicate> rule2;
+    rule2.emplace_back(1, new int[2]{ARG_VARIABLE(1), ARG_VARIABLE(0)}, 2);
+    rule2.emplace_back(1, new int[2]{ARG_VARIABLE(0), ARG_VARIABLE(1)}, 2);
+    /* 1(X0,?):-1(?,X0) */
+    std::vector<Predicate> rule3;
+    rule3.emplace_back(1, new int[2]{ARG_VARIABLE(0), ARG_EMPTY_VALUE}, 2);
+    rule3.emplace_back(1, new int[2]{ARG_EMPTY_VALUE, ARG_VARIABLE(0)}, 2);
+    for (Predicate & p: rule1) {
+        p.maintainArgs();
+    }
+    for (Predicate & p: rule2) {
+        p.maintainArgs();
+    }
+    for (Predicate & p: rule3) {
+        p.maintainArgs();
+    }
+    uint64_t const hash1 = Fingerprint::canonicalHash(rule1);
+
+    FingerprintCache cache;
+    Fingerprint* fp1 = nullptr;
+    bool release1 = false;
+    EXPECT_TRUE(cache.insert(rule1, hash1, fp1, release1));
+    EXPECT_EQ(nullptr, fp1);
+    EXPECT_EQ(1, cache.size());
+
+    /* The same canonical hash: full fingerprints are compared */
+    Fingerprint* fp2 = nullptr;
+    bool release2 = false;
+    EXPECT_FALSE(cache.insert(rule2, Fingerprint::canonicalHash(rule2), fp2, release2));
+    ASSERT_NE(nullptr, fp2);
+    EXPECT_TRUE(release2);
+    EXPECT_EQ(1, cache.size());
+    delete fp2;
+
+    /* Forced collision of different rules */
+    Fingerprint* fp3 = nullptr;
+    bool release3 = false;
+    EXPECT_TRUE(cache.insert(rule3, hash1, fp3, release3));
+    ASSERT_NE(nullptr, fp3);
+    EXPECT_FALSE(release3);
+    EXPECT_EQ(2, cache.size());
+
+    /* Adopt an equivalent fingerprint */
+    fp2 = new Fingerprint(rule2);
+    release2 = true;
+    cache.adopt(rule2, hash1, fp2, release2);
+    EXPECT_FALSE(release2);
+    EXPECT_TRUE(*fp2 == Fingerprint(rule1));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_LT(0, cache.getMemCost());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+}
+
 TEST_F(TestFingerprint, TestGeneralizationOf) {
     std::string rule_pair_strs[3][2] {{
             "2(X0,?):-1(?,X0)",
@@ -377,6 +486,35 @@ TEST_F(TestFingerprint, TestGeneralizationOf) {
     }
 }
 
+TEST_F(TestFingerprint, TestBindingSignature) {
+    /* 2(X0,?):-1(?,X0) */
+    std::vector<Predicate> rule1;
+    rule1.emplace_back(2, new int[2]{ARG_VARIABLE(0), ARG_EMPTY_VALUE}, 2);
+    rule1.emplace_back(1, new int[2]{ARG_EMPTY_VALUE, ARG_VARIABLE(0)}, 2);
+    /* 2(X0,X1):-1(X1,X0) */
+    std::vector<Predicate> rule2;
+    rule2.emplace_back(2, new int[2]{ARG_VARIABLE(0), ARG_VARIABLE(1)}, 2);
+    rule2.emplace_back(1, new int[2]{ARG_VARIABLE(1), ARG_VARIABLE(0)}, 2);
+    /* 2(?,?):- */
+    std::vector<Predicate> rule3;
+    rule3.emplace_back(2, new int[2]{ARG_EMPTY_VALUE, ARG_EMPTY_VALUE}, 2);
+    for (Predicate & p: rule1) {
+        p.maintainArgs();
+    }
+    for (Predicate & p: rule2) {
+        p.maintainArgs();
+    }
+    for (Predicate & p: rule3) {
+        p.maintainArgs();
+    }
+    Fingerprint fp1(rule1);
+    Fingerprint fp2(rule2);
+    Fingerprint fp3(rule3);
+    EXPECT_NE(0, fp1.getBindingSignature());
+    EXPECT_EQ(0, fp1.getBindingSignature() & ~fp2.getBindingSignature());
+    EXPECT_EQ(0, fp3.getBindingSignature());
+}
+
 TEST_F(TestFingerprint, TestNotGeneralizationOf) {
     std::string rule_pair_strs[3][2] {{
             "2(X0,X1):-3(X0,X1)",
@@ -121,10 +121,7 @@ TEST(RuleTest, TestConstructor) {
     ASSERT_EQ(predicate_body3, r->getPredicate(3));
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<const sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -162,10 +159,47 @@ TEST(RuleTest, TestCopyConstructor) {
 
     delete r1;
     delete r2;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabu_set) {
+        delete kv.first;
+        delete kv.second;
+    }
+}
+
+TEST(RuleTest, TestRestoreConstructor) {
+    Rule::MinFactCoverage = 0;
+    Rule::fingerprintCacheType cache;
+    Rule::tabuMapType tabu_set;
+    Rule* r1 = new BareRule(1, 5, cache, tabu_set);
+    ASSERT_EQ(UpdateStatus::Normal, r1->specializeCase5(0, 2, 99));
+    ASSERT_EQ(UpdateStatus::Normal, r1->specializeCase3(0, 0, 0, 1));
+    ASSERT_EQ(UpdateStatus::Normal, r1->specializeCase4(2, 4, 2, 0, 4));
+    ASSERT_EQ(UpdateStatus::Normal, r1->specializeCase4(2, 4, 1, 1, 0));
+    ASSERT_EQ(UpdateStatus::Normal, r1->specializeCase1(1, 1, 2));
+    ASSERT_STREQ(r1->toDumpString().c_str(), "1(X0,X0,99,?,X1):-2(X2,X2,X1,?),2(?,X2,?,?)");
+    ASSERT_EQ(6, cache.size());
+
+    std::vector<Predicate> structure;
+    for (int i = 0; i < r1->numPredicates(); i++) {
+        structure.push_back(r1->getPredicate(i));
     }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabu_set) {
+    Rule* r2 = new BareRule(structure, Eval(5, 8, r1->getLength()), cache, tabu_set);
+    EXPECT_STREQ(r1->toDumpString().c_str(), r2->toDumpString().c_str());
+    EXPECT_EQ(r1->getLength(), r2->getLength());
+    EXPECT_EQ(r1->numPredicates(), r2->numPredicates());
+    EXPECT_EQ(r1->usedLimitedVars(), r2->usedLimitedVars());
+    EXPECT_TRUE(*r1 == *r2);
+    EXPECT_EQ(Eval(5, 8, r1->getLength()), r2->getEval());
+    EXPECT_EQ(6, cache.size());
+
+    /* The limited variables are restored, so the rule can be specialized as usual */
+    ASSERT_EQ(UpdateStatus::Normal, r2->specializeCase1(2, 3, 1));
+    EXPECT_STREQ(r2->toDumpString().c_str(), "1(X0,X0,99,?,X1):-2(X2,X2,X1,?),2(?,X2,?,X1)");
+    EXPECT_EQ(r1->getLength() + 1, r2->getLength());
+    EXPECT_EQ(7, cache.size());
+
+    delete r1;
+    delete r2;
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabu_set) {
         delete kv.first;
         delete kv.second;
     }
@@ -205,10 +239,7 @@ TEST(RuleTest, TestSpecCase1) {
     ASSERT_EQ(cache.size(), 4);
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -255,10 +286,7 @@ TEST(RuleTest, TestSpecCase2) {
     ASSERT_EQ(cache.size(), 5);
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -319,10 +347,7 @@ TEST(RuleTest, TestSpecCase3) {
     ASSERT_EQ(cache.size(), 7);
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -369,10 +394,7 @@ TEST(RuleTest, TestSpecCase4) {
     ASSERT_EQ(cache.size(), 5);
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -440,10 +462,7 @@ TEST(RuleTest, TestSpecCase5) {
     ASSERT_EQ(cache.size(), 8);
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -466,9 +485,6 @@ TEST(RuleTest, TestGeneralize1) {
     ASSERT_EQ(2, r->usedLimitedVars());
     ASSERT_EQ(6, cache.size());
 
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
     cache.clear();
     ASSERT_EQ(UpdateStatus::Normal, r->generalize(1, 0));
     ASSERT_STREQ(r->toDumpString().c_str(), "1(X0,X1,3):-3(?,X1),3(3,X0)");
@@ -508,10 +524,7 @@ TEST(RuleTest, TestGeneralize1) {
     ASSERT_EQ(head, r->getHead());
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabu_set) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabu_set) {
         delete kv.first;
         delete kv.second;
     }
@@ -534,9 +547,6 @@ TEST(RuleTest, TestGeneralize2) {
     ASSERT_EQ(3, r->usedLimitedVars());
     ASSERT_EQ(6, cache.size());
 
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
     cache.clear();
     ASSERT_EQ(UpdateStatus::Normal, r->generalize(0, 0));
     ASSERT_STREQ(r->toDumpString().c_str(), "1(?,X1,X2):-2(X0),3(X2,X1),3(X2,X0)");
@@ -562,10 +572,7 @@ TEST(RuleTest, TestGeneralize2) {
     ASSERT_EQ(UpdateStatus::Invalid, r->generalize(0, 2));
 
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabu_set) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabu_set) {
         delete kv.first;
         delete kv.second;
     }
@@ -654,10 +661,7 @@ TEST(RuleTest, TestToString) {
     }
     delete[] rows;
     delete r;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -677,9 +681,6 @@ TEST(RuleTest, TestInvalid) {
     ASSERT_STREQ(r2->toDumpString().c_str(), "1(?,?,?):-2(?,X0),3(?,X0,?)");
 
     Rule* r3 = r->clone();
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
     cache.clear();
     ASSERT_EQ(UpdateStatus::Invalid, r3->generalize(1, 0));
     ASSERT_STREQ(r3->toDumpString().c_str(), "1(?,?,?):-2(?,X0),3(?,X0,?)");
@@ -700,10 +701,7 @@ TEST(RuleTest, TestInvalid) {
     delete r3;
     delete r4;
     delete r5;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -740,10 +738,7 @@ TEST(RuleTest, TestCacheHit) {
     delete r2;
     delete r3;
     delete r4;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
-    }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
@@ -768,11 +763,60 @@ TEST(RuleTest, TestInsufficientCoverageAndTabuHit) {
 
     delete r;
     delete r2;
-    for (const Fingerprint* const& fp: cache) {
-        delete fp;
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
+        delete kv.first;
+        delete kv.second;
     }
-    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::fingerprintCacheType*> const& kv: tabuMap) {
+}
+
+TEST(RuleTest, TestTabuMapIndex) {
+    Rule::fingerprintCacheType cache;
+    Rule::tabuMapType tabuMap;
+    BareRule* r = new BareRule(1, 3, cache, tabuMap);
+    r->coverage = 0.5;
+    ASSERT_EQ(UpdateStatus::Normal, r->specializeCase4(2, 2, 0, 0, 0));
+    BareRule* r2 = r->clone();
+    BareRule* r3 = r->clone();
+    r->coverage = 0;
+    ASSERT_EQ(UpdateStatus::InsufficientCoverage, r->specializeCase4(3, 3, 1, 0, 2));
+    ASSERT_STREQ(r->toDumpString().c_str(), "1(X0,?,X1):-2(X0,?),3(?,X1,?)");
+    ASSERT_EQ(1, tabuMap.size());
+    ASSERT_EQ(1, tabuMap.getCategories().size());
+    MultiSet<int> functors;
+    functors.add(2);
+    functors.add(3);
+    EXPECT_EQ(Rule::TabuMap::categorySignature(functors), tabuMap.getCategories()[0].signature);
+    EXPECT_EQ(2, tabuMap.getCategories()[0].functors->getSize());
+
+    /* Category {2, 3} is a sub-multiset of {2, 3, 3}, and the tabu fingerprint is a generalization */
+    r2->coverage = 0.5;
+    ASSERT_EQ(UpdateStatus::Normal, r2->specializeCase4(3, 3, 0, 1, 1));
+    ASSERT_STREQ(r2->toDumpString().c_str(), "1(X0,?,?):-2(X0,X1),3(X1,?,?)");
+    ASSERT_EQ(UpdateStatus::TabuPruned, r2->specializeCase4(3, 3, 1, 0, 2));
+    ASSERT_STREQ(r2->toDumpString().c_str(), "1(X0,?,X2):-2(X0,X1),3(X1,?,?),3(?,X2,?)");
+
+    /* Category {2, 2} is not a super-multiset of {2, 3} */
+    BareRule* r4 = r3->clone();
+    r4->coverage = 0.5;
+    ASSERT_EQ(UpdateStatus::Normal, r4->specializeCase4(2, 2, 1, 0, 2));
+    ASSERT_STREQ(r4->toDumpString().c_str(), "1(X0,?,X1):-2(X0,?),2(?,X1)");
+
+    /* Another fingerprint of the same category */
+    r3->coverage = 0;
+    ASSERT_EQ(UpdateStatus::InsufficientCoverage, r3->specializeCase4(3, 3, 0, 0, 1));
+    ASSERT_STREQ(r3->toDumpString().c_str(), "1(X0,X1,?):-2(X0,?),3(X1,?,?)");
+    EXPECT_EQ(1, tabuMap.size());
+    EXPECT_EQ(1, tabuMap.getCategories().size());
+    EXPECT_EQ(2, tabuMap.getCategories()[0].tabuSet->size());
+
+    delete r;
+    delete r2;
+    delete r3;
+    delete r4;
+    for (std::pair<sinc::MultiSet<int> *, sinc::Rule::tabuSetType*> const& kv: tabuMap) {
         delete kv.first;
         delete kv.second;
     }
+    tabuMap.clear();
+    EXPECT_EQ(0, tabuMap.getCategories().size());
 }
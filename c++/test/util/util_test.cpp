@@ -326,6 +326,54 @@ TEST(TestUtil, TestDisjointSet) {
     EXPECT_NE(s3.findSet(1), s3.findSet(3));
 }
 
+TEST(TestUtil, TestIntTupleSet) {
+    IntTupleSet s(3, 1);
+    EXPECT_EQ(s.getWidth(), 3);
+    EXPECT_EQ(s.size(), 0);
+
+    int t1[3]{1, 2, 3};
+    int t2[3]{3, 2, 1};
+    EXPECT_TRUE(s.insert(t1));
+    EXPECT_TRUE(s.insert(t2));
+    EXPECT_FALSE(s.insert(t1));
+    EXPECT_EQ(s.size(), 2);
+    EXPECT_TRUE(s.contains(t2));
+    EXPECT_EQ(s[0][0], 1);
+    EXPECT_EQ(s[1][0], 3);
+
+    /* Grow the table */
+    int t[3]{0, 0, 0};
+    for (int i = 0; i < 1000; i++) {
+        t[0] = i % 10;
+        t[1] = i / 10;
+        EXPECT_TRUE(s.insert(t));
+    }
+    for (int i = 0; i < 1000; i++) {
+        t[0] = i % 10;
+        t[1] = i / 10;
+        EXPECT_FALSE(s.insert(t));
+        EXPECT_EQ(s[i + 2][0], t[0]);
+        EXPECT_EQ(s[i + 2][1], t[1]);
+    }
+    EXPECT_EQ(s.size(), 1002);
+    EXPECT_TRUE(s.contains(t1));
+    int t3[3]{1, 2, 4};
+    EXPECT_FALSE(s.contains(t3));
+
+    s.clear();
+    EXPECT_EQ(s.size(), 0);
+    EXPECT_FALSE(s.contains(t1));
+    EXPECT_TRUE(s.insert(t3));
+    EXPECT_TRUE(s.insert(t1));
+    EXPECT_EQ(s.size(), 2);
+
+    /* Empty tuples */
+    IntTupleSet s0(0);
+    EXPECT_TRUE(s0.insert(t1));
+    EXPECT_FALSE(s0.insert(t2));
+    EXPECT_EQ(s0.size(), 1);
+}
+
 TEST(TestUtil, TestComparableArray) {
     ComparableArray<Record> a1(new Record[3]{
         Record(new int[3]{1, 2, 3}, 3),
@@ -371,4 +419,56 @@ TEST(TestPerformanceMonitor, TestFormatting) {
     Monitor4Test monitor;
     monitor.show(os);
     EXPECT_STREQ(os.str().c_str(), "My name is      Trams. I'm 30 years old. Pi is 3.141593");
-}
\ No newline at end of file
+}
+TEST(TestMemoryAccountant, TestBudgets) {
+    size_t cache = 5 * 1024;
+    size_t pool = 0;
+    MemoryAccountant accountant(10, 20, 4);
+    int const cache_id = accountant.addSource([&cache]() {return cache;});
+    accountant.addSource([&pool]() {return pool;});
+    EXPECT_EQ(accountant.sample(), MemoryAccountant::Normal);
+    EXPECT_EQ(accountant.getUsageKb(), 5);
+
+    /* Exceed the hard budget. `check()` only samples on every 4 calls */
+    pool = 30 * 1024;
+    EXPECT_EQ(accountant.check(), MemoryAccountant::Normal);
+    EXPECT_EQ(accountant.check(), MemoryAccountant::Normal);
+    EXPECT_EQ(accountant.check(), MemoryAccountant::Normal);
+    EXPECT_EQ(accountant.check(), MemoryAccountant::Hard);
+    EXPECT_EQ(accountant.getPeakUsageKb(), 35);
+    EXPECT_EQ(accountant.getSoftExceeded(), 1);
+
+    /* Relievers are invoked in order until the usage drops below the soft budget */
+    int first_calls = 0;
+    int second_calls = 0;
+    accountant.addReliever([&]() {
+        first_calls++;
+        size_t released = (pool > 10 * 1024) ? pool - 10 * 1024 : 0;
+        pool = std::min(pool, (size_t) 10 * 1024);
+        return released;
+    });
+    accountant.addReliever([&]() {
+        second_calls++;
+        size_t released = pool;
+        pool = 0;
+        return released;
+    });
+    EXPECT_EQ(accountant.sample(), MemoryAccountant::Normal);
+    EXPECT_EQ(first_calls, 1);
+    EXPECT_EQ(second_calls, 1);
+    EXPECT_EQ(accountant.getUsageKb(), 5);
+    EXPECT_EQ(accountant.getRelievedKb(), 30);
+    EXPECT_EQ(accountant.getSoftExceeded(), 2);
+
+    /* Soft level when the relievers release nothing */
+    cache = 15 * 1024;
+    EXPECT_EQ(accountant.sample(), MemoryAccountant::Soft);
+    EXPECT_EQ(first_calls, 2);
+    EXPECT_EQ(second_calls, 2);
+    EXPECT_EQ(accountant.getSoftExceeded(), 3);
+    EXPECT_EQ(accountant.getPeakUsageKb(), 35);
+
+    accountant.removeSource(cache_id);
+    EXPECT_EQ(accountant.sample(), MemoryAccountant::Normal);
+    EXPECT_EQ(accountant.getUsageKb(), 0);
+}